@@ -26,6 +26,11 @@ static constexpr uint8_t BAKED_COLOR_PACKAGE[] = {
 #include <chrono>
 #include <iostream>
 
+#include "../common/FrameTelemetry.h"
+#include "../common/MemoryLedger.h"
+#include "../common/ReplayLog.h"
+#include "../common/Trace.h"
+
 using namespace filament;
 using utils::Entity;
 
@@ -35,6 +40,9 @@ static uint32_t makeColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
 }
 
 int main() {
+    // 设置环境变量 DEMO_TRACE=trace.json 时记录 Chrome trace，退出时写出文件
+    demo::TraceSession traceSession;
+
     // ========================================
     // 第一步：初始化 SDL 和创建窗口
     // ========================================
@@ -82,7 +90,9 @@ int main() {
     // ========================================
     // 第二步：初始化 Filament 引擎和核心组件
     // ========================================
+    TRACE_NAME_BEGIN("Engine::create");
     Engine* engine = Engine::create(backend::Backend::METAL);
+    TRACE_NAME_END();
     if (!engine) {
         std::cerr << "Failed to create Filament engine" << std::endl;
         SDL_Metal_DestroyView(metalView);
@@ -134,6 +144,9 @@ int main() {
         0, 2, 3   // 第二个三角形：左下、右上、左上
     };
 
+    // 资源内存账本：设置 DEMO_MEMORY_REPORT=5 时每 5 秒打印一次各资源的字节数、Engine 对象数量和 RSS
+    demo::MemoryLedger memory;
+
     // ========================================
     // 第四步：创建顶点缓冲区和索引缓冲区
     // ========================================
@@ -155,14 +168,19 @@ int main() {
 
     // 上传索引数据
     indexBuffer->setBuffer(*engine, IndexBuffer::BufferDescriptor(indices, sizeof(indices)));
+    memory.addVertexBuffer("rectangle", vertexBuffer, sizeof(vertices));
+    memory.addIndexBuffer("rectangle", indexBuffer, IndexBuffer::IndexType::USHORT);
 
     // ========================================
     // 第五步：创建材质
     // ========================================
     // 使用预编译的材质包
+    TRACE_NAME_BEGIN("Material::build");
     Material* material = Material::Builder()
         .package(BAKED_COLOR_PACKAGE, sizeof(BAKED_COLOR_PACKAGE))
         .build(*engine);
+    TRACE_NAME_END();
+    memory.addMaterial("bakedcolor", material, sizeof(BAKED_COLOR_PACKAGE));
 
     MaterialInstance* materialInstance = material->getDefaultInstance();
 
@@ -203,26 +221,48 @@ int main() {
     // ========================================
     // 第八步：主渲染循环
     // ========================================
+    // 帧耗时遥测：退出时打印 p50/p90/p99/max 和卡顿次数，运行中可以用 kill -USR1 <pid> 打印
+    demo::FrameTelemetry::installSignalHandler();
+    demo::FrameTelemetry telemetry("01-rectangle");
+    // DEMO_RECORD=run.rec 录制输入和动画，DEMO_REPLAY=run.rec 逐帧回放
+    demo::ReplayLog replay;
+
     bool running = true;
     
     while (running) {
+        telemetry.beginFrame();
+        if (!replay.beginFrame(*engine)) {
+            break;  // 回放结束
+        }
+
+        TRACE_NAME_BEGIN("SDL_PollEvent");
         SDL_Event event;
-        while (SDL_PollEvent(&event)) {
+        while (replay.pollEvent(&event, SDL_PollEvent)) {
             if (event.type == SDL_EVENT_QUIT) {
                 running = false;
             }
         }
+        TRACE_NAME_END();
 
         // 执行渲染
-        if (renderer->beginFrame(swapChain)) {
+        TRACE_NAME_BEGIN("Renderer::beginFrame");
+        const bool frameReady = renderer->beginFrame(swapChain);
+        TRACE_NAME_END();
+        if (frameReady) {
             // 设置清除颜色为深蓝色
             renderer->setClearOptions({
                 .clearColor = {0.1f, 0.1f, 0.2f, 1.0f},
                 .clear = true
             });
+            TRACE_NAME_BEGIN("Renderer::render");
             renderer->render(view);
+            TRACE_NAME_END();
+            TRACE_NAME_BEGIN("Renderer::endFrame");
             renderer->endFrame();
+            TRACE_NAME_END();
         }
+        telemetry.endFrame(*renderer);
+        memory.tick(*engine);
     }
 
     // ========================================
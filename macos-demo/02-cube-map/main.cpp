@@ -17,11 +17,19 @@
 #include <filament/TextureSampler.h>
 
 #include <utils/EntityManager.h>
-#include "../generated/resources/resources.h"
+#include "../common/EmbeddedResources.h"
 #include <filament/Viewport.h>
 #include <filament/Color.h>
 
 #include <iostream>
+
+#include "../common/FrameTelemetry.h"
+#include "../common/MemoryLedger.h"
+#include "../common/PackFile.h"
+#include "../common/ReplayLog.h"
+#include "../common/TextureUploader.h"
+#include "../common/Trace.h"
+#include "../common/VertexPacker.h"
 #include <fstream>
 #include <vector>
 
@@ -31,6 +39,11 @@ using utils::Entity;
 
 // 使用BAKEDTEXTURE材质
 
+// macos-demo目录，由CMake在配置时传入源码树中的绝对路径
+#ifndef DEMO_ASSET_ROOT
+#define DEMO_ASSET_ROOT "macos-demo"
+#endif
+
 // 立方体顶点数据：位置 + UV坐标
 struct Vertex {
     float3 position;  // 3D位置坐标
@@ -97,51 +110,20 @@ static const uint16_t CUBE_INDICES[] = {
     20, 21, 22,  20, 22, 23,
 };
 
-// 加载RGBA纹理数据
-Texture* loadRGBATexture(Engine* engine, const std::string& filename, int width, int height) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open texture file: " << filename << std::endl;
-        return nullptr;
-    }
-    
-    // 读取RGBA数据
-    std::vector<uint8_t> data(width * height * 4);
-    file.read(reinterpret_cast<char*>(data.data()), data.size());
-    file.close();
-    
-    // 检查文件大小
-    size_t expectedSize = width * height * 4;
-    if (data.size() != expectedSize) {
-        std::cerr << "Texture file size mismatch. Expected: " << expectedSize 
-                  << ", Got: " << data.size() << std::endl;
-        return nullptr;
+// 请求加载RGBA纹理：资源包中有该文件时直接上传映射内存（映射在engine销毁后才释放），
+// 否则在工作线程上从DEMO_ASSET_ROOT（macos-demo目录）读取
+demo::TextureFuture requestRGBATexture(demo::TextureUploader& textures, const demo::PackFile& pack,
+        const std::string& name, uint32_t width, uint32_t height) {
+    if (const demo::PackView data = pack.find(name)) {
+        return textures.uploadRGBA(data.data, data.size, width, height);
     }
-    
-    // 创建纹理
-    Texture* texture = Texture::Builder()
-        .width(width)
-        .height(height)
-        .levels(1)
-        .format(Texture::InternalFormat::RGBA8)
-        .build(*engine);
-    
-    // 上传纹理数据
-    Texture::PixelBufferDescriptor buffer(
-        data.data(),
-        data.size(),
-        Texture::Format::RGBA,
-        Texture::Type::UBYTE
-    );
-    texture->setImage(*engine, 0, std::move(buffer));
-    
-    std::cout << "Texture loaded successfully: " << width << "x" << height 
-              << ", size: " << data.size() << " bytes" << std::endl;
-    
-    return texture;
+    return textures.loadRGBA(std::string(DEMO_ASSET_ROOT) + "/" + name, width, height);
 }
 
 int main() {
+    // 设置环境变量 DEMO_TRACE=trace.json 时记录 Chrome trace，退出时写出文件
+    demo::TraceSession traceSession;
+
     // ========================================
     // 第一步：初始化SDL
     // ========================================
@@ -195,7 +177,9 @@ int main() {
     // ========================================
     // 第二步：初始化Filament
     // ========================================
+    TRACE_NAME_BEGIN("Engine::create");
     Engine* engine = Engine::create(backend::Backend::METAL);
+    TRACE_NAME_END();
     if (!engine) {
         std::cerr << "Failed to create Filament engine" << std::endl;
         SDL_Metal_DestroyView(metalView);
@@ -210,15 +194,46 @@ int main() {
     View* view = engine->createView();
     SwapChain* swapChain = engine->createSwapChain(metalLayer);
 
+    // 资源内存账本：设置 DEMO_MEMORY_REPORT=5 时每 5 秒打印一次各资源的字节数、Engine 对象数量和 RSS
+    demo::MemoryLedger memory;
+
+    // 设置 DEMO_PACK=demo.pack 时从资源包读取纹理（由 demo-pack 生成），否则读取 macos-demo 目录下的文件
+    demo::PackFile pack;
+    pack.openFromEnvironment();
+
     // ========================================
     // 第三步：创建顶点缓冲区和索引缓冲区
     // ========================================
-    VertexBuffer* vertexBuffer = VertexBuffer::Builder()
+    // 量化顶点：位置相对立方体 AABB 存成归一化 SHORT4，UV 存成归一化 USHORT2，每个顶点 12 字节（float 布局 20 字节）
+    float3 cubePositions[24];
+    float2 cubeUvs[24];
+    for (size_t i = 0; i < 24; i++) {
+        cubePositions[i] = CUBE_VERTICES[i].position;
+        cubeUvs[i] = CUBE_VERTICES[i].uv;
+    }
+    demo::VertexPackInput packInput;
+    packInput.vertexCount = 24;
+    packInput.positions = cubePositions;
+    packInput.uvs = cubeUvs;
+    demo::PackedVertices packedVertices;
+    if (!demo::packVertices(packInput, {}, packedVertices)) {
+        engine->destroy(engine);
+        SDL_Metal_DestroyView(metalView);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return 1;
+    }
+    std::cout << "Packed vertices: " << packedVertices.stats.floatStride << " -> "
+              << packedVertices.stats.packedStride << " bytes, max position error "
+              << packedVertices.stats.positionError << " (bound " << packedVertices.stats.positionBound
+              << "), max UV error " << packedVertices.stats.uvError << std::endl;
+
+    VertexBuffer::Builder vertexBuilder;
+    vertexBuilder
         .vertexCount(24)  // 24个顶点
-        .bufferCount(1)  // 1个缓冲区
-        .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3, 0, 20)  // 位置：3个float，偏移0，步长20字节
-        .attribute(VertexAttribute::UV0, 0, VertexBuffer::AttributeType::FLOAT2, 12, 20)     // UV：2个float，偏移12，步长20字节
-        .build(*engine);
+        .bufferCount(1);  // 1个缓冲区
+    packedVertices.applyLayout(vertexBuilder);  // 位置和 UV 的类型、偏移、步长和归一化标志
+    VertexBuffer* vertexBuffer = vertexBuilder.build(*engine);
 
     IndexBuffer* indexBuffer = IndexBuffer::Builder()
         .indexCount(36)  // 36个索引（6个面 × 6个索引）
@@ -226,17 +241,42 @@ int main() {
         .build(*engine);
 
     // 上传顶点数据
-    vertexBuffer->setBufferAt(*engine, 0, VertexBuffer::BufferDescriptor(CUBE_VERTICES, sizeof(CUBE_VERTICES), nullptr));
+    // packedVertices 一直存活到 main() 结束，上传不需要拷贝
+    vertexBuffer->setBufferAt(*engine, 0, VertexBuffer::BufferDescriptor(
+        packedVertices.data.data(), packedVertices.data.size(), nullptr));
 
     // 上传索引数据
     indexBuffer->setBuffer(*engine, IndexBuffer::BufferDescriptor(CUBE_INDICES, sizeof(CUBE_INDICES)));
+    memory.addVertexBuffer("cube", vertexBuffer, packedVertices.data.size());
+    memory.addIndexBuffer("cube", indexBuffer, IndexBuffer::IndexType::USHORT);
 
     // ========================================
     // 第四步：加载纹理
     // ========================================
-    Texture* texture = loadRGBATexture(engine, 
-        "/Users/jason/Jason/opengl/LearnFilament/macos-demo/rgba8_200x200.rgba", 
-        200, 200);
+    // 只提交请求：工作线程读取文件的同时，引擎线程继续构建材质，之后再取回纹理
+    demo::TextureUploader textures(*engine, 1);
+    const demo::TextureFuture textureFuture =
+        requestRGBATexture(textures, pack, "rgba8_200x200.rgba", 200, 200);
+
+    // ========================================
+    // 第五步：创建材质
+    // ========================================
+    TRACE_NAME_BEGIN("Material::build");
+    Material* material = nullptr;
+    {
+        // 材质包只需要保持到 build()，之后租约的缓冲区还给资源包的池
+        const demo::BundleLease package = ACQUIRE_RESOURCE(RESOURCES, BAKEDTEXTURE);
+        material = Material::Builder()
+            .package(package.data(), package.size())
+            .build(*engine);
+    }
+    TRACE_NAME_END();
+    memory.addMaterial("bakedtexture", material, RESOURCES_BAKEDTEXTURE_SIZE);
+
+    // 取回纹理：setImage() 在这里提交，像素缓冲区在上传完成后由回调还给暂存池
+    TRACE_NAME_BEGIN("loadRGBATexture");
+    Texture* texture = textures.wait(textureFuture);
+    TRACE_NAME_END();
     if (!texture) {
         std::cerr << "Failed to load texture" << std::endl;
         engine->destroy(engine);
@@ -245,13 +285,8 @@ int main() {
         SDL_Quit();
         return 1;
     }
-
-    // ========================================
-    // 第五步：创建材质
-    // ========================================
-    Material* material = Material::Builder()
-        .package(RESOURCES_BAKEDTEXTURE_DATA, RESOURCES_BAKEDTEXTURE_SIZE)
-        .build(*engine);
+    std::cout << "Texture loaded successfully: 200x200" << std::endl;
+    memory.addTexture("rgba8_200x200", texture);
 
     MaterialInstance* materialInstance = material->getDefaultInstance();
     
@@ -267,7 +302,7 @@ int main() {
     Entity cube = utils::EntityManager::get().create();
 
     RenderableManager::Builder(1)
-        .boundingBox({{ -0.5, -0.5, -0.5 }, { 0.5, 0.5, 0.5 }})
+        .boundingBox(packedVertices.bounds)  // 打包空间中的包围盒
         .material(0, materialInstance)
         .geometry(0, RenderableManager::PrimitiveType::TRIANGLES, vertexBuffer, indexBuffer)
         .culling(false)
@@ -300,21 +335,35 @@ int main() {
     // ========================================
     // 第八步：主渲染循环
     // ========================================
+    // 帧耗时遥测：退出时打印 p50/p90/p99/max 和卡顿次数，运行中可以用 kill -USR1 <pid> 打印
+    demo::FrameTelemetry::installSignalHandler();
+    demo::FrameTelemetry telemetry("02-cube-map");
+    // DEMO_RECORD=run.rec 录制输入和动画，DEMO_REPLAY=run.rec 逐帧回放
+    demo::ReplayLog replay;
+
     bool running = true;
     auto startTime = std::chrono::high_resolution_clock::now();
     
     while (running) {
+        telemetry.beginFrame();
+        if (!replay.beginFrame(*engine)) {
+            break;  // 回放结束
+        }
+
+        TRACE_NAME_BEGIN("SDL_PollEvent");
         SDL_Event event;
-        while (SDL_PollEvent(&event)) {
+        while (replay.pollEvent(&event, SDL_PollEvent)) {
             if (event.type == SDL_EVENT_QUIT) {
                 running = false;
             }
         }
+        TRACE_NAME_END();
 
+        TRACE_NAME_BEGIN("update");
         // 计算动画时间
         auto now = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime);
-        float time = duration.count() / 1000.0f;
+        float time = replay.frameTime(duration.count() / 1000.0f);
 
         // 应用旋转变换：先横向转一圈，然后纵向转一圈
         auto& tcm = engine->getTransformManager();
@@ -333,20 +382,32 @@ int main() {
             verticalRotation = ((rotationTime - 8.0f) / 8.0f) * 2.0f * M_PI;
         }
         
-        tcm.setTransform(tcm.getInstance(cube), 
+        // decode 把量化的位置变回模型空间，乘在最右边
+        replay.setTransform(tcm, cube, 
             mat4f::rotation(horizontalRotation, float3{ 0, 1, 0 }) * 
-            mat4f::rotation(verticalRotation, float3{ 1, 0, 0 }));
+            mat4f::rotation(verticalRotation, float3{ 1, 0, 0 }) * packedVertices.decode);
+
+        TRACE_NAME_END();
 
         // 执行渲染
-        if (renderer->beginFrame(swapChain)) {
+        TRACE_NAME_BEGIN("Renderer::beginFrame");
+        const bool frameReady = renderer->beginFrame(swapChain);
+        TRACE_NAME_END();
+        if (frameReady) {
             // 设置清除颜色为深蓝色
             renderer->setClearOptions({
                 .clearColor = {0.1f, 0.1f, 0.2f, 1.0f},
                 .clear = true
             });
+            TRACE_NAME_BEGIN("Renderer::render");
             renderer->render(view);
+            TRACE_NAME_END();
+            TRACE_NAME_BEGIN("Renderer::endFrame");
             renderer->endFrame();
+            TRACE_NAME_END();
         }
+        telemetry.endFrame(*renderer);
+        memory.tick(*engine);
     }
 
     // ========================================
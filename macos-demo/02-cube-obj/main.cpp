@@ -18,11 +18,20 @@
 
 #include <utils/EntityManager.h>
 #include <filameshio/MeshReader.h>
-#include "../generated/resources/resources.h"
+#include "../common/EmbeddedResources.h"
 #include <filament/Viewport.h>
 #include <filament/Color.h>
 
 #include <iostream>
+
+#include "../common/FrameTelemetry.h"
+#include "../common/MappedMesh.h"
+#include "../common/ObjImporter.h"
+#include "../common/MemoryLedger.h"
+#include "../common/PackFile.h"
+#include "../common/ReplayLog.h"
+#include "../common/TextureUploader.h"
+#include "../common/Trace.h"
 #include <fstream>
 #include <vector>
 
@@ -31,7 +40,15 @@ using namespace filament::math;
 using namespace filamesh;
 using utils::Entity;
 
+// macos-demo目录，由CMake在配置时传入源码树中的绝对路径
+#ifndef DEMO_ASSET_ROOT
+#define DEMO_ASSET_ROOT "macos-demo"
+#endif
+
 int main() {
+    // 设置环境变量 DEMO_TRACE=trace.json 时记录 Chrome trace，退出时写出文件
+    demo::TraceSession traceSession;
+
     // ========================================
     // 第一步：初始化SDL
     // ========================================
@@ -85,7 +102,9 @@ int main() {
     // ========================================
     // 第二步：创建Filament引擎
     // ========================================
+    TRACE_NAME_BEGIN("Engine::create");
     Engine* engine = Engine::create(backend::Backend::METAL);
+    TRACE_NAME_END();
     if (!engine) {
         std::cerr << "Failed to create Filament engine" << std::endl;
         SDL_Metal_DestroyView(metalView);
@@ -101,34 +120,38 @@ int main() {
     View* view = engine->createView();
     SwapChain* swapChain = engine->createSwapChain(metalLayer);
 
+    // 资源内存账本：设置 DEMO_MEMORY_REPORT=5 时每 5 秒打印一次各资源的字节数、Engine 对象数量和 RSS
+    demo::MemoryLedger memory;
+
+    // 设置 DEMO_PACK=demo.pack 时从资源包读取网格和纹理（由 demo-pack 生成），否则读取单独的文件
+    demo::PackFile pack;
+    pack.openFromEnvironment();
+
+    // 先把纹理请求交给工作线程，读取文件与下面的网格加载、材质构建同时进行。
+    // 资源包中有该文件时直接上传映射内存（映射在engine销毁后才释放）
+    demo::TextureUploader textures(*engine, 1);
+    const demo::PackView texturePixels = pack.find("rgba8_200x200.rgba");
+    const demo::TextureFuture textureFuture = texturePixels
+        ? textures.uploadRGBA(texturePixels.data, texturePixels.size, 200, 200)
+        : textures.loadRGBA(std::string(DEMO_ASSET_ROOT) + "/rgba8_200x200.rgba", 200, 200);
+
     // ========================================
     // 第三步：加载cube.filamesh模型
     // ========================================
     std::string filameshPath = "/tmp/cube.filamesh";
-    
-    // 读取filamesh文件
-    std::ifstream filameshFile(filameshPath, std::ios::binary);
-    if (!filameshFile.is_open()) {
-        std::cerr << "Failed to open filamesh file: " << filameshPath << std::endl;
-        engine->destroy(engine);
-        SDL_Metal_DestroyView(metalView);
-        SDL_DestroyRenderer(sdlRenderer);
-        SDL_DestroyWindow(window);
-        SDL_Quit();
-        return 1;
+    if (!pack.find("cube.filamesh") && !std::ifstream(filameshPath)) {
+        // 没有预先用 filamesh 工具转换时直接导入 cube.obj，之后使用源文件旁边缓存的 filamesh
+        filameshPath = demo::resolveMeshPath(std::string(DEMO_ASSET_ROOT) + "/assets/models/cube/cube.obj");
     }
 
-    // 读取文件内容
-    std::string filameshContent((std::istreambuf_iterator<char>(filameshFile)),
-                                std::istreambuf_iterator<char>());
-    filameshFile.close();
-
-    // 使用MeshReader加载模型
-    MeshReader::Mesh mesh = MeshReader::loadMeshFromBuffer(engine, 
-        filameshContent.c_str(), nullptr, nullptr, nullptr);
+    // 映射filamesh文件并交给MeshReader，GPU上传完成后自动解除映射，不再整文件拷贝到内存；
+    // 资源包中有cube.filamesh时直接使用包内数据
+    demo::MappedMesh mapped = pack.find("cube.filamesh")
+        ? demo::loadMappedMesh(*engine, pack, "cube.filamesh", nullptr)
+        : demo::loadMappedMesh(*engine, filameshPath, nullptr);
+    MeshReader::Mesh mesh = mapped.mesh;
 
-    if (!mesh.renderable) {
-        std::cerr << "Failed to load mesh from filamesh file" << std::endl;
+    if (!mapped.isValid()) {
         engine->destroy(engine);
         SDL_Metal_DestroyView(metalView);
         SDL_DestroyRenderer(sdlRenderer);
@@ -138,42 +161,36 @@ int main() {
     }
 
     std::cout << "Successfully loaded cube.filamesh model" << std::endl;
+    memory.addVertexBuffer("cube.filamesh", mesh.vertexBuffer, mapped.vertexBytes);
+    memory.addIndexBuffer("cube.filamesh", mesh.indexBuffer, mapped.indexType);
 
     // ========================================
     // 第四步：创建材质
     // ========================================
-    Material* material = Material::Builder()
-        .package(RESOURCES_BAKEDTEXTURE_DATA, RESOURCES_BAKEDTEXTURE_SIZE)
-        .build(*engine);
+    TRACE_NAME_BEGIN("Material::build");
+    Material* material = nullptr;
+    {
+        // 材质包只需要保持到 build()，之后租约的缓冲区还给资源包的池
+        const demo::BundleLease package = ACQUIRE_RESOURCE(RESOURCES, BAKEDTEXTURE);
+        material = Material::Builder()
+            .package(package.data(), package.size())
+            .build(*engine);
+    }
+    TRACE_NAME_END();
+    memory.addMaterial("bakedtexture", material, RESOURCES_BAKEDTEXTURE_SIZE);
 
     MaterialInstance* materialInstance = material->getDefaultInstance();
 
     // ========================================
     // 第五步：加载纹理
     // ========================================
-    Texture* texture = nullptr;
-    std::string texturePath = "/Users/jason/Jason/opengl/LearnFilament/macos-demo/rgba8_200x200.rgba";
-    
-    std::ifstream textureFile(texturePath, std::ios::binary);
-    if (textureFile.is_open()) {
-        std::vector<uint8_t> textureData(200 * 200 * 4);
-        textureFile.read(reinterpret_cast<char*>(textureData.data()), textureData.size());
-        textureFile.close();
-
-        texture = Texture::Builder()
-            .width(200)
-            .height(200)
-            .levels(1)
-            .format(Texture::InternalFormat::RGBA8)
-            .build(*engine);
+    // 纹理在第二步之后已经交给工作线程读取，这里取回结果；像素缓冲区在上传完成后由回调还给暂存池
+    TRACE_NAME_BEGIN("loadRGBATexture");
+    Texture* texture = textures.wait(textureFuture);
+    TRACE_NAME_END();
 
-        Texture::PixelBufferDescriptor buffer(
-            textureData.data(),
-            textureData.size(),
-            Texture::Format::RGBA,
-            Texture::Type::UBYTE
-        );
-        texture->setImage(*engine, 0, std::move(buffer));
+    if (texture) {
+        memory.addTexture("rgba8_200x200", texture);
 
         // 设置纹理到材质
         TextureSampler sampler(TextureSampler::MinFilter::LINEAR, TextureSampler::MagFilter::LINEAR);
@@ -225,21 +242,35 @@ int main() {
     // ========================================
     // 第九步：主渲染循环
     // ========================================
+    // 帧耗时遥测：退出时打印 p50/p90/p99/max 和卡顿次数，运行中可以用 kill -USR1 <pid> 打印
+    demo::FrameTelemetry::installSignalHandler();
+    demo::FrameTelemetry telemetry("02-cube-obj");
+    // DEMO_RECORD=run.rec 录制输入和动画，DEMO_REPLAY=run.rec 逐帧回放
+    demo::ReplayLog replay;
+
     bool running = true;
     auto startTime = std::chrono::high_resolution_clock::now();
     
     while (running) {
+        telemetry.beginFrame();
+        if (!replay.beginFrame(*engine)) {
+            break;  // 回放结束
+        }
+
+        TRACE_NAME_BEGIN("SDL_PollEvent");
         SDL_Event event;
-        while (SDL_PollEvent(&event)) {
+        while (replay.pollEvent(&event, SDL_PollEvent)) {
             if (event.type == SDL_EVENT_QUIT) {
                 running = false;
             }
         }
+        TRACE_NAME_END();
 
+        TRACE_NAME_BEGIN("update");
         // 计算动画时间
         auto now = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime);
-        float time = duration.count() / 1000.0f;
+        float time = replay.frameTime(duration.count() / 1000.0f);
 
         // 应用旋转变换
         auto& tcm = engine->getTransformManager();
@@ -256,19 +287,30 @@ int main() {
             verticalRotation = ((rotationTime - 8.0f) / 8.0f) * 2.0f * M_PI;
         }
         
-        tcm.setTransform(tcm.getInstance(mesh.renderable), 
+        replay.setTransform(tcm, mesh.renderable, 
             mat4f::rotation(horizontalRotation, float3{ 0, 1, 0 }) * 
             mat4f::rotation(verticalRotation, float3{ 1, 0, 0 }));
 
+        TRACE_NAME_END();
+
         // 执行渲染
-        if (renderer->beginFrame(swapChain)) {
+        TRACE_NAME_BEGIN("Renderer::beginFrame");
+        const bool frameReady = renderer->beginFrame(swapChain);
+        TRACE_NAME_END();
+        if (frameReady) {
             renderer->setClearOptions({
                 .clearColor = {0.1f, 0.1f, 0.2f, 1.0f},
                 .clear = true
             });
+            TRACE_NAME_BEGIN("Renderer::render");
             renderer->render(view);
+            TRACE_NAME_END();
+            TRACE_NAME_BEGIN("Renderer::endFrame");
             renderer->endFrame();
+            TRACE_NAME_END();
         }
+        telemetry.endFrame(*renderer);
+        memory.tick(*engine);
     }
 
     // ========================================
@@ -23,6 +23,11 @@
 #include <chrono>
 #include <iostream>
 
+#include "../common/FrameTelemetry.h"
+#include "../common/MemoryLedger.h"
+#include "../common/ReplayLog.h"
+#include "../common/Trace.h"
+
 using namespace filament;
 using utils::Entity;
 
@@ -102,6 +107,9 @@ static const filament::math::short4 MORPH_TANGENTS[3] = {
 static constexpr uint16_t TRIANGLE_INDICES[3] = { 0, 1, 2 };
 
 int main() {
+    // 设置环境变量 DEMO_TRACE=trace.json 时记录 Chrome trace，退出时写出文件
+    demo::TraceSession traceSession;
+
     // ========================================
     // 第一步：初始化 SDL 和创建窗口
     // ========================================
@@ -158,7 +166,9 @@ int main() {
     // ========================================
     // 创建 Filament 引擎，这是所有 Filament 功能的核心
     // backend::Backend::METAL 指定使用 Metal 图形 API（macOS 专用）
+    TRACE_NAME_BEGIN("Engine::create");
     Engine* engine = Engine::create(backend::Backend::METAL);
+    TRACE_NAME_END();
     if (!engine) {
         std::cerr << "Failed to create Filament engine" << std::endl;
         SDL_Metal_DestroyView(metalView);
@@ -203,6 +213,9 @@ int main() {
     Camera* cam = engine->createCamera(camera);
     view->setCamera(cam);  // 将相机绑定到视图
 
+    // 资源内存账本：设置 DEMO_MEMORY_REPORT=5 时每 5 秒打印一次各资源的字节数、Engine 对象数量和 RSS
+    demo::MemoryLedger memory;
+
     // ========================================
     // 第四步：创建几何体数据（顶点和索引缓冲区）
     // ========================================
@@ -228,6 +241,8 @@ int main() {
     
     // 将索引数据上传到GPU
     ib->setBuffer(*engine, IndexBuffer::BufferDescriptor(TRIANGLE_INDICES, 6, nullptr));
+    memory.addVertexBuffer("triangle", vb, 36);
+    memory.addIndexBuffer("triangle", ib, IndexBuffer::IndexType::USHORT);
 
     // ========================================
     // 第五步：创建变形目标缓冲区
@@ -246,15 +261,19 @@ int main() {
     // 设置第二个变形目标的位置数据
     morphTargetBuffer->setPositionsAt(*engine, 1, MORPH_TARGET_2, 3, 0);
     morphTargetBuffer->setTangentsAt(*engine, 1, MORPH_TANGENTS, 3, 0);
+    memory.addMorphTargetBuffer("triangle", morphTargetBuffer);
 
     // ========================================
     // 第六步：创建材质和可渲染实体
     // ========================================
     // 材质（Material）定义物体的外观，包括颜色、纹理、光照等
     // 这里使用预编译的材质包，包含着色器代码和材质参数
+    TRACE_NAME_BEGIN("Material::build");
     Material* material = Material::Builder()
         .package((void*)BAKED_COLOR_PACKAGE, sizeof(BAKED_COLOR_PACKAGE))
         .build(*engine);
+    TRACE_NAME_END();
+    memory.addMaterial("bakedcolor", material, sizeof(BAKED_COLOR_PACKAGE));
 
     // 创建可渲染实体（Renderable），这是 Filament 渲染的核心概念
     // 它将几何体（顶点+索引）和材质组合成一个可渲染的对象
@@ -292,22 +311,36 @@ int main() {
     // ========================================
     // 第八步：主渲染循环
     // ========================================
+    // 帧耗时遥测：退出时打印 p50/p90/p99/max 和卡顿次数，运行中可以用 kill -USR1 <pid> 打印
+    demo::FrameTelemetry::installSignalHandler();
+    demo::FrameTelemetry telemetry("03-morphing");
+    // DEMO_RECORD=run.rec 录制输入和动画，DEMO_REPLAY=run.rec 逐帧回放
+    demo::ReplayLog replay;
+
     bool running = true;
     auto startTime = std::chrono::high_resolution_clock::now();  // 记录开始时间，用于动画
     
     while (running) {
+        telemetry.beginFrame();
+        if (!replay.beginFrame(*engine)) {
+            break;  // 回放结束
+        }
+
         // 处理用户输入事件（如关闭窗口）
+        TRACE_NAME_BEGIN("SDL_PollEvent");
         SDL_Event event;
-        while (SDL_PollEvent(&event)) {
+        while (replay.pollEvent(&event, SDL_PollEvent)) {
             if (event.type == SDL_EVENT_QUIT) {
                 running = false;
             }
         }
+        TRACE_NAME_END();
 
+        TRACE_NAME_BEGIN("update");
         // 计算动画时间，用于变形动画
         auto now = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime);
-        float time = duration.count() / 1000.0f;  // 转换为秒
+        float time = replay.frameTime(duration.count() / 1000.0f);  // 转换为秒
 
         // 计算变形权重，让三角形在两个变形目标之间平滑过渡
         // 使用正弦函数创建循环动画
@@ -316,13 +349,24 @@ int main() {
 
         // 设置变形权重
         auto& rm = engine->getRenderableManager();
-        rm.setMorphWeights(rm.getInstance(renderable), weights, 2, 0);
+        replay.setMorphWeights(rm, renderable, weights, 2, 0);
+
+        TRACE_NAME_END();
 
         // 执行渲染
-        if (renderer->beginFrame(swapChain)) {  // 开始渲染帧
+        TRACE_NAME_BEGIN("Renderer::beginFrame");
+        const bool frameReady = renderer->beginFrame(swapChain);  // 开始渲染帧
+        TRACE_NAME_END();
+        if (frameReady) {
+            TRACE_NAME_BEGIN("Renderer::render");
             renderer->render(view);              // 渲染视图
+            TRACE_NAME_END();
+            TRACE_NAME_BEGIN("Renderer::endFrame");
             renderer->endFrame();                // 结束渲染帧
+            TRACE_NAME_END();
         }
+        telemetry.endFrame(*renderer);
+        memory.tick(*engine);
     }
 
     // ========================================
@@ -11,6 +11,8 @@
 #include <filament/SwapChain.h>
 #include <filament/Viewport.h>
 #include <filament/LightManager.h>
+#include <filament/Texture.h>
+#include <filament/TextureSampler.h>
 
 #include <utils/EntityManager.h>
 
@@ -21,11 +23,17 @@
 
 #include <cmath>
 #include <chrono>
+#include <memory>
 #include <iostream>
 
+#include "../common/FrameTelemetry.h"
+#include "../common/MemoryLedger.h"
+#include "../common/ReplayLog.h"
+#include "../common/TextureUploader.h"
+#include "../common/Trace.h"
+
 // 包含原始的资源文件
-#include "../generated/resources/resources.h"
-#include "../generated/resources/monkey.h"
+#include "../common/EmbeddedResources.h"
 
 using namespace filament;
 using namespace filamesh;
@@ -33,6 +41,9 @@ using namespace filament::math;
 using utils::Entity;
 
 int main() {
+    // 设置环境变量 DEMO_TRACE=trace.json 时记录 Chrome trace，退出时写出文件
+    demo::TraceSession traceSession;
+
     // ========================================
     // 第一步：初始化 SDL 和创建窗口
     // ========================================
@@ -89,7 +100,9 @@ int main() {
     // ========================================
     // 创建 Filament 引擎，这是所有 Filament 功能的核心
     // backend::Backend::METAL 指定使用 Metal 图形 API（macOS 专用）
+    TRACE_NAME_BEGIN("Engine::create");
     Engine* engine = Engine::create(backend::Backend::METAL);
+    TRACE_NAME_END();
     if (!engine) {
         std::cerr << "Failed to create Filament engine" << std::endl;
         SDL_Metal_DestroyView(metalView);
@@ -134,30 +147,67 @@ int main() {
     Camera* cam = engine->createCamera(camera);
     view->setCamera(cam);  // 将相机绑定到视图
 
+    // 资源内存账本：设置 DEMO_MEMORY_REPORT=5 时每 5 秒打印一次各资源的字节数、Engine 对象数量和 RSS
+    demo::MemoryLedger memory;
+
     // ========================================
     // 第四步：加载猴头模型
     // ========================================
+    // 贴图先交给工作线程：albedo/roughness/metallic/ao 是 KTX2（Basis），转码成 GPU 支持的压缩格式，
+    // normal 是 PNG，解码后生成 mip 链。转码与下面的模型加载、材质构建同时进行，
+    // 渲染循环中每帧 pump() 一次，贴图就绪后替换占位纹理，启动不再等待解码
+    // 有 KTX2 请求时 uploader 必须先于 engine 销毁，所以放在堆上，清理时先释放
+    std::unique_ptr<demo::TextureUploader> textures(new demo::TextureUploader(*engine));
+    TRACE_NAME_BEGIN("TextureUploader::loadKtx2");
+    const demo::TextureFuture albedoFuture = textures->loadKtx2(
+            ACQUIRE_RESOURCE(MONKEY, ALBEDO).data(), MONKEY_ALBEDO_SIZE, true);
+    const demo::TextureFuture roughnessFuture = textures->loadKtx2(
+            ACQUIRE_RESOURCE(MONKEY, ROUGHNESS).data(), MONKEY_ROUGHNESS_SIZE, false);
+    const demo::TextureFuture metallicFuture = textures->loadKtx2(
+            ACQUIRE_RESOURCE(MONKEY, METALLIC).data(), MONKEY_METALLIC_SIZE, false);
+    const demo::TextureFuture aoFuture = textures->loadKtx2(
+            ACQUIRE_RESOURCE(MONKEY, AO).data(), MONKEY_AO_SIZE, false);
+    TRACE_NAME_END();
+    // PNG 在解码完成之前必须有效，MONKEY_NORMAL_DATA 在整个进程内有效
+    const demo::TextureFuture normalFuture = textures->decodeImage(MONKEY_NORMAL_DATA, MONKEY_NORMAL_SIZE, false);
+
     // 使用原始的猴头模型数据，这是 Filament 示例中使用的标准模型
+    TRACE_NAME_BEGIN("MeshReader::loadMeshFromBuffer");
     MeshReader::Mesh mesh = MeshReader::loadMeshFromBuffer(engine, MONKEY_SUZANNE_DATA, nullptr, nullptr, nullptr);
+    TRACE_NAME_END();
+    memory.addFilamesh("monkey", MONKEY_SUZANNE_DATA, mesh.vertexBuffer, mesh.indexBuffer);
 
     // ========================================
     // 第五步：创建PBR材质
     // ========================================
-    // 使用原始的PBR材质，这是 Filament 示例中使用的标准材质
-    Material* material = Material::Builder()
-        .package(RESOURCES_AIDEFAULTMAT_DATA, RESOURCES_AIDEFAULTMAT_SIZE)
-        .build(*engine);
+    // TEXTUREDLIT 从 albedo/roughness/metallic/normal/ao 五张贴图读取PBR参数
+    TRACE_NAME_BEGIN("Material::build");
+    Material* material = nullptr;
+    {
+        // 材质包只需要保持到 build()，之后租约的缓冲区还给资源包的池
+        const demo::BundleLease package = ACQUIRE_RESOURCE(RESOURCES, TEXTUREDLIT);
+        material = Material::Builder()
+            .package(package.data(), package.size())
+            .build(*engine);
+    }
+    TRACE_NAME_END();
+    memory.addMaterial("texturedlit", material, RESOURCES_TEXTUREDLIT_SIZE);
 
-    // 创建材质实例并设置PBR参数
+    // 创建材质实例，先绑定 1x1 占位纹理（灰色、中等粗糙度的非金属，平坦法线），贴图就绪后逐张替换
     MaterialInstance* materialInstance = material->createInstance();
-    // 设置基础颜色（线性RGB空间）
-    materialInstance->setParameter("baseColor", RgbType::LINEAR, float3{0.8f});
-    // 设置金属度（0.0 = 非金属，1.0 = 金属）
-    materialInstance->setParameter("metallic", 1.0f);
-    // 设置粗糙度（0.0 = 完全光滑，1.0 = 完全粗糙）
-    materialInstance->setParameter("roughness", 0.4f);
-    // 设置反射率（控制菲涅尔反射的强度）
-    materialInstance->setParameter("reflectance", 0.5f);
+    materialInstance->setParameter("clearCoat", 0.0f);
+    TextureSampler sampler(TextureSampler::MinFilter::LINEAR_MIPMAP_LINEAR, TextureSampler::MagFilter::LINEAR);
+    demo::TextureBindings textureBindings;
+    textureBindings.add(materialInstance, "albedo", albedoFuture,
+            demo::createSolidTexture(*engine, 204, 204, 204, 255, true), sampler);
+    textureBindings.add(materialInstance, "roughness", roughnessFuture,
+            demo::createSolidTexture(*engine, 128, 128, 128, 255, false), sampler);
+    textureBindings.add(materialInstance, "metallic", metallicFuture,
+            demo::createSolidTexture(*engine, 0, 0, 0, 255, false), sampler);
+    textureBindings.add(materialInstance, "ao", aoFuture,
+            demo::createSolidTexture(*engine, 255, 255, 255, 255, false), sampler);
+    textureBindings.add(materialInstance, "normal", normalFuture,
+            demo::createSolidTexture(*engine, 128, 128, 255, 255, false), sampler);
 
     // ========================================
     // 第六步：设置猴头模型的材质和变换
@@ -219,33 +269,62 @@ int main() {
     // ========================================
     // 第九步：主渲染循环
     // ========================================
+    // 帧耗时遥测：退出时打印 p50/p90/p99/max 和卡顿次数，运行中可以用 kill -USR1 <pid> 打印
+    demo::FrameTelemetry::installSignalHandler();
+    demo::FrameTelemetry telemetry("04-pbr");
+    // DEMO_RECORD=run.rec 录制输入和动画，DEMO_REPLAY=run.rec 逐帧回放
+    demo::ReplayLog replay;
+
     bool running = true;
     auto startTime = std::chrono::high_resolution_clock::now();  // 记录开始时间，用于动画
     
     while (running) {
+        telemetry.beginFrame();
+        if (!replay.beginFrame(*engine)) {
+            break;  // 回放结束
+        }
+
         // 处理用户输入事件（如关闭窗口）
+        TRACE_NAME_BEGIN("SDL_PollEvent");
         SDL_Event event;
-        while (SDL_PollEvent(&event)) {
+        while (replay.pollEvent(&event, SDL_PollEvent)) {
             if (event.type == SDL_EVENT_QUIT) {
                 running = false;
             }
         }
+        TRACE_NAME_END();
+
+        TRACE_NAME_BEGIN("update");
+        // 上传转码完成的 mip 层级，把已经就绪的贴图绑定到材质
+        textures->pump();
+        textureBindings.update(*engine, &memory);
 
         // 计算动画时间，用于旋转动画
         auto now = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime);
-        float time = duration.count() / 1000.0f;  // 转换为秒
+        float time = replay.frameTime(duration.count() / 1000.0f);  // 转换为秒
 
         // 应用旋转变换，让猴头模型绕Y轴旋转
         auto& tcm = engine->getTransformManager();  // 获取变换管理器
-        auto ti = tcm.getInstance(mesh.renderable);  // 获取猴头模型的变换实例
-        tcm.setTransform(ti, transform * mat4f::rotation(time, float3{ 0, 1, 0 }));  // 绕Y轴旋转
+        replay.setTransform(tcm, mesh.renderable,
+                transform * mat4f::rotation(time, float3{ 0, 1, 0 }));  // 绕Y轴旋转
+
+        TRACE_NAME_END();
 
         // 执行渲染
-        if (renderer->beginFrame(swapChain)) {  // 开始渲染帧
+        TRACE_NAME_BEGIN("Renderer::beginFrame");
+        const bool frameReady = renderer->beginFrame(swapChain);  // 开始渲染帧
+        TRACE_NAME_END();
+        if (frameReady) {
+            TRACE_NAME_BEGIN("Renderer::render");
             renderer->render(view);              // 渲染视图
+            TRACE_NAME_END();
+            TRACE_NAME_BEGIN("Renderer::endFrame");
             renderer->endFrame();                // 结束渲染帧
+            TRACE_NAME_END();
         }
+        telemetry.endFrame(*renderer);
+        memory.tick(*engine);
     }
 
     // ========================================
@@ -258,6 +337,8 @@ int main() {
     utils::EntityManager::get().destroy(light);  // 销毁光源实体ID
     engine->destroy(materialInstance);  // 销毁材质实例
     engine->destroy(material);    // 销毁材质
+    textures.reset();             // 销毁还在转码的纹理，之后不再有新的纹理兑现
+    textureBindings.destroy(*engine, &memory);  // 销毁贴图和占位纹理
     engine->destroy(skybox);      // 销毁天空盒
     engine->destroyCameraComponent(camera);  // 销毁相机组件
     utils::EntityManager::get().destroy(camera);  // 销毁相机实体ID
@@ -0,0 +1,383 @@
+// ========================================
+// demo-automation：渲染设置组合的帧耗时矩阵
+// ========================================
+// 用 viewer 的 AutomationEngine 以批处理模式跑一份 AutomationSpec：
+// 在无窗口环境下加载一个 glTF 模型，逐个应用 spec 展开后的设置组合
+// （MSAA、SSAO、bloom、TAA、动态分辨率、阴影类型等 filament/Options.h 中的选项），
+// 每个组合渲染固定帧数并记录 CPU 帧耗时，最后输出一行一个组合的 CSV，
+// 用来找出哪些后处理选项在 CPU 侧最贵。
+//
+// 用法：
+//   demo-automation [--model models/FlightHelmet/FlightHelmet.gltf] [--spec automation.json]
+//                   [--default-spec] [--warmup 5] [--frames 30]
+//                   [--backend noop|opengl|vulkan|metal]
+//                   [--width 800] [--height 600] [--assets macos-demo]
+//                   [--output automation.csv]
+// 不指定 --spec 时使用内置的 spec；--default-spec 使用 viewer 自带的默认测试序列。
+// spec 的格式见 filament 的 viewer/schemas/automation.json。
+// NOOP 后端只测得到 Filament 自身的 CPU 开销（剔除、命令生成、FrameGraph），
+// 驱动和 GPU 的开销需要在真实后端上测量。
+
+#include "../common/DemoScene.h"
+#include "../common/GltfLoader.h"
+#include "../common/Stats.h"
+#include "../common/Trace.h"
+
+#include <filament/Camera.h>
+#include <filament/LightManager.h>
+#include <filament/Renderer.h>
+#include <filament/Scene.h>
+#include <filament/View.h>
+
+#include <gltfio/FilamentAsset.h>
+#include <gltfio/FilamentInstance.h>
+
+#include <utils/EntityManager.h>
+
+#include <viewer/AutomationEngine.h>
+#include <viewer/AutomationSpec.h>
+#include <viewer/Settings.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace demo;
+using namespace filament;
+using namespace filament::math;
+using namespace filament::viewer;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 内置 spec：后处理关闭时的基准，加上 MSAA/SSAO/bloom/TAA/动态分辨率开关
+// 与四种阴影类型的全部组合（2^5 x 4 = 128 个）
+const char* const DEFAULT_SPEC = R"JSON([
+    {
+        "name": "ppoff",
+        "base": {
+            "view.postProcessingEnabled": false
+        }
+    },
+    {
+        "name": "matrix",
+        "base": {
+            "view.postProcessingEnabled": true,
+            "view.dithering": "NONE",
+            "view.antiAliasing": "NONE"
+        },
+        "permute": {
+            "view.msaa.enabled": [false, true],
+            "view.ssao.enabled": [false, true],
+            "view.bloom.enabled": [false, true],
+            "view.taa.enabled": [false, true],
+            "view.dsr.enabled": [false, true],
+            "view.shadowType": ["PCF", "VSM", "DPCF", "PCSS"]
+        }
+    }
+])JSON";
+
+struct Options {
+    SceneContext params;
+    Engine::Backend backend = Engine::Backend::NOOP;
+    std::string backendName = "noop";
+    std::string model = "models/FlightHelmet/FlightHelmet.gltf";
+    uint32_t warmupFrames = 5;
+    uint32_t measuredFrames = 30;
+};
+
+// 一个设置组合的测量结果
+struct CaseResult {
+    std::string name;
+    ViewSettings view;
+    std::vector<double> frameMs;
+    uint32_t skippedFrames = 0;
+};
+
+const char* getShadowTypeName(View::ShadowType type) {
+    switch (type) {
+        case View::ShadowType::PCF:  return "PCF";
+        case View::ShadowType::VSM:  return "VSM";
+        case View::ShadowType::DPCF: return "DPCF";
+        case View::ShadowType::PCSS: return "PCSS";
+        case View::ShadowType::PCFd: return "PCFd";
+    }
+    return "unknown";
+}
+
+// 渲染一帧，返回 CPU 耗时（毫秒），beginFrame() 返回 false 时返回负数
+double renderFrame(SceneContext& ctx) {
+    TRACE_NAME("frame");
+    const auto start = Clock::now();
+    if (!ctx.renderer->beginFrame(ctx.swapChain)) {
+        return -1.0;
+    }
+    ctx.renderer->render(ctx.view);
+    ctx.renderer->endFrame();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 以批处理模式跑完整个 spec，每个组合的帧耗时放进 results[currentTest]
+bool runSpec(SceneContext& ctx, const AutomationSpec& spec, gltfio::FilamentAsset& asset,
+        utils::Entity sun, const Options& options, std::vector<CaseResult>& results) {
+    Settings settings;
+    AutomationEngine automation(&spec, &settings);
+
+    AutomationEngine::Options automationOptions;
+    // 不按时间等待，只按帧数推进：每个组合渲染 warmup + frames 帧
+    automationOptions.sleepDuration = 0.0f;
+    automationOptions.minFrameCount = int(options.warmupFrames + options.measuredFrames);
+    automationOptions.verbose = false;
+    automation.setOptions(automationOptions);
+
+    gltfio::FilamentInstance* instance = asset.getInstance();
+    AutomationEngine::ViewerContent content = {};
+    content.view = ctx.view;
+    content.renderer = ctx.renderer;
+    content.materials = instance->getMaterialInstances();
+    content.materialCount = instance->getMaterialInstanceCount();
+    content.lightManager = &ctx.engine->getLightManager();
+    content.scene = ctx.scene;
+    content.indirectLight = nullptr;
+    content.sunlight = sun;
+    content.assetLights = const_cast<utils::Entity*>(asset.getLightEntities());
+    content.assetLightCount = asset.getLightEntityCount();
+
+    results.resize(spec.size());
+    for (size_t i = 0; i < spec.size(); i++) {
+        results[i].name = spec.getName(i);
+        Settings caseSettings;
+        spec.get(i, &caseSettings);
+        results[i].view = caseSettings.view;
+    }
+
+    // 模型已经加载完成，可以直接开始
+    automation.startBatchMode();
+    automation.signalBatchMode();
+
+    // 组合切换时 tick() 会应用新的设置，下一帧起属于新的组合。
+    // 每个组合前 warmup 帧（TAA/动态分辨率的历史、阴影贴图重建）不计入统计。
+    const float deltaTime = 1.0f / 60.0f;
+    size_t framesInCase = 0;
+    size_t lastTest = SIZE_MAX;
+    const size_t maxFrames = (spec.size() + 1) * size_t(automationOptions.minFrameCount + 2);
+    for (size_t frame = 0; frame < maxFrames && !automation.shouldClose(); frame++) {
+        automation.tick(ctx.engine, content, deltaTime);
+        if (!automation.isRunning()) {
+            continue;
+        }
+        ctx.view->setColorGrading(automation.getColorGrading(ctx.engine));
+
+        const size_t test = automation.currentTest();
+        if (test != lastTest) {
+            lastTest = test;
+            framesInCase = 0;
+        }
+        const double ms = renderFrame(ctx);
+        if (framesInCase++ < options.warmupFrames) {
+            continue;
+        }
+        if (ms < 0.0) {
+            results[test].skippedFrames++;
+        } else {
+            results[test].frameMs.push_back(ms);
+        }
+    }
+    ctx.engine->flushAndWait();
+    ctx.view->setColorGrading(nullptr);
+
+    if (!automation.shouldClose()) {
+        std::cerr << "Automation did not finish: " << automation.getStatusMessage() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void writeCsv(std::ostream& out, const std::vector<CaseResult>& results) {
+    out << "index,name,postProcessing,antiAliasing,msaa,ssao,bloom,taa,dsr,shadowType,"
+           "frames,skipped,meanMs,p50Ms,p90Ms,p99Ms,maxMs,relativeToFirst\n";
+    const double baseline = results.empty() ? 0.0 : computeStats(results[0].frameMs).mean;
+    out << std::fixed << std::setprecision(4);
+    for (size_t i = 0; i < results.size(); i++) {
+        const CaseResult& result = results[i];
+        const ViewSettings& view = result.view;
+        const SampleStats stats = computeStats(result.frameMs);
+        out << i << ',' << result.name << ','
+            << view.postProcessingEnabled << ','
+            << (view.antiAliasing == View::AntiAliasing::FXAA ? "FXAA" : "NONE") << ','
+            << (view.msaa.enabled ? int(view.msaa.sampleCount) : 0) << ','
+            << view.ssao.enabled << ','
+            << view.bloom.enabled << ','
+            << view.taa.enabled << ','
+            << view.dsr.enabled << ','
+            << getShadowTypeName(view.shadowType) << ','
+            << stats.count << ',' << result.skippedFrames << ','
+            << stats.mean << ',' << stats.p50 << ',' << stats.p90 << ','
+            << stats.p99 << ',' << stats.max << ','
+            << (baseline > 0.0 ? stats.mean / baseline : 0.0) << '\n';
+    }
+}
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options]\n"
+              << "  --model <file>       glTF/glb relative to --assets\n"
+              << "                       (default models/FlightHelmet/FlightHelmet.gltf)\n"
+              << "  --spec <file>        AutomationSpec JSON (default: built-in settings matrix)\n"
+              << "  --default-spec       use the viewer's default test sequence instead\n"
+              << "  --warmup <n>         frames per case rendered before measuring (default 5)\n"
+              << "  --frames <n>         measured frames per case (default 30)\n"
+              << "  --backend <name>     noop, opengl, vulkan or metal (default noop)\n"
+              << "  --width <n>          swapchain width (default 800)\n"
+              << "  --height <n>         swapchain height (default 600)\n"
+              << "  --assets <dir>       macos-demo directory (default macos-demo)\n"
+              << "  --output <file>      write CSV to file instead of stdout\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    TraceSession traceSession;
+    Options options;
+    std::string specFile;
+    bool useViewerDefault = false;
+    std::string outputPath;
+
+    // ========================================
+    // 第一步：解析命令行参数
+    // ========================================
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--model") && hasValue) {
+            options.model = argv[++i];
+        } else if (!strcmp(arg, "--spec") && hasValue) {
+            specFile = argv[++i];
+        } else if (!strcmp(arg, "--default-spec")) {
+            useViewerDefault = true;
+        } else if (!strcmp(arg, "--warmup") && hasValue) {
+            options.warmupFrames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--frames") && hasValue) {
+            options.measuredFrames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--backend") && hasValue && parseBackend(argv[i + 1], options.backend)) {
+            options.backendName = argv[++i];
+        } else if (!strcmp(arg, "--width") && hasValue) {
+            options.params.width = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--height") && hasValue) {
+            options.params.height = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--assets") && hasValue) {
+            options.params.assetRoot = argv[++i];
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+
+    if (options.measuredFrames == 0) {
+        std::cerr << "--frames must be positive" << std::endl;
+        return 1;
+    }
+
+    // ========================================
+    // 第二步：生成设置组合
+    // ========================================
+    std::unique_ptr<AutomationSpec> spec;
+    if (useViewerDefault) {
+        spec.reset(AutomationSpec::generateDefaultTestCases());
+    } else if (specFile.empty()) {
+        spec.reset(AutomationSpec::generate(DEFAULT_SPEC, strlen(DEFAULT_SPEC)));
+    } else {
+        std::ifstream in(specFile);
+        if (!in.is_open()) {
+            std::cerr << "Failed to open spec: " << specFile << std::endl;
+            return 1;
+        }
+        const std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        spec.reset(AutomationSpec::generate(json.c_str(), json.size()));
+    }
+    if (!spec || spec->size() == 0) {
+        std::cerr << "Invalid or empty automation spec" << std::endl;
+        return 1;
+    }
+
+    // ========================================
+    // 第三步：加载模型并逐个组合渲染
+    // ========================================
+    SceneContext ctx = options.params;
+    if (!createHeadlessContext(ctx, nullptr, options.backend)) {
+        return 1;
+    }
+
+    bool ok = false;
+    std::vector<CaseResult> results;
+    {
+        // GltfLoader 必须在 Engine 之前销毁
+        GltfLoader loader(*ctx.engine);
+        gltfio::FilamentAsset* asset = loader.load(ctx.assetRoot + "/" + options.model);
+        ctx.engine->flushAndWait();
+        if (asset) {
+            ctx.scene->addEntities(asset->getEntities(), asset->getEntityCount());
+
+            // AutomationEngine 会按 lighting 设置打开/关闭这个方向光
+            utils::Entity sun = utils::EntityManager::get().create();
+            LightManager::Builder(LightManager::Type::SUN)
+                .color(Color::toLinear<ACCURATE>(sRGBColor(0.98f, 0.92f, 0.89f)))
+                .intensity(110000.0f)
+                .direction({ 0.6f, -1.0f, -0.8f })
+                .castShadows(true)
+                .build(*ctx.engine, sun);
+            ctx.scene->addEntity(sun);
+
+            // 相机从斜上方看向整个模型
+            const Aabb bounds = asset->getBoundingBox();
+            const float radius = std::max(length(bounds.extent()), 1e-3f);
+            const double aspect = double(ctx.width) / double(ctx.height);
+            ctx.camera->setProjection(45.0, aspect, 0.01 * radius, 100.0 * radius);
+            ctx.camera->lookAt(bounds.center() + float3{ 0.0f, 0.5f, 2.5f } * radius,
+                    bounds.center(), float3{ 0.0f, 1.0f, 0.0f });
+
+            std::cerr << "Running " << spec->size() << " cases on " << options.model
+                      << " (" << options.backendName << ")..." << std::endl;
+            ok = runSpec(ctx, *spec, *asset, sun, options, results);
+
+            ctx.scene->remove(sun);
+            ctx.engine->destroy(sun);
+            utils::EntityManager::get().destroy(sun);
+            ctx.scene->removeEntities(asset->getEntities(), asset->getEntityCount());
+            loader.destroy(asset);
+        } else {
+            std::cerr << "Failed to load model: " << options.model << std::endl;
+        }
+    }
+    destroyHeadlessContext(ctx);
+
+    if (results.empty()) {
+        return 1;
+    }
+
+    // ========================================
+    // 第四步：输出 CSV
+    // ========================================
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open output file: " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    writeCsv(outputPath.empty() ? std::cout : file, results);
+
+    return ok ? 0 : 1;
+}
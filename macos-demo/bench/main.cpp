@@ -0,0 +1,153 @@
+// ========================================
+// demo-bench：无窗口的场景基准测试工具
+// ========================================
+// 使用 NOOP 后端和离屏 SwapChain 运行 macos-demo 下的各个场景，
+// 不依赖 SDL/Metal，可以在 Linux CI 上运行，结果以 JSON 输出。
+//
+// 用法：
+//   demo-bench [--scene 02-cube] [--frames 300] [--warmup 10]
+//              [--width 800] [--height 600]
+//              [--assets macos-demo] [--filamesh /tmp/cube.filamesh] [--pack demo.pack]
+//              [--output bench.json] [--trace trace.json]
+
+#include "../common/DemoScene.h"
+#include "../common/JsonWriter.h"
+#include "../common/PackFile.h"
+#include "../common/SceneBenchmark.h"
+#include "../common/Trace.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace demo;
+
+static void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options]\n"
+              << "  --scene <name>     run only this scene (may be repeated)\n"
+              << "  --frames <n>       measured frames per scene (default 300)\n"
+              << "  --warmup <n>       warmup frames per scene (default 10)\n"
+              << "  --width <n>        swapchain width (default 800)\n"
+              << "  --height <n>       swapchain height (default 600)\n"
+              << "  --assets <dir>     macos-demo directory (default macos-demo)\n"
+              << "  --filamesh <file>  mesh used by 02-cube-obj, .filamesh or .obj (default /tmp/cube.filamesh)\n"
+              << "  --pack <file>      read textures and meshes from a demo-pack archive\n"
+              << "  --output <file>    write JSON to file instead of stdout\n"
+              << "  --trace <file>     write a Chrome/Perfetto trace (or set DEMO_TRACE)\n"
+              << "  --list             list available scenes\n";
+}
+
+int main(int argc, char** argv) {
+    SceneContext params;
+    BenchmarkOptions options;
+    std::vector<std::string> scenes;
+    std::string outputPath;
+    std::string tracePath;
+    std::string packPath;
+
+    // ========================================
+    // 第一步：解析命令行参数
+    // ========================================
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--scene") && hasValue) {
+            scenes.emplace_back(argv[++i]);
+        } else if (!strcmp(arg, "--frames") && hasValue) {
+            options.frames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--warmup") && hasValue) {
+            options.warmupFrames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--width") && hasValue) {
+            params.width = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--height") && hasValue) {
+            params.height = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--assets") && hasValue) {
+            params.assetRoot = argv[++i];
+        } else if (!strcmp(arg, "--filamesh") && hasValue) {
+            params.filameshPath = argv[++i];
+        } else if (!strcmp(arg, "--pack") && hasValue) {
+            packPath = argv[++i];
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else if (!strcmp(arg, "--trace") && hasValue) {
+            tracePath = argv[++i];
+        } else if (!strcmp(arg, "--list")) {
+            for (const auto& name : getDemoSceneNames()) {
+                std::cout << name << std::endl;
+            }
+            return 0;
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+
+    if (scenes.empty()) {
+        scenes = getDemoSceneNames();
+    }
+    if (tracePath.empty() && std::getenv("DEMO_TRACE")) {
+        tracePath = std::getenv("DEMO_TRACE");
+    }
+    TraceSession traceSession(tracePath);
+
+    // 资源包在所有场景之间共享，比每个场景的 Engine 活得更久
+    PackFile pack;
+    if (!packPath.empty()) {
+        if (!pack.open(packPath)) {
+            return 1;
+        }
+        params.pack = &pack;
+    }
+
+    // ========================================
+    // 第二步：逐个场景运行基准测试
+    // ========================================
+    // 每个场景使用独立的 Engine，避免前一个场景的缓存影响下一个场景
+    std::vector<BenchmarkResult> results;
+    for (const auto& name : scenes) {
+        std::cerr << "Running " << name << "..." << std::endl;
+        TRACE_NAME("runSceneBenchmark");
+        results.push_back(runSceneBenchmark(name, params, nullptr, options));
+        if (!results.back().ok) {
+            std::cerr << "  " << name << ": " << results.back().error << std::endl;
+        }
+    }
+
+    // ========================================
+    // 第三步：输出 JSON
+    // ========================================
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open output file: " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputPath.empty() ? std::cout : file;
+
+    JsonWriter json(out);
+    json.beginObject();
+    json.key("backend").value("noop");
+    json.key("frames").value(options.frames);
+    json.key("warmupFrames").value(options.warmupFrames);
+    json.key("timeStep").value(options.timeStep);
+    json.key("width").value(params.width);
+    json.key("height").value(params.height);
+    json.key("scenes").beginArray();
+    for (const auto& result : results) {
+        writeBenchmarkResult(json, result);
+    }
+    json.endArray();
+    json.endObject();
+    out << std::endl;
+
+    bool allOk = true;
+    for (const auto& result : results) {
+        allOk = allOk && result.ok;
+    }
+    return allOk ? 0 : 1;
+}
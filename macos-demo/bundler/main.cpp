@@ -0,0 +1,284 @@
+// ========================================
+// demo-bundle：把 resgen 生成的内嵌资源转换成压缩资源包
+// ========================================
+// 读取 resgen 的 resources.h（XXX_OFFSET/XXX_SIZE 宏）和 resources.bin，
+// 每个条目单独用 LZ4 压缩，材质包按 filamat 分块去重（格式见 common/ResourceBundle.h），
+// 输出到 --output-dir：
+//
+//   <name>_bundle.bin        压缩资源包
+//   <name>_bundle.h          与 resources.h 同名的 XXX_DATA/XXX_SIZE 宏，XXX_DATA 首次访问时解压
+//   <name>_bundle.S          incbin 资源包（ELF）
+//   <name>_bundle.apple.S    incbin 资源包（Mach-O）
+//
+// CMake 在构建时对 resources 和 monkey 调用本工具（DEMO_COMPRESSED_RESOURCES=ON）。
+//
+// 用法：
+//   demo-bundle --header resources.h --input resources.bin --output-dir <dir>
+//               [--name resources] [--max-ratio 0.95] [--no-split]
+
+#include "../common/ResourceBundle.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace demo;
+
+namespace {
+
+// resources.h 中的一个条目，name 是宏名去掉 _OFFSET/_SIZE 后缀，例如 RESOURCES_AIDEFAULTMAT
+struct ResgenEntry {
+    std::string name;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    bool hasOffset = false;
+    bool hasSize = false;
+};
+
+struct ResgenHeader {
+    std::string prefix;     // 例如 RESOURCES
+    std::vector<ResgenEntry> entries;
+};
+
+bool readFile(const std::string& path, std::string& content) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        return false;
+    }
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool writeText(const std::string& path, const std::string& text) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << text;
+    if (!out) {
+        std::cerr << "Failed to write file: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 解析 resgen 头文件，条目按 offset 排序
+bool parseResgenHeader(const std::string& path, ResgenHeader& header) {
+    std::string text;
+    if (!readFile(path, text)) {
+        return false;
+    }
+
+    std::smatch match;
+    static const std::regex packagePattern(R"(extern\s+const\s+uint8_t\s+(\w+)_PACKAGE\s*\[\])");
+    if (!std::regex_search(text, match, packagePattern)) {
+        std::cerr << "No XXX_PACKAGE declaration in resgen header: " << path << std::endl;
+        return false;
+    }
+    header.prefix = match[1];
+
+    static const std::regex definePattern(R"(#define\s+(\w+)_(OFFSET|SIZE)\s+(\d+))");
+    for (auto it = std::sregex_iterator(text.begin(), text.end(), definePattern);
+            it != std::sregex_iterator(); ++it) {
+        const std::string name = (*it)[1];
+        const uint64_t value = std::strtoull((*it)[3].str().c_str(), nullptr, 10);
+        auto entry = std::find_if(header.entries.begin(), header.entries.end(),
+                [&name](const ResgenEntry& e) { return e.name == name; });
+        if (entry == header.entries.end()) {
+            header.entries.push_back({ name });
+            entry = header.entries.end() - 1;
+        }
+        if ((*it)[2] == "OFFSET") {
+            entry->offset = value;
+            entry->hasOffset = true;
+        } else {
+            entry->size = value;
+            entry->hasSize = true;
+        }
+    }
+
+    for (const auto& entry : header.entries) {
+        if (!entry.hasOffset || !entry.hasSize) {
+            std::cerr << "Incomplete resgen entry: " << entry.name << std::endl;
+            return false;
+        }
+    }
+    if (header.entries.empty()) {
+        std::cerr << "No entries in resgen header: " << path << std::endl;
+        return false;
+    }
+    std::stable_sort(header.entries.begin(), header.entries.end(),
+            [](const ResgenEntry& a, const ResgenEntry& b) { return a.offset < b.offset; });
+    return true;
+}
+
+std::string makeHeader(const ResgenHeader& resgen, const std::string& guard,
+        const std::string& symbol) {
+    std::ostringstream out;
+    out << "#ifndef " << guard << "\n"
+        << "#define " << guard << "\n\n"
+        << "// 由 demo-bundle 生成，不要手动修改\n\n"
+        << "#include <stdint.h>\n\n"
+        << "extern \"C\" {\n"
+        << "    extern const uint8_t " << symbol << "[];\n"
+        << "}\n\n"
+        << "namespace demo {\n"
+        << "const uint8_t* getBundleEntry(const uint8_t* bundle, uint32_t index) noexcept;\n"
+        << "}\n\n";
+    for (size_t i = 0; i < resgen.entries.size(); i++) {
+        const std::string& name = resgen.entries[i].name;
+        out << "#define " << name << "_INDEX " << i << "\n"
+            << "#define " << name << "_SIZE " << resgen.entries[i].size << "\n"
+            << "#define " << name << "_DATA (demo::getBundleEntry(" << symbol << ", "
+            << name << "_INDEX))\n\n";
+    }
+    out << "#endif\n";
+    return out.str();
+}
+
+std::string makeAssembly(const std::string& symbol, const std::string& binName, bool apple) {
+    std::ostringstream out;
+    const std::string label = apple ? "_" + symbol : symbol;
+    out << "    .global " << label << "\n"
+        << (apple ? "    .section __TEXT,__const\n" : "    .section .rodata\n")
+        << "    .p2align 4\n"
+        << label << ":\n"
+        << "    .incbin \"" << binName << "\"\n";
+    if (!apple) {
+        out << "\n    .section .note.GNU-stack,\"\",%progbits\n";
+    }
+    return out.str();
+}
+
+bool verifyBundle(const std::string& path, const ResgenHeader& resgen, const std::string& package) {
+    std::string bundle;
+    if (!readFile(path, bundle)) {
+        return false;
+    }
+    const auto* bytes = reinterpret_cast<const uint8_t*>(bundle.data());
+    for (size_t i = 0; i < resgen.entries.size(); i++) {
+        const ResgenEntry& entry = resgen.entries[i];
+        const BundleLease lease = acquireBundleEntry(bytes, uint32_t(i));
+        if (!lease || lease.size() != entry.size ||
+                std::memcmp(lease.data(), package.data() + entry.offset, entry.size) != 0) {
+            std::cerr << "Round trip failed for " << entry.name << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " --header <resgen.h> --input <resgen.bin> --output-dir <dir>\n"
+              << "  --header <file>      header generated by resgen\n"
+              << "  --input <file>       package generated by resgen\n"
+              << "  --output-dir <dir>   directory for <name>_bundle.{bin,h,S,apple.S}\n"
+              << "  --name <name>        output name (default: header file name without .h)\n"
+              << "  --max-ratio <r>      store entries raw when compressed/original > r (default 0.95)\n"
+              << "  --no-split           do not split filamat packages into shared chunks\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    std::string headerPath;
+    std::string inputPath;
+    std::string outputDir;
+    std::string name;
+    double maxRatio = 0.95;
+    bool splitMaterials = true;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--header") && hasValue) {
+            headerPath = argv[++i];
+        } else if (!strcmp(arg, "--input") && hasValue) {
+            inputPath = argv[++i];
+        } else if (!strcmp(arg, "--output-dir") && hasValue) {
+            outputDir = argv[++i];
+        } else if (!strcmp(arg, "--name") && hasValue) {
+            name = argv[++i];
+        } else if (!strcmp(arg, "--max-ratio") && hasValue) {
+            maxRatio = std::strtod(argv[++i], nullptr);
+        } else if (!strcmp(arg, "--no-split")) {
+            splitMaterials = false;
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+
+    if (headerPath.empty() || inputPath.empty() || outputDir.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (name.empty()) {
+        const size_t slash = headerPath.find_last_of('/');
+        name = headerPath.substr(slash == std::string::npos ? 0 : slash + 1);
+        if (name.size() > 2 && name.compare(name.size() - 2, 2, ".h") == 0) {
+            name.resize(name.size() - 2);
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    ResgenHeader resgen;
+    std::string package;
+    if (!parseResgenHeader(headerPath, resgen) || !readFile(inputPath, package)) {
+        return 1;
+    }
+
+    ResourceBundleWriter writer(maxRatio, splitMaterials);
+    uint64_t totalSize = 0;
+    for (const auto& entry : resgen.entries) {
+        if (entry.offset + entry.size > package.size()) {
+            std::cerr << entry.name << " is outside of " << inputPath << std::endl;
+            return 1;
+        }
+        const auto* data = reinterpret_cast<const uint8_t*>(package.data()) + entry.offset;
+        const auto& info = writer.getEntryInfo(writer.addEntry(data, entry.size));
+        totalSize += entry.size;
+        std::cerr << "  " << entry.name << ": " << entry.size;
+        switch (info.codec) {
+            case BundleCodec::NONE: std::cerr << " (raw)"; break;
+            case BundleCodec::LZ4: std::cerr << " -> " << info.storedSize << " (lz4)"; break;
+            case BundleCodec::CHUNKED:
+                std::cerr << " (" << info.segmentCount << " segments, " << info.sharedSegments
+                          << " shared, " << info.newBytes << " new bytes)";
+                break;
+        }
+        std::cerr << std::endl;
+    }
+    std::string upperName = name;
+    std::transform(upperName.begin(), upperName.end(), upperName.begin(),
+            [](unsigned char c) { return char(std::toupper(c)); });
+    const std::string symbol = resgen.prefix + "_BUNDLE";
+    const std::string base = outputDir + "/" + name + "_bundle";
+    const std::string binName = name + "_bundle.bin";
+    if (!writer.write(base + ".bin") ||
+            !writeText(base + ".h", makeHeader(resgen, upperName + "_BUNDLE_H_", symbol)) ||
+            !writeText(base + ".S", makeAssembly(symbol, binName, false)) ||
+            !writeText(base + ".apple.S", makeAssembly(symbol, binName, true))) {
+        return 1;
+    }
+    // 用运行时的读取路径把写出的资源包完整还原一遍，避免损坏的数据被链接进可执行文件
+    if (!verifyBundle(base + ".bin", resgen, package)) {
+        return 1;
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    std::ifstream written(base + ".bin", std::ios::binary | std::ios::ate);
+    std::cerr << "Bundled " << resgen.entries.size() << " entries (" << writer.getSegmentCount()
+              << " unique segments in " << writer.getBlockCount() << " blocks) from " << inputPath
+              << ": " << totalSize << " -> " << uint64_t(written.tellg()) << " bytes in " << ms << " ms"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,322 @@
+// ========================================
+// demo-coldstart：冷启动分阶段计时
+// ========================================
+// 在无窗口环境下按产品的启动顺序执行一次：
+//   Engine::create -> 创建 SwapChain/Renderer/View -> 场景搭建（材质构建、网格/纹理加载）
+//   -> 等待上传完成 -> 首帧（触发着色器编译） -> 若干稳定帧
+// 记录每一步的耗时，得到首帧时间（time-to-first-frame）。
+// 之后再逐个构建 resources.h 中的材质包并请求编译常用变体，
+// 得到每个材质包的 decode/build/compile 耗时（decode 只在使用压缩资源包时有意义），
+// 用来判断哪些材质值得并行构建或推迟加载。
+//
+// 用法：
+//   demo-coldstart [--scene 04-pbr] [--backend noop|opengl|vulkan|metal]
+//                  [--packages all|none|aidefaultmat,sandboxlit,...] [--frames 5]
+//                  [--width 800] [--height 600]
+//                  [--assets macos-demo] [--filamesh /tmp/cube.filamesh] [--pack demo.pack]
+//                  [--texture-threads 0]
+//                  [--output coldstart.json]
+// NOOP 后端不会真正编译着色器，首帧和 compile 耗时需要在真实后端上测量才有意义。
+
+#include "../common/DemoScene.h"
+#include "../common/JsonWriter.h"
+#include "../common/PackFile.h"
+#include "../common/ResourcePackages.h"
+#include "../common/StartupProfiler.h"
+#include "../common/TextureUploader.h"
+#include "../common/Trace.h"
+
+#include <filament/Material.h>
+#include <filament/Renderer.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace demo;
+using namespace filament;
+
+namespace {
+
+// 材质包编译时请求的变体：方向光、动态光源和阴影接收，覆盖 demo 中实际用到的组合
+constexpr UserVariantFilterMask COMPILE_VARIANTS =
+        UserVariantFilterMask(UserVariantFilterBit::DIRECTIONAL_LIGHTING) |
+        UserVariantFilterMask(UserVariantFilterBit::DYNAMIC_LIGHTING) |
+        UserVariantFilterMask(UserVariantFilterBit::SHADOW_RECEIVER);
+
+// 等待材质编译完成的上限，超时的步骤记为失败
+constexpr auto COMPILE_TIMEOUT = std::chrono::seconds(30);
+
+// 渲染一帧并等待后端执行完，返回是否真正渲染了
+bool renderFrame(SceneContext& ctx, StartupProfiler* profiler) {
+    bool rendered;
+    {
+        StartupStep step(profiler, "Renderer::beginFrame", "frame");
+        rendered = ctx.renderer->beginFrame(ctx.swapChain);
+    }
+    if (rendered) {
+        {
+            StartupStep step(profiler, "Renderer::render", "frame");
+            ctx.renderer->render(ctx.view);
+        }
+        StartupStep step(profiler, "Renderer::endFrame", "frame");
+        ctx.renderer->endFrame();
+    }
+    StartupStep step(profiler, "Engine::flushAndWait", "frame");
+    ctx.engine->flushAndWait();
+    return rendered;
+}
+
+// 构建一个材质包并等待常用变体编译完成，每个材质包单独计时
+void profilePackage(Engine& engine, const ResourcePackage& package, StartupProfiler& profiler) {
+    TRACE_NAME("profilePackage");
+    // 使用压缩资源包时，取数据会解压（或从共享片段拼接）这个材质包
+    StartupStep decodeStep(&profiler, package.name, "package.decode", package.size);
+    BundleLease data = package.acquire();
+    decodeStep.end(bool(data));
+    if (!data) {
+        return;
+    }
+
+    StartupStep buildStep(&profiler, package.name, "package.build", package.size);
+    Material* material = Material::Builder()
+        .package(data.data(), data.size())
+        .build(engine);
+    buildStep.end(material != nullptr);
+    // build() 之后 filament 不再引用材质包，缓冲区还给池
+    data = {};
+    if (!material) {
+        std::cerr << "Failed to build material package: " << package.name << std::endl;
+        return;
+    }
+
+    StartupStep compileStep(&profiler, package.name, "package.compile", package.size);
+    bool compiled = false;
+    material->compile(Material::CompilerPriorityQueue::HIGH, COMPILE_VARIANTS, nullptr,
+            [&compiled](Material*) { compiled = true; });
+    engine.flush();
+    // 回调在主线程上通过 pumpMessageQueues() 分发
+    const auto deadline = std::chrono::steady_clock::now() + COMPILE_TIMEOUT;
+    while (!compiled && std::chrono::steady_clock::now() < deadline) {
+        engine.flushAndWait();
+        engine.pumpMessageQueues();
+    }
+    compileStep.end(compiled);
+
+    engine.destroy(material);
+    engine.flushAndWait();
+}
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options]\n"
+              << "  --scene <name>       scene to start, or snapshot:<file> (default 04-pbr)\n"
+              << "  --backend <name>     noop, opengl, vulkan or metal (default noop)\n"
+              << "  --packages <list>    all, none or comma-separated package names (default all)\n"
+              << "  --frames <n>         steady frames measured after the first one (default 5)\n"
+              << "  --width <n>          swapchain width (default 800)\n"
+              << "  --height <n>         swapchain height (default 600)\n"
+              << "  --assets <dir>       macos-demo directory (default macos-demo)\n"
+              << "  --filamesh <file>    mesh used by 02-cube-obj, .filamesh or .obj (default /tmp/cube.filamesh)\n"
+              << "  --pack <file>        read textures and meshes from a demo-pack archive\n"
+              << "  --texture-threads <n> read textures on n worker threads (default 0, synchronous)\n"
+              << "  --output <file>      write JSON to file instead of stdout\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    // 计时从进程入口开始
+    StartupProfiler profiler;
+    TraceSession traceSession;
+
+    SceneContext ctx;
+    std::string sceneName = "04-pbr";
+    std::string backendName = "noop";
+    Engine::Backend backend = Engine::Backend::NOOP;
+    std::string packages = "all";
+    uint32_t steadyFrames = 5;
+    std::string outputPath;
+    std::string packPath;
+    uint32_t textureThreads = 0;
+
+    // ========================================
+    // 第一步：解析命令行参数
+    // ========================================
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--scene") && hasValue) {
+            sceneName = argv[++i];
+        } else if (!strcmp(arg, "--backend") && hasValue && parseBackend(argv[i + 1], backend)) {
+            backendName = argv[++i];
+        } else if (!strcmp(arg, "--packages") && hasValue) {
+            packages = argv[++i];
+        } else if (!strcmp(arg, "--frames") && hasValue) {
+            steadyFrames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--width") && hasValue) {
+            ctx.width = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--height") && hasValue) {
+            ctx.height = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--assets") && hasValue) {
+            ctx.assetRoot = argv[++i];
+        } else if (!strcmp(arg, "--filamesh") && hasValue) {
+            ctx.filameshPath = argv[++i];
+        } else if (!strcmp(arg, "--pack") && hasValue) {
+            packPath = argv[++i];
+        } else if (!strcmp(arg, "--texture-threads") && hasValue) {
+            textureThreads = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+
+    std::unique_ptr<DemoScene> demoScene = createDemoScene(sceneName);
+    if (!demoScene) {
+        std::cerr << "Unknown scene: " << sceneName << std::endl;
+        return 1;
+    }
+
+    // ========================================
+    // 第二步：按启动顺序计时到首帧
+    // ========================================
+    // 资源包只 open/mmap 一次，计入启动耗时
+    PackFile pack;
+    if (!packPath.empty()) {
+        StartupStep step(&profiler, "PackFile::open", "io");
+        step.end(pack.open(packPath));
+        if (!pack.isOpen()) {
+            return 1;
+        }
+        ctx.pack = &pack;
+    }
+    {
+        StartupStep step(&profiler, "Engine::create", "engine");
+        ctx.engine = Engine::create(backend);
+        step.end(ctx.engine != nullptr);
+    }
+    if (!ctx.engine) {
+        std::cerr << "Failed to create Filament engine" << std::endl;
+        return 1;
+    }
+    {
+        StartupStep step(&profiler, "attachHeadlessContext", "engine");
+        const bool attached = attachHeadlessContext(ctx);
+        step.end(attached);
+        if (!attached) {
+            return 1;
+        }
+    }
+
+    // 指定 --texture-threads 时纹理文件在工作线程上读入暂存池的缓冲区
+    std::unique_ptr<TextureUploader> textures;
+    if (textureThreads) {
+        textures.reset(new TextureUploader(*ctx.engine, textureThreads));
+        ctx.textures = textures.get();
+    }
+
+    // 场景构建器把材质、网格、纹理等子步骤记录到 ctx.profiler
+    ctx.profiler = &profiler;
+    bool ready;
+    {
+        StartupStep step(&profiler, "DemoScene::setup", "scene");
+        ready = demoScene->setup(ctx);
+        step.end(ready);
+    }
+    {
+        StartupStep step(&profiler, "upload (flushAndWait)", "upload");
+        ctx.engine->flushAndWait();
+    }
+
+    double timeToFirstFrameMs = 0.0;
+    double steadyFrameMs = 0.0;
+    if (ready) {
+        {
+            StartupStep step(&profiler, "first frame", "frame");
+            demoScene->update(ctx, 0.0f);
+            step.end(renderFrame(ctx, &profiler));
+        }
+        timeToFirstFrameMs = profiler.getElapsedMs();
+
+        // 后续帧不再逐步记录，只取平均值作为对比
+        const double start = profiler.getElapsedMs();
+        for (uint32_t frame = 1; frame <= steadyFrames; frame++) {
+            demoScene->update(ctx, float(frame) / 60.0f);
+            renderFrame(ctx, nullptr);
+        }
+        if (steadyFrames) {
+            steadyFrameMs = (profiler.getElapsedMs() - start) / double(steadyFrames);
+        }
+    } else {
+        std::cerr << "Scene setup failed: " << sceneName << std::endl;
+    }
+    ctx.profiler = nullptr;
+
+    // ========================================
+    // 第三步：逐个材质包计时 build/compile
+    // ========================================
+    if (packages != "none") {
+        size_t count = 0;
+        const ResourcePackage* all = getMaterialPackages(&count);
+        if (packages == "all") {
+            for (size_t i = 0; i < count; i++) {
+                profilePackage(*ctx.engine, all[i], profiler);
+            }
+        } else {
+            std::istringstream names(packages);
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                if (const ResourcePackage* package = findMaterialPackage(name.c_str())) {
+                    profilePackage(*ctx.engine, *package, profiler);
+                } else {
+                    std::cerr << "Unknown material package: " << name << std::endl;
+                }
+            }
+        }
+    }
+
+    demoScene->teardown(ctx);
+    ctx.textures = nullptr;
+    textures.reset();
+    destroyHeadlessContext(ctx);
+
+    // ========================================
+    // 第四步：输出报告
+    // ========================================
+    std::cerr << "[coldstart] " << sceneName << " on " << backendName
+              << ": first frame at " << timeToFirstFrameMs << " ms, steady frame "
+              << steadyFrameMs << " ms" << std::endl;
+    profiler.dump(std::cerr);
+
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open output file: " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputPath.empty() ? std::cout : file;
+
+    JsonWriter json(out);
+    json.beginObject();
+    json.key("scene").value(sceneName);
+    json.key("backend").value(backendName);
+    json.key("ok").value(ready);
+    json.key("timeToFirstFrameMs").value(timeToFirstFrameMs);
+    json.key("steadyFrameMs").value(steadyFrameMs);
+    json.key("steadyFrames").value(steadyFrames);
+    json.key("profile");
+    profiler.writeJson(json);
+    json.endObject();
+    out << std::endl;
+
+    return ready ? 0 : 1;
+}
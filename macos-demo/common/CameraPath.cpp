@@ -0,0 +1,128 @@
+#include "CameraPath.h"
+
+#include <camutils/Manipulator.h>
+
+#include <math/scalar.h>
+
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <memory>
+#include <sstream>
+
+using namespace filament::math;
+using filament::camutils::Mode;
+using Manipulator = filament::camutils::Manipulator<float>;
+
+namespace demo {
+
+namespace {
+
+// Bookmark::duration() 没有给出有效值时每段使用的时长（秒）
+constexpr double DEFAULT_SEGMENT_SECONDS = 2.0;
+
+} // anonymous namespace
+
+bool CameraPath::parse(std::istream& in, std::vector<CameraKey>& keys, std::string& error) {
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.resize(comment);
+        }
+        std::istringstream fields(line);
+        CameraKey key;
+        if (!(fields >> key.eye.x)) {
+            continue;   // 空行
+        }
+        if (!(fields >> key.eye.y >> key.eye.z >> key.target.x >> key.target.y >> key.target.z)) {
+            error = "line " + std::to_string(lineNumber) + ": expected 6 or 7 numbers";
+            return false;
+        }
+        if (!(fields >> key.duration)) {
+            key.duration = 0.0;
+        }
+        keys.push_back(key);
+    }
+    if (keys.size() < 2) {
+        error = "a camera path needs at least two keys";
+        return false;
+    }
+    return true;
+}
+
+std::vector<CameraKey> CameraPath::defaultKeys() {
+    return {
+        { { 0.0f, 0.3f, 3.0f },  { 0.0f, 0.0f, 0.0f },  3.0 },   // 正面
+        { { 3.0f, 0.6f, 0.0f },  { 0.0f, 0.0f, 0.0f },  3.0 },   // 右侧
+        { { 0.0f, 1.2f, -3.0f }, { 0.0f, 0.0f, 0.0f },  3.0 },   // 背面俯视
+        { { -3.0f, 0.3f, 0.0f }, { 0.0f, 0.0f, 0.0f },  3.0 },   // 左侧
+        { { 0.0f, 0.2f, 1.2f },  { 0.0f, 0.0f, 0.0f },  2.0 },   // 推近
+        { { 0.0f, 0.1f, 0.4f },  { 0.0f, 0.0f, -1.0f }, 3.0 },   // 进入模型内部，大部分物体在视锥外
+        { { 0.0f, 0.5f, 8.0f },  { 0.0f, 0.0f, 0.0f },  0.0 },   // 拉远，模型只占很少的像素
+    };
+}
+
+CameraPath::CameraPath(const std::vector<CameraKey>& keys, float3 center, float radius,
+        uint32_t width, uint32_t height) {
+    auto toWorld = [&](float3 p) { return center + p * radius; };
+
+    const float twoPi = 2.0f * float(M_PI);
+    std::vector<Manipulator::Bookmark> bookmarks;
+    for (const auto& key : keys) {
+        const float3 eye = toWorld(key.eye);
+        const float3 target = toWorld(key.target);
+        const float3 offset = eye - target;
+        OrbitKey orbit{ target, length(offset), 0.0f, 0.0f };
+        if (orbit.distance > 0.0f) {
+            orbit.phi = std::asin(std::clamp(offset.y / orbit.distance, -1.0f, 1.0f));
+            orbit.theta = std::atan2(offset.x, offset.z);
+        }
+        // atan2 的结果在 [-π, π]，加减 2π 到离上一个关键帧最近的值
+        if (!mKeys.empty()) {
+            const float previous = mKeys.back().theta;
+            orbit.theta -= twoPi * std::round((orbit.theta - previous) / twoPi);
+        }
+        mKeys.push_back(orbit);
+
+        // Bookmark 只用来估计每段的时长
+        std::unique_ptr<Manipulator> manipulator(Manipulator::Builder()
+                .viewport(int(width), int(height))
+                .targetPosition(target.x, target.y, target.z)
+                .orbitHomePosition(eye.x, eye.y, eye.z)
+                .build(Mode::ORBIT));
+        bookmarks.push_back(manipulator->getCurrentBookmark());
+    }
+
+    for (size_t i = 0; i + 1 < keys.size(); i++) {
+        double duration = keys[i].duration;
+        if (!(duration > 0.0)) {
+            duration = Manipulator::Bookmark::duration(bookmarks[i], bookmarks[i + 1]);
+        }
+        if (!(duration > 0.0) || !std::isfinite(duration)) {
+            duration = DEFAULT_SEGMENT_SECONDS;
+        }
+        mDurations.push_back(duration);
+    }
+}
+
+void CameraPath::evaluate(size_t segment, double t, float3* eye, float3* target,
+        float3* up) const {
+    const OrbitKey& a = mKeys[segment];
+    const OrbitKey& b = mKeys[segment + 1];
+    const float s = float(t);
+    const float3 pivot = mix(a.pivot, b.pivot, s);
+    const float distance = mix(a.distance, b.distance, s);
+    const float phi = mix(a.phi, b.phi, s);
+    const float theta = mix(a.theta, b.theta, s);
+    *target = pivot;
+    *eye = pivot + distance * float3{ std::sin(theta) * std::cos(phi), std::sin(phi),
+            std::cos(theta) * std::cos(phi) };
+    // 与 Manipulator::getLookAt() 相同：上方向取世界 +Y 在视线垂直平面上的分量
+    const float3 gaze = normalize(*target - *eye);
+    *up = cross(cross(gaze, float3{ 0.0f, 1.0f, 0.0f }), gaze);
+}
+
+} // namespace demo
@@ -0,0 +1,65 @@
+#ifndef DEMO_COMMON_CAMERAPATH_H
+#define DEMO_COMMON_CAMERAPATH_H
+
+#include <math/vec3.h>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace demo {
+
+// ========================================
+// 环绕注视点的相机路径
+// ========================================
+// 路径由一串关键帧组成，每个关键帧是一个相机位置和注视点。关键帧被转换成与 camutils
+// ORBIT 模式相同的参数（注视点、距离、仰角 phi、方位角 theta），相邻两个之间对它们线性插值，
+// 相机沿球面绕注视点移动而不是穿过模型。theta 展开到离上一个关键帧最近的值，总是沿较短的方向绕。
+//
+// 关键帧坐标是相对值：以模型包围盒中心为原点、包围球半径为单位，
+// 同一条路径可以用在尺寸差别很大的模型上。
+//
+// 路径文件每行一个关键帧，# 开头为注释：
+//   eyeX eyeY eyeZ  targetX targetY targetZ  [到下一个关键帧的秒数]
+// 省略秒数时使用 camutils::Bookmark::duration() 的建议值。
+struct CameraKey {
+    filament::math::float3 eye;
+    filament::math::float3 target;
+    double duration = 0.0;
+};
+
+class CameraPath {
+public:
+    // 解析路径文件，失败时 error 给出行号和原因
+    static bool parse(std::istream& in, std::vector<CameraKey>& keys, std::string& error);
+
+    // 内置路径：绕模型环绕一周，推近到模型内部（大量物体被裁剪），再拉远到远处
+    static std::vector<CameraKey> defaultKeys();
+
+    // center/radius 为模型的包围球，keys 至少需要两个
+    CameraPath(const std::vector<CameraKey>& keys, filament::math::float3 center, float radius,
+            uint32_t width, uint32_t height);
+
+    // 段数 = 关键帧数 - 1
+    size_t getSegmentCount() const noexcept { return mDurations.size(); }
+    double getSegmentDuration(size_t segment) const noexcept { return mDurations[segment]; }
+
+    // 第 segment 段中参数 t（0~1）处的相机姿态
+    void evaluate(size_t segment, double t, filament::math::float3* eye,
+            filament::math::float3* target, filament::math::float3* up) const;
+
+private:
+    // 相机位置 = pivot + distance * (sinθ·cosφ, sinφ, cosθ·cosφ)，与 OrbitManipulator 相同
+    struct OrbitKey {
+        filament::math::float3 pivot;
+        float distance;
+        float phi;
+        float theta;
+    };
+    std::vector<OrbitKey> mKeys;
+    std::vector<double> mDurations;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_CAMERAPATH_H
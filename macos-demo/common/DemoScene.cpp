@@ -0,0 +1,143 @@
+#include "DemoScene.h"
+#include "scenes/Scenes.h"
+
+#include <filament/Camera.h>
+#include <filament/Renderer.h>
+#include <filament/Scene.h>
+#include <filament/SwapChain.h>
+#include <filament/View.h>
+#include <filament/Viewport.h>
+
+#include <utils/EntityManager.h>
+
+#include <cstring>
+#include <iostream>
+
+using namespace filament;
+
+namespace demo {
+
+namespace {
+
+// 场景注册表：名称 -> 工厂函数
+struct SceneEntry {
+    const char* name;
+    std::unique_ptr<DemoScene> (*create)();
+};
+
+const SceneEntry SCENES[] = {
+    { "01-triangle",  &createTriangleScene },
+    { "02-cube",      &createCubeScene },
+    { "02-cube-map",  &createCubeMapScene },
+    { "02-cube-obj",  &createCubeObjScene },
+    { "03-morphing",  &createMorphingScene },
+    { "04-pbr",       &createPbrScene },
+};
+
+} // anonymous namespace
+
+std::vector<std::string> getDemoSceneNames() {
+    std::vector<std::string> names;
+    for (const auto& entry : SCENES) {
+        names.emplace_back(entry.name);
+    }
+    return names;
+}
+
+std::unique_ptr<DemoScene> createDemoScene(const std::string& name) {
+    // 场景快照、LOD 和簇剔除场景不在注册表里，按前缀识别
+    constexpr char SNAPSHOT_PREFIX[] = "snapshot:";
+    if (name.compare(0, sizeof(SNAPSHOT_PREFIX) - 1, SNAPSHOT_PREFIX) == 0) {
+        return createSnapshotScene(name.substr(sizeof(SNAPSHOT_PREFIX) - 1));
+    }
+    constexpr char LOD_PREFIX[] = "lod:";
+    constexpr char LOD_OFF_PREFIX[] = "lod-off:";
+    if (name.compare(0, sizeof(LOD_PREFIX) - 1, LOD_PREFIX) == 0) {
+        return createLodScene(name.substr(sizeof(LOD_PREFIX) - 1), true);
+    }
+    if (name.compare(0, sizeof(LOD_OFF_PREFIX) - 1, LOD_OFF_PREFIX) == 0) {
+        return createLodScene(name.substr(sizeof(LOD_OFF_PREFIX) - 1), false);
+    }
+    constexpr char MESHLET_PREFIX[] = "meshlet:";
+    constexpr char MESHLET_OFF_PREFIX[] = "meshlet-off:";
+    if (name.compare(0, sizeof(MESHLET_PREFIX) - 1, MESHLET_PREFIX) == 0) {
+        return createMeshletScene(name.substr(sizeof(MESHLET_PREFIX) - 1), true);
+    }
+    if (name.compare(0, sizeof(MESHLET_OFF_PREFIX) - 1, MESHLET_OFF_PREFIX) == 0) {
+        return createMeshletScene(name.substr(sizeof(MESHLET_OFF_PREFIX) - 1), false);
+    }
+    for (const auto& entry : SCENES) {
+        if (name == entry.name) {
+            return entry.create();
+        }
+    }
+    return nullptr;
+}
+
+bool parseBackend(const char* name, Engine::Backend& backend) {
+    if (!strcmp(name, "noop")) {
+        backend = Engine::Backend::NOOP;
+    } else if (!strcmp(name, "opengl")) {
+        backend = Engine::Backend::OPENGL;
+    } else if (!strcmp(name, "vulkan")) {
+        backend = Engine::Backend::VULKAN;
+    } else if (!strcmp(name, "metal")) {
+        backend = Engine::Backend::METAL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool createHeadlessContext(SceneContext& ctx, const Engine::Config* config,
+        Engine::Backend backend) {
+    ctx.engine = Engine::create(backend, nullptr, nullptr, config);
+    if (!ctx.engine) {
+        std::cerr << "Failed to create Filament engine" << std::endl;
+        return false;
+    }
+    return attachHeadlessContext(ctx);
+}
+
+bool attachHeadlessContext(SceneContext& ctx) {
+    // 离屏 SwapChain：不需要原生窗口，只需要指定尺寸
+    ctx.swapChain = ctx.engine->createSwapChain(ctx.width, ctx.height);
+    if (!ctx.swapChain) {
+        std::cerr << "Failed to create headless SwapChain" << std::endl;
+        Engine::destroy(&ctx.engine);
+        return false;
+    }
+
+    ctx.renderer = ctx.engine->createRenderer();
+    ctx.scene = ctx.engine->createScene();
+    ctx.view = ctx.engine->createView();
+
+    ctx.cameraEntity = utils::EntityManager::get().create();
+    ctx.camera = ctx.engine->createCamera(ctx.cameraEntity);
+
+    ctx.view->setCamera(ctx.camera);
+    ctx.view->setScene(ctx.scene);
+    ctx.view->setViewport(Viewport{ 0, 0, ctx.width, ctx.height });
+    return true;
+}
+
+void destroyHeadlessContext(SceneContext& ctx) {
+    if (!ctx.engine) {
+        return;
+    }
+    ctx.engine->destroyCameraComponent(ctx.cameraEntity);
+    utils::EntityManager::get().destroy(ctx.cameraEntity);
+    ctx.engine->destroy(ctx.view);
+    ctx.engine->destroy(ctx.scene);
+    ctx.engine->destroy(ctx.renderer);
+    ctx.engine->destroy(ctx.swapChain);
+    Engine::destroy(&ctx.engine);
+
+    ctx.camera = nullptr;
+    ctx.view = nullptr;
+    ctx.scene = nullptr;
+    ctx.renderer = nullptr;
+    ctx.swapChain = nullptr;
+}
+
+} // namespace demo
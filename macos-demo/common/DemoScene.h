@@ -0,0 +1,115 @@
+#ifndef DEMO_COMMON_DEMOSCENE_H
+#define DEMO_COMMON_DEMOSCENE_H
+
+#include <filament/Engine.h>
+
+#include <utils/Entity.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace filament {
+class Camera;
+class Renderer;
+class Scene;
+class SwapChain;
+class View;
+}
+
+namespace demo {
+
+class MemoryLedger;
+class PackFile;
+class StartupProfiler;
+class TextureUploader;
+
+// ========================================
+// 场景运行所需的 Filament 核心对象
+// ========================================
+// macos-demo 下每个示例都自己创建 Engine/Renderer/Scene/View/Camera，
+// 这里把它们集中到一个结构体里，方便场景构建器和基准测试工具共享。
+struct SceneContext {
+    filament::Engine* engine = nullptr;
+    filament::SwapChain* swapChain = nullptr;
+    filament::Renderer* renderer = nullptr;
+    filament::Scene* scene = nullptr;
+    filament::View* view = nullptr;
+    filament::Camera* camera = nullptr;
+    utils::Entity cameraEntity;
+
+    uint32_t width = 800;
+    uint32_t height = 600;
+
+    // 资源根目录（即 macos-demo 目录），用于查找纹理等外部文件
+    std::string assetRoot = "macos-demo";
+    // 02-cube-obj 使用的 filamesh 文件，由 filamesh 工具从 cube.obj 生成；
+    // 也可以直接指定 .obj 文件，由 ObjImporter 导入并缓存（见 common/ObjImporter.h）
+    std::string filameshPath = "/tmp/cube.filamesh";
+    // 非空时优先从资源包读取纹理（相对 assetRoot 的路径）和网格（包内路径 "cube.filamesh"），
+    // 数据直接引用映射内存，资源包必须比 Engine 活得更久
+    const PackFile* pack = nullptr;
+    // 非空时，资源包中没有的纹理交给它在工作线程上读取，像素缓冲区取自暂存池（见 common/TextureUploader.h）
+    TextureUploader* textures = nullptr;
+
+    // 非空时，场景构建器把材质构建、网格和纹理加载等步骤记录到这里（见 demo-coldstart）
+    StartupProfiler* profiler = nullptr;
+    // 非空时，场景构建器把创建的缓冲区、纹理和材质登记到这里，teardown() 时注销
+    MemoryLedger* memory = nullptr;
+};
+
+// ========================================
+// 可复用的场景构建器
+// ========================================
+// 每个示例的场景搭建（几何体、材质、光源、相机）和动画更新逻辑
+// 都被提取成一个 DemoScene，和窗口系统、渲染后端完全解耦。
+class DemoScene {
+public:
+    virtual ~DemoScene() = default;
+
+    // 场景名称，与 macos-demo 下的目录名一致，例如 "02-cube"
+    virtual const char* getName() const noexcept = 0;
+
+    // 创建几何体、材质和可渲染实体并加入 ctx.scene，同时设置相机投影
+    // 失败时返回 false，已经创建的对象由 teardown() 负责清理
+    virtual bool setup(SceneContext& ctx) = 0;
+
+    // 根据动画时间（秒）更新变换或变形权重，每帧调用一次
+    virtual void update(SceneContext& ctx, float time) = 0;
+
+    // 销毁 setup() 中创建的所有对象
+    virtual void teardown(SceneContext& ctx) = 0;
+};
+
+// 所有可用场景的名称，顺序与 macos-demo 的目录编号一致
+std::vector<std::string> getDemoSceneNames();
+
+// 根据名称创建场景构建器，名称未知时返回 nullptr。
+// "snapshot:<path>" 加载 demo-snapshot 烘焙的场景快照（见 common/SceneSnapshot.h），
+// "lod:<path>" / "lod-off:<path>" 把一个网格铺成方阵并按距离切换 LOD / 总是画全精度（见 common/MeshLod.h），
+// "meshlet:<path>" / "meshlet-off:<path>" 近距离环绕一个网格，每帧在 CPU 上剔除簇 / 画完整网格（见 common/Meshlet.h），
+// 它们都不在 getDemoSceneNames() 中
+std::unique_ptr<DemoScene> createDemoScene(const std::string& name);
+
+// ========================================
+// 无窗口（headless）运行环境
+// ========================================
+// 使用 NOOP 后端和离屏 SwapChain 创建 Engine，不依赖 SDL 和 Metal，
+// 可以在没有 GPU 的 Linux CI 机器上运行。config 为 nullptr 时使用默认配置。
+bool createHeadlessContext(SceneContext& ctx,
+        const filament::Engine::Config* config = nullptr,
+        filament::Engine::Backend backend = filament::Engine::Backend::NOOP);
+
+// 在已经创建好的 ctx.engine 上创建离屏 SwapChain、Renderer、Scene、View 和 Camera，
+// 用于需要单独计时 Engine::create() 的场合；失败时会销毁 ctx.engine
+bool attachHeadlessContext(SceneContext& ctx);
+
+// 命令行中的后端名（noop、opengl、vulkan、metal）转换为 Backend，名字未知时返回 false
+bool parseBackend(const char* name, filament::Engine::Backend& backend);
+
+// 按创建的反序销毁 createHeadlessContext() 创建的对象
+void destroyHeadlessContext(SceneContext& ctx);
+
+} // namespace demo
+
+#endif // DEMO_COMMON_DEMOSCENE_H
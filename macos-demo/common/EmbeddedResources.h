@@ -0,0 +1,31 @@
+#ifndef DEMO_COMMON_EMBEDDEDRESOURCES_H
+#define DEMO_COMMON_EMBEDDEDRESOURCES_H
+
+// ========================================
+// 内嵌资源（材质包、monkey 模型和贴图）
+// ========================================
+// 两种形式提供同名的 RESOURCES_XXX_DATA/SIZE、MONKEY_XXX_DATA/SIZE 宏：
+// - DEMO_COMPRESSED_RESOURCES：demo-bundle 在构建时生成的 LZ4 压缩资源包（见 ResourceBundle.h），
+//   XXX_DATA 是函数调用，第一次访问时解压，只访问用到的条目
+// - 否则：resgen 生成的原始数据，XXX_DATA 是指向 incbin 数据的常量地址
+// 使用方不要直接包含 generated/resources 下的头文件，也不要假设 XXX_DATA 是编译期常量。
+//
+// 只在一次调用中用到的数据（材质包只需要保持到 Material::Builder::build()）用
+// ACQUIRE_RESOURCE(RESOURCES, AIDEFAULTMAT) 取出一个 BundleLease，析构后缓冲区回到池中，
+// 不会像 XXX_DATA 那样在缓存中常驻；未压缩时租约直接引用 incbin 数据。
+
+#include "ResourceBundle.h"
+
+#ifdef DEMO_COMPRESSED_RESOURCES
+#include <resources_bundle.h>
+#include <monkey_bundle.h>
+#define ACQUIRE_RESOURCE(PACKAGE, NAME) \
+    (demo::acquireBundleEntry(PACKAGE##_BUNDLE, PACKAGE##_##NAME##_INDEX))
+#else
+#include "../generated/resources/resources.h"
+#include "../generated/resources/monkey.h"
+#define ACQUIRE_RESOURCE(PACKAGE, NAME) \
+    (demo::BundleLease(PACKAGE##_##NAME##_DATA, PACKAGE##_##NAME##_SIZE))
+#endif
+
+#endif // DEMO_COMMON_EMBEDDEDRESOURCES_H
@@ -0,0 +1,79 @@
+#include "Filamesh.h"
+
+#include <cstring>
+
+namespace demo {
+
+const char* readFilameshLayout(const void* file, size_t size, FilameshLayout& layout) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(file);
+    FilameshHeader& header = layout.header;
+    if (size < sizeof(header)) {
+        return "Not a filamesh file";
+    }
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, "FILAMESH", sizeof(header.magic)) != 0) {
+        return "Not a filamesh file";
+    }
+    const uint64_t indicesOffset = uint64_t(sizeof(header)) + header.vertexSize;
+    const uint64_t partsOffset = indicesOffset + header.indexSize;
+    uint64_t offset = partsOffset + uint64_t(header.parts) * sizeof(FilameshPart);
+    uint32_t materialCount = 0;
+    if (offset + sizeof(materialCount) > size) {
+        return "Truncated filamesh file";
+    }
+    std::memcpy(&materialCount, bytes + offset, sizeof(materialCount));
+    offset += sizeof(materialCount);
+    for (uint32_t i = 0; i < materialCount; i++) {
+        uint32_t length = 0;
+        if (offset + sizeof(length) > size) {
+            return "Truncated filamesh file";
+        }
+        std::memcpy(&length, bytes + offset, sizeof(length));
+        offset += sizeof(length) + uint64_t(length) + 1;
+    }
+    if (offset > size) {
+        return "Truncated filamesh file";
+    }
+    layout.indicesOffset = size_t(indicesOffset);
+    layout.partsOffset = size_t(partsOffset);
+    layout.materialsEnd = size_t(offset);
+    return nullptr;
+}
+
+const char* checkInterleavedFilamesh(const FilameshHeader& header) {
+    if ((header.flags & FILAMESH_COMPRESSION) || !(header.flags & FILAMESH_INTERLEAVED)) {
+        return "Only uncompressed interleaved filamesh files are supported";
+    }
+    const uint32_t stride = header.stridePosition;
+    if (header.vertexCount == 0 || stride == 0 || uint64_t(header.vertexCount) * stride != header.vertexSize ||
+            uint64_t(header.offsetPosition) + sizeof(uint16_t) * 3 > stride ||
+            uint64_t(header.indexCount) * filameshIndexElementSize(header) != header.indexSize) {
+        return "Truncated filamesh file";
+    }
+    return nullptr;
+}
+
+size_t filameshIndexElementSize(const FilameshHeader& header) {
+    return header.indexType == FILAMESH_INDEX_UI16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+uint64_t filameshVertexBytes(const FilameshHeader& header) {
+    if (!(header.flags & FILAMESH_COMPRESSION)) {
+        return header.vertexSize;
+    }
+    // HALF4 位置 + SHORT4 切线空间四元数
+    uint64_t bytesPerVertex = 4 * sizeof(uint16_t) + 4 * sizeof(int16_t);
+    if (header.offsetColor != FILAMESH_NO_ATTRIBUTE) {
+        bytesPerVertex += 4 * sizeof(uint8_t);
+    }
+    // HALF2 和 SHORT2 都是 4 字节
+    if (header.offsetUV0 != FILAMESH_NO_ATTRIBUTE) {
+        bytesPerVertex += 2 * sizeof(uint16_t);
+    }
+    if (header.offsetUV1 != FILAMESH_NO_ATTRIBUTE) {
+        bytesPerVertex += 2 * sizeof(uint16_t);
+    }
+    return uint64_t(header.vertexCount) * bytesPerVertex;
+}
+
+} // namespace demo
@@ -0,0 +1,93 @@
+#ifndef DEMO_COMMON_FILAMESH_H
+#define DEMO_COMMON_FILAMESH_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace demo {
+
+// ========================================
+// filamesh 文件格式
+// ========================================
+// filameshio::MeshReader 读取、filamesh 工具和 ObjImporter 写出的格式：
+//
+//   FilameshHeader | 顶点数据 (vertexSize) | 索引 (indexSize) | parts 个 FilameshPart |
+//   uint32 材质数 | 每个材质 { uint32 长度; 名字; '\0' }
+//
+// 未压缩时顶点数据按 FILAMESH_INTERLEAVED 交错存放，各属性的 stride 相同。
+// 压缩时（FILAMESH_COMPRESSION）顶点和索引是 meshoptimizer 编码，vertexSize/indexSize 是编码后的大小，
+// stride 都是 0，offset 是解码后各属性在非交错缓冲区中的位置。
+// MeshLod 的 LOD 表追加在材质名之后（见 MeshLod.h），MeshReader 会忽略它。
+struct FilameshHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t parts;
+    float aabb[6];              // 中心, 半边长
+    uint32_t flags;
+    uint32_t offsetPosition;
+    uint32_t stridePosition;
+    uint32_t offsetTangents;
+    uint32_t strideTangents;
+    uint32_t offsetColor;
+    uint32_t strideColor;
+    uint32_t offsetUV0;
+    uint32_t strideUV0;
+    uint32_t offsetUV1;
+    uint32_t strideUV1;
+    uint32_t vertexCount;
+    uint32_t vertexSize;
+    uint32_t indexType;
+    uint32_t indexCount;
+    uint32_t indexSize;
+};
+static_assert(sizeof(FilameshHeader) == 104, "filamesh header is tightly packed");
+
+struct FilameshPart {
+    uint32_t offset;            // 第一个索引的位置
+    uint32_t indexCount;
+    uint32_t minIndex;
+    uint32_t maxIndex;
+    uint32_t materialID;
+    float aabb[6];
+};
+
+constexpr uint32_t FILAMESH_VERSION = 1;
+
+// flags
+constexpr uint32_t FILAMESH_INTERLEAVED = 0x1;
+constexpr uint32_t FILAMESH_TEXCOORD_SNORM16 = 0x2;     // UV 是归一化 SHORT2，否则是 HALF2
+constexpr uint32_t FILAMESH_COMPRESSION = 0x4;
+
+// indexType
+constexpr uint32_t FILAMESH_INDEX_UI32 = 0;
+constexpr uint32_t FILAMESH_INDEX_UI16 = 1;
+
+// 属性不存在时的 offset/stride
+constexpr uint32_t FILAMESH_NO_ATTRIBUTE = UINT32_MAX;
+
+// 文件中各段的位置，readFilameshLayout() 已经检查过它们都在文件内
+struct FilameshLayout {
+    FilameshHeader header;
+    size_t indicesOffset;
+    size_t partsOffset;
+    size_t materialsEnd;        // 材质名之后，即 LOD 表的位置
+};
+
+// 读取文件头，检查顶点、索引、part 表和材质名都在 size 之内。
+// 成功时返回 nullptr，失败时返回原因（不打印，由调用者加上文件名输出）
+const char* readFilameshLayout(const void* file, size_t size, FilameshLayout& layout);
+
+// 在 readFilameshLayout() 之后检查文件是未压缩的交错格式：每个顶点的位置都在顶点数据内，
+// vertexSize、indexSize 与数量一致。成功时返回 nullptr，失败时返回原因
+const char* checkInterleavedFilamesh(const FilameshHeader& header);
+
+// 索引的字节数（2 或 4）
+size_t filameshIndexElementSize(const FilameshHeader& header);
+
+// 上传到 GPU 的顶点数据字节数。未压缩时就是 vertexSize；压缩时 vertexSize 是编码后的大小，
+// 按解码后的属性计算：HALF4 位置、SHORT4 切线，有的话加上 UBYTE4 颜色和 HALF2/SHORT2 的 UV0、UV1
+uint64_t filameshVertexBytes(const FilameshHeader& header);
+
+} // namespace demo
+
+#endif // DEMO_COMMON_FILAMESH_H
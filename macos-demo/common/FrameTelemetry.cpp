@@ -0,0 +1,237 @@
+#include "FrameTelemetry.h"
+#include "JsonWriter.h"
+#include "Trace.h"
+
+#include <filament/Renderer.h>
+
+#include <algorithm>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+
+using namespace filament;
+
+namespace demo {
+
+namespace {
+
+// 存活的 FrameTelemetry 注册表，固定大小，注册/注销都是无锁的
+constexpr size_t MAX_TELEMETRY = 32;
+std::atomic<FrameTelemetry*> gRegistry[MAX_TELEMETRY];
+
+// SIGUSR1 到达后置位，由渲染线程在 endFrame() 中检查并转储
+std::atomic<bool> gDumpRequested{ false };
+
+void registerTelemetry(FrameTelemetry* telemetry) {
+    for (auto& slot : gRegistry) {
+        FrameTelemetry* expected = nullptr;
+        if (slot.compare_exchange_strong(expected, telemetry)) {
+            return;
+        }
+    }
+}
+
+void unregisterTelemetry(FrameTelemetry* telemetry) {
+    for (auto& slot : gRegistry) {
+        FrameTelemetry* expected = telemetry;
+        if (slot.compare_exchange_strong(expected, nullptr)) {
+            return;
+        }
+    }
+}
+
+void onDumpSignal(int) {
+    gDumpRequested.store(true, std::memory_order_relaxed);
+}
+
+void writeHistogramJson(JsonWriter& json, const FrameHistogram& h) {
+    json.beginObject();
+    json.key("count").value(h.getCount());
+    json.key("mean").value(h.getMean());
+    json.key("p50").value(h.getPercentile(0.50));
+    json.key("p90").value(h.getPercentile(0.90));
+    json.key("p99").value(h.getPercentile(0.99));
+    json.key("max").value(h.getMax());
+    json.endObject();
+}
+
+void dumpHistogramRow(std::ostream& out, const char* name, const FrameHistogram& h) {
+    out << "  " << std::left << std::setw(10) << name << std::right
+        << std::setw(8) << h.getCount()
+        << std::setw(10) << h.getMean()
+        << std::setw(10) << h.getPercentile(0.50)
+        << std::setw(10) << h.getPercentile(0.90)
+        << std::setw(10) << h.getPercentile(0.99)
+        << std::setw(10) << h.getMax() << '\n';
+}
+
+} // anonymous namespace
+
+// ========================================
+// FrameHistogram
+// ========================================
+
+void FrameHistogram::record(double ms) noexcept {
+    if (!(ms >= 0.0)) {
+        return;
+    }
+    const uint32_t index = std::min(uint32_t(ms / BUCKET_WIDTH_MS), BUCKET_COUNT);
+    mBuckets[index].fetch_add(1, std::memory_order_relaxed);
+
+    const uint64_t ns = uint64_t(ms * 1e6);
+    mSumNs.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t currentMax = mMaxNs.load(std::memory_order_relaxed);
+    while (ns > currentMax &&
+           !mMaxNs.compare_exchange_weak(currentMax, ns, std::memory_order_relaxed)) {
+    }
+    // 最后更新计数，读取方看到的 count 不会超过桶内样本总数
+    mCount.fetch_add(1, std::memory_order_release);
+}
+
+void FrameHistogram::reset() noexcept {
+    for (auto& bucket : mBuckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    mCount.store(0, std::memory_order_relaxed);
+    mSumNs.store(0, std::memory_order_relaxed);
+    mMaxNs.store(0, std::memory_order_relaxed);
+}
+
+double FrameHistogram::getMean() const noexcept {
+    const uint64_t count = mCount.load(std::memory_order_acquire);
+    return count ? double(mSumNs.load(std::memory_order_relaxed)) / 1e6 / double(count) : 0.0;
+}
+
+double FrameHistogram::getMax() const noexcept {
+    return double(mMaxNs.load(std::memory_order_relaxed)) / 1e6;
+}
+
+double FrameHistogram::getPercentile(double p) const noexcept {
+    const uint64_t count = mCount.load(std::memory_order_acquire);
+    if (!count) {
+        return 0.0;
+    }
+    const uint64_t target = std::max<uint64_t>(1, uint64_t(p * double(count) + 0.5));
+    uint64_t accumulated = 0;
+    for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+        accumulated += mBuckets[i].load(std::memory_order_relaxed);
+        if (accumulated >= target) {
+            // 桶上界不会超过实际最大值
+            return std::min(double(i + 1) * BUCKET_WIDTH_MS, getMax());
+        }
+    }
+    return getMax();
+}
+
+// ========================================
+// FrameTelemetry
+// ========================================
+
+FrameTelemetry::FrameTelemetry(std::string sceneName)
+        : FrameTelemetry(std::move(sceneName), Config{}) {
+}
+
+FrameTelemetry::FrameTelemetry(std::string sceneName, Config config)
+        : mSceneName(std::move(sceneName)), mConfig(config) {
+    registerTelemetry(this);
+}
+
+FrameTelemetry::~FrameTelemetry() {
+    unregisterTelemetry(this);
+    if (mConfig.dumpOnDestroy) {
+        dump(std::cerr);
+    }
+}
+
+void FrameTelemetry::beginFrame() noexcept {
+    mFrameStart = Clock::now();
+    if (mHasLastFrame) {
+        const double interval = std::chrono::duration<double, std::milli>(
+                mFrameStart - mLastFrameStart).count();
+        mInterval.record(interval);
+        if (interval > mConfig.jankThresholdMs) {
+            mJankCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    mLastFrameStart = mFrameStart;
+    mHasLastFrame = true;
+}
+
+void FrameTelemetry::endFrame(const Renderer& renderer) noexcept {
+    mCpu.record(std::chrono::duration<double, std::milli>(Clock::now() - mFrameStart).count());
+    pollFrameInfo(renderer);
+
+    if (gDumpRequested.exchange(false, std::memory_order_relaxed)) {
+        dumpAll(std::cerr);
+    }
+}
+
+void FrameTelemetry::pollFrameInfo(const Renderer& renderer) noexcept {
+    // 历史记录里只有已经完成 GPU 计时的帧，按 frameId 去重，每帧只统计一次
+    auto history = renderer.getFrameInfoHistory(renderer.getMaxFrameHistorySize());
+    uint32_t newestId = mLastFrameId;
+    for (const auto& info : history) {
+        if (mHasFrameId && info.frameId <= mLastFrameId) {
+            continue;
+        }
+        newestId = std::max(newestId, info.frameId);
+        if (info.backendEndFrame > info.backendBeginFrame) {
+            mBackend.record(double(info.backendEndFrame - info.backendBeginFrame) / 1e6);
+            // 后端线程的帧区间放到 trace 的独立轨道上（时间戳与 Trace::now() 同为 steady_clock）
+            if (Trace::isEnabled()) {
+                Trace::complete("backend frame", "filament backend", info.backendBeginFrame,
+                        info.backendEndFrame - info.backendBeginFrame);
+            }
+        }
+        if (info.frameTime > 0) {
+            mGpu.record(double(info.frameTime) / 1e6);
+        }
+    }
+    if (!history.empty()) {
+        mLastFrameId = newestId;
+        mHasFrameId = true;
+    }
+}
+
+void FrameTelemetry::dump(std::ostream& out) const {
+    out << "[telemetry] " << mSceneName
+        << "  jank(>" << mConfig.jankThresholdMs << "ms): " << getJankCount() << '\n';
+    out << std::fixed << std::setprecision(2);
+    out << "  " << std::left << std::setw(10) << "(ms)" << std::right
+        << std::setw(8) << "count" << std::setw(10) << "mean"
+        << std::setw(10) << "p50" << std::setw(10) << "p90"
+        << std::setw(10) << "p99" << std::setw(10) << "max" << '\n';
+    dumpHistogramRow(out, "interval", mInterval);
+    dumpHistogramRow(out, "cpu", mCpu);
+    dumpHistogramRow(out, "backend", mBackend);
+    dumpHistogramRow(out, "gpu", mGpu);
+    out << std::defaultfloat << std::flush;
+}
+
+void FrameTelemetry::writeJson(JsonWriter& json) const {
+    json.beginObject();
+    json.key("scene").value(mSceneName);
+    json.key("jankThresholdMs").value(mConfig.jankThresholdMs);
+    json.key("jankCount").value(getJankCount());
+    json.key("intervalMs"); writeHistogramJson(json, mInterval);
+    json.key("cpuMs");      writeHistogramJson(json, mCpu);
+    json.key("backendMs");  writeHistogramJson(json, mBackend);
+    json.key("gpuMs");      writeHistogramJson(json, mGpu);
+    json.endObject();
+}
+
+void FrameTelemetry::installSignalHandler() {
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, &onDumpSignal);
+#endif
+}
+
+void FrameTelemetry::dumpAll(std::ostream& out) {
+    for (auto& slot : gRegistry) {
+        if (FrameTelemetry* telemetry = slot.load()) {
+            telemetry->dump(out);
+        }
+    }
+}
+
+} // namespace demo
@@ -0,0 +1,119 @@
+#ifndef DEMO_COMMON_FRAMETELEMETRY_H
+#define DEMO_COMMON_FRAMETELEMETRY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace filament {
+class Renderer;
+}
+
+namespace demo {
+
+class JsonWriter;
+
+// ========================================
+// 固定大小的无锁帧耗时直方图
+// ========================================
+// 0 ~ 100ms 按 0.1ms 分桶，超过 100ms 的帧落入溢出桶（最大值仍然精确记录）。
+// 所有计数都是原子变量，渲染线程写入的同时其他线程（或信号触发的转储）可以直接读取。
+class FrameHistogram {
+public:
+    static constexpr uint32_t BUCKET_COUNT = 1000;
+    static constexpr double BUCKET_WIDTH_MS = 0.1;
+
+    FrameHistogram() noexcept { reset(); }
+    FrameHistogram(const FrameHistogram&) = delete;
+    FrameHistogram& operator=(const FrameHistogram&) = delete;
+
+    void record(double ms) noexcept;
+    void reset() noexcept;
+
+    uint64_t getCount() const noexcept { return mCount.load(std::memory_order_relaxed); }
+    double getMean() const noexcept;
+    double getMax() const noexcept;
+    // 返回分位数 p (0~1) 所在桶的上界，精度为 BUCKET_WIDTH_MS
+    double getPercentile(double p) const noexcept;
+
+private:
+    std::atomic<uint32_t> mBuckets[BUCKET_COUNT + 1];  // 最后一个是溢出桶
+    std::atomic<uint64_t> mCount{ 0 };
+    std::atomic<uint64_t> mSumNs{ 0 };
+    std::atomic<uint64_t> mMaxNs{ 0 };
+};
+
+// ========================================
+// 每个场景的帧耗时遥测
+// ========================================
+// 在渲染循环中调用 beginFrame()/endFrame()：
+//   - interval: 相邻两帧 beginFrame() 之间的墙钟时间（用户实际感受到的帧间隔）
+//   - cpu:      beginFrame() 到 endFrame() 之间主线程的耗时
+//   - backend:  Renderer::getFrameInfoHistory() 报告的后端线程耗时
+//   - gpu:      Renderer::getFrameInfoHistory() 报告的 GPU 耗时（后端不支持时为空）
+// 帧间隔超过 jankThresholdMs 的帧计为一次卡顿（jank）。
+//
+// 对象析构时把直方图打印到 stderr；收到 SIGUSR1 后会在下一次 endFrame() 打印
+// 当前所有场景的直方图。
+class FrameTelemetry {
+public:
+    struct Config {
+        double jankThresholdMs = 1000.0 / 30.0;  // 默认：掉到 30fps 以下视为卡顿
+        bool dumpOnDestroy = true;
+    };
+
+    explicit FrameTelemetry(std::string sceneName);
+    FrameTelemetry(std::string sceneName, Config config);
+    ~FrameTelemetry();
+
+    FrameTelemetry(const FrameTelemetry&) = delete;
+    FrameTelemetry& operator=(const FrameTelemetry&) = delete;
+
+    // 在处理输入、更新动画之前调用
+    void beginFrame() noexcept;
+
+    // 在 Renderer::endFrame() 之后调用（即使 beginFrame 返回 false 也要调用）
+    void endFrame(const filament::Renderer& renderer) noexcept;
+
+    const std::string& getSceneName() const noexcept { return mSceneName; }
+    uint64_t getJankCount() const noexcept { return mJankCount.load(std::memory_order_relaxed); }
+    const FrameHistogram& getIntervalHistogram() const noexcept { return mInterval; }
+    const FrameHistogram& getCpuHistogram() const noexcept { return mCpu; }
+    const FrameHistogram& getBackendHistogram() const noexcept { return mBackend; }
+    const FrameHistogram& getGpuHistogram() const noexcept { return mGpu; }
+
+    // 以表格形式打印所有直方图的 p50/p90/p99/max
+    void dump(std::ostream& out) const;
+    void writeJson(JsonWriter& json) const;
+
+    // 安装 SIGUSR1 处理函数，处理函数只设置一个原子标志，保证异步信号安全
+    static void installSignalHandler();
+    // 打印当前存活的所有 FrameTelemetry
+    static void dumpAll(std::ostream& out);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void pollFrameInfo(const filament::Renderer& renderer) noexcept;
+
+    std::string mSceneName;
+    Config mConfig;
+
+    FrameHistogram mInterval;
+    FrameHistogram mCpu;
+    FrameHistogram mBackend;
+    FrameHistogram mGpu;
+    std::atomic<uint64_t> mJankCount{ 0 };
+
+    Clock::time_point mFrameStart{};
+    Clock::time_point mLastFrameStart{};
+    bool mHasLastFrame = false;
+    uint32_t mLastFrameId = 0;
+    bool mHasFrameId = false;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_FRAMETELEMETRY_H
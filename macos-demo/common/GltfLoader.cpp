@@ -0,0 +1,272 @@
+#include "GltfLoader.h"
+#include "GltfTextureProvider.h"
+#include "PackFile.h"
+#include "Trace.h"
+
+#include <filament/Engine.h>
+
+#include <gltfio/AssetLoader.h>
+#include <gltfio/FilamentAsset.h>
+#include <gltfio/MaterialProvider.h>
+#include <gltfio/ResourceLoader.h>
+#include <gltfio/TextureProvider.h>
+#include <gltfio/materials/uberarchive.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+using namespace filament;
+using namespace filament::gltfio;
+
+namespace demo {
+
+namespace {
+
+std::string directoryOf(const std::string& path) {
+    const size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? "" : path.substr(0, slash + 1);
+}
+
+bool readFile(const std::string& path, std::vector<uint8_t>& content) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// 按文件名推断贴图用途，例如 FlightHelmet_normal.png、*_occlusionRoughnessMetallic.png。
+// 推断不出时返回 false，由 GltfTextureProvider 按 sRGB 标志决定
+bool guessTextureRole(const char* uri, TextureRole& role) {
+    std::string name(uri);
+    std::transform(name.begin(), name.end(), name.begin(),
+            [](unsigned char c) { return char(std::tolower(c)); });
+    const auto contains = [&name](const char* word) { return name.find(word) != std::string::npos; };
+    if (contains("normal")) {
+        role = TextureRole::NORMAL;
+    } else if (contains("occlusion") || contains("rough") || contains("metal") || contains("orm")) {
+        role = TextureRole::OCCLUSION_ROUGHNESS_METALLIC;
+    } else if (contains("basecolor") || contains("albedo") || contains("diffuse")) {
+        role = TextureRole::BASE_COLOR;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+GltfLoader::GltfLoader(Engine& engine, uint32_t textureThreads) : mEngine(engine) {
+    mMaterials = createUbershaderProvider(&engine, UBERARCHIVE_DEFAULT_DATA, UBERARCHIVE_DEFAULT_SIZE);
+    mAssetLoader = AssetLoader::create({ &engine, mMaterials, nullptr });
+
+    mResourceLoader = new ResourceLoader({ &engine, nullptr, true });
+    mImageProvider = new GltfTextureProvider(engine, textureThreads);
+    mKtx2Provider = createKtx2Provider(&engine);
+    mResourceLoader->addTextureProvider("image/png", mImageProvider);
+    mResourceLoader->addTextureProvider("image/jpeg", mImageProvider);
+    mResourceLoader->addTextureProvider("image/ktx2", mKtx2Provider);
+}
+
+GltfLoader::~GltfLoader() {
+    if (mPending) {
+        cancelLoad();
+    }
+    delete mResourceLoader;
+    delete mImageProvider;
+    delete mKtx2Provider;
+    AssetLoader::destroy(&mAssetLoader);
+    mMaterials->destroyMaterials();
+    delete mMaterials;
+}
+
+FilamentAsset* GltfLoader::load(const std::string& path) {
+    return loadFile(path, false);
+}
+
+FilamentAsset* GltfLoader::load(const PackFile& pack, const std::string& path) {
+    return loadPack(pack, path, false);
+}
+
+FilamentAsset* GltfLoader::load(const uint8_t* data, size_t size, const std::string& name) {
+    return loadMemory(data, size, name, false);
+}
+
+FilamentAsset* GltfLoader::loadAsync(const std::string& path) {
+    return loadFile(path, true);
+}
+
+FilamentAsset* GltfLoader::loadAsync(const PackFile& pack, const std::string& path) {
+    return loadPack(pack, path, true);
+}
+
+FilamentAsset* GltfLoader::loadAsync(const uint8_t* data, size_t size, const std::string& name) {
+    return loadMemory(data, size, name, true);
+}
+
+FilamentAsset* GltfLoader::loadFile(const std::string& path, bool async) {
+    TRACE_CALL();
+    finishPending();
+    std::vector<uint8_t> content;
+    if (!readFile(path, content)) {
+        std::cerr << "Failed to open glTF file: " << path << std::endl;
+        return nullptr;
+    }
+
+    // createAsset() 会拷贝需要保留的数据，content 可以随后释放
+    FilamentAsset* asset = mAssetLoader->createAsset(content.data(), uint32_t(content.size()));
+    if (!asset) {
+        std::cerr << "Failed to parse glTF file: " << path << std::endl;
+        return nullptr;
+    }
+
+    // 外部 buffer 和纹理由这里读入 URI 缓存，GltfTextureProvider 才能按数据指针认出每张图片的用途。
+    // 读不到的文件留给 ResourceLoader 报错
+    const std::string directory = directoryOf(path);
+    const char* const* uris = asset->getResourceUris();
+    mFiles.resize(asset->getResourceUriCount());
+    for (size_t i = 0; i < asset->getResourceUriCount(); i++) {
+        if (!strncmp(uris[i], "data:", 5) || !readFile(directory + uris[i], mFiles[i])) {
+            continue;
+        }
+        addResource(uris[i], mFiles[i].data(), mFiles[i].size());
+    }
+    return startLoad(asset, path, async);
+}
+
+FilamentAsset* GltfLoader::loadPack(const PackFile& pack, const std::string& path, bool async) {
+    TRACE_CALL();
+    finishPending();
+    const PackView content = pack.find(path);
+    if (!content) {
+        std::cerr << "glTF file not found in pack: " << path << std::endl;
+        return nullptr;
+    }
+
+    FilamentAsset* asset = mAssetLoader->createAsset(content.data, uint32_t(content.size));
+    if (!asset) {
+        std::cerr << "Failed to parse glTF file: " << path << std::endl;
+        return nullptr;
+    }
+
+    // 外部 buffer 和纹理以 glTF 文件所在目录为基准在包内查找，直接放进 ResourceLoader 的 URI 缓存，
+    // 映射内存由资源包持有，不需要释放回调
+    const std::string directory = directoryOf(path);
+    const char* const* uris = asset->getResourceUris();
+    for (size_t i = 0; i < asset->getResourceUriCount(); i++) {
+        if (const PackView data = pack.find(directory + uris[i])) {
+            addResource(uris[i], data.data, data.size);
+        }
+    }
+    return startLoad(asset, path, async);
+}
+
+FilamentAsset* GltfLoader::loadMemory(const uint8_t* data, size_t size, const std::string& name,
+        bool async) {
+    TRACE_CALL();
+    finishPending();
+    FilamentAsset* asset = mAssetLoader->createAsset(data, uint32_t(size));
+    if (!asset) {
+        std::cerr << "Failed to parse glTF data: " << name << std::endl;
+        return nullptr;
+    }
+    if (asset->getResourceUriCount()) {
+        std::cerr << "glTF data references external files: " << name << std::endl;
+        mAssetLoader->destroyAsset(asset);
+        return nullptr;
+    }
+    return startLoad(asset, name, async);
+}
+
+void GltfLoader::addResource(const char* uri, const void* data, size_t size) {
+    mResourceLoader->addResourceData(uri, ResourceLoader::BufferDescriptor(data, size));
+    TextureRole role;
+    if (guessTextureRole(uri, role)) {
+        mImageProvider->setRole(data, role);
+    }
+}
+
+FilamentAsset* GltfLoader::startLoad(FilamentAsset* asset, const std::string& path, bool async) {
+    // 外部 buffer 和纹理的相对路径以 glTF 文件所在目录为基准
+    mResourceLoader->setConfiguration({ &mEngine, path.c_str(), true });
+    const bool loaded = async ? mResourceLoader->asyncBeginLoad(asset)
+            : mResourceLoader->loadResources(asset);
+    if (!loaded) {
+        std::cerr << "Failed to load glTF resources: " << path << std::endl;
+        cancelLoad();
+        mAssetLoader->destroyAsset(asset);
+        return nullptr;
+    }
+    if (async) {
+        mPending = asset;
+    } else {
+        finishLoad(asset);
+    }
+    return asset;
+}
+
+void GltfLoader::finishLoad(FilamentAsset* asset) {
+    // URI 缓存只在本次加载中使用，清空后不会影响下一个模型
+    mResourceLoader->evictResourceData();
+    mImageProvider->clearRoles();
+    mFiles.clear();
+    if (asset) {
+        asset->releaseSourceData();
+    }
+}
+
+float GltfLoader::update() {
+    if (!mPending) {
+        return 1.0f;
+    }
+    mResourceLoader->asyncUpdateLoad();
+    const float progress = mResourceLoader->asyncGetLoadProgress();
+    if (progress >= 1.0f) {
+        finishLoad(mPending);
+        mPending = nullptr;
+    }
+    return progress;
+}
+
+void GltfLoader::finishPending() {
+    if (!mPending) {
+        return;
+    }
+    TRACE_CALL();
+    while (update() < 1.0f) {
+        mImageProvider->waitForCompletion();
+        mKtx2Provider->waitForCompletion();
+    }
+}
+
+void GltfLoader::cancelLoad() {
+    TRACE_CALL();
+    // asyncCancelLoad() 让各个 provider 丢弃还没开始的解码并等正在进行的解码结束，
+    // 但结果还留在 provider 里。模型销毁后这些 Texture 就失效了，这里趁它们还有效时全部弹出
+    mResourceLoader->asyncCancelLoad();
+    for (TextureProvider* provider : { (TextureProvider*) mImageProvider, mKtx2Provider }) {
+        provider->updateQueue();
+        while (provider->popTexture()) {
+        }
+    }
+    finishLoad(nullptr);
+    mPending = nullptr;
+}
+
+void GltfLoader::destroy(FilamentAsset* asset) {
+    if (!asset) {
+        return;
+    }
+    if (asset == mPending) {
+        cancelLoad();
+    }
+    mAssetLoader->destroyAsset(asset);
+}
+
+} // namespace demo
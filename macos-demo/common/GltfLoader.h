@@ -0,0 +1,104 @@
+#ifndef DEMO_COMMON_GLTFLOADER_H
+#define DEMO_COMMON_GLTFLOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace filament {
+class Engine;
+namespace gltfio {
+class AssetLoader;
+class FilamentAsset;
+class MaterialProvider;
+class ResourceLoader;
+class TextureProvider;
+}
+}
+
+namespace demo {
+
+class GltfTextureProvider;
+class PackFile;
+
+// ========================================
+// glTF 模型加载
+// ========================================
+// 用 gltfio 从磁盘加载 .gltf/.glb（包括外部 buffer 和 png/jpeg/ktx2 纹理），
+// 材质使用 gltfio 自带的 ubershader 存档，不需要在运行时编译材质。
+// PNG/JPEG 由 GltfTextureProvider 在 textureThreads 个工作线程上并行解码，按图片 URI 推断用途，
+// 基础色先解码；KTX2 使用 gltfio 自带的 Ktx2 provider。
+//
+// load() 是同步的：返回时纹理已经解码并提交上传。loadAsync() 返回时几何体已经上传，
+// 模型可以立即加入 Scene 渲染（还没有就绪的贴图按材质的默认值绘制），之后每帧调用 update()，
+// 解码完成的纹理逐张绑定到材质上。同一时间只有一个模型在异步加载（ResourceLoader 的限制），
+// 开始下一次加载前会先同步完成上一个。异步加载中途 destroy() 时取消还没开始的解码。
+// 必须在 Engine 销毁之前销毁 GltfLoader 和它加载的所有模型。
+class GltfLoader {
+public:
+    // textureThreads 为 0 时使用全部硬件线程
+    explicit GltfLoader(filament::Engine& engine, uint32_t textureThreads = 0);
+    ~GltfLoader();
+
+    GltfLoader(const GltfLoader&) = delete;
+    GltfLoader& operator=(const GltfLoader&) = delete;
+
+    // 加载失败时打印原因并返回 nullptr。返回的模型还没有加入任何 Scene
+    filament::gltfio::FilamentAsset* load(const std::string& path);
+
+    // 从资源包加载，path 为包内路径。glTF 本身和外部 buffer/纹理都直接引用映射内存，
+    // 不经过文件系统；资源包必须比 Engine 活得更久
+    filament::gltfio::FilamentAsset* load(const PackFile& pack, const std::string& path);
+
+    // 从内存加载不引用外部文件的 .glb（例如内嵌的 DamagedHelmet），name 只用于错误信息。
+    // data 在返回后即可释放
+    filament::gltfio::FilamentAsset* load(const uint8_t* data, size_t size, const std::string& name);
+
+    // 异步加载，纹理由 update() 逐帧上传。失败时打印原因并返回 nullptr
+    filament::gltfio::FilamentAsset* loadAsync(const std::string& path);
+    filament::gltfio::FilamentAsset* loadAsync(const PackFile& pack, const std::string& path);
+    filament::gltfio::FilamentAsset* loadAsync(const uint8_t* data, size_t size, const std::string& name);
+
+    // 在引擎线程上每帧调用，绑定已经解码的纹理，返回异步加载的进度 [0, 1]。没有异步加载时返回 1
+    float update();
+
+    // 正在异步加载的模型，没有时为 nullptr
+    filament::gltfio::FilamentAsset* getPendingAsset() const noexcept { return mPending; }
+
+    GltfTextureProvider& getTextureProvider() noexcept { return *mImageProvider; }
+
+    void destroy(filament::gltfio::FilamentAsset* asset);
+
+private:
+    filament::gltfio::FilamentAsset* loadFile(const std::string& path, bool async);
+    filament::gltfio::FilamentAsset* loadPack(const PackFile& pack, const std::string& path, bool async);
+    filament::gltfio::FilamentAsset* loadMemory(const uint8_t* data, size_t size, const std::string& name,
+            bool async);
+
+    // 把外部 buffer/图片放进 ResourceLoader 的 URI 缓存，图片按 URI 登记用途
+    void addResource(const char* uri, const void* data, size_t size);
+
+    // 加载外部资源，同步时还释放 glTF 源数据。失败时销毁 asset 并返回 nullptr
+    filament::gltfio::FilamentAsset* startLoad(filament::gltfio::FilamentAsset* asset,
+            const std::string& path, bool async);
+    // 清空 URI 缓存和读入的文件，释放 glTF 源数据
+    void finishLoad(filament::gltfio::FilamentAsset* asset);
+    // 同步完成正在进行的异步加载
+    void finishPending();
+    // 取消正在进行的加载，丢弃 provider 中剩余的纹理
+    void cancelLoad();
+
+    filament::Engine& mEngine;
+    filament::gltfio::MaterialProvider* mMaterials = nullptr;
+    filament::gltfio::AssetLoader* mAssetLoader = nullptr;
+    filament::gltfio::ResourceLoader* mResourceLoader = nullptr;
+    GltfTextureProvider* mImageProvider = nullptr;
+    filament::gltfio::TextureProvider* mKtx2Provider = nullptr;
+    filament::gltfio::FilamentAsset* mPending = nullptr;
+    std::vector<std::vector<uint8_t>> mFiles;   // load(path) 读入的外部文件，加载完成后释放
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_GLTFLOADER_H
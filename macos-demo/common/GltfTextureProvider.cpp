@@ -0,0 +1,374 @@
+#include "GltfTextureProvider.h"
+#include "Parallel.h"
+#include "Trace.h"
+
+#include <filament/Engine.h>
+#include <filament/Texture.h>
+
+#include <algorithm>
+#include <chrono>
+
+// filament 发行包带有 libstb.a，但没有安装 stb_image.h，这里声明用到的函数
+extern "C" {
+unsigned char* stbi_load_from_memory(const unsigned char* buffer, int length, int* x, int* y,
+        int* channelsInFile, int desiredChannels);
+int stbi_info_from_memory(const unsigned char* buffer, int length, int* x, int* y, int* comp);
+const char* stbi_failure_reason(void);
+void stbi_image_free(void* data);
+}
+
+using namespace filament;
+using filament::gltfio::TextureProvider;
+
+namespace demo {
+
+struct GltfTextureProvider::Job {
+    Texture* texture = nullptr;
+    std::vector<uint8_t> source;        // pushTexture() 的数据不能保留指针，拷贝一份
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool srgb = false;
+    TextureRole role = TextureRole::OCCLUSION_ROUGHNESS_METALLIC;
+    uint64_t sequence = 0;
+
+    uint8_t* decoded = nullptr;         // 由 stbi_image_free() 释放
+    size_t reservedBytes = 0;           // 计入 mPendingBytes 的字节数
+    std::string error;                  // 解码失败或取消时的 getPopMessage()
+
+    size_t decodedSize() const noexcept { return size_t(width) * height * 4; }
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 按 TextureRole、像素数（大的优先）、推入顺序比较，a 应该先于 b 解码时返回 true
+template<typename JobPtr>
+bool decodesBefore(const JobPtr& a, const JobPtr& b) {
+    if (a->role != b->role) {
+        return a->role < b->role;
+    }
+    const uint64_t pixelsA = uint64_t(a->width) * a->height;
+    const uint64_t pixelsB = uint64_t(b->width) * b->height;
+    if (pixelsA != pixelsB) {
+        return pixelsA > pixelsB;
+    }
+    return a->sequence < b->sequence;
+}
+
+// std::push_heap/pop_heap 是大根堆，堆顶是 decodesBefore 意义下最先解码的任务
+struct HeapOrder {
+    template<typename JobPtr>
+    bool operator()(const JobPtr& a, const JobPtr& b) const {
+        return decodesBefore(b, a);
+    }
+};
+
+} // anonymous namespace
+
+// 每个工作线程一个按优先级排列的堆。所有者和偷任务的线程都从堆顶取，
+// 各个队列的任务都按全局的优先级顺序开始解码
+struct GltfTextureProvider::WorkerQueue {
+    std::mutex lock;
+    std::vector<std::unique_ptr<Job>> jobs;
+};
+
+// ========================================
+// 构造与销毁
+// ========================================
+
+GltfTextureProvider::GltfTextureProvider(Engine& engine, uint32_t threadCount, size_t maxDecodedBytes)
+        : mEngine(engine), mMaxDecodedBytes(maxDecodedBytes) {
+    const uint32_t workers = resolveThreadCount(threadCount);
+    for (uint32_t i = 0; i < workers; i++) {
+        mQueues.emplace_back(new WorkerQueue());
+    }
+    mWorkers.reserve(workers);
+    for (uint32_t i = 0; i < workers; i++) {
+        mWorkers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+GltfTextureProvider::~GltfTextureProvider() {
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        mStopping = true;
+    }
+    mWorkCondition.notify_all();
+    for (auto& worker : mWorkers) {
+        worker.join();
+    }
+    // Texture 归 ResourceLoader 所在的 FilamentAsset 所有，这里只释放还没有上传的像素
+    for (auto& job : mDecoded) {
+        if (job->decoded) {
+            stbi_image_free(job->decoded);
+        }
+    }
+}
+
+void GltfTextureProvider::setRole(const void* data, TextureRole role) {
+    mRoles[data] = role;
+}
+
+void GltfTextureProvider::clearRoles() {
+    mRoles.clear();
+}
+
+// ========================================
+// 引擎线程：推入、上传、弹出
+// ========================================
+
+TextureProvider::Texture* GltfTextureProvider::pushTexture(const uint8_t* data, size_t byteCount,
+        const char* mimeType, TextureFlags flags) {
+    TRACE_CALL();
+    mPushMessage.clear();
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    if (!stbi_info_from_memory(data, int(byteCount), &width, &height, &channels)) {
+        const char* reason = stbi_failure_reason();
+        mPushMessage = std::string("Unable to parse ") + (mimeType ? mimeType : "image") + ": "
+                + (reason ? reason : "unknown error");
+        return nullptr;
+    }
+
+    std::unique_ptr<Job> job(new Job());
+    job->width = uint32_t(width);
+    job->height = uint32_t(height);
+    job->srgb = any(flags & TextureFlags::sRGB);
+    // levels 超出上限时 Builder 会截断到完整 mip 链的层数，updateQueue() 生成其余层级
+    job->texture = Texture::Builder()
+        .width(job->width)
+        .height(job->height)
+        .levels(0xff)
+        .format(job->srgb ? Texture::InternalFormat::SRGB8_A8 : Texture::InternalFormat::RGBA8)
+        .build(mEngine);
+    if (!job->texture) {
+        mPushMessage = "Unable to build Texture object";
+        return nullptr;
+    }
+    job->source.assign(data, data + byteCount);
+    const auto role = mRoles.find(data);
+    job->role = role != mRoles.end() ? role->second
+            : job->srgb ? TextureRole::BASE_COLOR : TextureRole::OCCLUSION_ROUGHNESS_METALLIC;
+    Texture* texture = job->texture;
+
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        job->sequence = mSequence++;
+        // 轮流放进各个工作线程的队列，空闲的线程会把其余队列的任务偷走
+        WorkerQueue& queue = *mQueues[job->sequence % mQueues.size()];
+        {
+            std::lock_guard<std::mutex> queueGuard(queue.lock);
+            queue.jobs.push_back(std::move(job));
+            std::push_heap(queue.jobs.begin(), queue.jobs.end(), HeapOrder());
+        }
+        mQueued++;
+        mStats.pushed++;
+    }
+    mWorkCondition.notify_one();
+    mPushedCount++;
+    return texture;
+}
+
+void GltfTextureProvider::upload(Job& job) {
+    if (!job.decoded) {
+        return;
+    }
+    TRACE_NAME("GltfTextureProvider::upload");
+    uint8_t* decoded = job.decoded;
+    job.decoded = nullptr;
+    job.texture->setImage(mEngine, 0, Texture::PixelBufferDescriptor(decoded, job.decodedSize(),
+            Texture::Format::RGBA, Texture::Type::UBYTE,
+            [](void* buffer, size_t, void*) { stbi_image_free(buffer); }));
+    job.texture->generateMipmaps(mEngine);
+}
+
+size_t GltfTextureProvider::uploadDecoded(std::unique_lock<std::mutex>& lock) {
+    if (mDecoded.empty()) {
+        return 0;
+    }
+    std::vector<std::unique_ptr<Job>> decoded;
+    decoded.swap(mDecoded);
+    lock.unlock();
+
+    size_t releasedBytes = 0;
+    for (auto& job : decoded) {
+        upload(*job);
+        releasedBytes += job->reservedBytes;
+        job->reservedBytes = 0;
+        mPoppable.push_back(std::move(job));
+        mDecodedCount++;
+    }
+
+    // 像素交给 setImage() 后由 Engine 持有，这里就把额度还给工作线程
+    lock.lock();
+    mPendingBytes -= releasedBytes;
+    if (releasedBytes) {
+        mWorkCondition.notify_all();
+    }
+    return decoded.size();
+}
+
+void GltfTextureProvider::updateQueue() {
+    std::unique_lock<std::mutex> lock(mLock);
+    uploadDecoded(lock);
+}
+
+TextureProvider::Texture* GltfTextureProvider::popTexture() {
+    mPopMessage.clear();
+    if (mPoppable.empty()) {
+        return nullptr;
+    }
+    std::unique_ptr<Job> job = std::move(mPoppable.front());
+    mPoppable.pop_front();
+    mPopMessage = job->error;
+    mPoppedCount++;
+    return job->texture;
+}
+
+const char* GltfTextureProvider::getPushMessage() const {
+    return mPushMessage.empty() ? nullptr : mPushMessage.c_str();
+}
+
+const char* GltfTextureProvider::getPopMessage() const {
+    return mPopMessage.empty() ? nullptr : mPopMessage.c_str();
+}
+
+void GltfTextureProvider::waitForCompletion() {
+    TRACE_CALL();
+    std::unique_lock<std::mutex> lock(mLock);
+    for (;;) {
+        // 超过 maxDecodedBytes 而暂停的工作线程要等这里上传释放额度，等待时也要上传
+        uploadDecoded(lock);
+        if (!mQueued && !mRunning && mDecoded.empty()) {
+            return;
+        }
+        mDoneCondition.wait(lock, [this]() { return !mDecoded.empty() || (!mQueued && !mRunning); });
+    }
+}
+
+void GltfTextureProvider::cancelDecoding() {
+    TRACE_CALL();
+    std::unique_lock<std::mutex> lock(mLock);
+    for (auto& queue : mQueues) {
+        std::lock_guard<std::mutex> queueGuard(queue->lock);
+        for (auto& job : queue->jobs) {
+            job->error = "Texture decoding was cancelled";
+            job->source = std::vector<uint8_t>();
+            mDecoded.push_back(std::move(job));
+            mStats.cancelled++;
+        }
+        mQueued -= queue->jobs.size();
+        queue->jobs.clear();
+    }
+    // 已经开始的任务不能中断，等它们解码完。取消的任务在下一次 updateQueue() 后可以弹出
+    mDoneCondition.wait(lock, [this]() { return !mQueued && !mRunning; });
+}
+
+size_t GltfTextureProvider::getPushedCount() const {
+    return mPushedCount;
+}
+
+size_t GltfTextureProvider::getPoppedCount() const {
+    return mPoppedCount;
+}
+
+size_t GltfTextureProvider::getDecodedCount() const {
+    return mDecodedCount;
+}
+
+GltfTextureStats GltfTextureProvider::getStats() const {
+    std::lock_guard<std::mutex> guard(mLock);
+    return mStats;
+}
+
+// ========================================
+// 工作线程
+// ========================================
+
+std::unique_ptr<GltfTextureProvider::Job> GltfTextureProvider::takeJob(size_t index, bool& stolen) {
+    // 先取自己队列的堆顶，队列空了再依次看其他线程的队列
+    for (size_t i = 0; i < mQueues.size(); i++) {
+        WorkerQueue& queue = *mQueues[(index + i) % mQueues.size()];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.jobs.empty()) {
+            continue;
+        }
+        std::pop_heap(queue.jobs.begin(), queue.jobs.end(), HeapOrder());
+        std::unique_ptr<Job> job = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        stolen = i != 0;
+        return job;
+    }
+    return nullptr;
+}
+
+void GltfTextureProvider::workerLoop(size_t index) {
+    std::unique_lock<std::mutex> lock(mLock);
+    for (;;) {
+        // 已经有像素等着上传时，超过额度就不再开始新的解码
+        auto overBudget = [this]() { return mPendingBytes && mPendingBytes >= mMaxDecodedBytes; };
+        if (mQueued && overBudget()) {
+            mStats.budgetWaits++;
+        }
+        mWorkCondition.wait(lock, [&]() { return mStopping || (mQueued && !overBudget()); });
+        if (mStopping) {
+            return;
+        }
+
+        // 不能持有 mLock 去锁队列：pushTexture() 和 cancelDecoding() 是先锁 mLock 再锁队列
+        lock.unlock();
+        bool stolen = false;
+        std::unique_ptr<Job> job = takeJob(index, stolen);
+        lock.lock();
+        if (!job) {
+            // 任务被别的线程取走了
+            continue;
+        }
+        mStats.steals += stolen ? 1 : 0;
+        mQueued--;
+        mRunning++;
+        job->reservedBytes = job->decodedSize();
+        mPendingBytes += job->reservedBytes;
+        mStats.peakPendingBytes = std::max<uint64_t>(mStats.peakPendingBytes, mPendingBytes);
+        lock.unlock();
+
+        const auto start = Clock::now();
+        {
+            TRACE_NAME("GltfTextureProvider::decode");
+            int width = 0;
+            int height = 0;
+            int channels = 0;
+            job->decoded = stbi_load_from_memory(job->source.data(), int(job->source.size()),
+                    &width, &height, &channels, 4);
+            if (!job->decoded) {
+                const char* reason = stbi_failure_reason();
+                job->error = std::string("Unable to decode texture: ") + (reason ? reason : "unknown error");
+            } else if (uint32_t(width) != job->width || uint32_t(height) != job->height) {
+                job->error = "Decoded texture size does not match the header";
+                stbi_image_free(job->decoded);
+                job->decoded = nullptr;
+            }
+        }
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        job->source = std::vector<uint8_t>();
+
+        lock.lock();
+        mRunning--;
+        mStats.decodeMs += ms;
+        if (job->decoded) {
+            mStats.decoded++;
+            mStats.decodedBytes += job->decodedSize();
+        } else {
+            mStats.failed++;
+            mPendingBytes -= job->reservedBytes;
+            job->reservedBytes = 0;
+            mWorkCondition.notify_all();
+        }
+        mDecoded.push_back(std::move(job));
+        mDoneCondition.notify_all();
+    }
+}
+
+} // namespace demo
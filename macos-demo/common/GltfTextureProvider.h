@@ -0,0 +1,128 @@
+#ifndef DEMO_COMMON_GLTFTEXTUREPROVIDER_H
+#define DEMO_COMMON_GLTFTEXTUREPROVIDER_H
+
+#include <gltfio/TextureProvider.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace demo {
+
+// ========================================
+// glTF 纹理并行解码
+// ========================================
+// gltfio 自带的 createStbProvider() 按推入顺序解码 PNG/JPEG，ResourceLoader 看到的纹理一张一张出现。
+// GltfTextureProvider 实现同样的 TextureProvider 接口：
+//
+//   1. pushTexture() 在引擎线程上用 stbi_info 读出尺寸，创建 Texture，把解码任务放进某个工作线程的队列
+//   2. 每个工作线程先取自己队列中优先级最高的任务，队列空了就从其他线程的队列里偷优先级最高的任务
+//   3. updateQueue() 在引擎线程上 setImage() 并生成 mip 链，纹理随即可以 popTexture()
+//
+// 优先级依次比较纹理用途（基础色先于法线，法线先于遮蔽/粗糙度/金属度）、像素数（大的先解码）和推入顺序。
+// TextureProvider 接口只带 sRGB 标志：sRGB 纹理视为基础色（自发光也在其中），其余默认视为遮蔽/粗糙度/金属度，
+// 调用者可以在 pushTexture() 之前用 setRole() 按数据指针指定用途（GltfLoader 按图片 URI 推断）。
+// gltfio 不告诉 provider 纹理贴在哪个图元上，像素数是屏幕占比的近似：模型上大块表面通常用大贴图。
+//
+// 正在解码和已解码、还没有交给 setImage() 的像素总量达到 maxDecodedBytes 后工作线程暂停开始新的解码，
+// 等引擎线程上传释放额度，避免几十张 4K 贴图同时解码撑爆内存。
+// cancelDecoding() 丢弃还没开始的任务，ResourceLoader::asyncCancelLoad() 调用它，
+// GltfLoader 在异步加载中途销毁模型时由此取消该模型剩余的解码。
+//
+// 除 getStats() 外所有方法都只在引擎线程上调用。必须先于 Engine 销毁。
+
+// 纹理用途，数值越小越先解码
+enum class TextureRole : uint8_t {
+    BASE_COLOR,
+    NORMAL,
+    OCCLUSION_ROUGHNESS_METALLIC,
+};
+
+struct GltfTextureStats {
+    uint32_t pushed = 0;
+    uint32_t decoded = 0;
+    uint32_t failed = 0;
+    uint32_t cancelled = 0;
+    uint32_t steals = 0;                // 从其他工作线程队列偷来的任务数
+    uint32_t budgetWaits = 0;           // 因为超过 maxDecodedBytes 暂停解码的次数
+    uint64_t decodedBytes = 0;          // 解码出的 RGBA 像素总字节数
+    uint64_t peakPendingBytes = 0;      // 同时存在的已解码（和正在解码）像素的最大字节数
+    double decodeMs = 0.0;              // 工作线程上的解码总耗时
+};
+
+class GltfTextureProvider final : public filament::gltfio::TextureProvider {
+public:
+    // threadCount 为 0 时使用全部硬件线程
+    explicit GltfTextureProvider(filament::Engine& engine, uint32_t threadCount = 0,
+            size_t maxDecodedBytes = 256u << 20);
+    ~GltfTextureProvider() override;
+
+    GltfTextureProvider(const GltfTextureProvider&) = delete;
+    GltfTextureProvider& operator=(const GltfTextureProvider&) = delete;
+
+    // 指定以 data 开头的图片的用途，之后 pushTexture() 收到同一个指针时使用
+    void setRole(const void* data, TextureRole role);
+    void clearRoles();
+
+    Texture* pushTexture(const uint8_t* data, size_t byteCount, const char* mimeType,
+            TextureFlags flags) override;
+    Texture* popTexture() override;
+    void updateQueue() override;
+    const char* getPushMessage() const override;
+    const char* getPopMessage() const override;
+    void waitForCompletion() override;
+    void cancelDecoding() override;
+    size_t getPushedCount() const override;
+    size_t getPoppedCount() const override;
+    size_t getDecodedCount() const override;
+
+    uint32_t getThreadCount() const noexcept { return uint32_t(mWorkers.size()); }
+    GltfTextureStats getStats() const;
+
+private:
+    // 一张纹理的解码任务，从工作线程队列经过解码进入 mDecoded，上传后进入 mPoppable
+    struct Job;
+    struct WorkerQueue;
+
+    void workerLoop(size_t index);
+    // 先取自己队列的任务，队列空了从其他队列偷，stolen 表示是否偷来的
+    std::unique_ptr<Job> takeJob(size_t index, bool& stolen);
+    void upload(Job& job);
+    // 上传所有已解码的任务，返回上传的数量。调用时持有 mLock
+    size_t uploadDecoded(std::unique_lock<std::mutex>& lock);
+
+    filament::Engine& mEngine;
+    std::vector<std::unique_ptr<WorkerQueue>> mQueues;
+    std::vector<std::thread> mWorkers;
+    std::unordered_map<const void*, TextureRole> mRoles;
+    const size_t mMaxDecodedBytes;
+    uint64_t mSequence = 0;
+
+    std::string mPushMessage;
+    std::string mPopMessage;
+    std::deque<std::unique_ptr<Job>> mPoppable;     // 只在引擎线程上访问
+    size_t mPushedCount = 0;
+    size_t mPoppedCount = 0;
+    size_t mDecodedCount = 0;
+
+    mutable std::mutex mLock;
+    std::condition_variable mWorkCondition;     // 有新任务或释放了解码内存
+    std::condition_variable mDoneCondition;     // 有任务解码完成
+    std::vector<std::unique_ptr<Job>> mDecoded;
+    size_t mQueued = 0;         // 还在队列中的任务数
+    size_t mRunning = 0;        // 正在解码的任务数
+    size_t mPendingBytes = 0;   // 正在解码和已解码未上传的像素字节数
+    bool mStopping = false;
+    GltfTextureStats mStats;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_GLTFTEXTUREPROVIDER_H
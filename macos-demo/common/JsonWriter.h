@@ -0,0 +1,106 @@
+#ifndef DEMO_COMMON_JSONWRITER_H
+#define DEMO_COMMON_JSONWRITER_H
+
+#include <cmath>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace demo {
+
+// ========================================
+// 极简的流式 JSON 输出工具
+// ========================================
+// 基准测试、性能报告等工具都需要输出机器可读的结果，
+// 这里只实现写入（不做解析），自动处理逗号和字符串转义。
+//
+// 用法：
+//   JsonWriter json(std::cout);
+//   json.beginObject();
+//   json.key("frames").value(100);
+//   json.endObject();
+class JsonWriter {
+public:
+    explicit JsonWriter(std::ostream& out) : mOut(out) {}
+
+    JsonWriter& beginObject() { prefix(); mOut << '{'; mFirst.push_back(true); return *this; }
+    JsonWriter& endObject()   { mFirst.pop_back(); mOut << '}'; return *this; }
+    JsonWriter& beginArray()  { prefix(); mOut << '['; mFirst.push_back(true); return *this; }
+    JsonWriter& endArray()    { mFirst.pop_back(); mOut << ']'; return *this; }
+
+    // 写入对象的键，下一次 value()/beginObject()/beginArray() 写入对应的值
+    JsonWriter& key(const char* name) {
+        prefix();
+        writeString(name);
+        mOut << ':';
+        mAfterKey = true;
+        return *this;
+    }
+
+    JsonWriter& value(const char* s)        { prefix(); writeString(s); return *this; }
+    JsonWriter& value(const std::string& s) { return value(s.c_str()); }
+    JsonWriter& value(bool b)               { prefix(); mOut << (b ? "true" : "false"); return *this; }
+    // 整数按基础类型重载，避免 size_t/uint64_t 在不同平台上的二义性
+    JsonWriter& value(int v)                { prefix(); mOut << v; return *this; }
+    JsonWriter& value(unsigned v)           { prefix(); mOut << v; return *this; }
+    JsonWriter& value(long v)               { prefix(); mOut << v; return *this; }
+    JsonWriter& value(unsigned long v)      { prefix(); mOut << v; return *this; }
+    JsonWriter& value(long long v)          { prefix(); mOut << v; return *this; }
+    JsonWriter& value(unsigned long long v) { prefix(); mOut << v; return *this; }
+    JsonWriter& value(double v) {
+        prefix();
+        // JSON 不支持 NaN/Inf，统一输出 null
+        if (std::isfinite(v)) {
+            mOut << v;
+        } else {
+            mOut << "null";
+        }
+        return *this;
+    }
+
+private:
+    // 在同一层级的元素之间插入逗号
+    void prefix() {
+        if (mAfterKey) {
+            mAfterKey = false;
+            return;
+        }
+        if (!mFirst.empty()) {
+            if (!mFirst.back()) {
+                mOut << ',';
+            }
+            mFirst.back() = false;
+        }
+    }
+
+    void writeString(const char* s) {
+        mOut << '"';
+        for (; *s; ++s) {
+            const char c = *s;
+            switch (c) {
+                case '"':  mOut << "\\\""; break;
+                case '\\': mOut << "\\\\"; break;
+                case '\n': mOut << "\\n";  break;
+                case '\r': mOut << "\\r";  break;
+                case '\t': mOut << "\\t";  break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        static const char* HEX = "0123456789abcdef";
+                        mOut << "\\u00" << HEX[(c >> 4) & 0xF] << HEX[c & 0xF];
+                    } else {
+                        mOut << c;
+                    }
+                    break;
+            }
+        }
+        mOut << '"';
+    }
+
+    std::ostream& mOut;
+    std::vector<bool> mFirst;   // 每一层是否还没有写入元素
+    bool mAfterKey = false;     // 刚写完键，下一个值不需要逗号
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_JSONWRITER_H
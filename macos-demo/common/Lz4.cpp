@@ -0,0 +1,156 @@
+#include "Lz4.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace demo {
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+// LZ4 规范：最后 5 个字节必须是字面量，最后一个匹配必须在结尾 12 字节之前开始
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MATCH_FIND_LIMIT = 12;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr unsigned HASH_BITS = 16;
+constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hash32(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// 长度字段超过 15 时，余下部分以 255 为单位追加
+void writeLength(std::vector<uint8_t>& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(uint8_t(length));
+}
+
+void writeSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalLength,
+        size_t offset, size_t matchLength) {
+    const size_t matchCode = matchLength ? matchLength - MIN_MATCH : 0;
+    out.push_back(uint8_t((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literalLength >= 15) {
+        writeLength(out, literalLength - 15);
+    }
+    out.insert(out.end(), literals, literals + literalLength);
+    if (matchLength) {
+        out.push_back(uint8_t(offset));
+        out.push_back(uint8_t(offset >> 8));
+        if (matchCode >= 15) {
+            writeLength(out, matchCode - 15);
+        }
+    }
+}
+
+} // anonymous namespace
+
+std::vector<uint8_t> lz4Compress(const uint8_t* data, size_t size) {
+    std::vector<uint8_t> out;
+    out.reserve(size / 2 + 16);
+
+    size_t anchor = 0;
+    if (size > MATCH_FIND_LIMIT) {
+        std::vector<uint32_t> table(size_t(1) << HASH_BITS, EMPTY_SLOT);
+        const size_t searchLimit = size - MATCH_FIND_LIMIT;
+        const size_t matchLimit = size - LAST_LITERALS;
+        size_t position = 0;
+        while (position < searchLimit) {
+            const uint32_t sequence = read32(data + position);
+            uint32_t& slot = table[hash32(sequence)];
+            const uint32_t candidate = slot;
+            slot = uint32_t(position);
+            if (candidate == EMPTY_SLOT || position - candidate > MAX_OFFSET ||
+                    read32(data + candidate) != sequence) {
+                position++;
+                continue;
+            }
+
+            size_t length = MIN_MATCH;
+            while (position + length < matchLimit && data[candidate + length] == data[position + length]) {
+                length++;
+            }
+            writeSequence(out, data + anchor, position - anchor, position - candidate, length);
+            position += length;
+            anchor = position;
+        }
+    }
+    // 最后一段只有字面量
+    writeSequence(out, data + anchor, size - anchor, 0, 0);
+    return out;
+}
+
+bool lz4Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    const uint8_t* in = src;
+    const uint8_t* const inEnd = src + srcSize;
+    uint8_t* out = dst;
+    uint8_t* const outEnd = dst + dstSize;
+
+    const auto readLength = [&in, inEnd](size_t& length) {
+        uint8_t byte;
+        do {
+            if (in >= inEnd) {
+                return false;
+            }
+            byte = *in++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (in < inEnd) {
+        const uint8_t token = *in++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(literalLength)) {
+            return false;
+        }
+        if (literalLength > size_t(inEnd - in) || literalLength > size_t(outEnd - out)) {
+            return false;
+        }
+        if (literalLength) {
+            std::memcpy(out, in, literalLength);
+        }
+        in += literalLength;
+        out += literalLength;
+
+        // 最后一个序列没有匹配部分
+        if (in == inEnd) {
+            break;
+        }
+
+        if (inEnd - in < 2) {
+            return false;
+        }
+        const size_t offset = size_t(in[0]) | (size_t(in[1]) << 8);
+        in += 2;
+        if (offset == 0 || offset > size_t(out - dst)) {
+            return false;
+        }
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (matchLength > size_t(outEnd - out)) {
+            return false;
+        }
+        // 匹配可能和输出重叠（offset < matchLength），必须逐字节复制
+        const uint8_t* match = out - offset;
+        for (size_t i = 0; i < matchLength; i++) {
+            out[i] = match[i];
+        }
+        out += matchLength;
+    }
+    return out == outEnd;
+}
+
+} // namespace demo
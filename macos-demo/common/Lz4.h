@@ -0,0 +1,26 @@
+#ifndef DEMO_COMMON_LZ4_H
+#define DEMO_COMMON_LZ4_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace demo {
+
+// ========================================
+// LZ4 块格式编解码
+// ========================================
+// 只实现 LZ4 block format（不含 frame 头和校验），输出可以被标准 LZ4_decompress_safe() 解码。
+// 压缩使用单哈希表的贪心匹配，速度和压缩率与 LZ4 默认级别相近；
+// 解压逐字节检查边界，损坏的数据不会越界读写。
+// filament 自带的 zstd 静态库没有随 SDK 发布头文件，这里用一个不依赖第三方库的实现。
+
+// 压缩 size 字节，返回压缩后的数据（不可压缩时可能比输入稍大）
+std::vector<uint8_t> lz4Compress(const uint8_t* data, size_t size);
+
+// 解压到 dst，dstSize 必须等于原始大小。数据损坏或大小不符时返回 false
+bool lz4Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+} // namespace demo
+
+#endif // DEMO_COMMON_LZ4_H
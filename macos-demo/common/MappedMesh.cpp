@@ -0,0 +1,140 @@
+#include "MappedMesh.h"
+#include "Filamesh.h"
+#include "MemoryLedger.h"
+#include "PackFile.h"
+#include "Trace.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+using namespace filament;
+using namespace filamesh;
+
+namespace demo {
+
+namespace {
+
+// 一段文件映射，作为 MeshReader 回调的 user 参数，在回调中释放
+struct Mapping {
+    void* address = nullptr;
+    size_t size = 0;
+};
+
+void unmap(Mapping* mapping) {
+    munmap(mapping->address, mapping->size);
+    delete mapping;
+}
+
+// 只读映射整个文件，失败时打印原因并返回 nullptr
+Mapping* mapFile(const std::string& path) {
+    TRACE_NAME("mapFile");
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open filamesh file: " << path << " (" << std::strerror(errno) << ")"
+                  << std::endl;
+        return nullptr;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(FilameshHeader)) {
+        std::cerr << "Not a filamesh file: " << path << std::endl;
+        close(fd);
+        return nullptr;
+    }
+    const size_t size = size_t(info.st_size);
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // 映射建立后文件描述符就不再需要了
+    close(fd);
+    if (address == MAP_FAILED) {
+        std::cerr << "Failed to map filamesh file: " << path << " (" << std::strerror(errno) << ")"
+                  << std::endl;
+        return nullptr;
+    }
+    // MeshReader 和上传都是从头到尾顺序读取
+    madvise(address, size, MADV_SEQUENTIAL);
+    return new Mapping{ address, size };
+}
+
+// 校验文件头后交给 MeshReader。返回 false 时 MeshReader 没有接管 data（包括 MeshReader 加载失败），
+// destructor 不会被调用，由调用者释放
+bool loadFromBuffer(Engine& engine, const void* data, size_t size,
+        MeshReader::Callback destructor, void* user, MaterialInstance* material,
+        MappedMesh& result) {
+    result.fileSize = size;
+    if (size < sizeof(FilameshHeader) ||
+            !MemoryLedger::readFilameshFootprint(data, &result.vertexBytes, &result.indexType)) {
+        std::cerr << "Not a filamesh file: " << result.path << std::endl;
+        return false;
+    }
+
+    TRACE_NAME("MeshReader::loadMeshFromBuffer");
+    result.mesh = MeshReader::loadMeshFromBuffer(&engine, data, destructor, user, material);
+    if (!result.isValid()) {
+        std::cerr << "Failed to load mesh from filamesh file: " << result.path << std::endl;
+    }
+    return result.isValid();
+}
+
+// 把映射交给 MeshReader，映射的所有权随之转移
+void loadFromMapping(Engine& engine, Mapping* mapping, MaterialInstance* material,
+        MappedMesh& result) {
+    if (!loadFromBuffer(engine, mapping->address, mapping->size,
+            [](void*, size_t, void* user) { unmap(static_cast<Mapping*>(user)); },
+            mapping, material, result)) {
+        unmap(mapping);
+    }
+}
+
+} // anonymous namespace
+
+MappedMesh loadMappedMesh(Engine& engine, const std::string& path, MaterialInstance* material) {
+    MappedMesh result;
+    result.path = path;
+    if (Mapping* mapping = mapFile(path)) {
+        loadFromMapping(engine, mapping, material, result);
+    }
+    return result;
+}
+
+MappedMesh loadMappedMesh(Engine& engine, const PackFile& pack, const std::string& name,
+        MaterialInstance* material) {
+    MappedMesh result;
+    result.path = name;
+    const PackView data = pack.find(name);
+    if (!data) {
+        std::cerr << "Filamesh not found in pack: " << name << std::endl;
+        return result;
+    }
+    // 资源包本身就是映射内存，并且比 Engine 活得更久，不需要回调
+    loadFromBuffer(engine, data.data, data.size, nullptr, nullptr, material, result);
+    return result;
+}
+
+std::vector<MappedMesh> loadMappedMeshes(Engine& engine, const std::vector<std::string>& paths,
+        MaterialInstance* material) {
+    TRACE_NAME("loadMappedMeshes");
+    // 先映射全部文件并请求预读，内核在后台把后面的文件读进页缓存
+    std::vector<Mapping*> mappings(paths.size(), nullptr);
+    for (size_t i = 0; i < paths.size(); i++) {
+        mappings[i] = mapFile(paths[i]);
+        if (mappings[i]) {
+            madvise(mappings[i]->address, mappings[i]->size, MADV_WILLNEED);
+        }
+    }
+
+    std::vector<MappedMesh> results(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        results[i].path = paths[i];
+        if (mappings[i]) {
+            loadFromMapping(engine, mappings[i], material, results[i]);
+        }
+    }
+    return results;
+}
+
+} // namespace demo
@@ -0,0 +1,59 @@
+#ifndef DEMO_COMMON_MAPPEDMESH_H
+#define DEMO_COMMON_MAPPEDMESH_H
+
+#include <filament/IndexBuffer.h>
+
+#include <filameshio/MeshReader.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace filament {
+class Engine;
+class MaterialInstance;
+}
+
+namespace demo {
+
+class PackFile;
+
+// ========================================
+// 内存映射的 filamesh 加载
+// ========================================
+// 用 mmap 把 filamesh 文件映射进来，直接把映射地址交给 MeshReader::loadMeshFromBuffer，
+// 在 MeshReader 的回调（上传完成后）里 munmap。
+// 和读入 std::string 相比少一次整文件拷贝，文件页是可丢弃的干净页，加载期间的内存峰值减半。
+//
+// 映射在 Engine 处理完上传命令之后才会释放，所以必须在 Engine 销毁之前
+// 至少调用一次 flushAndWait()（销毁 Engine 本身也会做这一步）。
+struct MappedMesh {
+    std::string path;
+    filamesh::MeshReader::Mesh mesh;
+    size_t fileSize = 0;
+    // 从 filamesh 文件头读出的上传大小，供 MemoryLedger::addVertexBuffer()/addIndexBuffer() 使用。
+    // 映射在上传后就会解除，加载之后不能再从数据里读取
+    uint64_t vertexBytes = 0;
+    filament::IndexBuffer::IndexType indexType = filament::IndexBuffer::IndexType::UINT;
+
+    bool isValid() const noexcept { return !mesh.renderable.isNull(); }
+};
+
+// 加载一个 filamesh 文件，所有图元使用 material（为空时使用 MeshReader 的默认材质）。
+// 失败时打印原因，返回的 MappedMesh::isValid() 为 false
+MappedMesh loadMappedMesh(filament::Engine& engine, const std::string& path,
+        filament::MaterialInstance* material);
+
+// 从资源包中按包内路径加载。资源包已经整体映射，数据直接交给 MeshReader，不做拷贝也不再单独映射
+MappedMesh loadMappedMesh(filament::Engine& engine, const PackFile& pack, const std::string& name,
+        filament::MaterialInstance* material);
+
+// 批量加载：先映射所有文件并提示内核预读，再逐个交给 MeshReader，
+// 后面文件的磁盘读取和前面文件的解析/上传可以重叠。结果与 paths 一一对应
+std::vector<MappedMesh> loadMappedMeshes(filament::Engine& engine,
+        const std::vector<std::string>& paths, filament::MaterialInstance* material);
+
+} // namespace demo
+
+#endif // DEMO_COMMON_MAPPEDMESH_H
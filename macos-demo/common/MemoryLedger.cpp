@@ -0,0 +1,321 @@
+#include "MemoryLedger.h"
+#include "Filamesh.h"
+#include "JsonWriter.h"
+#include "ProcessMemory.h"
+
+#include <filament/Engine.h>
+#include <filament/MorphTargetBuffer.h>
+#include <filament/Texture.h>
+#include <filament/VertexBuffer.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+using namespace filament;
+
+namespace demo {
+
+namespace {
+
+using Format = Texture::InternalFormat;
+
+// 一个像素块的尺寸和字节数，未压缩格式的块为 1x1
+struct FormatBlock {
+    uint32_t width;
+    uint32_t height;
+    uint32_t bytes;
+};
+
+// ASTC 各格式的块尺寸，线性和 sRGB 两组的顺序相同
+constexpr uint8_t ASTC_BLOCKS[][2] = {
+    { 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 },
+    { 8, 8 }, { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 },
+};
+
+// 依赖 TextureFormat 枚举按每像素位数分组排列的顺序（见 backend/DriverEnums.h）
+FormatBlock getFormatBlock(Format format) noexcept {
+    if (backend::isASTCCompression(format)) {
+        const size_t index = (size_t(format) - size_t(Format::RGBA_ASTC_4x4)) % 14;
+        return { ASTC_BLOCKS[index][0], ASTC_BLOCKS[index][1], 16 };
+    }
+    if (backend::isCompressedFormat(format)) {
+        switch (format) {
+            // 64 位的 4x4 块
+            case Format::EAC_R11:
+            case Format::EAC_R11_SIGNED:
+            case Format::ETC2_RGB8:
+            case Format::ETC2_SRGB8:
+            case Format::ETC2_RGB8_A1:
+            case Format::ETC2_SRGB8_A1:
+            case Format::DXT1_RGB:
+            case Format::DXT1_RGBA:
+            case Format::DXT1_SRGB:
+            case Format::DXT1_SRGBA:
+            case Format::RED_RGTC1:
+            case Format::SIGNED_RED_RGTC1:
+                return { 4, 4, 8 };
+            default:
+                return { 4, 4, 16 };
+        }
+    }
+    // 分组边界上有几个格式的实际大小和所在分组不同
+    switch (format) {
+        case Format::RGB9_E5:           return { 1, 1, 4 };
+        case Format::DEPTH24:           return { 1, 1, 4 };
+        case Format::DEPTH32F_STENCIL8: return { 1, 1, 8 };
+        default: break;
+    }
+    if (format <= Format::STENCIL8) return { 1, 1, 1 };
+    if (format <= Format::DEPTH16)  return { 1, 1, 2 };
+    if (format <= Format::DEPTH24)  return { 1, 1, 3 };
+    if (format <= Format::DEPTH32F_STENCIL8) return { 1, 1, 4 };
+    if (format <= Format::RGB16I)   return { 1, 1, 6 };
+    if (format <= Format::RGBA16I)  return { 1, 1, 8 };
+    if (format <= Format::RGB32I)   return { 1, 1, 12 };
+    return { 1, 1, 16 };
+}
+
+// MorphTargetBuffer 每个顶点每个目标的数据：float4 位置 + short4 切线
+constexpr uint64_t MORPH_TARGET_VERTEX_BYTES = 4 * sizeof(float) + 4 * sizeof(int16_t);
+
+double readReportInterval() {
+    const char* value = std::getenv("DEMO_MEMORY_REPORT");
+    return value ? std::atof(value) : 0.0;
+}
+
+double toKiB(uint64_t bytes) {
+    return double(bytes) / 1024.0;
+}
+
+} // anonymous namespace
+
+// ========================================
+// MemoryReport
+// ========================================
+
+const char* MemoryReport::getKindName(Kind kind) noexcept {
+    switch (kind) {
+        case VERTEX_BUFFER:       return "vertex";
+        case INDEX_BUFFER:        return "index";
+        case TEXTURE:             return "texture";
+        case MORPH_TARGET_BUFFER: return "morph";
+        case MATERIAL_PACKAGE:    return "material";
+        default:                  return "?";
+    }
+}
+
+void MemoryReport::dump(std::ostream& out) const {
+    out << "[memory] tracked " << toKiB(trackedBytes) << " KiB, rss "
+        << toKiB(rssBytes) << " KiB, peak rss " << toKiB(peakRssBytes) << " KiB\n";
+    out << std::fixed << std::setprecision(1);
+    out << "  " << std::left << std::setw(16) << "(KiB)" << std::right;
+    for (int kind = 0; kind < KIND_COUNT; kind++) {
+        out << std::setw(10) << getKindName(Kind(kind));
+    }
+    out << std::setw(10) << "total" << '\n';
+    for (const Asset& asset : assets) {
+        out << "  " << std::left << std::setw(16) << asset.name << std::right;
+        for (uint64_t bytes : asset.bytes) {
+            out << std::setw(10) << toKiB(bytes);
+        }
+        out << std::setw(10) << toKiB(asset.total) << '\n';
+    }
+    if (!engineCounts.empty()) {
+        out << "  engine:";
+        for (const auto& count : engineCounts) {
+            out << ' ' << count.first << '=' << count.second;
+        }
+        out << '\n';
+    }
+    out << std::defaultfloat << std::flush;
+}
+
+void MemoryReport::writeJson(JsonWriter& json) const {
+    json.beginObject();
+    json.key("trackedBytes").value(trackedBytes);
+    json.key("rssBytes").value(rssBytes);
+    json.key("peakRssBytes").value(peakRssBytes);
+    json.key("assets").beginArray();
+    for (const Asset& asset : assets) {
+        json.beginObject();
+        json.key("name").value(asset.name);
+        for (int kind = 0; kind < KIND_COUNT; kind++) {
+            if (asset.bytes[kind]) {
+                json.key(getKindName(Kind(kind))).value(asset.bytes[kind]);
+            }
+        }
+        json.key("total").value(asset.total);
+        json.endObject();
+    }
+    json.endArray();
+    json.key("engine").beginObject();
+    for (const auto& count : engineCounts) {
+        json.key(count.first).value(static_cast<unsigned long>(count.second));
+    }
+    json.endObject();
+    json.endObject();
+}
+
+// ========================================
+// MemoryLedger
+// ========================================
+
+MemoryLedger::MemoryLedger() : MemoryLedger(readReportInterval()) {
+}
+
+MemoryLedger::MemoryLedger(double reportIntervalSeconds)
+        : mReportIntervalSeconds(reportIntervalSeconds), mLastReport(Clock::now()) {
+}
+
+void MemoryLedger::add(const std::string& asset, Kind kind, const void* object, uint64_t bytes) {
+    if (!object) {
+        return;
+    }
+    remove(object);
+    mEntries.push_back({ asset, kind, object, bytes });
+}
+
+void MemoryLedger::addVertexBuffer(const std::string& asset, const VertexBuffer* buffer,
+        uint64_t bytes) {
+    add(asset, Kind::VERTEX_BUFFER, buffer, bytes);
+}
+
+void MemoryLedger::addIndexBuffer(const std::string& asset, const IndexBuffer* buffer,
+        IndexBuffer::IndexType type) {
+    if (buffer) {
+        const uint64_t indexSize = type == IndexBuffer::IndexType::USHORT ? 2 : 4;
+        add(asset, Kind::INDEX_BUFFER, buffer, buffer->getIndexCount() * indexSize);
+    }
+}
+
+void MemoryLedger::addTexture(const std::string& asset, const Texture* texture) {
+    if (texture) {
+        add(asset, Kind::TEXTURE, texture, computeTextureBytes(*texture));
+    }
+}
+
+void MemoryLedger::addMorphTargetBuffer(const std::string& asset, const MorphTargetBuffer* buffer) {
+    if (buffer) {
+        add(asset, Kind::MORPH_TARGET_BUFFER, buffer,
+                uint64_t(buffer->getVertexCount()) * buffer->getCount() * MORPH_TARGET_VERTEX_BYTES);
+    }
+}
+
+void MemoryLedger::addMaterial(const std::string& asset, const Material* material,
+        size_t packageSize) {
+    add(asset, Kind::MATERIAL_PACKAGE, material, packageSize);
+}
+
+void MemoryLedger::addFilamesh(const std::string& asset, const void* filamesh,
+        const VertexBuffer* vertexBuffer, const IndexBuffer* indexBuffer) {
+    uint64_t vertexBytes;
+    IndexBuffer::IndexType indexType;
+    if (!readFilameshFootprint(filamesh, &vertexBytes, &indexType)) {
+        std::cerr << "Not a filamesh buffer: " << asset << std::endl;
+        return;
+    }
+    addVertexBuffer(asset, vertexBuffer, vertexBytes);
+    addIndexBuffer(asset, indexBuffer, indexType);
+}
+
+void MemoryLedger::remove(const void* object) {
+    mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(),
+            [object](const Entry& entry) { return entry.object == object; }), mEntries.end());
+}
+
+uint64_t MemoryLedger::getTrackedBytes() const noexcept {
+    uint64_t total = 0;
+    for (const Entry& entry : mEntries) {
+        total += entry.bytes;
+    }
+    return total;
+}
+
+MemoryReport MemoryLedger::snapshot(const Engine* engine) const {
+    MemoryReport report;
+    for (const Entry& entry : mEntries) {
+        auto it = std::find_if(report.assets.begin(), report.assets.end(),
+                [&entry](const MemoryReport::Asset& asset) { return asset.name == entry.asset; });
+        if (it == report.assets.end()) {
+            report.assets.emplace_back();
+            it = report.assets.end() - 1;
+            it->name = entry.asset;
+        }
+        it->bytes[entry.kind] += entry.bytes;
+        it->total += entry.bytes;
+        report.trackedBytes += entry.bytes;
+    }
+    std::stable_sort(report.assets.begin(), report.assets.end(),
+            [](const MemoryReport::Asset& a, const MemoryReport::Asset& b) {
+                return a.total > b.total;
+            });
+
+    report.rssBytes = getCurrentRssBytes();
+    report.peakRssBytes = getPeakRssBytes();
+
+    if (engine) {
+        report.engineCounts = {
+            { "vertexBuffers", engine->getVertexBufferCount() },
+            { "indexBuffers", engine->getIndexBufferCount() },
+            { "bufferObjects", engine->getBufferObjectCount() },
+            { "morphTargetBuffers", engine->getMorphTargetBufferCount() },
+            { "skinningBuffers", engine->getSkinningBufferCount() },
+            { "instanceBuffers", engine->getInstanceBufferCount() },
+            { "textures", engine->getTextureCount() },
+            { "materials", engine->getMaterialCount() },
+            { "renderTargets", engine->getRenderTargetCount() },
+            { "indirectLights", engine->getIndirectLightCount() },
+            { "skyboxes", engine->getSkyboxeCount() },
+            { "views", engine->getViewCount() },
+            { "scenes", engine->getSceneCount() },
+        };
+    }
+    return report;
+}
+
+void MemoryLedger::tick(const Engine& engine) {
+    if (mReportIntervalSeconds <= 0.0) {
+        return;
+    }
+    const auto now = Clock::now();
+    if (std::chrono::duration<double>(now - mLastReport).count() >= mReportIntervalSeconds) {
+        mLastReport = now;
+        snapshot(&engine).dump(std::cerr);
+    }
+}
+
+uint64_t MemoryLedger::computeTextureBytes(const Texture& texture) {
+    const FormatBlock block = getFormatBlock(texture.getFormat());
+    const Texture::Sampler target = texture.getTarget();
+    const uint64_t faces = (target == Texture::Sampler::SAMPLER_CUBEMAP ||
+                            target == Texture::Sampler::SAMPLER_CUBEMAP_ARRAY) ? 6 : 1;
+    uint64_t total = 0;
+    for (size_t level = 0; level < texture.getLevels(); level++) {
+        const uint64_t blocksX = (texture.getWidth(level) + block.width - 1) / block.width;
+        const uint64_t blocksY = (texture.getHeight(level) + block.height - 1) / block.height;
+        // 只有 3D 纹理的深度随 mip 层级减半，数组纹理每层的层数不变
+        const uint64_t depth = target == Texture::Sampler::SAMPLER_3D
+                ? texture.getDepth(level) : texture.getDepth(0);
+        total += blocksX * blocksY * block.bytes * std::max<uint64_t>(depth, 1);
+    }
+    return total * faces;
+}
+
+bool MemoryLedger::readFilameshFootprint(const void* filamesh, uint64_t* vertexBytes,
+        IndexBuffer::IndexType* indexType) {
+    FilameshHeader header;
+    std::memcpy(&header, filamesh, sizeof(header));
+    if (std::memcmp(header.magic, "FILAMESH", sizeof(header.magic)) != 0) {
+        return false;
+    }
+    // 压缩过的 filamesh 中 vertexSize 是压缩后的大小，上传到 GPU 的是解码后的属性
+    *vertexBytes = filameshVertexBytes(header);
+    *indexType = header.indexType == FILAMESH_INDEX_UI16
+            ? IndexBuffer::IndexType::USHORT : IndexBuffer::IndexType::UINT;
+    return true;
+}
+
+} // namespace demo
@@ -0,0 +1,145 @@
+#ifndef DEMO_COMMON_MEMORYLEDGER_H
+#define DEMO_COMMON_MEMORYLEDGER_H
+
+#include <filament/IndexBuffer.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace filament {
+class Engine;
+class Material;
+class MorphTargetBuffer;
+class Texture;
+class VertexBuffer;
+}
+
+namespace demo {
+
+class JsonWriter;
+
+// ========================================
+// 内存报告
+// ========================================
+// MemoryLedger::snapshot() 的结果：按资源（asset）汇总的字节数、
+// Engine::get*Count() 报告的对象数量，以及进程 RSS。
+// 结构体本身不引用 Engine，Engine 销毁后仍然可以写出。
+struct MemoryReport {
+    // 资源的种类，同一个资源可以同时占用多个种类（例如网格的顶点和索引）
+    enum Kind : uint8_t {
+        VERTEX_BUFFER,
+        INDEX_BUFFER,
+        TEXTURE,
+        MORPH_TARGET_BUFFER,
+        MATERIAL_PACKAGE,
+        KIND_COUNT
+    };
+
+    struct Asset {
+        std::string name;
+        uint64_t bytes[KIND_COUNT] = {};
+        uint64_t total = 0;
+    };
+
+    std::vector<Asset> assets;      // 按 total 从大到小排序
+    uint64_t trackedBytes = 0;      // 所有资源之和
+    uint64_t rssBytes = 0;          // 当前 RSS
+    uint64_t peakRssBytes = 0;      // RSS 峰值
+    // Engine::getVertexBufferCount() 等，名字不带 get/Count，例如 "vertexBuffers"
+    std::vector<std::pair<const char*, size_t>> engineCounts;
+
+    static const char* getKindName(Kind kind) noexcept;
+
+    // 以表格形式打印，每个资源一行
+    void dump(std::ostream& out) const;
+    void writeJson(JsonWriter& json) const;
+};
+
+// ========================================
+// 资源内存账本
+// ========================================
+// 示例创建 VertexBuffer、IndexBuffer、Texture、MorphTargetBuffer 和材质时
+// 把对象登记到账本上，销毁时注销。字节数按创建参数计算：
+//   - 顶点缓冲区：由调用方按属性布局给出
+//   - 索引缓冲区：索引数 x 索引大小
+//   - 纹理：按内部格式（包括压缩格式的块大小）逐级累加各 mip 层级，立方体贴图乘 6
+//   - MorphTargetBuffer：每个顶点每个目标 float4 位置 + short4 切线
+//   - 材质：材质包大小（着色器编译后的驱动内存无法从外部得到，不计入）
+// 这些是按格式推算的 GPU 资源大小，不包括驱动的对齐和内部副本；
+// 和 RSS 放在一起看，可以判断内存是花在资源上还是引擎/驱动本身。
+//
+// 每个对象归属于一个资源名（asset），例如 04-pbr 的猴头网格记为 "monkey"，
+// 材质包记为 "texturedlit"，报告中各占一行。
+//
+// 设置环境变量 DEMO_MEMORY_REPORT=<秒> 时，tick() 按该间隔把报告打印到 stderr。
+class MemoryLedger {
+public:
+    using Kind = MemoryReport::Kind;
+
+    // 打印间隔从环境变量 DEMO_MEMORY_REPORT 读取，未设置时不定期打印
+    MemoryLedger();
+    // reportIntervalSeconds <= 0 时不定期打印
+    explicit MemoryLedger(double reportIntervalSeconds);
+
+    MemoryLedger(const MemoryLedger&) = delete;
+    MemoryLedger& operator=(const MemoryLedger&) = delete;
+
+    // 登记一个对象，object 用于 remove() 时查找；同一个对象重复登记时覆盖旧的记录
+    void add(const std::string& asset, Kind kind, const void* object, uint64_t bytes);
+
+    void addVertexBuffer(const std::string& asset, const filament::VertexBuffer* buffer,
+            uint64_t bytes);
+    void addIndexBuffer(const std::string& asset, const filament::IndexBuffer* buffer,
+            filament::IndexBuffer::IndexType type);
+    void addTexture(const std::string& asset, const filament::Texture* texture);
+    void addMorphTargetBuffer(const std::string& asset, const filament::MorphTargetBuffer* buffer);
+    void addMaterial(const std::string& asset, const filament::Material* material,
+            size_t packageSize);
+
+    // MeshReader 从 filamesh 数据创建的顶点/索引缓冲区，字节数从 filamesh 文件头读取，
+    // 调用时 filamesh 数据必须仍然有效
+    void addFilamesh(const std::string& asset, const void* filamesh,
+            const filament::VertexBuffer* vertexBuffer, const filament::IndexBuffer* indexBuffer);
+
+    // 对象销毁时调用，未登记的对象直接忽略
+    void remove(const void* object);
+
+    uint64_t getTrackedBytes() const noexcept;
+
+    // 汇总当前账本，engine 非空时同时读取各类对象的数量
+    MemoryReport snapshot(const filament::Engine* engine) const;
+
+    // 每帧调用一次，到达打印间隔时把报告打印到 stderr
+    void tick(const filament::Engine& engine);
+
+    // 按纹理的格式、尺寸和 mip 层级计算字节数
+    static uint64_t computeTextureBytes(const filament::Texture& texture);
+
+    // 从 filamesh 文件头读取解压后的顶点数据大小和索引类型，不是 filamesh 数据时返回 false。
+    // filamesh 数据在上传后就会被释放时，先用它读出大小，再调用 addVertexBuffer()/addIndexBuffer()
+    static bool readFilameshFootprint(const void* filamesh, uint64_t* vertexBytes,
+            filament::IndexBuffer::IndexType* indexType);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::string asset;
+        Kind kind;
+        const void* object;
+        uint64_t bytes;
+    };
+
+    std::vector<Entry> mEntries;
+    double mReportIntervalSeconds = 0.0;
+    Clock::time_point mLastReport;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_MEMORYLEDGER_H
@@ -0,0 +1,828 @@
+#include "MeshLod.h"
+#include "Filamesh.h"
+#include "MeshOptimizer.h"
+#include "Trace.h"
+
+#include <filament/Camera.h>
+#include <filament/Engine.h>
+#include <filament/RenderableManager.h>
+#include <filament/TransformManager.h>
+
+#include <math/half.h>
+#include <math/mat4.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <unordered_map>
+
+using namespace filament;
+using namespace filament::math;
+
+namespace demo {
+
+namespace {
+
+// ========================================
+// LOD 表（追加在 filamesh 材质名之后）
+// ========================================
+struct FilameshLodHeader {
+    char magic[8];
+    uint32_t levelCount;
+    uint32_t partCount;
+};
+
+struct FilameshLod {
+    uint32_t offset;
+    uint32_t indexCount;
+    float error;
+};
+
+constexpr char LOD_MAGIC[8] = { 'F', 'I', 'L', 'A', 'L', 'O', 'D', '1' };
+
+// 边界/接缝边的约束平面相对三角形平面的权重，越大越不容易把边界拉进来
+constexpr double EDGE_WEIGHT = 10.0;
+// 折叠后三角形法线转过的角度超过约 75°（cos < 0.25）视为翻转
+constexpr double FLIP_COSINE = 0.25;
+// 每一轮只接受代价不超过本轮第 goal 个候选 1.5 倍的折叠
+constexpr float PASS_COST_FACTOR = 1.5f;
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ========================================
+// 二次误差
+// ========================================
+// Q(p) = pᵀAp + 2bᵀp + c 是 p 到一组平面的加权距离平方和，A 对称只存 6 个元素。
+// evaluate() 除以权重之和，得到平均的距离平方
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+    double b0 = 0, b1 = 0, b2 = 0;
+    double c = 0;
+    double weight = 0;
+
+    // 平面 dot(n, p) + d = 0，n 为单位向量
+    void addPlane(const double3& n, double d, double w) noexcept {
+        a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z;
+        a11 += w * n.y * n.y; a12 += w * n.y * n.z; a22 += w * n.z * n.z;
+        b0 += w * n.x * d; b1 += w * n.y * d; b2 += w * n.z * d;
+        c += w * d * d;
+        weight += w;
+    }
+
+    void add(const Quadric& q) noexcept {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02; a11 += q.a11; a12 += q.a12; a22 += q.a22;
+        b0 += q.b0; b1 += q.b1; b2 += q.b2;
+        c += q.c;
+        weight += q.weight;
+    }
+
+    double evaluate(const double3& p) const noexcept {
+        if (weight <= 0.0) {
+            return 0.0;
+        }
+        const double r = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z +
+                2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z) +
+                2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+        return std::max(r, 0.0) / weight;
+    }
+};
+
+enum class VertexKind : uint8_t {
+    MANIFOLD,   // 内部顶点，只有一个 wedge，可以折叠到任何邻居
+    BORDER,     // 开放边界上恰好两条边界边，只沿边界折叠
+    SEAM,       // 两个 wedge，恰好两条接缝边，只沿接缝折叠
+    LOCKED,     // 非流形、边界或接缝的交汇点等，不动
+};
+
+struct Collapse {
+    uint32_t from;
+    uint32_t to;
+    float cost;
+};
+
+inline uint64_t edgeKey(uint32_t a, uint32_t b) noexcept {
+    return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+}
+
+// ========================================
+// 半边折叠简化器
+// ========================================
+// 构造时焊接位置、给顶点分类并累加二次误差，simplify() 每次都从原网格开始，
+// 同一个网格的各级 LOD 共享这些准备工作。
+// 位置按“代表顶点”编号：同一位置的所有 wedge 中排序最靠前的那个
+class Simplifier {
+public:
+    Simplifier(const uint32_t* indices, size_t indexCount, const float3* positions, size_t vertexCount)
+            : mIndices(indices, indices + indexCount), mPoints(vertexCount), mPosition(vertexCount),
+              mNextWedge(vertexCount), mKind(vertexCount, VertexKind::LOCKED), mQuadrics(vertexCount) {
+        // 位置平移缩放到单位包围盒内，代价与网格的尺寸无关
+        float3 minimum = positions[0];
+        float3 maximum = positions[0];
+        for (size_t v = 1; v < vertexCount; v++) {
+            minimum = min(minimum, positions[v]);
+            maximum = max(maximum, positions[v]);
+        }
+        const float3 extent = maximum - minimum;
+        mScale = std::max({ extent.x, extent.y, extent.z });
+        if (!(mScale > 0.0f)) {
+            mScale = 1.0f;
+        }
+        for (size_t v = 0; v < vertexCount; v++) {
+            mPoints[v] = double3((positions[v] - minimum) / mScale);
+        }
+
+        // 焊接：位置完全相同的顶点排在一起，串成一个 wedge 环
+        std::vector<uint32_t> order(vertexCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [positions](uint32_t a, uint32_t b) {
+            const float3& p = positions[a];
+            const float3& q = positions[b];
+            if (p.x != q.x) return p.x < q.x;
+            if (p.y != q.y) return p.y < q.y;
+            if (p.z != q.z) return p.z < q.z;
+            return a < b;
+        });
+        for (size_t begin = 0; begin < vertexCount;) {
+            size_t end = begin + 1;
+            while (end < vertexCount && positions[order[end]] == positions[order[begin]]) {
+                end++;
+            }
+            for (size_t i = begin; i < end; i++) {
+                mPosition[order[i]] = order[begin];
+                mNextWedge[order[i]] = order[i + 1 < end ? i + 1 : begin];
+            }
+            begin = end;
+        }
+
+        classifyVertices();
+        computeQuadrics();
+    }
+
+    // maxError 是模型空间单位，error 返回同样单位的误差
+    std::vector<uint32_t> simplify(size_t targetIndexCount, float maxError, float& error) const {
+        std::vector<uint32_t> result = mIndices;
+        std::vector<Quadric> quadrics = mQuadrics;
+        const size_t vertexCount = mPoints.size();
+        std::vector<uint32_t> remap(vertexCount);
+        std::vector<uint32_t> ringOffsets(vertexCount + 1);
+        std::vector<uint32_t> ring;
+        std::vector<bool> locked(vertexCount);
+        std::vector<Collapse> candidates;
+        std::unordered_map<uint64_t, uint32_t> edges;
+        std::vector<std::pair<uint32_t, uint32_t>> wedgeMap;
+        const float costLimit = (maxError / mScale) * (maxError / mScale);
+        float maxCost = 0.0f;
+
+        removeDegenerate(result);
+        while (result.size() > targetIndexCount) {
+            // 当前网格的边，值为相邻三角形数（1 为边界边）
+            edges.clear();
+            for (size_t i = 0; i < result.size(); i += 3) {
+                for (int k = 0; k < 3; k++) {
+                    edges[edgeKey(mPosition[result[i + k]], mPosition[result[i + (k + 1) % 3]])]++;
+                }
+            }
+            candidates.clear();
+            for (const auto& [key, count] : edges) {
+                const uint32_t a = uint32_t(key >> 32);
+                const uint32_t b = uint32_t(key);
+                const float ab = collapseCost(quadrics, a, b, count);
+                const float ba = collapseCost(quadrics, b, a, count);
+                if (ab <= ba && ab < INFINITY) {
+                    candidates.push_back({ a, b, ab });
+                } else if (ba < INFINITY) {
+                    candidates.push_back({ b, a, ba });
+                }
+            }
+            if (candidates.empty()) {
+                break;
+            }
+            std::sort(candidates.begin(), candidates.end(), [](const Collapse& x, const Collapse& y) {
+                return x.cost < y.cost;
+            });
+            // 一次折叠大约去掉两个三角形
+            const size_t goal = std::min((result.size() - targetIndexCount) / 6 + 1, candidates.size());
+            const float passLimit = std::min(candidates[goal - 1].cost * PASS_COST_FACTOR, costLimit);
+
+            // 每个位置周围的三角形（CSR）
+            std::fill(ringOffsets.begin(), ringOffsets.end(), 0u);
+            for (uint32_t index : result) {
+                ringOffsets[mPosition[index] + 1]++;
+            }
+            std::partial_sum(ringOffsets.begin(), ringOffsets.end(), ringOffsets.begin());
+            ring.resize(result.size());
+            std::vector<uint32_t> fill(ringOffsets.begin(), ringOffsets.end() - 1);
+            for (size_t i = 0; i < result.size(); i++) {
+                ring[fill[mPosition[result[i]]]++] = uint32_t(i / 3);
+            }
+
+            std::iota(remap.begin(), remap.end(), 0u);
+            std::fill(locked.begin(), locked.end(), false);
+            size_t removed = 0;
+            size_t collapses = 0;
+            for (const Collapse& collapse : candidates) {
+                if (collapse.cost > passLimit || result.size() - removed <= targetIndexCount) {
+                    break;
+                }
+                if (locked[collapse.from] || locked[collapse.to]) {
+                    continue;
+                }
+                const uint32_t* first = ring.data() + ringOffsets[collapse.from];
+                const uint32_t* last = ring.data() + ringOffsets[collapse.from + 1];
+                size_t shared = 0;
+                if (!mapWedges(result, first, last, collapse, wedgeMap, shared) ||
+                        hasFlip(result, first, last, collapse)) {
+                    continue;
+                }
+                for (const auto& [wedge, target] : wedgeMap) {
+                    remap[wedge] = target;
+                }
+                quadrics[collapse.to].add(quadrics[collapse.from]);
+                // 一环邻域在本轮内不再变化，上面的 ring 和翻转检查对后面的候选仍然有效
+                for (const uint32_t* t = first; t != last; t++) {
+                    for (int k = 0; k < 3; k++) {
+                        locked[mPosition[result[*t * 3 + k]]] = true;
+                    }
+                }
+                removed += shared * 3;
+                collapses++;
+                maxCost = std::max(maxCost, collapse.cost);
+            }
+            if (collapses == 0) {
+                break;
+            }
+            for (uint32_t& index : result) {
+                index = remap[index];
+            }
+            removeDegenerate(result);
+        }
+        error = std::sqrt(maxCost) * mScale;
+        return result;
+    }
+
+private:
+    void classifyVertices() {
+        // 每条边（按位置）的相邻三角形数，以及两侧 wedge 是否一致
+        struct EdgeInfo {
+            uint32_t count = 0;
+            uint32_t lowWedge = 0;
+            uint32_t highWedge = 0;
+            bool seam = false;
+        };
+        std::unordered_map<uint64_t, EdgeInfo> edges;
+        edges.reserve(mIndices.size());
+        std::vector<bool> referenced(mPoints.size());
+        for (size_t i = 0; i < mIndices.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t a = mIndices[i + k];
+                uint32_t b = mIndices[i + (k + 1) % 3];
+                referenced[a] = true;
+                if (mPosition[a] == mPosition[b]) {
+                    continue;
+                }
+                if (mPosition[a] > mPosition[b]) {
+                    std::swap(a, b);
+                }
+                EdgeInfo& edge = edges[edgeKey(mPosition[a], mPosition[b])];
+                if (edge.count++ == 0) {
+                    edge.lowWedge = a;
+                    edge.highWedge = b;
+                } else if (edge.lowWedge != a || edge.highWedge != b) {
+                    edge.seam = true;
+                }
+            }
+        }
+
+        std::vector<uint8_t> borderEdges(mPoints.size());
+        std::vector<uint8_t> seamEdges(mPoints.size());
+        std::vector<bool> nonManifold(mPoints.size());
+        for (const auto& [key, edge] : edges) {
+            for (const uint32_t position : { uint32_t(key >> 32), uint32_t(key) }) {
+                if (edge.count > 2) {
+                    nonManifold[position] = true;
+                } else if (edge.count == 1) {
+                    borderEdges[position] = uint8_t(std::min(borderEdges[position] + 1, 255));
+                } else if (edge.seam) {
+                    seamEdges[position] = uint8_t(std::min(seamEdges[position] + 1, 255));
+                }
+            }
+        }
+        for (uint32_t v = 0; v < mPoints.size(); v++) {
+            if (mPosition[v] != v) {
+                continue;
+            }
+            uint32_t wedges = 0;
+            uint32_t w = v;
+            do {
+                wedges += referenced[w] ? 1 : 0;
+                w = mNextWedge[w];
+            } while (w != v);
+            if (nonManifold[v]) {
+                mKind[v] = VertexKind::LOCKED;
+            } else if (borderEdges[v] > 0) {
+                mKind[v] = borderEdges[v] == 2 && seamEdges[v] == 0 && wedges == 1
+                        ? VertexKind::BORDER : VertexKind::LOCKED;
+            } else if (wedges == 1) {
+                mKind[v] = VertexKind::MANIFOLD;
+            } else if (wedges == 2 && seamEdges[v] == 2) {
+                mKind[v] = VertexKind::SEAM;
+            } else {
+                mKind[v] = VertexKind::LOCKED;
+            }
+        }
+
+        // 边界边和接缝边再加一个垂直于三角形、经过这条边的约束平面，保持轮廓和 UV 接缝的形状
+        mEdgeConstraints.clear();
+        for (size_t i = 0; i < mIndices.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                const uint32_t a = mPosition[mIndices[i + k]];
+                const uint32_t b = mPosition[mIndices[i + (k + 1) % 3]];
+                if (a == b) {
+                    continue;
+                }
+                const EdgeInfo& edge = edges[edgeKey(a, b)];
+                if (edge.count == 1 || (edge.count == 2 && edge.seam)) {
+                    mEdgeConstraints.push_back({ uint32_t(i / 3), uint32_t(k) });
+                }
+            }
+        }
+    }
+
+    void computeQuadrics() {
+        for (size_t i = 0; i < mIndices.size(); i += 3) {
+            const uint32_t p0 = mPosition[mIndices[i]];
+            const uint32_t p1 = mPosition[mIndices[i + 1]];
+            const uint32_t p2 = mPosition[mIndices[i + 2]];
+            double3 n = cross(mPoints[p1] - mPoints[p0], mPoints[p2] - mPoints[p0]);
+            const double doubleArea = length(n);
+            if (doubleArea <= 0.0) {
+                continue;
+            }
+            n /= doubleArea;
+            const double d = -dot(n, mPoints[p0]);
+            for (const uint32_t p : { p0, p1, p2 }) {
+                mQuadrics[p].addPlane(n, d, doubleArea * 0.5);
+            }
+        }
+        for (const auto& [triangle, corner] : mEdgeConstraints) {
+            const uint32_t* t = mIndices.data() + size_t(triangle) * 3;
+            const uint32_t a = mPosition[t[corner]];
+            const uint32_t b = mPosition[t[(corner + 1) % 3]];
+            const uint32_t c = mPosition[t[(corner + 2) % 3]];
+            const double3 edge = mPoints[b] - mPoints[a];
+            const double3 normal = cross(edge, mPoints[c] - mPoints[a]);
+            double3 n = cross(edge, normal);
+            const double nLength = length(n);
+            if (nLength <= 0.0) {
+                continue;
+            }
+            n /= nLength;
+            const double d = -dot(n, mPoints[a]);
+            const double w = dot(edge, edge) * EDGE_WEIGHT;
+            mQuadrics[a].addPlane(n, d, w);
+            mQuadrics[b].addPlane(n, d, w);
+        }
+    }
+
+    // 把 from 折叠到 to 的代价，不允许时返回 INFINITY。edgeTriangles 为 1 时是边界边
+    float collapseCost(const std::vector<Quadric>& quadrics, uint32_t from, uint32_t to,
+            uint32_t edgeTriangles) const noexcept {
+        const VertexKind kind = mKind[from];
+        if (kind == VertexKind::LOCKED || (kind == VertexKind::BORDER && edgeTriangles != 1)) {
+            return INFINITY;
+        }
+        Quadric q = quadrics[from];
+        q.add(quadrics[to]);
+        return float(q.evaluate(mPoints[to]));
+    }
+
+    // from 的每个 wedge 都要在含有这条边的三角形中对应到 to 的唯一一个 wedge，
+    // 否则折叠会把接缝两侧的 UV 混在一起。shared 返回会退化掉的三角形数
+    bool mapWedges(const std::vector<uint32_t>& indices, const uint32_t* first, const uint32_t* last,
+            const Collapse& collapse, std::vector<std::pair<uint32_t, uint32_t>>& wedgeMap,
+            size_t& shared) const {
+        wedgeMap.clear();
+        shared = 0;
+        for (const uint32_t* t = first; t != last; t++) {
+            const uint32_t* triangle = indices.data() + size_t(*t) * 3;
+            uint32_t fromWedge = ~0u;
+            uint32_t toWedge = ~0u;
+            for (int k = 0; k < 3; k++) {
+                if (mPosition[triangle[k]] == collapse.from) {
+                    fromWedge = triangle[k];
+                } else if (mPosition[triangle[k]] == collapse.to) {
+                    toWedge = triangle[k];
+                }
+            }
+            if (toWedge == ~0u) {
+                continue;
+            }
+            shared++;
+            auto it = std::find_if(wedgeMap.begin(), wedgeMap.end(),
+                    [fromWedge](const auto& entry) { return entry.first == fromWedge; });
+            if (it == wedgeMap.end()) {
+                wedgeMap.emplace_back(fromWedge, toWedge);
+            } else if (it->second != toWedge) {
+                return false;
+            }
+        }
+        for (const uint32_t* t = first; t != last; t++) {
+            const uint32_t* triangle = indices.data() + size_t(*t) * 3;
+            for (int k = 0; k < 3; k++) {
+                const uint32_t wedge = triangle[k];
+                if (mPosition[wedge] == collapse.from &&
+                        std::none_of(wedgeMap.begin(), wedgeMap.end(),
+                                [wedge](const auto& entry) { return entry.first == wedge; })) {
+                    return false;
+                }
+            }
+        }
+        return shared > 0;
+    }
+
+    // 不含这条边的三角形把 from 移到 to 之后，法线方向变化太大（或面积退化为零）时拒绝
+    bool hasFlip(const std::vector<uint32_t>& indices, const uint32_t* first, const uint32_t* last,
+            const Collapse& collapse) const {
+        const double3& target = mPoints[collapse.to];
+        for (const uint32_t* t = first; t != last; t++) {
+            const uint32_t* triangle = indices.data() + size_t(*t) * 3;
+            int corner = 0;
+            bool containsEdge = false;
+            for (int k = 0; k < 3; k++) {
+                const uint32_t position = mPosition[triangle[k]];
+                corner = position == collapse.from ? k : corner;
+                containsEdge = containsEdge || position == collapse.to;
+            }
+            if (containsEdge) {
+                continue;
+            }
+            const double3& a = mPoints[mPosition[triangle[corner]]];
+            const double3& b = mPoints[mPosition[triangle[(corner + 1) % 3]]];
+            const double3& c = mPoints[mPosition[triangle[(corner + 2) % 3]]];
+            const double3 before = cross(b - a, c - a);
+            const double3 after = cross(b - target, c - target);
+            if (dot(before, after) <= FLIP_COSINE * std::sqrt(dot(before, before) * dot(after, after))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void removeDegenerate(std::vector<uint32_t>& indices) const {
+        size_t write = 0;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            const uint32_t a = mPosition[indices[i]];
+            const uint32_t b = mPosition[indices[i + 1]];
+            const uint32_t c = mPosition[indices[i + 2]];
+            if (a != b && b != c && a != c) {
+                indices[write++] = indices[i];
+                indices[write++] = indices[i + 1];
+                indices[write++] = indices[i + 2];
+            }
+        }
+        indices.resize(write);
+    }
+
+    std::vector<uint32_t> mIndices;
+    std::vector<double3> mPoints;           // 归一化后的位置
+    std::vector<uint32_t> mPosition;        // 顶点 -> 代表顶点
+    std::vector<uint32_t> mNextWedge;       // 同一位置的 wedge 环
+    std::vector<VertexKind> mKind;          // 按代表顶点
+    std::vector<Quadric> mQuadrics;         // 按代表顶点
+    std::vector<std::pair<uint32_t, uint32_t>> mEdgeConstraints;   // (三角形, 角) 开始的边界/接缝边
+    float mScale = 1.0f;
+};
+
+template<typename T>
+void append(std::vector<uint8_t>& out, const T* data, size_t count) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + count * sizeof(T));
+}
+
+} // anonymous namespace
+
+std::vector<uint32_t> simplifyMesh(const uint32_t* indices, size_t indexCount, const float3* positions,
+        size_t vertexCount, size_t targetIndexCount, float maxError, float* error) {
+    TRACE_CALL();
+    float result = 0.0f;
+    std::vector<uint32_t> simplified;
+    if (indexCount >= 3 && vertexCount > 0) {
+        simplified = Simplifier(indices, indexCount, positions, vertexCount)
+                .simplify(targetIndexCount, maxError, result);
+    }
+    if (error) {
+        *error = result;
+    }
+    return simplified;
+}
+
+LodChain buildLodChain(const uint32_t* indices, size_t indexCount, const float3* positions,
+        size_t vertexCount, const LodOptions& options) {
+    TRACE_CALL();
+    const uint32_t levelCount = std::clamp(options.levelCount, 1u, MAX_LOD_LEVELS);
+    LodChain chain;
+    chain.indices.assign(indices, indices + indexCount);
+    chain.levels.push_back({ 0, uint32_t(indexCount), 0.0f });
+    if (levelCount == 1 || indexCount < 3 || vertexCount == 0) {
+        chain.levels.resize(levelCount, chain.levels[0]);
+        return chain;
+    }
+
+    float3 minimum = positions[indices[0]];
+    float3 maximum = minimum;
+    for (size_t i = 1; i < indexCount; i++) {
+        minimum = min(minimum, positions[indices[i]]);
+        maximum = max(maximum, positions[indices[i]]);
+    }
+    const float3 extent = maximum - minimum;
+    const float maxError = options.maxError * std::max({ extent.x, extent.y, extent.z });
+
+    const Simplifier simplifier(indices, indexCount, positions, vertexCount);
+    double target = double(indexCount);
+    for (uint32_t level = 1; level < levelCount; level++) {
+        target *= options.reduction;
+        const LodLevel previous = chain.levels.back();
+        float error = 0.0f;
+        std::vector<uint32_t> lod = simplifier.simplify(size_t(target) / 3 * 3, maxError, error);
+        if (lod.empty() || lod.size() >= previous.indexCount) {
+            chain.levels.push_back(previous);
+            continue;
+        }
+        optimizeVertexCache(lod.data(), lod.size(), vertexCount);
+        chain.levels.push_back({ uint32_t(chain.indices.size()), uint32_t(lod.size()),
+                std::max(error, previous.error) });
+        chain.indices.insert(chain.indices.end(), lod.begin(), lod.end());
+    }
+    return chain;
+}
+
+bool appendFilameshLods(std::vector<uint8_t>& file, const LodOptions& options, LodBuildStats* stats) {
+    TRACE_CALL();
+    FilameshLayout layout;
+    const char* error = readFilameshLayout(file.data(), file.size(), layout);
+    const FilameshHeader& header = layout.header;
+    if (!error) {
+        error = checkInterleavedFilamesh(header);
+    }
+    if (error) {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    const bool shortIndices = header.indexType == FILAMESH_INDEX_UI16;
+    const size_t elementSize = filameshIndexElementSize(header);
+    const uint32_t stride = header.stridePosition;
+    const uint32_t levelCount = std::clamp(options.levelCount, 1u, MAX_LOD_LEVELS);
+
+    const auto start = std::chrono::steady_clock::now();
+    const uint8_t* vertexData = file.data() + sizeof(FilameshHeader);
+    const uint8_t* indexData = file.data() + layout.indicesOffset;
+    std::vector<uint32_t> indices(header.indexCount);
+    for (uint32_t i = 0; i < header.indexCount; i++) {
+        if (shortIndices) {
+            uint16_t index;
+            std::memcpy(&index, indexData + i * sizeof(index), sizeof(index));
+            indices[i] = index;
+        } else {
+            std::memcpy(&indices[i], indexData + i * sizeof(uint32_t), sizeof(uint32_t));
+        }
+    }
+    std::vector<float3> positions(header.vertexCount);
+    for (uint32_t v = 0; v < header.vertexCount; v++) {
+        uint16_t bits[3];
+        std::memcpy(bits, vertexData + size_t(v) * stride + header.offsetPosition, sizeof(bits));
+        positions[v] = float3{ float(makeHalf(bits[0])), float(makeHalf(bits[1])), float(makeHalf(bits[2])) };
+    }
+    std::vector<FilameshPart> parts(header.parts);
+    std::memcpy(parts.data(), file.data() + layout.partsOffset, parts.size() * sizeof(FilameshPart));
+
+    // 已经有 LOD 表时，上次追加的索引都在第 0 级之后，截掉后重新生成
+    uint32_t baseIndexCount = header.indexCount;
+    LodTable previous;
+    if (readFilameshLods(file.data(), file.size(), previous)) {
+        uint64_t end = 0;
+        for (const FilameshPart& part : parts) {
+            end = std::max(end, uint64_t(part.offset) + part.indexCount);
+        }
+        baseIndexCount = uint32_t(std::min(end, uint64_t(header.indexCount)));
+    }
+
+    // 每个 part 在自己的顶点区间 [minIndex, maxIndex] 内简化，新索引追加在原索引之后
+    std::vector<uint32_t> extra;
+    std::vector<FilameshLod> table;
+    if (stats) {
+        *stats = {};
+        stats->partCount = header.parts;
+        stats->levelCount = levelCount;
+        stats->vertexCount = header.vertexCount;
+        stats->triangleCount.assign(levelCount, 0);
+        stats->error.assign(levelCount, 0.0f);
+    }
+    for (const FilameshPart& part : parts) {
+        if (part.offset > baseIndexCount || part.indexCount > baseIndexCount - part.offset ||
+                part.minIndex > part.maxIndex || part.maxIndex >= header.vertexCount) {
+            std::cerr << "Filamesh part out of range" << std::endl;
+            return false;
+        }
+        std::vector<uint32_t> partIndices(indices.begin() + part.offset,
+                indices.begin() + part.offset + part.indexCount);
+        for (uint32_t& index : partIndices) {
+            if (index < part.minIndex || index > part.maxIndex) {
+                std::cerr << "Filamesh index out of part range" << std::endl;
+                return false;
+            }
+            index -= part.minIndex;
+        }
+        const LodChain chain = buildLodChain(partIndices.data(), partIndices.size(),
+                positions.data() + part.minIndex, size_t(part.maxIndex - part.minIndex) + 1,
+                { levelCount, options.reduction, options.maxError });
+        for (uint32_t level = 0; level < levelCount; level++) {
+            const LodLevel& lod = chain.levels[level];
+            FilameshLod entry{ part.offset, lod.indexCount, lod.error };
+            if (level > 0 && lod.offset == chain.levels[level - 1].offset) {
+                entry.offset = table.back().offset;
+            } else if (level > 0) {
+                entry.offset = baseIndexCount + uint32_t(extra.size());
+                for (uint32_t i = 0; i < lod.indexCount; i++) {
+                    extra.push_back(chain.indices[lod.offset + i] + part.minIndex);
+                }
+            }
+            table.push_back(entry);
+            if (stats) {
+                stats->triangleCount[level] += lod.indexCount / 3;
+                stats->error[level] = std::max(stats->error[level], lod.error);
+            }
+        }
+    }
+    if (stats) {
+        stats->simplifyMs = elapsedMs(start);
+    }
+
+    // 头 | 顶点 | 原索引 + LOD 索引 | part 表 | 材质名 | LOD 表
+    FilameshHeader newHeader = header;
+    newHeader.indexCount = baseIndexCount + uint32_t(extra.size());
+    newHeader.indexSize = uint32_t(newHeader.indexCount * elementSize);
+    std::vector<uint8_t> result;
+    result.reserve(layout.indicesOffset + newHeader.indexSize + (layout.materialsEnd - layout.partsOffset) +
+            sizeof(FilameshLodHeader) + table.size() * sizeof(FilameshLod));
+    append(result, &newHeader, 1);
+    append(result, file.data() + sizeof(FilameshHeader),
+            layout.indicesOffset - sizeof(FilameshHeader) + size_t(baseIndexCount) * elementSize);
+    for (uint32_t index : extra) {
+        if (shortIndices) {
+            const uint16_t shortIndex = uint16_t(index);
+            append(result, &shortIndex, 1);
+        } else {
+            append(result, &index, 1);
+        }
+    }
+    append(result, file.data() + layout.partsOffset, layout.materialsEnd - layout.partsOffset);
+    FilameshLodHeader lodHeader;
+    std::memcpy(lodHeader.magic, LOD_MAGIC, sizeof(LOD_MAGIC));
+    lodHeader.levelCount = levelCount;
+    lodHeader.partCount = header.parts;
+    append(result, &lodHeader, 1);
+    append(result, table.data(), table.size());
+    file.swap(result);
+    return true;
+}
+
+bool readFilameshLods(const uint8_t* file, size_t size, LodTable& table) {
+    FilameshLayout layout;
+    if (readFilameshLayout(file, size, layout)) {
+        return false;
+    }
+    FilameshLodHeader lodHeader;
+    if (layout.materialsEnd + sizeof(lodHeader) > size) {
+        return false;
+    }
+    std::memcpy(&lodHeader, file + layout.materialsEnd, sizeof(lodHeader));
+    const size_t count = size_t(lodHeader.levelCount) * lodHeader.partCount;
+    if (std::memcmp(lodHeader.magic, LOD_MAGIC, sizeof(LOD_MAGIC)) != 0 ||
+            lodHeader.levelCount == 0 || lodHeader.levelCount > MAX_LOD_LEVELS ||
+            lodHeader.partCount != layout.header.parts ||
+            layout.materialsEnd + sizeof(lodHeader) + count * sizeof(FilameshLod) > size) {
+        return false;
+    }
+    table.levelCount = lodHeader.levelCount;
+    table.partCount = lodHeader.partCount;
+    table.levels.resize(count);
+    const uint8_t* entries = file + layout.materialsEnd + sizeof(lodHeader);
+    for (size_t i = 0; i < count; i++) {
+        FilameshLod entry;
+        std::memcpy(&entry, entries + i * sizeof(entry), sizeof(entry));
+        if (entry.offset > layout.header.indexCount ||
+                entry.indexCount > layout.header.indexCount - entry.offset) {
+            return false;
+        }
+        table.levels[i] = { entry.offset, entry.indexCount, entry.error };
+    }
+    return true;
+}
+
+// ========================================
+// LodSelector
+// ========================================
+void LodSelector::add(utils::Entity renderable, VertexBuffer* vertices, IndexBuffer* indices,
+        const LodLevel* levels, uint32_t primitiveCount, uint32_t levelCount, const Box& bounds) {
+    Entry entry{};
+    entry.renderable = renderable;
+    entry.vertices = vertices;
+    entry.indices = indices;
+    entry.primitiveCount = primitiveCount;
+    entry.levelCount = std::min(levelCount, MAX_LOD_LEVELS);
+    for (uint32_t primitive = 0; primitive < primitiveCount; primitive++) {
+        const LodLevel* first = levels + size_t(primitive) * levelCount;
+        entry.levels.insert(entry.levels.end(), first, first + entry.levelCount);
+    }
+    for (uint32_t level = 0; level < entry.levelCount; level++) {
+        for (uint32_t primitive = 0; primitive < primitiveCount; primitive++) {
+            const LodLevel& lod = entry.levels[size_t(primitive) * entry.levelCount + level];
+            entry.errors[level] = std::max(entry.errors[level], lod.error);
+            entry.triangles[level] += lod.indexCount / 3;
+        }
+    }
+    entry.center = bounds.center;
+    entry.radius = length(bounds.halfExtent);
+    entry.current = 0;
+    mEntries.push_back(std::move(entry));
+    updateStats();
+}
+
+void LodSelector::update(Engine& engine, const Camera& camera, uint32_t viewportHeight) {
+    TRACE_CALL();
+    auto& tcm = engine.getTransformManager();
+    const double3 eye = camera.getPosition();
+    // 距离 d 处长度为 e 的误差投影到屏幕上的像素数：e * proj[1][1] / d * (height / 2)
+    const float pixelsPerUnit = float(camera.getProjectionMatrix()[1][1]) * float(viewportHeight) * 0.5f;
+    const float coarsen = mPixelError * (1.0f - mHysteresis);
+    const float refine = mPixelError * (1.0f + mHysteresis);
+
+    mStats.switches = 0;
+    for (Entry& entry : mEntries) {
+        const mat4f world = tcm.getWorldTransform(tcm.getInstance(entry.renderable));
+        const float scale = std::sqrt(std::max({ dot(world[0].xyz, world[0].xyz),
+                dot(world[1].xyz, world[1].xyz), dot(world[2].xyz, world[2].xyz) }));
+        const float3 center = (world * float4(entry.center, 1.0f)).xyz;
+        // 到包围球最近点的距离，相机在球内时按很近处理，总是用第 0 级
+        const float distance = float(length(double3(center) - eye)) - entry.radius * scale;
+        const float factor = distance > 1e-4f ? scale * pixelsPerUnit / distance : INFINITY;
+
+        uint32_t level = entry.current;
+        if (entry.errors[level] * factor > refine) {
+            while (level > 0 && entry.errors[level] * factor > mPixelError) {
+                level--;
+            }
+        } else {
+            while (level + 1 < entry.levelCount && entry.errors[level + 1] * factor <= coarsen) {
+                level++;
+            }
+        }
+        if (level != entry.current) {
+            apply(engine, entry, level);
+            mStats.switches++;
+        }
+    }
+    updateStats();
+}
+
+void LodSelector::force(Engine& engine, uint32_t level) {
+    mStats.switches = 0;
+    for (Entry& entry : mEntries) {
+        const uint32_t target = std::min(level, entry.levelCount - 1);
+        if (target != entry.current) {
+            apply(engine, entry, target);
+            mStats.switches++;
+        }
+    }
+    updateStats();
+}
+
+void LodSelector::apply(Engine& engine, Entry& entry, uint32_t level) {
+    auto& rcm = engine.getRenderableManager();
+    const auto instance = rcm.getInstance(entry.renderable);
+    for (uint32_t primitive = 0; primitive < entry.primitiveCount; primitive++) {
+        const LodLevel& lod = entry.levels[size_t(primitive) * entry.levelCount + level];
+        rcm.setGeometryAt(instance, primitive, RenderableManager::PrimitiveType::TRIANGLES,
+                entry.vertices, entry.indices, lod.offset, lod.indexCount);
+    }
+    entry.current = level;
+}
+
+void LodSelector::updateStats() {
+    const uint32_t switches = mStats.switches;
+    mStats = {};
+    mStats.switches = switches;
+    mStats.renderableCount = uint32_t(mEntries.size());
+    for (const Entry& entry : mEntries) {
+        mStats.instances[entry.current]++;
+        mStats.triangles += entry.triangles[entry.current];
+        mStats.fullTriangles += entry.triangles[0];
+    }
+}
+
+} // namespace demo
@@ -0,0 +1,163 @@
+#ifndef DEMO_COMMON_MESHLOD_H
+#define DEMO_COMMON_MESHLOD_H
+
+#include <filament/Box.h>
+
+#include <math/vec3.h>
+
+#include <utils/Entity.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace filament {
+class Camera;
+class Engine;
+class IndexBuffer;
+class VertexBuffer;
+}
+
+namespace demo {
+
+// ========================================
+// 网格简化与 LOD 链
+// ========================================
+// lucy.obj 这样的稠密网格在任何距离都按全部三角形绘制。这里分三部分：
+//
+//   1. simplifyMesh()：二次误差度量（Garland & Heckbert，1997）的半边折叠，顶点只会折叠到已有的邻居上，
+//      所以简化结果只是一组新的索引，仍然引用原来的顶点缓冲区，法线、UV 等属性原样保留。
+//      位置相同的顶点先焊接成一个“位置”，UV/法线不同的副本（wedge）构成接缝：
+//      开放边界上的顶点只沿边界折叠，接缝上的顶点只沿接缝折叠，各 wedge 折叠到对端对应的 wedge 上，
+//      接缝两侧的 UV 不会被拉到一起；拓扑更复杂的顶点不动
+//   2. buildLodChain()：从原网格按 reduction 逐级简化出 levelCount 级 LOD（第 0 级是原网格），
+//      所有级别的索引首尾相接放在同一个索引缓冲区里，每一级只是一个 (offset, count) 区间
+//   3. LodSelector：每帧按投影到屏幕上的误差（像素）为每个实体选级别，带滞回，
+//      级别变化时用 RenderableManager::setGeometryAt() 改绘制的索引区间
+//
+// 误差是简化后的表面到原表面的距离估计（二次误差的平方根），单位与顶点位置相同。
+
+constexpr uint32_t MAX_LOD_LEVELS = 8;
+
+// 一级 LOD：索引缓冲区中的区间
+struct LodLevel {
+    uint32_t offset = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f;         // 模型空间单位
+};
+
+struct LodOptions {
+    uint32_t levelCount = 4;    // 包括原网格，最多 MAX_LOD_LEVELS
+    float reduction = 0.5f;     // 每一级相对上一级的三角形比例
+    float maxError = 0.05f;     // 相对网格包围盒最大边长的误差上限，超过时不再往下简化
+};
+
+// 把三角形列表简化到不超过 targetIndexCount 个索引（误差超过 maxError 时提前停止，结果可能更多）。
+// maxError 与 error 都是模型空间单位
+std::vector<uint32_t> simplifyMesh(const uint32_t* indices, size_t indexCount,
+        const filament::math::float3* positions, size_t vertexCount, size_t targetIndexCount,
+        float maxError, float* error = nullptr);
+
+struct LodChain {
+    std::vector<uint32_t> indices;  // 各级索引首尾相接
+    std::vector<LodLevel> levels;   // 总是 options.levelCount 级，offset 相对 indices
+};
+
+// 第 0 级是原网格。简化不动（误差到了上限或拓扑不允许）的级别重复上一级的区间，不额外占用索引
+LodChain buildLodChain(const uint32_t* indices, size_t indexCount,
+        const filament::math::float3* positions, size_t vertexCount, const LodOptions& options = {});
+
+// ========================================
+// filamesh 中的 LOD 表
+// ========================================
+// LOD 索引追加在 filamesh 索引缓冲区的末尾，part 表仍然描述第 0 级，MeshReader 照常加载全精度网格。
+// 材质名之后是 LOD 表（旧的读取器会忽略）：
+//
+//   char magic[8] = "FILALOD1" | uint32 levelCount | uint32 partCount |
+//   partCount * levelCount 个 { uint32 offset; uint32 indexCount; float error; }（同一 part 的各级相邻）
+struct LodTable {
+    uint32_t levelCount = 0;
+    uint32_t partCount = 0;
+    std::vector<LodLevel> levels;
+
+    const LodLevel* part(uint32_t index) const noexcept { return levels.data() + size_t(index) * levelCount; }
+};
+
+struct LodBuildStats {
+    uint32_t partCount = 0;
+    uint32_t levelCount = 0;
+    uint32_t vertexCount = 0;
+    std::vector<uint32_t> triangleCount;    // 每级所有 part 的三角形数之和
+    std::vector<float> error;               // 每级所有 part 的最大误差
+    double simplifyMs = 0.0;
+};
+
+// 为内存中未压缩的交错 filamesh 的每个 part 生成 LOD 链并追加到文件数据（已有 LOD 表时先去掉）。
+// 失败时打印原因并返回 false，file 不变
+bool appendFilameshLods(std::vector<uint8_t>& file, const LodOptions& options, LodBuildStats* stats = nullptr);
+
+// 读取 filamesh 的 LOD 表，没有时返回 false（不打印）
+bool readFilameshLods(const uint8_t* file, size_t size, LodTable& table);
+
+// ========================================
+// 按屏幕误差选择 LOD
+// ========================================
+struct LodSelectorStats {
+    uint32_t renderableCount = 0;
+    uint32_t instances[MAX_LOD_LEVELS] = {};    // 每级当前使用的实体数
+    uint64_t triangles = 0;                     // 当前绘制的三角形
+    uint64_t fullTriangles = 0;                 // 全部用第 0 级时的三角形
+    uint32_t switches = 0;                      // 上一次 update() 中切换级别的实体数
+};
+
+class LodSelector {
+public:
+    // pixelError：允许的屏幕误差（像素）。hysteresis：变粗要求误差低于 pixelError * (1 - h)，
+    // 当前级别的误差超过 pixelError * (1 + h) 才变细，在阈值附近来回移动的相机不会让级别每帧跳动
+    explicit LodSelector(float pixelError = 1.0f, float hysteresis = 0.25f)
+            : mPixelError(pixelError), mHysteresis(hysteresis) {}
+
+    // levels 有 primitiveCount * levelCount 项，同一 primitive 的各级相邻，区间都在 indices 中。
+    // bounds 是模型空间包围盒。实体从第 0 级开始
+    void add(utils::Entity renderable, filament::VertexBuffer* vertices, filament::IndexBuffer* indices,
+            const LodLevel* levels, uint32_t primitiveCount, uint32_t levelCount, const filament::Box& bounds);
+
+    // 每帧在 Renderer::render() 之前调用；viewportHeight 是像素高度
+    void update(filament::Engine& engine, const filament::Camera& camera, uint32_t viewportHeight);
+
+    // 把所有实体固定在一个级别上（对比用），level 超出时取最粗的一级
+    void force(filament::Engine& engine, uint32_t level);
+
+    void clear() noexcept { mEntries.clear(); }
+
+    void setPixelError(float pixelError) noexcept { mPixelError = pixelError; }
+
+    const LodSelectorStats& getStats() const noexcept { return mStats; }
+
+private:
+    struct Entry {
+        utils::Entity renderable;
+        filament::VertexBuffer* vertices;
+        filament::IndexBuffer* indices;
+        std::vector<LodLevel> levels;
+        uint32_t primitiveCount;
+        uint32_t levelCount;
+        float errors[MAX_LOD_LEVELS];       // 每级各 primitive 的最大误差
+        uint32_t triangles[MAX_LOD_LEVELS];
+        filament::math::float3 center;
+        float radius;
+        uint32_t current;
+    };
+
+    void apply(filament::Engine& engine, Entry& entry, uint32_t level);
+    void updateStats();
+
+    std::vector<Entry> mEntries;
+    float mPixelError;
+    float mHysteresis;
+    LodSelectorStats mStats;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_MESHLOD_H
@@ -0,0 +1,519 @@
+#include "MeshOptimizer.h"
+#include "Filamesh.h"
+#include "MeshLod.h"
+#include "Trace.h"
+
+#include <math/half.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+
+using namespace filament::math;
+
+namespace demo {
+
+namespace {
+
+// overfetch 模拟的顶点读取缓存：64 字节缓存行，2048 行（128KB）直接映射
+constexpr size_t FETCH_LINE_SIZE = 64;
+constexpr size_t FETCH_LINE_COUNT = 2048;
+
+// ========================================
+// FIFO 后变换缓存模拟
+// ========================================
+// 每次缓存未命中时间戳加一，顶点在最近 cacheSize 次未命中之内进入缓存时仍在缓存里。
+// reset() 把时间戳向前推 cacheSize + 1，所有顶点都不再命中
+class VertexCache {
+public:
+    VertexCache(size_t vertexCount, uint32_t cacheSize)
+            : mTime(vertexCount, 0), mCacheSize(cacheSize), mTimestamp(cacheSize + 1) {
+    }
+
+    bool contains(uint32_t vertex) const noexcept {
+        return mTimestamp - mTime[vertex] <= mCacheSize;
+    }
+
+    // 返回 true 表示未命中（顶点需要变换）
+    bool access(uint32_t vertex) noexcept {
+        if (contains(vertex)) {
+            return false;
+        }
+        mTime[vertex] = mTimestamp++;
+        return true;
+    }
+
+    uint32_t triangleMisses(const uint32_t* triangle) noexcept {
+        return uint32_t(access(triangle[0])) + uint32_t(access(triangle[1])) + uint32_t(access(triangle[2]));
+    }
+
+    // 顶点进入缓存之后已经发生了几次未命中，大于 cacheSize 时已经不在缓存中
+    uint64_t age(uint32_t vertex) const noexcept { return mTimestamp - mTime[vertex]; }
+
+    void reset() noexcept { mTimestamp += mCacheSize + 1; }
+
+private:
+    std::vector<uint64_t> mTime;
+    const uint64_t mCacheSize;
+    uint64_t mTimestamp;
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+MeshCacheStats analyzeMesh(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+        size_t vertexStride, uint32_t cacheSize) {
+    MeshCacheStats stats;
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || vertexCount == 0) {
+        return stats;
+    }
+    VertexCache cache(vertexCount, cacheSize);
+    std::vector<uint8_t> used(vertexCount, 0);
+    size_t transformed = 0;
+    size_t usedCount = 0;
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        const uint32_t vertex = indices[i];
+        transformed += cache.access(vertex);
+        usedCount += !used[vertex];
+        used[vertex] = 1;
+    }
+    stats.acmr = float(double(transformed) / double(triangleCount));
+    stats.atvr = float(double(transformed) / double(usedCount));
+
+    if (vertexStride) {
+        std::vector<uint64_t> tags(FETCH_LINE_COUNT, ~0ull);
+        uint64_t fetched = 0;
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            const uint64_t begin = uint64_t(indices[i]) * vertexStride;
+            const uint64_t end = begin + vertexStride;
+            for (uint64_t line = begin / FETCH_LINE_SIZE; line <= (end - 1) / FETCH_LINE_SIZE; line++) {
+                uint64_t& tag = tags[line % FETCH_LINE_COUNT];
+                if (tag != line) {
+                    tag = line;
+                    fetched += FETCH_LINE_SIZE;
+                }
+            }
+        }
+        stats.overfetch = float(double(fetched) / double(vertexCount * vertexStride));
+    }
+    return stats;
+}
+
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+    TRACE_NAME("optimizeVertexCache");
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // 每个顶点还没输出的三角形数，以及顶点到三角形的邻接表（CSR）
+    std::vector<uint32_t> live(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        live[indices[i]]++;
+    }
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        offsets[v + 1] = offsets[v] + live[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            adjacency[cursor[indices[i]]++] = uint32_t(i / 3);
+        }
+    }
+
+    VertexCache cache(vertexCount, cacheSize);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> deadEnd;          // 输出过的顶点，扇心走到死路时从这里回溯
+    std::vector<uint32_t> candidates;       // 当前扇形输出的顶点，下一个扇心的候选
+    std::vector<uint32_t> result;
+    deadEnd.reserve(triangleCount * 3);
+    result.reserve(triangleCount * 3);
+    size_t scan = 0;                        // 回溯栈也空了时按编号顺序找下一个还有三角形的顶点
+
+    auto skipDeadEnd = [&]() -> int64_t {
+        while (!deadEnd.empty()) {
+            const uint32_t vertex = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[vertex]) {
+                return vertex;
+            }
+        }
+        for (; scan < vertexCount; scan++) {
+            if (live[scan]) {
+                return int64_t(scan++);
+            }
+        }
+        return -1;
+    };
+
+    int64_t fanning = skipDeadEnd();
+    while (fanning >= 0) {
+        const uint32_t center = uint32_t(fanning);
+        candidates.clear();
+        for (uint32_t a = offsets[center]; a < offsets[center + 1]; a++) {
+            const uint32_t triangle = adjacency[a];
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = 1;
+            for (size_t k = 0; k < 3; k++) {
+                const uint32_t vertex = indices[triangle * 3 + k];
+                result.push_back(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                live[vertex]--;
+                cache.access(vertex);
+            }
+        }
+
+        // 下一个扇心：输出它剩下的三角形之后仍在缓存里的顶点中，进入缓存最早的那个；
+        // 都不满足时选任意一个还有三角形的候选，没有候选时回溯
+        fanning = -1;
+        int64_t bestPriority = -1;
+        for (const uint32_t vertex : candidates) {
+            if (!live[vertex]) {
+                continue;
+            }
+            int64_t priority = 0;
+            if (cache.age(vertex) + 2 * uint64_t(live[vertex]) <= cacheSize) {
+                priority = int64_t(cache.age(vertex));
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                fanning = vertex;
+            }
+        }
+        if (fanning < 0) {
+            fanning = skipDeadEnd();
+        }
+    }
+    std::copy(result.begin(), result.end(), indices);
+}
+
+void optimizeOverdraw(uint32_t* indices, size_t indexCount, const float3* positions, size_t vertexCount,
+        float threshold, uint32_t cacheSize) {
+    TRACE_NAME("optimizeOverdraw");
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2) {
+        return;
+    }
+
+    // 硬边界：三个顶点都不在缓存里的三角形，从这里切开不损失任何缓存命中
+    VertexCache cache(vertexCount, cacheSize);
+    std::vector<size_t> hardBoundaries;
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (cache.triangleMisses(indices + t * 3) == 3 || t == 0) {
+            hardBoundaries.push_back(t);
+        }
+    }
+    hardBoundaries.push_back(triangleCount);
+
+    // 软边界：硬簇内部继续切，只要切出的前缀 ACMR 不超过整个硬簇 ACMR 的 threshold 倍
+    std::vector<size_t> clusters;
+    for (size_t h = 0; h + 1 < hardBoundaries.size(); h++) {
+        const size_t begin = hardBoundaries[h];
+        const size_t end = hardBoundaries[h + 1];
+        cache.reset();
+        size_t clusterMisses = 0;
+        for (size_t t = begin; t < end; t++) {
+            clusterMisses += cache.triangleMisses(indices + t * 3);
+        }
+        const double limit = threshold * double(clusterMisses) / double(end - begin);
+
+        cache.reset();
+        size_t start = begin;
+        size_t misses = 0;
+        clusters.push_back(begin);
+        for (size_t t = begin; t < end; t++) {
+            misses += cache.triangleMisses(indices + t * 3);
+            if (t + 1 < end && double(misses) / double(t - start + 1) <= limit) {
+                start = t + 1;
+                misses = 0;
+                clusters.push_back(start);
+                cache.reset();
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    // 网格中心取所有被引用顶点的平均位置
+    double3 meshCenter{ 0 };
+    std::vector<uint8_t> used(vertexCount, 0);
+    size_t usedCount = 0;
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        if (!used[indices[i]]) {
+            used[indices[i]] = 1;
+            meshCenter += double3(positions[indices[i]]);
+            usedCount++;
+        }
+    }
+    meshCenter /= double(usedCount);
+
+    // 簇的排序键：面积加权的中心相对网格中心的偏移在面积加权法线上的投影，外侧朝外的簇先画
+    const size_t clusterCount = clusters.size() - 1;
+    std::vector<float> keys(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++) {
+        double3 center{ 0 };
+        double3 normal{ 0 };
+        double area = 0.0;
+        for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+            const double3 p0(positions[indices[t * 3 + 0]]);
+            const double3 p1(positions[indices[t * 3 + 1]]);
+            const double3 p2(positions[indices[t * 3 + 2]]);
+            const double3 n = cross(p1 - p0, p2 - p0);
+            const double a = length(n);
+            center += (p0 + p1 + p2) * (a / 3.0);
+            normal += n;
+            area += a;
+        }
+        const double normalLength = length(normal);
+        if (area > 0.0 && normalLength > 0.0) {
+            keys[c] = float(dot(center / area - meshCenter, normal / normalLength));
+        } else {
+            keys[c] = 0.0f;
+        }
+    }
+    std::vector<uint32_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) {
+        return keys[a] > keys[b];
+    });
+
+    std::vector<uint32_t> result;
+    result.reserve(triangleCount * 3);
+    for (const uint32_t c : order) {
+        result.insert(result.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+    }
+    std::copy(result.begin(), result.end(), indices);
+}
+
+std::vector<uint32_t> optimizeVertexFetch(uint32_t* indices, size_t indexCount, size_t vertexCount,
+        size_t& newVertexCount) {
+    TRACE_NAME("optimizeVertexFetch");
+    std::vector<uint32_t> remap(vertexCount, ~0u);
+    uint32_t next = 0;
+    for (size_t i = 0; i < indexCount; i++) {
+        uint32_t& target = remap[indices[i]];
+        if (target == ~0u) {
+            target = next++;
+        }
+        indices[i] = target;
+    }
+    newVertexCount = next;
+    return remap;
+}
+
+std::vector<uint32_t> optimizeMesh(uint32_t* indices, size_t indexCount, const float3* positions,
+        size_t vertexCount, size_t& newVertexCount, size_t vertexStride, MeshOptimizeStats* stats,
+        uint32_t cacheSize) {
+    TRACE_CALL();
+    const auto start = std::chrono::steady_clock::now();
+    if (stats) {
+        stats->before = analyzeMesh(indices, indexCount, vertexCount, vertexStride, cacheSize);
+    }
+    optimizeVertexCache(indices, indexCount, vertexCount, cacheSize);
+    optimizeOverdraw(indices, indexCount, positions, vertexCount, 1.05f, cacheSize);
+    std::vector<uint32_t> remap = optimizeVertexFetch(indices, indexCount, vertexCount, newVertexCount);
+    if (stats) {
+        stats->optimizeMs = elapsedMs(start);
+        stats->after = analyzeMesh(indices, indexCount, newVertexCount, vertexStride, cacheSize);
+        stats->triangleCount = indexCount / 3;
+        stats->vertexCount = newVertexCount;
+    }
+    return remap;
+}
+
+bool optimizeFilamesh(const std::string& path, bool write, MeshOptimizeStats& stats, uint32_t cacheSize) {
+    TRACE_CALL();
+    std::vector<uint8_t> file;
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            std::cerr << "Failed to open filamesh file: " << path << std::endl;
+            return false;
+        }
+        file.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    FilameshLayout layout;
+    const char* error = readFilameshLayout(file.data(), file.size(), layout);
+    const FilameshHeader& header = layout.header;
+    if (!error) {
+        error = checkInterleavedFilamesh(header);
+    }
+    if (error) {
+        std::cerr << error << ": " << path << std::endl;
+        return false;
+    }
+    const bool shortIndices = header.indexType == FILAMESH_INDEX_UI16;
+    const uint32_t stride = header.stridePosition;
+    const size_t partsOffset = layout.partsOffset;
+
+    const auto start = std::chrono::steady_clock::now();
+    uint8_t* vertexData = file.data() + sizeof(header);
+    uint8_t* indexData = vertexData + header.vertexSize;
+    std::vector<uint32_t> indices(header.indexCount);
+    for (uint32_t i = 0; i < header.indexCount; i++) {
+        if (shortIndices) {
+            uint16_t index;
+            std::memcpy(&index, indexData + i * sizeof(index), sizeof(index));
+            indices[i] = index;
+        } else {
+            std::memcpy(&indices[i], indexData + i * sizeof(uint32_t), sizeof(uint32_t));
+        }
+        if (indices[i] >= header.vertexCount) {
+            std::cerr << "Filamesh index out of range: " << path << std::endl;
+            return false;
+        }
+    }
+    std::vector<float3> positions(header.vertexCount);
+    for (uint32_t v = 0; v < header.vertexCount; v++) {
+        uint16_t bits[3];
+        std::memcpy(bits, vertexData + size_t(v) * stride + header.offsetPosition, sizeof(bits));
+        positions[v] = float3{ float(makeHalf(bits[0])), float(makeHalf(bits[1])), float(makeHalf(bits[2])) };
+    }
+    std::vector<FilameshPart> parts(header.parts);
+    std::memcpy(parts.data(), file.data() + partsOffset, parts.size() * sizeof(FilameshPart));
+
+    // 各 part 的顶点区间互不重叠、索引都落在自己的区间内时才能重排顶点
+    bool disjoint = true;
+    std::vector<const FilameshPart*> sorted;
+    std::vector<bool> covered(header.indexCount, false);    // 属于某个 part（第 0 级）的索引
+    for (const FilameshPart& part : parts) {
+        if (part.offset > header.indexCount || part.indexCount > header.indexCount - part.offset ||
+                part.minIndex > part.maxIndex || part.maxIndex >= header.vertexCount) {
+            std::cerr << "Filamesh part out of range: " << path << std::endl;
+            return false;
+        }
+        for (uint32_t i = part.offset; i < part.offset + part.indexCount; i++) {
+            disjoint = disjoint && indices[i] >= part.minIndex && indices[i] <= part.maxIndex;
+            covered[i] = true;
+        }
+        sorted.push_back(&part);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const FilameshPart* a, const FilameshPart* b) {
+        return a->minIndex < b->minIndex;
+    });
+    for (size_t i = 1; i < sorted.size(); i++) {
+        disjoint = disjoint && sorted[i]->minIndex > sorted[i - 1]->maxIndex;
+    }
+
+    // demo-lod 追加的 LOD 索引在 part 之后，指向同样的顶点。重排顶点后它们也要按同样的映射改写，
+    // 改写完再逐个比较 LOD 索引引用的顶点数据，确认每级的三角形没有变
+    LodTable lods;
+    const bool hasLods = readFilameshLods(file.data(), file.size(), lods);
+    std::vector<uint32_t> originalIndices;
+    std::vector<uint8_t> originalVertices;
+    if (hasLods) {
+        originalIndices = indices;
+        originalVertices.assign(vertexData, vertexData + header.vertexSize);
+    }
+
+    stats.before = analyzeMesh(indices.data(), indices.size(), header.vertexCount, stride, cacheSize);
+    std::vector<uint32_t> vertexRemap(header.vertexCount);
+    std::iota(vertexRemap.begin(), vertexRemap.end(), 0u);
+    std::vector<uint8_t> scratch;
+    for (const FilameshPart& part : parts) {
+        uint32_t* partIndices = indices.data() + part.offset;
+        if (!disjoint) {
+            optimizeVertexCache(partIndices, part.indexCount, header.vertexCount, cacheSize);
+            optimizeOverdraw(partIndices, part.indexCount, positions.data(), header.vertexCount, 1.05f,
+                    cacheSize);
+            continue;
+        }
+        // 在 part 自己的顶点区间内重新编号，未引用的顶点排在区间末尾，文件布局不变
+        const uint32_t base = part.minIndex;
+        const size_t rangeCount = size_t(part.maxIndex - part.minIndex) + 1;
+        for (uint32_t i = 0; i < part.indexCount; i++) {
+            partIndices[i] -= base;
+        }
+        size_t newCount;
+        std::vector<uint32_t> remap = optimizeMesh(partIndices, part.indexCount, positions.data() + base,
+                rangeCount, newCount, 0, nullptr, cacheSize);
+        for (uint32_t& target : remap) {
+            if (target == ~0u) {
+                target = uint32_t(newCount++);
+            }
+        }
+        scratch.resize(rangeCount * stride);
+        uint8_t* partVertices = vertexData + size_t(base) * stride;
+        for (size_t v = 0; v < rangeCount; v++) {
+            std::memcpy(scratch.data() + size_t(remap[v]) * stride, partVertices + v * stride, stride);
+        }
+        std::memcpy(partVertices, scratch.data(), scratch.size());
+        for (uint32_t i = 0; i < part.indexCount; i++) {
+            partIndices[i] += base;
+        }
+        for (size_t v = 0; v < rangeCount; v++) {
+            vertexRemap[base + v] = base + remap[v];
+        }
+    }
+    // 不属于任何 part 的索引（LOD 索引）按同样的映射改写
+    for (uint32_t i = 0; i < header.indexCount; i++) {
+        if (!covered[i]) {
+            indices[i] = vertexRemap[indices[i]];
+        }
+    }
+    if (hasLods) {
+        for (const LodLevel& lod : lods.levels) {
+            for (uint32_t i = lod.offset; i < lod.offset + lod.indexCount; i++) {
+                // 第 0 级的三角形被重排过，只比较 part 之外的级别
+                if (!covered[i] && std::memcmp(originalVertices.data() + size_t(originalIndices[i]) * stride,
+                        vertexData + size_t(indices[i]) * stride, stride) != 0) {
+                    std::cerr << "Filamesh LOD indices no longer match their vertices: " << path << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    stats.optimizeMs = elapsedMs(start);
+    stats.after = analyzeMesh(indices.data(), indices.size(), header.vertexCount, stride, cacheSize);
+    stats.triangleCount = header.indexCount / 3;
+    stats.vertexCount = header.vertexCount;
+    if (!write) {
+        return true;
+    }
+
+    for (uint32_t i = 0; i < header.indexCount; i++) {
+        if (shortIndices) {
+            const uint16_t index = uint16_t(indices[i]);
+            std::memcpy(indexData + i * sizeof(index), &index, sizeof(index));
+        } else {
+            std::memcpy(indexData + i * sizeof(uint32_t), &indices[i], sizeof(uint32_t));
+        }
+    }
+    // 先写临时文件再改名，MeshReader 或 loadMappedMesh() 正在读的旧文件不受影响
+    const std::string temporary = path + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(file.data()), std::streamsize(file.size()));
+        if (!out) {
+            std::cerr << "Failed to write filamesh file: " << temporary << std::endl;
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to rename filamesh file: " << path << " (" << std::strerror(errno) << ")"
+                  << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace demo
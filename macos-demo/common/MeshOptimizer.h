@@ -0,0 +1,91 @@
+#ifndef DEMO_COMMON_MESHOPTIMIZER_H
+#define DEMO_COMMON_MESHOPTIMIZER_H
+
+#include <math/vec3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace demo {
+
+// ========================================
+// 索引/顶点顺序优化
+// ========================================
+// OBJ、filamesh 的三角形按源文件的顺序上传，稠密网格上同一个顶点会被顶点着色器反复变换。
+// 这里按三步重排，每一步只改变顺序，不改变网格本身：
+//
+//   1. optimizeVertexCache()：Tipsify（Sander 等，2007）——围绕一个顶点扇形输出它的所有三角形，
+//      下一个扇心优先选还在后变换缓存里、剩余三角形少的顶点，走到死路时回溯最近输出过的顶点
+//   2. optimizeOverdraw()：把第 1 步的结果按缓存命中情况切成小簇，簇按“离网格中心多远、朝外多少”排序，
+//      外侧朝外的簇先画，被它们挡住的内侧片元可以被 early-Z 剔除；切簇保证 ACMR 最多变差 threshold 倍
+//   3. optimizeVertexFetch()：顶点按第一次被索引引用的顺序重新编号，顶点读取变成顺序访问，
+//      没有被引用的顶点被丢弃
+//
+// 指标用 FIFO 后变换缓存模拟：ACMR 是每个三角形平均变换的顶点数（下限约 0.5），
+// ATVR 是每个顶点平均被变换的次数（下限 1）；overfetch 是按 64 字节缓存行（128KB 直接映射缓存）
+// 读取的顶点字节数相对顶点缓冲区大小的倍数（下限 1）。
+//
+// 所有函数只处理三角形列表，索引是 [0, vertexCount) 内的 32 位顶点编号。
+
+// 模拟和优化使用的后变换缓存大小（Apple/AMD/NVIDIA 的实际大小在 16~32 之间）
+constexpr uint32_t DEFAULT_VERTEX_CACHE_SIZE = 16;
+
+struct MeshCacheStats {
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+    float overfetch = 0.0f;     // vertexStride 为 0 时不计算
+};
+
+MeshCacheStats analyzeMesh(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+        size_t vertexStride = 0, uint32_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+// 原地重排三角形
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount,
+        uint32_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+// 原地重排三角形，indices 应该已经过 optimizeVertexCache()
+void optimizeOverdraw(uint32_t* indices, size_t indexCount, const filament::math::float3* positions,
+        size_t vertexCount, float threshold = 1.05f, uint32_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+// 原地重写索引，返回旧编号到新编号的映射（未引用的顶点为 ~0u），newVertexCount 返回引用到的顶点数
+std::vector<uint32_t> optimizeVertexFetch(uint32_t* indices, size_t indexCount, size_t vertexCount,
+        size_t& newVertexCount);
+
+// 按 optimizeVertexFetch() 的映射重排一个顶点属性数组
+template<typename T>
+void remapVertices(std::vector<T>& vertices, const std::vector<uint32_t>& remap, size_t newVertexCount) {
+    std::vector<T> result(newVertexCount);
+    for (size_t i = 0; i < remap.size() && i < vertices.size(); i++) {
+        if (remap[i] != ~0u) {
+            result[remap[i]] = vertices[i];
+        }
+    }
+    vertices.swap(result);
+}
+
+struct MeshOptimizeStats {
+    MeshCacheStats before;
+    MeshCacheStats after;
+    size_t triangleCount = 0;
+    size_t vertexCount = 0;
+    double optimizeMs = 0.0;
+};
+
+// 依次执行三步，返回顶点映射（见 optimizeVertexFetch()），调用者用 remapVertices() 重排所有顶点属性。
+// stats 非空时记录优化前后的指标，vertexStride 用于计算 overfetch
+std::vector<uint32_t> optimizeMesh(uint32_t* indices, size_t indexCount,
+        const filament::math::float3* positions, size_t vertexCount, size_t& newVertexCount,
+        size_t vertexStride = 0, MeshOptimizeStats* stats = nullptr,
+        uint32_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+// 原地优化一个未压缩的交错 filamesh 文件（ObjImporter 的缓存或 filamesh 工具的输出），逐个 part 处理。
+// part 之间共享顶点时只重排三角形。demo-lod 追加的 LOD 索引随顶点一起改写，LOD 表不变。
+// write 为 false 时只统计不写回。失败时打印原因并返回 false
+bool optimizeFilamesh(const std::string& path, bool write, MeshOptimizeStats& stats,
+        uint32_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
+} // namespace demo
+
+#endif // DEMO_COMMON_MESHOPTIMIZER_H
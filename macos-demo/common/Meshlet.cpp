@@ -0,0 +1,389 @@
+#include "Meshlet.h"
+#include "Filamesh.h"
+#include "Trace.h"
+
+#include <filament/Frustum.h>
+
+#include <math/half.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+using namespace filament;
+using namespace filament::math;
+
+namespace demo {
+
+namespace {
+
+// 法线与锥轴的最小夹角余弦不超过这个值时锥太宽，剔除几乎不会发生，直接不做背面测试
+constexpr float MIN_CONE_DOT = 0.1f;
+
+enum Visibility : uint8_t {
+    VISIBLE = 0,
+    OUTSIDE_FRUSTUM = 1,
+    BACKFACING = 2,
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 位置完全相同的顶点映射到同一个代表顶点，簇的生长不会在 UV/法线接缝处断开
+std::vector<uint32_t> weldPositions(const float3* positions, size_t vertexCount) {
+    std::vector<uint32_t> order(vertexCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [positions](uint32_t a, uint32_t b) {
+        const float3& p = positions[a];
+        const float3& q = positions[b];
+        if (p.x != q.x) return p.x < q.x;
+        if (p.y != q.y) return p.y < q.y;
+        if (p.z != q.z) return p.z < q.z;
+        return a < b;
+    });
+    std::vector<uint32_t> welded(vertexCount);
+    for (size_t begin = 0; begin < vertexCount;) {
+        size_t end = begin + 1;
+        while (end < vertexCount && positions[order[end]] == positions[order[begin]]) {
+            end++;
+        }
+        for (size_t i = begin; i < end; i++) {
+            welded[order[i]] = order[begin];
+        }
+        begin = end;
+    }
+    return welded;
+}
+
+// 簇的 AABB、包围球和法线锥
+void computeBounds(const uint32_t* indices, size_t indexCount, const float3* positions, Meshlet& meshlet) {
+    float3 minimum = positions[indices[0]];
+    float3 maximum = minimum;
+    for (size_t i = 1; i < indexCount; i++) {
+        minimum = min(minimum, positions[indices[i]]);
+        maximum = max(maximum, positions[indices[i]]);
+    }
+    meshlet.bounds = Box().set(minimum, maximum);
+    float radius = 0.0f;
+    for (size_t i = 0; i < indexCount; i++) {
+        radius = std::max(radius, distance(positions[indices[i]], meshlet.bounds.center));
+    }
+    meshlet.radius = radius;
+
+    float3 normals[256];
+    size_t normalCount = 0;
+    float3 axis = 0.0f;
+    for (size_t i = 0; i < indexCount && normalCount < 256; i += 3) {
+        const float3& a = positions[indices[i]];
+        const float3 n = cross(positions[indices[i + 1]] - a, positions[indices[i + 2]] - a);
+        const float area = length(n);
+        if (area > 0.0f) {
+            normals[normalCount++] = n / area;
+            axis += n / area;
+        }
+    }
+    const float axisLength = length(axis);
+    meshlet.coneCutoff = 1.0f;
+    if (normalCount == 0 || !(axisLength > 1e-6f)) {
+        return;
+    }
+    meshlet.coneAxis = axis / axisLength;
+    float minDot = 1.0f;
+    for (size_t i = 0; i < normalCount; i++) {
+        minDot = std::min(minDot, dot(normals[i], meshlet.coneAxis));
+    }
+    if (minDot > MIN_CONE_DOT) {
+        meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+} // anonymous namespace
+
+void buildMeshlets(const uint32_t* indices, size_t indexCount, const float3* positions, size_t vertexCount,
+        uint32_t part, const MeshletOptions& options, MeshletMesh& out) {
+    TRACE_CALL();
+    out.partCount = std::max(out.partCount, part + 1);
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || vertexCount == 0) {
+        return;
+    }
+    const uint32_t maxVertices = std::max(options.maxVertices, 3u);
+    const uint32_t maxTriangles = std::clamp(options.maxTriangles, 1u, 256u);
+
+    // 代表顶点 -> 相邻三角形（CSR）
+    const std::vector<uint32_t> welded = weldPositions(positions, vertexCount);
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        adjacencyOffsets[welded[indices[i]] + 1]++;
+    }
+    std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            adjacency[fill[welded[indices[i]]]++] = uint32_t(i / 3);
+        }
+    }
+    std::vector<float3> centroids(triangleCount);
+    std::vector<float3> normals(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++) {
+        const float3& a = positions[indices[t * 3]];
+        const float3& b = positions[indices[t * 3 + 1]];
+        const float3& c = positions[indices[t * 3 + 2]];
+        centroids[t] = (a + b + c) / 3.0f;
+        const float3 n = cross(b - a, c - a);
+        const float area = length(n);
+        normals[t] = area > 0.0f ? n / area : float3(0.0f);
+    }
+    const float coneWeight = std::clamp(options.coneWeight, 0.0f, 1.0f);
+
+    std::vector<bool> used(triangleCount, false);
+    std::vector<uint32_t> stamp(vertexCount, ~0u);     // 顶点最后加入的簇
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> triangles;
+    size_t remaining = triangleCount;
+    size_t scan = 0;
+    uint32_t meshletIndex = 0;
+    uint32_t meshletVertices = 0;
+    float3 centroidSum = 0.0f;
+    float3 normalSum = 0.0f;
+
+    auto addTriangle = [&](uint32_t t) {
+        used[t] = true;
+        remaining--;
+        triangles.push_back(t);
+        centroidSum += centroids[t];
+        normalSum += normals[t];
+        for (int k = 0; k < 3; k++) {
+            const uint32_t v = indices[t * 3 + k];
+            if (stamp[v] != meshletIndex) {
+                stamp[v] = meshletIndex;
+                meshletVertices++;
+            }
+            const uint32_t w = welded[v];
+            for (uint32_t a = adjacencyOffsets[w]; a < adjacencyOffsets[w + 1]; a++) {
+                if (!used[adjacency[a]]) {
+                    candidates.push_back(adjacency[a]);
+                }
+            }
+        }
+    };
+
+    while (remaining > 0) {
+        // 上一个簇边上剩下的三角形作为种子，簇之间在空间上保持连续
+        uint32_t seed = ~0u;
+        for (uint32_t t : candidates) {
+            if (!used[t]) {
+                seed = t;
+                break;
+            }
+        }
+        if (seed == ~0u) {
+            while (used[scan]) {
+                scan++;
+            }
+            seed = uint32_t(scan);
+        }
+        candidates.clear();
+        triangles.clear();
+        meshletVertices = 0;
+        centroidSum = 0.0f;
+        normalSum = 0.0f;
+        addTriangle(seed);
+
+        while (triangles.size() < maxTriangles) {
+            const float3 center = centroidSum / float(triangles.size());
+            const float normalLength = length(normalSum);
+            const float3 normal = normalLength > 0.0f ? normalSum / normalLength : float3(0.0f);
+            uint32_t best = ~0u;
+            bool bestFills = false;
+            float bestScore = std::numeric_limits<float>::max();
+            size_t write = 0;
+            for (uint32_t t : candidates) {
+                if (used[t]) {
+                    continue;
+                }
+                candidates[write++] = t;
+                uint32_t newVertices = 0;
+                for (int k = 0; k < 3; k++) {
+                    newVertices += stamp[indices[t * 3 + k]] != meshletIndex ? 1 : 0;
+                }
+                if (meshletVertices + newVertices > maxVertices) {
+                    continue;
+                }
+                // 不引入新顶点的三角形（填补簇里的缺口）优先，其次按距离打分，法线偏离簇的平均法线时距离被放大
+                const bool fills = newVertices == 0;
+                const float spread = dot(normals[t], normal);
+                const float score = distance(centroids[t], center) *
+                        std::max(1.0f - spread * coneWeight, 1e-3f);
+                if ((fills && !bestFills) || (fills == bestFills && score < bestScore)) {
+                    best = t;
+                    bestFills = fills;
+                    bestScore = score;
+                }
+            }
+            candidates.resize(write);
+            if (best == ~0u) {
+                break;
+            }
+            addTriangle(best);
+        }
+
+        Meshlet meshlet;
+        meshlet.offset = uint32_t(out.indices.size());
+        meshlet.indexCount = uint32_t(triangles.size() * 3);
+        meshlet.part = part;
+        for (uint32_t t : triangles) {
+            out.indices.insert(out.indices.end(), indices + t * 3, indices + t * 3 + 3);
+        }
+        computeBounds(out.indices.data() + meshlet.offset, meshlet.indexCount, positions, meshlet);
+        out.meshlets.push_back(meshlet);
+        meshletIndex++;
+    }
+}
+
+bool buildFilameshMeshlets(const uint8_t* file, size_t size, const MeshletOptions& options, MeshletMesh& out) {
+    TRACE_CALL();
+    FilameshLayout layout;
+    if (const char* error = readFilameshLayout(file, size, layout)) {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    const FilameshHeader& header = layout.header;
+    if (header.flags & FILAMESH_COMPRESSION) {
+        std::cerr << "Compressed filamesh files cannot be split into meshlets" << std::endl;
+        return false;
+    }
+    const bool shortIndices = header.indexType == FILAMESH_INDEX_UI16;
+    const size_t elementSize = filameshIndexElementSize(header);
+    const size_t indicesOffset = layout.indicesOffset;
+    const size_t partsOffset = layout.partsOffset;
+    if (header.vertexCount == 0 || header.stridePosition == 0 ||
+            uint64_t(header.vertexCount - 1) * header.stridePosition + header.offsetPosition +
+                    sizeof(uint16_t) * 3 > header.vertexSize ||
+            uint64_t(header.indexCount) * elementSize > header.indexSize) {
+        std::cerr << "Truncated filamesh file" << std::endl;
+        return false;
+    }
+
+    const uint8_t* vertexData = file + sizeof(header);
+    std::vector<float3> positions(header.vertexCount);
+    for (uint32_t v = 0; v < header.vertexCount; v++) {
+        uint16_t bits[3];
+        std::memcpy(bits, vertexData + size_t(v) * header.stridePosition + header.offsetPosition, sizeof(bits));
+        positions[v] = float3{ float(makeHalf(bits[0])), float(makeHalf(bits[1])), float(makeHalf(bits[2])) };
+    }
+    out = {};
+    std::vector<uint32_t> partIndices;
+    for (uint32_t p = 0; p < header.parts; p++) {
+        FilameshPart part;
+        std::memcpy(&part, file + partsOffset + p * sizeof(part), sizeof(part));
+        if (part.offset > header.indexCount || part.indexCount > header.indexCount - part.offset ||
+                part.minIndex > part.maxIndex || part.maxIndex >= header.vertexCount) {
+            std::cerr << "Filamesh part out of range" << std::endl;
+            return false;
+        }
+        // 在 part 自己的顶点区间内建簇，邻接表只覆盖这个区间
+        partIndices.resize(part.indexCount);
+        const uint8_t* indexData = file + indicesOffset + size_t(part.offset) * elementSize;
+        for (uint32_t i = 0; i < part.indexCount; i++) {
+            uint32_t index;
+            if (shortIndices) {
+                uint16_t shortIndex;
+                std::memcpy(&shortIndex, indexData + i * sizeof(shortIndex), sizeof(shortIndex));
+                index = shortIndex;
+            } else {
+                std::memcpy(&index, indexData + i * sizeof(index), sizeof(index));
+            }
+            if (index < part.minIndex || index > part.maxIndex) {
+                std::cerr << "Filamesh index out of part range" << std::endl;
+                return false;
+            }
+            partIndices[i] = index - part.minIndex;
+        }
+        const size_t first = out.indices.size();
+        buildMeshlets(partIndices.data(), partIndices.size(), positions.data() + part.minIndex,
+                size_t(part.maxIndex - part.minIndex) + 1, p, options, out);
+        for (size_t i = first; i < out.indices.size(); i++) {
+            out.indices[i] += part.minIndex;
+        }
+    }
+    return true;
+}
+
+size_t MeshletCuller::cull(const MeshletMesh& mesh, const mat4f& modelViewProjection, const float3& eye,
+        uint32_t* output, std::vector<MeshletRange>& ranges, bool backface) {
+    TRACE_CALL();
+    const auto start = std::chrono::steady_clock::now();
+    const Frustum frustum(modelViewProjection);
+    const size_t count = mesh.meshlets.size();
+    const size_t chunks = (count + MIN_MESHLETS_PER_THREAD - 1) / MIN_MESHLETS_PER_THREAD;
+    mVisibility.resize(count);
+    mOffsets.resize(count);
+
+    // 1. 并行测试每个簇
+    mPool.run(chunks, [&](size_t begin, size_t end) {
+        const size_t last = std::min(end * MIN_MESHLETS_PER_THREAD, count);
+        for (size_t i = begin * MIN_MESHLETS_PER_THREAD; i < last; i++) {
+            const Meshlet& meshlet = mesh.meshlets[i];
+            if (!frustum.intersects(meshlet.bounds)) {
+                mVisibility[i] = OUTSIDE_FRUSTUM;
+                continue;
+            }
+            const float3 direction = meshlet.bounds.center - eye;
+            mVisibility[i] = backface && dot(direction, meshlet.coneAxis) >=
+                    meshlet.coneCutoff * length(direction) + meshlet.radius ? BACKFACING : VISIBLE;
+        }
+    });
+
+    // 2. 串行前缀和：可见簇在 output 中的偏移和每个 part 的区间（簇数只有三角形数的百分之一）
+    mStats = {};
+    mStats.meshlets = uint32_t(count);
+    ranges.assign(mesh.partCount, MeshletRange{});
+    uint32_t total = 0;
+    uint32_t currentPart = ~0u;
+    for (size_t i = 0; i < count; i++) {
+        const Meshlet& meshlet = mesh.meshlets[i];
+        if (meshlet.part != currentPart) {
+            currentPart = meshlet.part;
+            ranges[currentPart].offset = total;
+        }
+        mStats.triangles += meshlet.indexCount / 3;
+        switch (mVisibility[i]) {
+            case VISIBLE:
+                mOffsets[i] = total;
+                total += meshlet.indexCount;
+                ranges[currentPart].indexCount += meshlet.indexCount;
+                mStats.visibleMeshlets++;
+                mStats.visibleTriangles += meshlet.indexCount / 3;
+                break;
+            case OUTSIDE_FRUSTUM:
+                mStats.frustumCulled++;
+                break;
+            case BACKFACING:
+                mStats.backfaceCulled++;
+                break;
+        }
+    }
+
+    // 3. 并行压缩：可见簇的索引拷贝到各自的偏移
+    mPool.run(chunks, [&](size_t begin, size_t end) {
+        const size_t last = std::min(end * MIN_MESHLETS_PER_THREAD, count);
+        for (size_t i = begin * MIN_MESHLETS_PER_THREAD; i < last; i++) {
+            if (mVisibility[i] == VISIBLE) {
+                const Meshlet& meshlet = mesh.meshlets[i];
+                std::memcpy(output + mOffsets[i], mesh.indices.data() + meshlet.offset,
+                        meshlet.indexCount * sizeof(uint32_t));
+            }
+        }
+    });
+    mStats.cullMs = elapsedMs(start);
+    return total;
+}
+
+} // namespace demo
@@ -0,0 +1,106 @@
+#ifndef DEMO_COMMON_MESHLET_H
+#define DEMO_COMMON_MESHLET_H
+
+#include "Parallel.h"
+
+#include <filament/Box.h>
+
+#include <math/mat4.h>
+#include <math/vec3.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace demo {
+
+// ========================================
+// 簇（meshlet）划分与 CPU 簇剔除
+// ========================================
+// RenderableManager::Builder::boundingBox() 只能整个实体一起剔除，lucy 这样的稠密网格靠近看时
+// 大部分三角形在屏幕外或背对相机，仍然全部提交。这里把网格切成几十到一百多个三角形的簇：
+//
+//   buildMeshlets()：从一个三角形开始，反复加入与簇共享顶点（按位置焊接）的三角形，
+//      优先不引入新顶点的，其次离簇中心近、法线与簇平均法线接近的，直到顶点数或三角形数到上限；
+//      每个簇记录 AABB、包围球和法线锥（轴是三角形法线的平均方向，cutoff 由与轴夹角最大的法线决定）
+//   MeshletCuller::cull()：在 WorkerPool 上并行地用相机视锥（模型空间）测试每个簇的 AABB，
+//      用法线锥测试整簇是否背对相机，再把留下的簇的索引区间并行拷贝成一段连续的索引，
+//      调用者每帧把它上传到一个索引缓冲区
+//
+// 背面测试（Zeux，meshoptimizer）：dot(center - eye, axis) >= cutoff * |center - eye| + radius 时，
+// 从 eye 看簇里所有三角形都是背面。cutoff = sin(锥的半角)，锥超过半球时为 1，永远不剔除。
+
+struct MeshletOptions {
+    uint32_t maxVertices = 64;
+    uint32_t maxTriangles = 124;   // 最多 256
+    float coneWeight = 0.5f;        // 0 只按距离生长；越大越偏向法线一致的三角形，法线锥更窄、背面剔除更多
+};
+
+struct Meshlet {
+    uint32_t offset = 0;            // MeshletMesh::indices 中的偏移
+    uint32_t indexCount = 0;
+    uint32_t part = 0;
+    filament::Box bounds;           // 模型空间 AABB
+    float radius = 0.0f;            // 以 bounds.center 为中心的包围球半径
+    filament::math::float3 coneAxis = { 0.0f, 0.0f, 1.0f };
+    float coneCutoff = 1.0f;
+};
+
+struct MeshletMesh {
+    std::vector<uint32_t> indices;  // 按簇重排的索引，每个簇连续
+    std::vector<Meshlet> meshlets;  // 同一 part 的簇相邻，part 按编号递增
+    uint32_t partCount = 0;
+};
+
+// 把一个三角形列表切成簇追加到 out，簇记录为第 part 个 part（out.partCount 随之增大）
+void buildMeshlets(const uint32_t* indices, size_t indexCount, const filament::math::float3* positions,
+        size_t vertexCount, uint32_t part, const MeshletOptions& options, MeshletMesh& out);
+
+// 为内存中的 filamesh（不支持压缩）的每个 part 建簇，索引仍然引用文件的顶点缓冲区。
+// 失败时打印原因并返回 false
+bool buildFilameshMeshlets(const uint8_t* file, size_t size, const MeshletOptions& options, MeshletMesh& out);
+
+// 一个 part 剔除后的索引区间
+struct MeshletRange {
+    uint32_t offset = 0;
+    uint32_t indexCount = 0;
+};
+
+struct MeshletCullStats {
+    uint32_t meshlets = 0;
+    uint32_t visibleMeshlets = 0;
+    uint32_t frustumCulled = 0;
+    uint32_t backfaceCulled = 0;
+    uint64_t triangles = 0;
+    uint64_t visibleTriangles = 0;
+    double cullMs = 0.0;
+};
+
+class MeshletCuller {
+public:
+    // threadCount 包括调用线程，0 表示使用全部硬件线程
+    explicit MeshletCuller(uint32_t threadCount = 0) : mPool(threadCount) {}
+
+    // modelViewProjection 把模型空间变到裁剪空间，eye 是模型空间中的相机位置。
+    // output 至少要有 mesh.indices.size() 个元素；ranges 返回每个 part 在 output 中的区间。
+    // backface 为 false 时只做视锥剔除（双面材质）。返回写入的索引数
+    size_t cull(const MeshletMesh& mesh, const filament::math::mat4f& modelViewProjection,
+            const filament::math::float3& eye, uint32_t* output, std::vector<MeshletRange>& ranges,
+            bool backface = true);
+
+    const MeshletCullStats& getStats() const noexcept { return mStats; }
+    uint32_t getThreadCount() const noexcept { return mPool.getThreadCount(); }
+
+private:
+    // 一个线程至少处理这么多个簇，簇少时不值得唤醒其他线程
+    static constexpr size_t MIN_MESHLETS_PER_THREAD = 1024;
+
+    WorkerPool mPool;
+    std::vector<uint8_t> mVisibility;   // 0 可见，1 视锥外，2 背面
+    std::vector<uint32_t> mOffsets;     // 每个可见簇在 output 中的偏移
+    MeshletCullStats mStats;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_MESHLET_H
@@ -0,0 +1,1124 @@
+#include "ObjImporter.h"
+#include "Filamesh.h"
+#include "Parallel.h"
+#include "TangentSpace.h"
+#include "Trace.h"
+
+#include <math/half.h>
+#include <math/vec2.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+using namespace filament::math;
+
+namespace demo {
+
+namespace {
+
+// 导入逻辑或输出格式变化时递增，旧缓存的文件名随之失效
+constexpr uint64_t IMPORTER_VERSION = 3;
+// 内容哈希按固定大小的块并行计算，结果与线程数无关
+constexpr size_t HASH_BLOCK_SIZE = 1024 * 1024;
+// 每个解析线程至少分到这么多字节，小文件不值得切块
+constexpr size_t MIN_PARSE_CHUNK = 64 * 1024;
+// 去重的分片数固定，与线程数无关
+constexpr uint32_t DEDUP_SHARD_BITS = 6;
+constexpr uint32_t DEDUP_SHARDS = 1u << DEDUP_SHARD_BITS;
+
+constexpr int32_t NO_INDEX = std::numeric_limits<int32_t>::min();
+constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+// MeshReader 的顶点属性：HALF4 位置、SHORT4 切线空间四元数、UBYTE4 颜色、HALF2 UV。
+// half 向量没有平凡的默认构造，这里直接保存 half 的位模式
+struct FilameshVertex {
+    uint16_t position[4];
+    short4 tangents;
+    uint8_t color[4];
+    uint16_t uv0[2];
+};
+static_assert(sizeof(FilameshVertex) == 24, "filamesh vertices are tightly packed");
+
+// ========================================
+// 文件映射和内容哈希
+// ========================================
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() {
+        if (mData) {
+            munmap(const_cast<char*>(mData), mSize);
+        }
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        TRACE_NAME("ObjImporter::map");
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Failed to open OBJ file: " << path << " (" << std::strerror(errno) << ")"
+                      << std::endl;
+            return false;
+        }
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            std::cerr << "Empty OBJ file: " << path << std::endl;
+            close(fd);
+            return false;
+        }
+        const size_t size = size_t(info.st_size);
+        void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            std::cerr << "Failed to map OBJ file: " << path << " (" << std::strerror(errno) << ")"
+                      << std::endl;
+            return false;
+        }
+        // 哈希和解析都是顺序读取，提前让内核把整个文件读进来
+        madvise(address, size, MADV_WILLNEED);
+        mData = static_cast<const char*>(address);
+        mSize = size;
+        return true;
+    }
+
+    const char* data() const noexcept { return mData; }
+    size_t size() const noexcept { return mSize; }
+
+private:
+    const char* mData = nullptr;
+    size_t mSize = 0;
+};
+
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// 每 1MB 一块并行哈希，再把块哈希、文件大小、导入器版本和影响输出的选项合成一个哈希
+uint64_t hashContent(const char* data, size_t size, uint32_t threadCount, bool optimize) {
+    TRACE_NAME("ObjImporter::hash");
+    const size_t blockCount = (size + HASH_BLOCK_SIZE - 1) / HASH_BLOCK_SIZE;
+    std::vector<uint64_t> blockHashes(blockCount);
+    parallelFor(threadCount, blockCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const size_t offset = i * HASH_BLOCK_SIZE;
+            blockHashes[i] = fnv1a(data + offset, std::min(HASH_BLOCK_SIZE, size - offset));
+        }
+    });
+    uint64_t hash = fnv1a(&IMPORTER_VERSION, sizeof(IMPORTER_VERSION));
+    const uint8_t optimized = optimize;
+    hash = fnv1a(&optimized, sizeof(optimized), hash);
+    const uint64_t size64 = size;
+    hash = fnv1a(&size64, sizeof(size64), hash);
+    return fnv1a(blockHashes.data(), blockHashes.size() * sizeof(uint64_t), hash);
+}
+
+// ========================================
+// 解析
+// ========================================
+// 一个三角形顶点的 (位置, UV, 法线) 序号，从 0 开始，缺少的分量为 NO_INDEX
+struct Corner {
+    int32_t index[3];
+};
+
+enum Attribute : uint8_t { POSITION = 0, UV = 1, NORMAL = 2 };
+
+bool operator==(const Corner& a, const Corner& b) noexcept {
+    return a.index[0] == b.index[0] && a.index[1] == b.index[1] && a.index[2] == b.index[2];
+}
+
+uint64_t hashCorner(const Corner& c) noexcept {
+    uint64_t h = uint64_t(uint32_t(c.index[0])) * 0x9e3779b97f4a7c15ull;
+    h ^= uint64_t(uint32_t(c.index[1])) * 0xc2b2ae3d27d4eb4full;
+    h ^= uint64_t(uint32_t(c.index[2])) * 0x165667b19e3779f9ull;
+    h ^= h >> 31;
+    h *= 0xbf58476d1ce4e5b9ull;
+    return h ^ (h >> 29);
+}
+
+// 一个解析线程的结果。序号在合并时才变成全局序号：
+// 正序号本来就是全局的，负序号（相对当前已出现的数量）先换算成相对本块起点的序号，记在 relative 中
+struct ObjChunk {
+    std::vector<float3> positions;
+    std::vector<float2> uvs;
+    std::vector<float3> normals;
+    std::vector<Corner> corners;            // 每个三角形 3 个
+
+    struct Fixup {
+        uint32_t corner;
+        Attribute attribute;
+    };
+    std::vector<Fixup> relative;
+
+    // 从 firstTriangle 开始使用 materialNames[name]
+    struct MaterialRun {
+        uint32_t firstTriangle;
+        uint32_t name;
+    };
+    std::vector<MaterialRun> materials;
+    std::vector<std::string> materialNames;
+
+    std::string error;
+};
+
+bool isSpace(char c) noexcept {
+    return c == ' ' || c == '\t';
+}
+
+bool isDigit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+const char* skipSpaces(const char* p, const char* end) noexcept {
+    while (p < end && isSpace(*p)) {
+        p++;
+    }
+    return p;
+}
+
+// 十进制浮点数（可选符号、小数、指数），不依赖 locale，比 strtof 快得多
+bool parseFloat(const char*& p, const char* end, float& out) noexcept {
+    static constexpr double POWERS_OF_TEN[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    constexpr uint64_t MAX_MANTISSA = 100000000000000000ull;
+
+    p = skipSpaces(p, end);
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    for (; p < end && isDigit(*p); p++) {
+        if (mantissa < MAX_MANTISSA) {
+            mantissa = mantissa * 10 + uint64_t(*p - '0');
+        } else {
+            exponent++;
+        }
+        hasDigits = true;
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && isDigit(*p); p++) {
+            if (mantissa < MAX_MANTISSA) {
+                mantissa = mantissa * 10 + uint64_t(*p - '0');
+                exponent--;
+            }
+            hasDigits = true;
+        }
+    }
+    if (!hasDigits) {
+        return false;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negativeExponent = *p == '-';
+            p++;
+        }
+        if (p >= end || !isDigit(*p)) {
+            return false;
+        }
+        int value = 0;
+        for (; p < end && isDigit(*p); p++) {
+            value = std::min(value * 10 + (*p - '0'), 1000);
+        }
+        exponent += negativeExponent ? -value : value;
+    }
+
+    double value = double(mantissa);
+    if (exponent < 0) {
+        value = -exponent <= 22 ? value / POWERS_OF_TEN[-exponent] : value * std::pow(10.0, exponent);
+    } else if (exponent > 0) {
+        value = exponent <= 22 ? value * POWERS_OF_TEN[exponent] : value * std::pow(10.0, exponent);
+    }
+    out = float(negative ? -value : value);
+    return true;
+}
+
+bool parseInt(const char*& p, const char* end, int32_t& out) noexcept {
+    bool negative = false;
+    if (p < end && *p == '-') {
+        negative = true;
+        p++;
+    }
+    if (p >= end || !isDigit(*p)) {
+        return false;
+    }
+    int64_t value = 0;
+    for (; p < end && isDigit(*p); p++) {
+        value = std::min<int64_t>(value * 10 + (*p - '0'), std::numeric_limits<int32_t>::max());
+    }
+    out = int32_t(negative ? -value : value);
+    return true;
+}
+
+bool startsWith(const char* p, const char* end, const char* keyword) noexcept {
+    const size_t length = std::strlen(keyword);
+    return size_t(end - p) > length && std::memcmp(p, keyword, length) == 0 && isSpace(p[length]);
+}
+
+class ChunkParser {
+public:
+    explicit ChunkParser(ObjChunk& chunk) : mChunk(chunk) {}
+
+    void parse(const char* begin, const char* end) {
+        for (const char* p = begin; p < end && mChunk.error.empty();) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)));
+            if (!lineEnd) {
+                lineEnd = end;
+            }
+            const char* contentEnd = lineEnd;
+            if (contentEnd > p && contentEnd[-1] == '\r') {
+                contentEnd--;
+            }
+            if (!parseLine(skipSpaces(p, contentEnd), contentEnd)) {
+                mChunk.error = "Malformed OBJ line: " + std::string(p, contentEnd);
+            }
+            p = lineEnd + 1;
+        }
+    }
+
+private:
+    // relative 的第 i 位表示 corner.index[i] 是相对本块起点的序号
+    struct FaceCorner {
+        Corner corner;
+        uint8_t relative;
+    };
+
+    bool parseLine(const char* p, const char* end) {
+        if (startsWith(p, end, "v")) {
+            float3 position;
+            p += 1;
+            if (!parseFloat(p, end, position.x) || !parseFloat(p, end, position.y) ||
+                    !parseFloat(p, end, position.z)) {
+                return false;
+            }
+            mChunk.positions.push_back(position);
+        } else if (startsWith(p, end, "vt")) {
+            float2 uv{};
+            p += 2;
+            if (!parseFloat(p, end, uv.x)) {
+                return false;
+            }
+            // v 分量可以省略
+            parseFloat(p, end, uv.y);
+            mChunk.uvs.push_back(uv);
+        } else if (startsWith(p, end, "vn")) {
+            float3 normal;
+            p += 2;
+            if (!parseFloat(p, end, normal.x) || !parseFloat(p, end, normal.y) ||
+                    !parseFloat(p, end, normal.z)) {
+                return false;
+            }
+            mChunk.normals.push_back(normal);
+        } else if (startsWith(p, end, "f")) {
+            return parseFace(p + 1, end);
+        } else if (startsWith(p, end, "usemtl")) {
+            p = skipSpaces(p + 6, end);
+            while (end > p && isSpace(end[-1])) {
+                end--;
+            }
+            mChunk.materials.push_back({ uint32_t(mChunk.corners.size() / 3),
+                    uint32_t(mChunk.materialNames.size()) });
+            mChunk.materialNames.emplace_back(p, end);
+        }
+        // 注释、o/g/s/mtllib 等其他语句不影响几何数据
+        return true;
+    }
+
+    bool parseIndex(const char*& p, const char* end, Attribute attribute, FaceCorner& corner) {
+        int32_t value;
+        if (!parseInt(p, end, value) || value == 0) {
+            return false;
+        }
+        if (value > 0) {
+            corner.corner.index[attribute] = value - 1;
+        } else {
+            // 负序号相对于当前已经出现的数量，合并时再加上本块之前的数量
+            const size_t count = attribute == POSITION ? mChunk.positions.size()
+                    : attribute == UV ? mChunk.uvs.size() : mChunk.normals.size();
+            corner.corner.index[attribute] = int32_t(int64_t(count) + value);
+            corner.relative |= uint8_t(1u << attribute);
+        }
+        return true;
+    }
+
+    bool parseFace(const char* p, const char* end) {
+        mFace.clear();
+        for (p = skipSpaces(p, end); p < end; p = skipSpaces(p, end)) {
+            FaceCorner corner{ { { NO_INDEX, NO_INDEX, NO_INDEX } }, 0 };
+            if (!parseIndex(p, end, POSITION, corner)) {
+                return false;
+            }
+            if (p < end && *p == '/') {
+                p++;
+                if (p < end && *p != '/' && !parseIndex(p, end, UV, corner)) {
+                    return false;
+                }
+                if (p < end && *p == '/') {
+                    p++;
+                    if (!parseIndex(p, end, NORMAL, corner)) {
+                        return false;
+                    }
+                }
+            }
+            if (p < end && !isSpace(*p)) {
+                return false;
+            }
+            mFace.push_back(corner);
+        }
+        if (mFace.size() < 3) {
+            return false;
+        }
+        // 凸多边形按扇形三角化
+        for (size_t i = 1; i + 1 < mFace.size(); i++) {
+            emit(mFace[0]);
+            emit(mFace[i]);
+            emit(mFace[i + 1]);
+        }
+        return true;
+    }
+
+    void emit(const FaceCorner& corner) {
+        const uint32_t index = uint32_t(mChunk.corners.size());
+        mChunk.corners.push_back(corner.corner);
+        for (uint8_t attribute = POSITION; attribute <= NORMAL; attribute++) {
+            if (corner.relative & (1u << attribute)) {
+                mChunk.relative.push_back({ index, Attribute(attribute) });
+            }
+        }
+    }
+
+    ObjChunk& mChunk;
+    std::vector<FaceCorner> mFace;
+};
+
+// 按行边界把 [data, data + size) 切成最多 threadCount 块
+std::vector<std::pair<size_t, size_t>> splitLines(const char* data, size_t size, uint32_t threadCount) {
+    const size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threadCount, size / MIN_PARSE_CHUNK));
+    std::vector<std::pair<size_t, size_t>> ranges;
+    size_t begin = 0;
+    for (size_t i = 1; i <= chunkCount && begin < size; i++) {
+        size_t end = i == chunkCount ? size : std::max(begin, size * i / chunkCount);
+        if (end < size) {
+            const void* newline = std::memchr(data + end, '\n', size - end);
+            end = newline ? size_t(static_cast<const char*>(newline) - data) + 1 : size;
+        }
+        ranges.emplace_back(begin, end);
+        begin = end;
+    }
+    return ranges;
+}
+
+// ========================================
+// 合并后的网格
+// ========================================
+struct ObjMesh {
+    std::vector<float3> positions;
+    std::vector<float2> uvs;
+    std::vector<float3> normals;
+    std::vector<Corner> corners;
+    std::vector<std::string> materialNames;
+    // 每个 part 的三角形序号，part 顺序与材质首次出现的顺序一致
+    std::vector<std::vector<uint32_t>> parts;
+    bool hasUvs = false;
+};
+
+bool mergeChunks(std::vector<ObjChunk>& chunks, uint32_t threadCount, ObjMesh& mesh) {
+    TRACE_NAME("ObjImporter::merge");
+    const size_t chunkCount = chunks.size();
+    std::vector<size_t> positionBase(chunkCount), uvBase(chunkCount), normalBase(chunkCount);
+    std::vector<size_t> cornerBase(chunkCount);
+    size_t positionCount = 0, uvCount = 0, normalCount = 0, cornerCount = 0;
+    for (size_t i = 0; i < chunkCount; i++) {
+        if (!chunks[i].error.empty()) {
+            std::cerr << chunks[i].error << std::endl;
+            return false;
+        }
+        positionBase[i] = positionCount;
+        uvBase[i] = uvCount;
+        normalBase[i] = normalCount;
+        cornerBase[i] = cornerCount;
+        positionCount += chunks[i].positions.size();
+        uvCount += chunks[i].uvs.size();
+        normalCount += chunks[i].normals.size();
+        cornerCount += chunks[i].corners.size();
+    }
+    if (cornerCount == 0) {
+        std::cerr << "OBJ file has no faces" << std::endl;
+        return false;
+    }
+    if (positionCount > size_t(std::numeric_limits<int32_t>::max()) ||
+            cornerCount > size_t(std::numeric_limits<uint32_t>::max())) {
+        std::cerr << "OBJ file is too large" << std::endl;
+        return false;
+    }
+
+    mesh.positions.resize(positionCount);
+    mesh.uvs.resize(uvCount);
+    mesh.normals.resize(normalCount);
+    mesh.corners.resize(cornerCount);
+    const int32_t limits[3] = { int32_t(positionCount), int32_t(uvCount), int32_t(normalCount) };
+    std::atomic<bool> valid{ true };
+    std::atomic<bool> hasUvs{ false };
+    parallelFor(threadCount, chunkCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            ObjChunk& chunk = chunks[i];
+            std::copy(chunk.positions.begin(), chunk.positions.end(), mesh.positions.begin() + positionBase[i]);
+            std::copy(chunk.uvs.begin(), chunk.uvs.end(), mesh.uvs.begin() + uvBase[i]);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), mesh.normals.begin() + normalBase[i]);
+            const size_t bases[3] = { positionBase[i], uvBase[i], normalBase[i] };
+            for (const auto& fixup : chunk.relative) {
+                chunk.corners[fixup.corner].index[fixup.attribute] += int32_t(bases[fixup.attribute]);
+            }
+            bool chunkHasUvs = false;
+            for (const Corner& corner : chunk.corners) {
+                for (int attribute = POSITION; attribute <= NORMAL; attribute++) {
+                    const int32_t index = corner.index[attribute];
+                    if (index != NO_INDEX && (index < 0 || index >= limits[attribute])) {
+                        valid = false;
+                    }
+                }
+                chunkHasUvs |= corner.index[UV] != NO_INDEX;
+            }
+            if (chunkHasUvs) {
+                hasUvs = true;
+            }
+            std::copy(chunk.corners.begin(), chunk.corners.end(), mesh.corners.begin() + cornerBase[i]);
+            // 数据已经复制到 mesh 中，尽早释放
+            chunk.positions = {};
+            chunk.uvs = {};
+            chunk.normals = {};
+            chunk.corners = {};
+        }
+    });
+    if (!valid) {
+        std::cerr << "OBJ face references a vertex that does not exist" << std::endl;
+        return false;
+    }
+    mesh.hasUvs = hasUvs;
+
+    // usemtl 在块之间延续：块开头没有 usemtl 的三角形使用前一块最后的材质
+    const size_t triangleCount = cornerCount / 3;
+    std::unordered_map<std::string, uint32_t> materialIds;
+    std::vector<uint32_t> triangleMaterial(triangleCount);
+    uint32_t current = UINT32_MAX;
+    const auto materialId = [&](const std::string& name) {
+        auto it = materialIds.emplace(name, uint32_t(mesh.materialNames.size()));
+        if (it.second) {
+            mesh.materialNames.push_back(name);
+        }
+        return it.first->second;
+    };
+    for (size_t i = 0; i < chunkCount; i++) {
+        const uint32_t chunkBegin = uint32_t(cornerBase[i] / 3);
+        const uint32_t chunkEnd = i + 1 < chunkCount ? uint32_t(cornerBase[i + 1] / 3) : uint32_t(triangleCount);
+        uint32_t runBegin = chunkBegin;
+        for (const auto& run : chunks[i].materials) {
+            if (current == UINT32_MAX && chunkBegin + run.firstTriangle > runBegin) {
+                current = materialId("DefaultMaterial");
+            }
+            std::fill(triangleMaterial.begin() + runBegin, triangleMaterial.begin() + chunkBegin + run.firstTriangle,
+                    current);
+            runBegin = chunkBegin + run.firstTriangle;
+            current = materialId(chunks[i].materialNames[run.name]);
+        }
+        if (current == UINT32_MAX && chunkEnd > runBegin) {
+            current = materialId("DefaultMaterial");
+        }
+        std::fill(triangleMaterial.begin() + runBegin, triangleMaterial.begin() + chunkEnd, current);
+    }
+
+    // 按材质分组，组内保持原来的三角形顺序；只用到的材质才会生成 part
+    std::vector<uint32_t> partOfMaterial(mesh.materialNames.size(), UINT32_MAX);
+    for (uint32_t material : triangleMaterial) {
+        if (partOfMaterial[material] == UINT32_MAX) {
+            partOfMaterial[material] = uint32_t(mesh.parts.size());
+            mesh.parts.emplace_back();
+        }
+        mesh.parts[partOfMaterial[material]].push_back(0);
+    }
+    std::vector<size_t> fill(mesh.parts.size(), 0);
+    for (uint32_t triangle = 0; triangle < triangleCount; triangle++) {
+        const uint32_t part = partOfMaterial[triangleMaterial[triangle]];
+        mesh.parts[part][fill[part]++] = triangle;
+    }
+    // part 的材质序号就是 part 序号，只保留用到的材质名
+    std::vector<std::string> usedNames(mesh.parts.size());
+    for (size_t material = 0; material < partOfMaterial.size(); material++) {
+        if (partOfMaterial[material] != UINT32_MAX) {
+            usedNames[partOfMaterial[material]] = std::move(mesh.materialNames[material]);
+        }
+    }
+    mesh.materialNames = std::move(usedNames);
+    return true;
+}
+
+// 缺少法线的顶点使用按面积加权的平滑法线：追加到 normals 末尾，序号为 normals.size() + 位置序号
+bool generateMissingNormals(ObjMesh& mesh, uint32_t threadCount) {
+    TRACE_NAME("ObjImporter::normals");
+    std::atomic<bool> missing{ false };
+    parallelFor(threadCount, mesh.corners.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end && !missing.load(std::memory_order_relaxed); i++) {
+            if (mesh.corners[i].index[NORMAL] == NO_INDEX) {
+                missing = true;
+            }
+        }
+    });
+    if (!missing) {
+        return false;
+    }
+
+    // 面法线并行计算（叉积的长度就是面积的两倍），累加到顶点上按顺序进行，结果与线程数无关
+    const size_t triangleCount = mesh.corners.size() / 3;
+    std::vector<float3> faceNormals(triangleCount);
+    parallelFor(threadCount, triangleCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const float3& a = mesh.positions[mesh.corners[i * 3 + 0].index[POSITION]];
+            const float3& b = mesh.positions[mesh.corners[i * 3 + 1].index[POSITION]];
+            const float3& c = mesh.positions[mesh.corners[i * 3 + 2].index[POSITION]];
+            faceNormals[i] = cross(b - a, c - a);
+        }
+    });
+    const size_t base = mesh.normals.size();
+    mesh.normals.resize(base + mesh.positions.size(), float3{ 0 });
+    for (size_t i = 0; i < triangleCount; i++) {
+        for (size_t k = 0; k < 3; k++) {
+            mesh.normals[base + mesh.corners[i * 3 + k].index[POSITION]] += faceNormals[i];
+        }
+    }
+    parallelFor(threadCount, mesh.positions.size(), [&](size_t begin, size_t end) {
+        for (size_t i = base + begin; i < base + end; i++) {
+            const float length = std::sqrt(dot(mesh.normals[i], mesh.normals[i]));
+            mesh.normals[i] = length > 0.0f ? mesh.normals[i] / length : float3{ 0, 0, 1 };
+        }
+    });
+    parallelFor(threadCount, mesh.corners.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            Corner& corner = mesh.corners[i];
+            if (corner.index[NORMAL] == NO_INDEX) {
+                corner.index[NORMAL] = int32_t(base) + corner.index[POSITION];
+            }
+        }
+    });
+    return true;
+}
+
+// ========================================
+// 去重和切线空间
+// ========================================
+struct PartMesh {
+    std::vector<float3> positions;
+    std::vector<float2> uvs;
+    std::vector<float3> normals;
+    std::vector<short4> tangents;
+    std::vector<uint3> triangles;
+};
+
+// 对一个 part 的顶点去重。角点按哈希分到固定数量的分片，每个分片由一个线程独占处理，
+// 分片内按角点顺序插入开放寻址表，记录每个角点对应的首次出现位置；
+// 最后对“是否首次出现”做前缀和，顶点编号与单线程按首次出现顺序编号完全一致
+void deduplicate(const ObjMesh& mesh, const std::vector<uint32_t>& triangles, uint32_t threadCount,
+        PartMesh& part) {
+    TRACE_NAME("ObjImporter::dedup");
+    const size_t cornerCount = triangles.size() * 3;
+    std::vector<Corner> corners(cornerCount);
+    std::vector<uint64_t> hashes(cornerCount);
+
+    // 按区间统计每个分片的角点数
+    const size_t rangeCount = std::max<size_t>(1, std::min<size_t>(threadCount, cornerCount / 4096));
+    const auto rangeBegin = [&](size_t range) { return cornerCount * range / rangeCount; };
+    std::vector<uint32_t> counts(rangeCount * DEDUP_SHARDS, 0);
+    parallelFor(threadCount, rangeCount, [&](size_t begin, size_t end) {
+        for (size_t range = begin; range < end; range++) {
+            uint32_t* rangeCounts = counts.data() + range * DEDUP_SHARDS;
+            for (size_t i = rangeBegin(range); i < rangeBegin(range + 1); i++) {
+                corners[i] = mesh.corners[size_t(triangles[i / 3]) * 3 + i % 3];
+                hashes[i] = hashCorner(corners[i]);
+                rangeCounts[hashes[i] >> (64 - DEDUP_SHARD_BITS)]++;
+            }
+        }
+    });
+
+    // 分片内按角点顺序排列：分片优先，同一分片内区间在前的在前
+    std::vector<uint32_t> offsets(rangeCount * DEDUP_SHARDS);
+    std::vector<uint32_t> shardBegin(DEDUP_SHARDS + 1);
+    uint32_t offset = 0;
+    for (uint32_t shard = 0; shard < DEDUP_SHARDS; shard++) {
+        shardBegin[shard] = offset;
+        for (size_t range = 0; range < rangeCount; range++) {
+            offsets[range * DEDUP_SHARDS + shard] = offset;
+            offset += counts[range * DEDUP_SHARDS + shard];
+        }
+    }
+    shardBegin[DEDUP_SHARDS] = offset;
+    std::vector<uint32_t> order(cornerCount);
+    parallelFor(threadCount, rangeCount, [&](size_t begin, size_t end) {
+        for (size_t range = begin; range < end; range++) {
+            uint32_t* rangeOffsets = offsets.data() + range * DEDUP_SHARDS;
+            for (size_t i = rangeBegin(range); i < rangeBegin(range + 1); i++) {
+                order[rangeOffsets[hashes[i] >> (64 - DEDUP_SHARD_BITS)]++] = uint32_t(i);
+            }
+        }
+    });
+
+    // representative[i] 是与角点 i 相同的第一个角点
+    std::vector<uint32_t> representative(cornerCount);
+    parallelFor(threadCount, DEDUP_SHARDS, [&](size_t begin, size_t end) {
+        std::vector<uint32_t> table;
+        for (size_t shard = begin; shard < end; shard++) {
+            const uint32_t count = shardBegin[shard + 1] - shardBegin[shard];
+            size_t capacity = 16;
+            while (capacity < size_t(count) * 2) {
+                capacity *= 2;
+            }
+            table.assign(capacity, EMPTY_SLOT);
+            for (uint32_t k = shardBegin[shard]; k < shardBegin[shard + 1]; k++) {
+                const uint32_t i = order[k];
+                for (size_t slot = (hashes[i] >> DEDUP_SHARD_BITS) & (capacity - 1);;
+                        slot = (slot + 1) & (capacity - 1)) {
+                    if (table[slot] == EMPTY_SLOT) {
+                        table[slot] = i;
+                        representative[i] = i;
+                        break;
+                    }
+                    if (hashes[table[slot]] == hashes[i] && corners[table[slot]] == corners[i]) {
+                        representative[i] = table[slot];
+                        break;
+                    }
+                }
+            }
+        }
+    });
+
+    // 首次出现的角点按顺序编号
+    std::vector<uint32_t> uniqueCounts(rangeCount, 0);
+    parallelFor(threadCount, rangeCount, [&](size_t begin, size_t end) {
+        for (size_t range = begin; range < end; range++) {
+            for (size_t i = rangeBegin(range); i < rangeBegin(range + 1); i++) {
+                uniqueCounts[range] += representative[i] == i;
+            }
+        }
+    });
+    std::vector<uint32_t> uniqueBase(rangeCount);
+    uint32_t vertexCount = 0;
+    for (size_t range = 0; range < rangeCount; range++) {
+        uniqueBase[range] = vertexCount;
+        vertexCount += uniqueCounts[range];
+    }
+    std::vector<uint32_t> vertexOf(cornerCount);
+    part.positions.resize(vertexCount);
+    part.normals.resize(vertexCount);
+    part.uvs.resize(mesh.hasUvs ? vertexCount : 0);
+    parallelFor(threadCount, rangeCount, [&](size_t begin, size_t end) {
+        for (size_t range = begin; range < end; range++) {
+            uint32_t vertex = uniqueBase[range];
+            for (size_t i = rangeBegin(range); i < rangeBegin(range + 1); i++) {
+                if (representative[i] != i) {
+                    continue;
+                }
+                const Corner& corner = corners[i];
+                part.positions[vertex] = mesh.positions[corner.index[POSITION]];
+                part.normals[vertex] = mesh.normals[corner.index[NORMAL]];
+                if (mesh.hasUvs) {
+                    part.uvs[vertex] = corner.index[UV] != NO_INDEX ? mesh.uvs[corner.index[UV]] : float2{ 0 };
+                }
+                vertexOf[i] = vertex++;
+            }
+        }
+    });
+    part.triangles.resize(triangles.size());
+    parallelFor(threadCount, triangles.size(), [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            part.triangles[t] = uint3{ vertexOf[representative[t * 3 + 0]],
+                    vertexOf[representative[t * 3 + 1]], vertexOf[representative[t * 3 + 2]] };
+        }
+    });
+}
+
+// 有 UV 时使用 mikktspace（会重新焊接顶点），否则只根据法线构造切线空间。
+// 大的 part 按空间切块并行生成（见 TangentSpace.h），结果与单线程相同。失败时 part 不变并返回 false
+bool generateTangents(PartMesh& part, uint32_t threadCount) {
+    TRACE_NAME("ObjImporter::tangents");
+    TangentSpaceInput input;
+    input.positions = part.positions.data();
+    input.normals = part.normals.data();
+    input.uvs = part.uvs.empty() ? nullptr : part.uvs.data();
+    input.vertexCount = part.positions.size();
+    input.triangles = part.triangles.data();
+    input.triangleCount = part.triangles.size();
+    TangentSpaceOptions options;
+    options.threadCount = threadCount;
+    TangentSpaceOutput output;
+    if (!generateTangentSpace(input, options, output)) {
+        return false;
+    }
+
+    part.tangents = std::move(output.tangents);
+    if (output.remeshed) {
+        part.positions = std::move(output.positions);
+        part.uvs = std::move(output.uvs);
+        part.triangles = std::move(output.triangles);
+    }
+    // 法线已经编码在切线空间四元数里
+    part.normals = {};
+    return true;
+}
+
+// 重排三角形和顶点，切线空间已经生成，只需要重排位置、UV 和切线
+void optimizePart(PartMesh& part, MeshOptimizeStats& stats) {
+    static_assert(sizeof(uint3) == sizeof(uint32_t) * 3, "triangles must be tightly packed");
+    size_t vertexCount;
+    const std::vector<uint32_t> remap = optimizeMesh(reinterpret_cast<uint32_t*>(part.triangles.data()),
+            part.triangles.size() * 3, part.positions.data(), part.positions.size(), vertexCount, 0, &stats);
+    remapVertices(part.positions, remap, vertexCount);
+    if (!part.uvs.empty()) {
+        remapVertices(part.uvs, remap, vertexCount);
+    }
+    remapVertices(part.tangents, remap, vertexCount);
+}
+
+// 按三角形数合计各 part 的 ACMR，按引用到的顶点数合计 ATVR
+MeshCacheStats combineStats(const std::vector<MeshOptimizeStats>& stats, bool after) {
+    double transformed = 0.0;
+    double triangles = 0.0;
+    double vertices = 0.0;
+    for (const MeshOptimizeStats& part : stats) {
+        const MeshCacheStats& cache = after ? part.after : part.before;
+        const double partTransformed = double(cache.acmr) * double(part.triangleCount);
+        transformed += partTransformed;
+        triangles += double(part.triangleCount);
+        vertices += cache.atvr > 0.0f ? partTransformed / double(cache.atvr) : 0.0;
+    }
+    MeshCacheStats combined;
+    combined.acmr = triangles > 0.0 ? float(transformed / triangles) : 0.0f;
+    combined.atvr = vertices > 0.0 ? float(transformed / vertices) : 0.0f;
+    return combined;
+}
+
+// ========================================
+// 写出 filamesh
+// ========================================
+void computeBounds(const std::vector<float3>& positions, float aabb[6]) {
+    float3 minimum{ std::numeric_limits<float>::max() };
+    float3 maximum{ std::numeric_limits<float>::lowest() };
+    for (const float3& p : positions) {
+        minimum = min(minimum, p);
+        maximum = max(maximum, p);
+    }
+    if (positions.empty()) {
+        minimum = maximum = float3{ 0 };
+    }
+    const float3 center = (minimum + maximum) * 0.5f;
+    const float3 halfExtent = (maximum - minimum) * 0.5f;
+    std::memcpy(aabb, &center, sizeof(center));
+    std::memcpy(aabb + 3, &halfExtent, sizeof(halfExtent));
+}
+
+template<typename T>
+void append(std::vector<uint8_t>& out, const T* data, size_t count) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + count * sizeof(T));
+}
+
+bool writeFilamesh(const std::string& path, const std::vector<PartMesh>& parts,
+        const std::vector<std::string>& materialNames, uint32_t threadCount, size_t& vertexCount) {
+    TRACE_NAME("ObjImporter::write");
+    std::vector<uint32_t> vertexBase(parts.size());
+    std::vector<uint32_t> indexBase(parts.size());
+    size_t indexCount = 0;
+    vertexCount = 0;
+    for (size_t i = 0; i < parts.size(); i++) {
+        vertexBase[i] = uint32_t(vertexCount);
+        indexBase[i] = uint32_t(indexCount);
+        vertexCount += parts[i].positions.size();
+        indexCount += parts[i].triangles.size() * 3;
+    }
+    const bool shortIndices = vertexCount <= 65536;
+    const size_t indexSize = shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+
+    std::vector<FilameshVertex> vertices(vertexCount);
+    std::vector<uint8_t> indices(indexCount * indexSize);
+    for (size_t i = 0; i < parts.size(); i++) {
+        const PartMesh& part = parts[i];
+        FilameshVertex* partVertices = vertices.data() + vertexBase[i];
+        parallelFor(threadCount, part.positions.size(), [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; v++) {
+                const float3& p = part.positions[v];
+                const float2 uv = part.uvs.empty() ? float2{ 0 } : part.uvs[v];
+                FilameshVertex& vertex = partVertices[v];
+                vertex.position[0] = getBits(half(p.x));
+                vertex.position[1] = getBits(half(p.y));
+                vertex.position[2] = getBits(half(p.z));
+                vertex.position[3] = getBits(half(1.0f));
+                vertex.tangents = part.tangents[v];
+                std::memset(vertex.color, 0xff, sizeof(vertex.color));
+                vertex.uv0[0] = getBits(half(uv.x));
+                vertex.uv0[1] = getBits(half(uv.y));
+            }
+        });
+        parallelFor(threadCount, part.triangles.size(), [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) {
+                for (size_t k = 0; k < 3; k++) {
+                    const uint32_t index = vertexBase[i] + part.triangles[t][k];
+                    const size_t position = (indexBase[i] + t * 3 + k) * indexSize;
+                    if (shortIndices) {
+                        const uint16_t value = uint16_t(index);
+                        std::memcpy(indices.data() + position, &value, sizeof(value));
+                    } else {
+                        std::memcpy(indices.data() + position, &index, sizeof(index));
+                    }
+                }
+            }
+        });
+    }
+
+    std::vector<float3> allPositions;
+    allPositions.reserve(vertexCount);
+    std::vector<FilameshPart> fileParts(parts.size());
+    for (size_t i = 0; i < parts.size(); i++) {
+        allPositions.insert(allPositions.end(), parts[i].positions.begin(), parts[i].positions.end());
+        FilameshPart& filePart = fileParts[i];
+        filePart.offset = indexBase[i];
+        filePart.indexCount = uint32_t(parts[i].triangles.size() * 3);
+        filePart.minIndex = vertexBase[i];
+        filePart.maxIndex = vertexBase[i] + uint32_t(std::max<size_t>(parts[i].positions.size(), 1)) - 1;
+        filePart.materialID = uint32_t(i);
+        computeBounds(parts[i].positions, filePart.aabb);
+    }
+
+    FilameshHeader header{};
+    std::memcpy(header.magic, "FILAMESH", sizeof(header.magic));
+    header.version = FILAMESH_VERSION;
+    header.parts = uint32_t(parts.size());
+    computeBounds(allPositions, header.aabb);
+    header.flags = FILAMESH_INTERLEAVED;
+    header.offsetPosition = offsetof(FilameshVertex, position);
+    header.offsetTangents = offsetof(FilameshVertex, tangents);
+    header.offsetColor = offsetof(FilameshVertex, color);
+    header.offsetUV0 = offsetof(FilameshVertex, uv0);
+    header.stridePosition = header.strideTangents = header.strideColor = header.strideUV0 =
+            sizeof(FilameshVertex);
+    header.offsetUV1 = header.strideUV1 = FILAMESH_NO_ATTRIBUTE;
+    header.vertexCount = uint32_t(vertexCount);
+    header.vertexSize = uint32_t(vertexCount * sizeof(FilameshVertex));
+    header.indexType = shortIndices ? FILAMESH_INDEX_UI16 : FILAMESH_INDEX_UI32;
+    header.indexCount = uint32_t(indexCount);
+    header.indexSize = uint32_t(indices.size());
+
+    std::vector<uint8_t> file;
+    file.reserve(sizeof(header) + header.vertexSize + header.indexSize + fileParts.size() * sizeof(FilameshPart));
+    append(file, &header, 1);
+    append(file, vertices.data(), vertices.size());
+    append(file, indices.data(), indices.size());
+    append(file, fileParts.data(), fileParts.size());
+    const uint32_t materialCount = uint32_t(materialNames.size());
+    append(file, &materialCount, 1);
+    for (const std::string& name : materialNames) {
+        const uint32_t length = uint32_t(name.size());
+        append(file, &length, 1);
+        append(file, name.c_str(), name.size() + 1);
+    }
+
+    // 先写临时文件再改名，并发导入同一个文件或中途退出都不会留下不完整的缓存
+    const std::string temporary = path + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(file.data()), std::streamsize(file.size()));
+        if (!out) {
+            std::cerr << "Failed to write filamesh file: " << temporary << std::endl;
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to write filamesh file: " << path << " (" << std::strerror(errno) << ")"
+                  << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// 删除同一个源文件的旧缓存：<name>.<16 位十六进制>.filamesh
+void removeStaleCaches(const std::filesystem::path& cache, const std::string& stem) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(cache.parent_path(), error)) {
+        const std::string name = entry.path().filename().string();
+        const std::string suffix = ".filamesh";
+        if (entry.path() == cache || name.size() != stem.size() + 1 + 16 + suffix.size() ||
+                name.compare(0, stem.size() + 1, stem + ".") != 0 ||
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+        const std::string hash = name.substr(stem.size() + 1, 16);
+        if (std::all_of(hash.begin(), hash.end(), [](char c) { return std::isxdigit(uint8_t(c)); })) {
+            fs::remove(entry.path(), error);
+        }
+    }
+}
+
+bool isFilamesh(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[8] = {};
+    in.read(magic, sizeof(magic));
+    return in && std::memcmp(magic, "FILAMESH", sizeof(magic)) == 0;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point& start) {
+    const auto now = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(now - start).count();
+    start = now;
+    return ms;
+}
+
+} // anonymous namespace
+
+ObjImportResult importObj(const std::string& objPath, const ObjImportOptions& options) {
+    TRACE_CALL();
+    namespace fs = std::filesystem;
+    const auto start = std::chrono::steady_clock::now();
+    auto stageStart = start;
+
+    ObjImportResult result;
+    result.threadCount = resolveThreadCount(options.threadCount);
+    const uint32_t threadCount = result.threadCount;
+
+    MappedFile file;
+    if (!file.open(objPath)) {
+        return result;
+    }
+    result.objBytes = file.size();
+
+    char hashText[17];
+    std::snprintf(hashText, sizeof(hashText), "%016llx",
+            (unsigned long long) hashContent(file.data(), file.size(), threadCount, options.optimize));
+    const fs::path source(objPath);
+    const std::string stem = source.stem().string();
+    const fs::path cacheDirectory = options.writeCache ? source.parent_path() : fs::temp_directory_path();
+    const fs::path cachePath = cacheDirectory / (stem + "." + hashText + ".filamesh");
+    result.hashMs = elapsedMs(stageStart);
+
+    if (options.readCache && isFilamesh(cachePath.string())) {
+        result.filameshPath = cachePath.string();
+        result.cacheHit = true;
+        result.totalMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    // 按行边界切块并行解析
+    const auto ranges = splitLines(file.data(), file.size(), threadCount);
+    std::vector<ObjChunk> chunks(ranges.size());
+    {
+        TRACE_NAME("ObjImporter::parse");
+        parallelFor(threadCount, ranges.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                TRACE_NAME("ObjImporter::parseChunk");
+                ChunkParser(chunks[i]).parse(file.data() + ranges[i].first, file.data() + ranges[i].second);
+            }
+        });
+    }
+    result.parseMs = elapsedMs(stageStart);
+
+    ObjMesh mesh;
+    if (!mergeChunks(chunks, threadCount, mesh)) {
+        std::cerr << "Failed to import OBJ file: " << objPath << std::endl;
+        return result;
+    }
+    chunks.clear();
+    result.generatedNormals = generateMissingNormals(mesh, threadCount);
+    result.positionCount = mesh.positions.size();
+    result.triangleCount = mesh.corners.size() / 3;
+    result.partCount = mesh.parts.size();
+    result.mergeMs = elapsedMs(stageStart);
+
+    std::vector<PartMesh> parts(mesh.parts.size());
+    for (size_t i = 0; i < parts.size(); i++) {
+        deduplicate(mesh, mesh.parts[i], threadCount, parts[i]);
+    }
+    const std::vector<std::string> materialNames = std::move(mesh.materialNames);
+    mesh = {};
+    result.dedupMs = elapsedMs(stageStart);
+
+    // part 之间并行，线程比 part 多时每个 part 再分块并行
+    const uint32_t partThreads = std::max<uint32_t>(1, threadCount / uint32_t(std::max<size_t>(parts.size(), 1)));
+    std::vector<uint8_t> tangentsGenerated(parts.size(), 0);
+    parallelFor(threadCount, parts.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            tangentsGenerated[i] = generateTangents(parts[i], partThreads);
+        }
+    });
+    if (std::find(tangentsGenerated.begin(), tangentsGenerated.end(), 0) != tangentsGenerated.end()) {
+        std::cerr << "Failed to generate tangents: " << objPath << std::endl;
+        return result;
+    }
+    result.tangentMs = elapsedMs(stageStart);
+
+    if (options.optimize) {
+        TRACE_NAME("ObjImporter::optimize");
+        std::vector<MeshOptimizeStats> stats(parts.size());
+        parallelFor(threadCount, parts.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                optimizePart(parts[i], stats[i]);
+            }
+        });
+        result.cacheBefore = combineStats(stats, false);
+        result.cacheAfter = combineStats(stats, true);
+    }
+    result.optimizeMs = elapsedMs(stageStart);
+
+    if (!writeFilamesh(cachePath.string(), parts, materialNames, threadCount, result.vertexCount)) {
+        return result;
+    }
+    if (options.writeCache) {
+        removeStaleCaches(cachePath, stem);
+    }
+    result.writeMs = elapsedMs(stageStart);
+
+    result.filameshPath = cachePath.string();
+    result.totalMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+std::string resolveMeshPath(const std::string& path) {
+    const std::string extension = ".obj";
+    if (path.size() < extension.size() ||
+            path.compare(path.size() - extension.size(), extension.size(), extension) != 0) {
+        return path;
+    }
+    return importObj(path).filameshPath;
+}
+
+} // namespace demo
@@ -0,0 +1,75 @@
+#ifndef DEMO_COMMON_OBJIMPORTER_H
+#define DEMO_COMMON_OBJIMPORTER_H
+
+#include "MeshOptimizer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace demo {
+
+// ========================================
+// OBJ 导入（带 filamesh 缓存）
+// ========================================
+// macos-demo/assets/models 下的 .obj 原来只能先用离线的 filamesh 工具转换。
+// importObj() 在进程内完成同样的转换：
+//
+//   1. mmap 整个 OBJ 文件，按块计算内容哈希，缓存命中时直接返回缓存路径，不做任何解析
+//   2. 按行边界把文件切成 N 块，多个线程同时解析 v/vt/vn/f/usemtl（多边形按扇形三角化）
+//   3. 合并各块（负索引、跨块的 usemtl 在这里解析），按材质分成多个 part
+//   4. 用哈希表对 (位置, UV, 法线) 三元组去重，按哈希分片并行处理，
+//      顶点编号与单线程按首次出现顺序编号的结果完全一致，缓存内容与线程数无关
+//   5. 缺少法线时按面积加权生成平滑法线，各 part 并行用 geometry::TangentSpaceMesh 生成切线空间，
+//      大的 part 按空间切块并行（见 TangentSpace.h）
+//   6. 各 part 并行用 MeshOptimizer 重排三角形（顶点缓存、overdraw）和顶点（读取顺序）
+//   7. 写出未压缩的交错 filamesh（与 filamesh 工具相同的格式，MeshReader 直接读取）
+//
+// 缓存文件写在源文件旁边：<dir>/<name>.<内容哈希>.filamesh。源文件内容变化后哈希随之变化，
+// 旧的缓存文件在写入新缓存时删除。返回的路径可以交给 loadMappedMesh()。
+
+struct ObjImportOptions {
+    uint32_t threadCount = 0;   // 0 表示使用全部硬件线程
+    bool readCache = true;      // false 时总是重新解析（用于测量导入耗时）
+    bool writeCache = true;     // false 时写到临时文件，不覆盖源文件旁边的缓存
+    bool optimize = true;       // false 时保持 OBJ 中的三角形顺序（缓存文件名不同）
+};
+
+struct ObjImportResult {
+    std::string filameshPath;   // 导入失败时为空
+    bool cacheHit = false;
+    uint32_t threadCount = 0;
+
+    uint64_t objBytes = 0;
+    size_t positionCount = 0;   // OBJ 中 v 的数量
+    size_t triangleCount = 0;
+    size_t vertexCount = 0;     // 去重（和 mikktspace 重新焊接）之后的顶点数
+    size_t partCount = 0;
+    bool generatedNormals = false;
+
+    // 优化前后的后变换缓存指标（所有 part 合计，不计算 overfetch），缓存命中或不优化时为 0
+    MeshCacheStats cacheBefore;
+    MeshCacheStats cacheAfter;
+
+    // 各阶段耗时（毫秒），缓存命中时只有 hashMs
+    double hashMs = 0.0;
+    double parseMs = 0.0;
+    double mergeMs = 0.0;
+    double dedupMs = 0.0;
+    double tangentMs = 0.0;
+    double optimizeMs = 0.0;
+    double writeMs = 0.0;
+    double totalMs = 0.0;
+
+    bool isValid() const noexcept { return !filameshPath.empty(); }
+};
+
+// 导入 objPath，返回 filamesh 缓存路径。失败时打印原因，返回的 isValid() 为 false
+ObjImportResult importObj(const std::string& objPath, const ObjImportOptions& options = {});
+
+// path 以 .obj 结尾时导入并返回缓存的 filamesh 路径（失败时返回空字符串），否则原样返回
+std::string resolveMeshPath(const std::string& path);
+
+} // namespace demo
+
+#endif // DEMO_COMMON_OBJIMPORTER_H
@@ -0,0 +1,297 @@
+#include "PackFile.h"
+#include "Trace.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <tuple>
+
+namespace demo {
+
+namespace {
+
+constexpr char PACK_MAGIC[8] = { 'D', 'E', 'M', 'O', 'P', 'A', 'C', 'K' };
+constexpr uint32_t PACK_VERSION = 1;
+
+// 文件头，所有整数均为小端
+struct PackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t alignment;
+    uint64_t entryCount;
+    uint64_t tocOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+// 目录表的一项，按 (hash, 路径) 排序
+struct PackEntry {
+    uint64_t hash;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t pathOffset;
+    uint32_t pathLength;
+};
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // anonymous namespace
+
+// ========================================
+// PackFile
+// ========================================
+
+PackFile::~PackFile() {
+    close();
+}
+
+bool PackFile::open(const std::string& path) {
+    TRACE_NAME("PackFile::open");
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open pack file: " << path << " (" << std::strerror(errno) << ")"
+                  << std::endl;
+        return false;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(PackHeader)) {
+        std::cerr << "Not a pack file: " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    const size_t size = size_t(info.st_size);
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        std::cerr << "Failed to map pack file: " << path << " (" << std::strerror(errno) << ")"
+                  << std::endl;
+        return false;
+    }
+
+    // 校验文件头和目录表都落在文件范围内，之后的查找不再做边界检查
+    PackHeader header;
+    std::memcpy(&header, address, sizeof(header));
+    const uint64_t tocBytes = header.entryCount * sizeof(PackEntry);
+    bool valid = std::memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0 &&
+            header.version == PACK_VERSION &&
+            header.tocOffset % alignof(PackEntry) == 0 &&
+            header.entryCount <= size / sizeof(PackEntry) &&
+            header.tocOffset <= size && tocBytes <= size - header.tocOffset &&
+            header.stringsOffset <= size && header.stringsSize <= size - header.stringsOffset;
+    if (valid) {
+        const PackEntry* entries = reinterpret_cast<const PackEntry*>(
+                static_cast<const uint8_t*>(address) + header.tocOffset);
+        for (uint64_t i = 0; i < header.entryCount && valid; i++) {
+            const PackEntry& entry = entries[i];
+            valid = entry.offset <= size && entry.size <= size - entry.offset &&
+                    uint64_t(entry.pathOffset) + entry.pathLength <= header.stringsSize;
+        }
+    }
+    if (!valid) {
+        std::cerr << "Invalid or unsupported pack file: " << path << std::endl;
+        munmap(address, size);
+        return false;
+    }
+
+    mAddress = address;
+    mSize = size;
+    mEntryCount = size_t(header.entryCount);
+    mEntries = static_cast<const uint8_t*>(address) + header.tocOffset;
+    mStrings = static_cast<const char*>(address) + header.stringsOffset;
+    return true;
+}
+
+bool PackFile::openFromEnvironment() {
+    const char* path = std::getenv("DEMO_PACK");
+    return path && *path && open(path);
+}
+
+void PackFile::close() {
+    if (mAddress) {
+        munmap(mAddress, mSize);
+    }
+    mAddress = nullptr;
+    mSize = 0;
+    mEntryCount = 0;
+    mEntries = nullptr;
+    mStrings = nullptr;
+}
+
+PackView PackFile::find(std::string_view path) const {
+    if (!mAddress) {
+        return {};
+    }
+    const std::string name = normalizePath(path);
+    const uint64_t hash = hashPath(name);
+    const PackEntry* entries = static_cast<const PackEntry*>(mEntries);
+    const PackEntry* end = entries + mEntryCount;
+    const PackEntry* it = std::lower_bound(entries, end, hash,
+            [](const PackEntry& entry, uint64_t value) { return entry.hash < value; });
+    // 哈希相同时逐个比较路径
+    for (; it != end && it->hash == hash; ++it) {
+        if (std::string_view(mStrings + it->pathOffset, it->pathLength) == name) {
+            return getEntryData(size_t(it - entries));
+        }
+    }
+    return {};
+}
+
+std::string_view PackFile::getEntryPath(size_t index) const {
+    const PackEntry& entry = static_cast<const PackEntry*>(mEntries)[index];
+    return { mStrings + entry.pathOffset, entry.pathLength };
+}
+
+PackView PackFile::getEntryData(size_t index) const {
+    const PackEntry& entry = static_cast<const PackEntry*>(mEntries)[index];
+    return { static_cast<const uint8_t*>(mAddress) + entry.offset, size_t(entry.size) };
+}
+
+uint64_t PackFile::hashPath(std::string_view path) noexcept {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (char c : path) {
+        hash ^= uint8_t(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::string PackFile::normalizePath(std::string_view path) {
+    while (path.size() >= 2 && path[0] == '.' && (path[1] == '/' || path[1] == '\\')) {
+        path.remove_prefix(2);
+    }
+    std::string result(path);
+    std::replace(result.begin(), result.end(), '\\', '/');
+    return result;
+}
+
+// ========================================
+// PackWriter
+// ========================================
+
+PackWriter::PackWriter(uint32_t alignment)
+        : mAlignment(alignment && !(alignment & (alignment - 1)) ? alignment : 64) {
+}
+
+bool PackWriter::addFile(const std::string& name, const std::string& sourcePath) {
+    const std::string normalized = PackFile::normalizePath(name);
+    for (const File& file : mFiles) {
+        if (file.name == normalized) {
+            std::cerr << "Duplicate pack entry: " << normalized << std::endl;
+            return false;
+        }
+    }
+    mFiles.push_back({ normalized, sourcePath });
+    return true;
+}
+
+long PackWriter::addDirectory(const std::string& root, const std::string& directory) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    const fs::path rootPath(root);
+    std::vector<fs::path> paths;
+    for (fs::recursive_directory_iterator it(rootPath / directory, error), end;
+            !error && it != end; it.increment(error)) {
+        if (it->is_regular_file() && it->path().filename().string()[0] != '.') {
+            paths.push_back(it->path());
+        }
+    }
+    if (error) {
+        std::cerr << "Failed to read directory: " << (rootPath / directory).string()
+                  << " (" << error.message() << ")" << std::endl;
+        return -1;
+    }
+
+    // 目录遍历顺序不确定，排序后打包结果可以逐字节复现
+    std::sort(paths.begin(), paths.end());
+    for (const fs::path& path : paths) {
+        if (!addFile(path.lexically_relative(rootPath).generic_string(), path.string())) {
+            return -1;
+        }
+    }
+    return long(paths.size());
+}
+
+bool PackWriter::write(const std::string& outputPath) const {
+    TRACE_NAME("PackWriter::write");
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open output file: " << outputPath << std::endl;
+        return false;
+    }
+
+    const auto pad = [&out](uint64_t alignment) {
+        const uint64_t position = uint64_t(out.tellp());
+        for (uint64_t i = position; i < alignUp(position, alignment); i++) {
+            out.put('\0');
+        }
+    };
+
+    // 先占位写文件头，最后回填
+    PackHeader header{};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<PackEntry> entries;
+    std::string strings;
+    entries.reserve(mFiles.size());
+    for (const File& file : mFiles) {
+        std::ifstream in(file.sourcePath, std::ios::binary);
+        if (!in.is_open()) {
+            std::cerr << "Failed to open file: " << file.sourcePath << std::endl;
+            return false;
+        }
+        pad(mAlignment);
+        PackEntry entry{};
+        entry.hash = PackFile::hashPath(file.name);
+        entry.offset = uint64_t(out.tellp());
+        // 空文件时 rdbuf 输出会置 failbit，需要单独处理
+        if (in.peek() != std::ifstream::traits_type::eof()) {
+            out << in.rdbuf();
+        }
+        entry.size = uint64_t(out.tellp()) - entry.offset;
+        entry.pathOffset = uint32_t(strings.size());
+        entry.pathLength = uint32_t(file.name.size());
+        strings += file.name;
+        entries.push_back(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(),
+            [&strings](const PackEntry& a, const PackEntry& b) {
+        return std::make_tuple(a.hash, std::string_view(strings).substr(a.pathOffset, a.pathLength)) <
+               std::make_tuple(b.hash, std::string_view(strings).substr(b.pathOffset, b.pathLength));
+    });
+
+    pad(alignof(PackEntry));
+    std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = PACK_VERSION;
+    header.alignment = mAlignment;
+    header.entryCount = entries.size();
+    header.tocOffset = uint64_t(out.tellp());
+    out.write(reinterpret_cast<const char*>(entries.data()),
+            std::streamsize(entries.size() * sizeof(PackEntry)));
+    header.stringsOffset = uint64_t(out.tellp());
+    header.stringsSize = strings.size();
+    out.write(strings.data(), std::streamsize(strings.size()));
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out.good()) {
+        std::cerr << "Failed to write pack file: " << outputPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace demo
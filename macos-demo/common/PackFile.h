@@ -0,0 +1,102 @@
+#ifndef DEMO_COMMON_PACKFILE_H
+#define DEMO_COMMON_PACKFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace demo {
+
+// ========================================
+// 资源包（只读虚拟文件系统）
+// ========================================
+// demo-pack 把 macos-demo/assets、macos-demo/models 等目录下的文件拼接成一个资源包：
+//
+//   文件头 | 文件数据（每个按 alignment 对齐） | 目录表（按路径哈希排序） | 路径字符串
+//
+// 运行时 PackFile 只 open/mmap 一次，按相对路径（例如 "models/FlightHelmet/FlightHelmet.gltf"）
+// 二分查找目录表，返回指向映射内存的视图，不做任何拷贝。
+// 视图在 PackFile 销毁前一直有效，可以不带回调直接交给 BufferDescriptor，
+// 前提是 PackFile 比使用这些数据的 Engine 活得更久（或者在销毁前 flushAndWait()）。
+
+// 资源包中一个文件的数据，类似 std::span<const uint8_t>
+struct PackView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const noexcept { return data != nullptr; }
+    const uint8_t* begin() const noexcept { return data; }
+    const uint8_t* end() const noexcept { return data + size; }
+};
+
+class PackFile {
+public:
+    PackFile() = default;
+    ~PackFile();
+
+    PackFile(const PackFile&) = delete;
+    PackFile& operator=(const PackFile&) = delete;
+
+    // 映射资源包并校验文件头和目录表，失败时打印原因并返回 false
+    bool open(const std::string& path);
+    // 从环境变量 DEMO_PACK 读取资源包路径，未设置或打开失败时返回 false
+    bool openFromEnvironment();
+    void close();
+
+    bool isOpen() const noexcept { return mAddress != nullptr; }
+
+    // 按相对路径查找，"./" 前缀和 "\" 分隔符会被规范化；找不到时返回空视图
+    PackView find(std::string_view path) const;
+
+    size_t getEntryCount() const noexcept { return mEntryCount; }
+    std::string_view getEntryPath(size_t index) const;
+    PackView getEntryData(size_t index) const;
+
+    // 目录表使用的路径哈希（FNV-1a 64 位，对规范化后的路径计算）
+    static uint64_t hashPath(std::string_view path) noexcept;
+    // 去掉开头的 "./" 并把 "\" 换成 "/"
+    static std::string normalizePath(std::string_view path);
+
+private:
+    void* mAddress = nullptr;
+    size_t mSize = 0;
+    size_t mEntryCount = 0;
+    const void* mEntries = nullptr;
+    const char* mStrings = nullptr;
+};
+
+// ========================================
+// 资源包写入（离线打包）
+// ========================================
+class PackWriter {
+public:
+    // 每个文件的数据按 alignment 字节对齐（必须是 2 的幂），默认 64 满足所有 BufferDescriptor 的要求
+    explicit PackWriter(uint32_t alignment = 64);
+
+    // 以 name 为包内路径加入 sourcePath 指向的文件。同名文件重复加入时返回 false
+    bool addFile(const std::string& name, const std::string& sourcePath);
+
+    // 递归加入 root/directory 下的所有普通文件（跳过以 "." 开头的文件），
+    // 包内路径为相对 root 的路径，例如 "models/lucy/lucy.glb"。返回加入的文件数，失败时返回 -1
+    long addDirectory(const std::string& root, const std::string& directory);
+
+    size_t getFileCount() const noexcept { return mFiles.size(); }
+
+    // 写出资源包，失败时打印原因并返回 false
+    bool write(const std::string& outputPath) const;
+
+private:
+    struct File {
+        std::string name;
+        std::string sourcePath;
+    };
+
+    uint32_t mAlignment;
+    std::vector<File> mFiles;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_PACKFILE_H
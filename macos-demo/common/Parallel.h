@@ -0,0 +1,153 @@
+#ifndef DEMO_COMMON_PARALLEL_H
+#define DEMO_COMMON_PARALLEL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace demo {
+
+// ========================================
+// 简单的数据并行工具
+// ========================================
+// 离线处理（OBJ 导入、网格处理）一次只跑一个阶段，每个阶段把数据切成连续区间交给若干线程，
+// 阶段之间用 join 同步。线程创建的开销（几十微秒）相对每个阶段的耗时可以忽略，
+// 不需要常驻的线程池。
+
+// 0 表示使用全部硬件线程
+inline uint32_t resolveThreadCount(uint32_t requested) noexcept {
+    if (requested) {
+        return requested;
+    }
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return hardware ? hardware : 1;
+}
+
+// 把 [0, count) 切成最多 threadCount 段连续区间，并行调用 fn(begin, end)。
+// 调用线程处理第一段，返回时所有区间都已处理完
+template<typename Fn>
+void parallelFor(uint32_t threadCount, size_t count, Fn&& fn) {
+    const size_t ranges = std::min<size_t>(std::max<uint32_t>(threadCount, 1), count);
+    if (ranges <= 1) {
+        if (count) {
+            fn(size_t(0), count);
+        }
+        return;
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(ranges - 1);
+    for (size_t i = 1; i < ranges; i++) {
+        threads.emplace_back([&fn, i, ranges, count]() {
+            fn(count * i / ranges, count * (i + 1) / ranges);
+        });
+    }
+    fn(size_t(0), count / ranges);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// ========================================
+// 常驻工作线程
+// ========================================
+// 每帧都要执行的并行阶段（例如 MeshletCuller）不能每次都创建线程，WorkerPool 的线程常驻，
+// run() 的切分方式与 parallelFor() 相同：调用线程处理第一段，返回时所有区间都已处理完。
+// 同一时间只能有一个线程调用 run()
+class WorkerPool {
+public:
+    // threadCount 包括调用线程，0 表示使用全部硬件线程
+    explicit WorkerPool(uint32_t threadCount = 0) : mThreadCount(resolveThreadCount(threadCount)) {
+        mThreads.reserve(mThreadCount - 1);
+        for (uint32_t i = 1; i < mThreadCount; i++) {
+            mThreads.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mWake.notify_all();
+        for (auto& thread : mThreads) {
+            thread.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    uint32_t getThreadCount() const noexcept { return mThreadCount; }
+
+    template<typename Fn>
+    void run(size_t count, Fn&& fn) {
+        const size_t ranges = std::min<size_t>(mThreadCount, count);
+        if (ranges <= 1) {
+            if (count) {
+                fn(size_t(0), count);
+            }
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTask = [](void* user, size_t begin, size_t end) {
+                (*static_cast<std::remove_reference_t<Fn>*>(user))(begin, end);
+            };
+            mUser = &fn;
+            mCount = count;
+            mRanges = ranges;
+            mPending = ranges - 1;
+            mGeneration++;
+        }
+        mWake.notify_all();
+        fn(size_t(0), count / ranges);
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this]() { return mPending == 0; });
+    }
+
+private:
+    void workerLoop(uint32_t index) {
+        uint64_t generation = 0;
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true) {
+            mWake.wait(lock, [this, generation]() { return mStop || mGeneration != generation; });
+            if (mStop) {
+                return;
+            }
+            generation = mGeneration;
+            if (index >= mRanges) {
+                continue;
+            }
+            const size_t begin = mCount * index / mRanges;
+            const size_t end = mCount * (index + 1) / mRanges;
+            lock.unlock();
+            mTask(mUser, begin, end);
+            lock.lock();
+            if (--mPending == 0) {
+                mDone.notify_one();
+            }
+        }
+    }
+
+    const uint32_t mThreadCount;
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    void (*mTask)(void* user, size_t begin, size_t end) = nullptr;
+    void* mUser = nullptr;
+    size_t mCount = 0;
+    size_t mRanges = 0;
+    size_t mPending = 0;
+    uint64_t mGeneration = 0;
+    bool mStop = false;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_PARALLEL_H
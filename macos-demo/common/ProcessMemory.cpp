@@ -0,0 +1,49 @@
+#include "ProcessMemory.h"
+
+#include <sys/resource.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+namespace demo {
+
+uint64_t getCurrentRssBytes() noexcept {
+#if defined(__APPLE__)
+    mach_task_basic_info_data_t info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+            reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return uint64_t(info.resident_size);
+#else
+    // statm 的第二列是常驻页数
+    std::ifstream statm("/proc/self/statm");
+    uint64_t sizePages = 0;
+    uint64_t residentPages = 0;
+    if (!(statm >> sizePages >> residentPages)) {
+        return 0;
+    }
+    return residentPages * uint64_t(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+uint64_t getPeakRssBytes() noexcept {
+    struct rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    // macOS 的 ru_maxrss 单位是字节
+    return uint64_t(usage.ru_maxrss);
+#else
+    // Linux 的 ru_maxrss 单位是 KiB
+    return uint64_t(usage.ru_maxrss) * 1024;
+#endif
+}
+
+} // namespace demo
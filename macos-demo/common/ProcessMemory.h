@@ -0,0 +1,22 @@
+#ifndef DEMO_COMMON_PROCESSMEMORY_H
+#define DEMO_COMMON_PROCESSMEMORY_H
+
+#include <cstdint>
+
+namespace demo {
+
+// ========================================
+// 进程内存占用
+// ========================================
+// 读取当前进程的常驻内存（RSS），单位字节，读取失败时返回 0。
+// Linux 读取 /proc/self/statm 和 getrusage()，macOS 使用 task_info()。
+
+// 当前 RSS
+uint64_t getCurrentRssBytes() noexcept;
+
+// 进程启动以来的 RSS 峰值（只增不减，需要按配置比较时应在独立的子进程里测量）
+uint64_t getPeakRssBytes() noexcept;
+
+} // namespace demo
+
+#endif // DEMO_COMMON_PROCESSMEMORY_H
@@ -0,0 +1,261 @@
+#include "ReplayLog.h"
+
+#include <filament/Engine.h>
+#include <filament/RenderableManager.h>
+#include <filament/TransformManager.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+using namespace filament;
+using namespace filament::math;
+
+namespace demo {
+
+namespace {
+
+constexpr char MAGIC[8] = { 'D', 'E', 'M', 'O', 'R', 'E', 'C', '\0' };
+constexpr uint32_t VERSION = 1;
+
+// 单条变形权重记录的上限，超出视为日志损坏
+constexpr uint32_t MAX_MORPH_WEIGHTS = 256;
+
+// DEMO_REPLAY 优先于 DEMO_RECORD
+ReplayLog::Mode modeFromEnvironment() {
+    if (std::getenv("DEMO_REPLAY")) {
+        return ReplayLog::Mode::REPLAY;
+    }
+    return std::getenv("DEMO_RECORD") ? ReplayLog::Mode::RECORD : ReplayLog::Mode::OFF;
+}
+
+std::string pathFromEnvironment() {
+    const char* replay = std::getenv("DEMO_REPLAY");
+    const char* record = std::getenv("DEMO_RECORD");
+    return replay ? replay : (record ? record : "");
+}
+
+float fixedStepFromEnvironment() {
+    const char* step = std::getenv("DEMO_FIXED_STEP");
+    return step ? std::strtof(step, nullptr) : 0.0f;
+}
+
+} // anonymous namespace
+
+ReplayLog::ReplayLog()
+        : ReplayLog(modeFromEnvironment(), pathFromEnvironment(), fixedStepFromEnvironment()) {
+}
+
+ReplayLog::ReplayLog(Mode mode, const std::string& path, float fixedStep)
+        : mMode(mode), mPath(path), mFixedStep(fixedStep > 0.0f ? fixedStep : 0.0f) {
+    if (mMode == Mode::RECORD) {
+        mOut.open(mPath, std::ios::binary | std::ios::trunc);
+        if (!mOut.is_open()) {
+            disable("failed to open file for writing");
+            return;
+        }
+        write(MAGIC, sizeof(MAGIC));
+        write(&VERSION, sizeof(VERSION));
+        std::cerr << "Recording to " << mPath << std::endl;
+    } else if (mMode == Mode::REPLAY) {
+        std::ifstream in(mPath, std::ios::binary);
+        if (!in.is_open()) {
+            disable("failed to open file");
+            return;
+        }
+        mData.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        char magic[sizeof(MAGIC)];
+        uint32_t version = 0;
+        if (!read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+                !read(&version, sizeof(version)) || version != VERSION) {
+            disable("not a replay log or unsupported version");
+            return;
+        }
+        std::cerr << "Replaying " << mPath << std::endl;
+    }
+}
+
+ReplayLog::~ReplayLog() {
+    if (mMode == Mode::RECORD) {
+        mOut.flush();
+        std::cerr << "Recorded " << (mStarted ? mFrameIndex + 1 : 0) << " frames to "
+                  << mPath << std::endl;
+    }
+}
+
+void ReplayLog::disable(const char* reason) {
+    std::cerr << "ReplayLog: " << mPath << ": " << reason << std::endl;
+    mMode = Mode::OFF;
+    mOut.close();
+    mData.clear();
+    mEvents.clear();
+}
+
+void ReplayLog::write(const void* data, size_t size) {
+    mOut.write(static_cast<const char*>(data), std::streamsize(size));
+}
+
+bool ReplayLog::read(void* data, size_t size) {
+    if (mData.size() - mCursor < size) {
+        return false;
+    }
+    std::memcpy(data, mData.data() + mCursor, size);
+    mCursor += size;
+    return true;
+}
+
+bool ReplayLog::beginFrame(Engine& engine) {
+    if (mStarted) {
+        mFrameIndex++;
+    }
+    mStarted = true;
+
+    if (mMode == Mode::RECORD) {
+        const Tag tag = Tag::FRAME;
+        write(&tag, sizeof(tag));
+        return true;
+    }
+    if (mMode != Mode::REPLAY) {
+        return true;
+    }
+
+    // 上一帧没有取走的事件丢弃，保证每帧的事件与录制时一致
+    mEvents.clear();
+
+    Tag tag;
+    if (!read(&tag, sizeof(tag))) {
+        return false;   // 日志结束
+    }
+    if (tag != Tag::FRAME) {
+        disable("corrupted log (expected frame marker)");
+        return false;
+    }
+
+    auto& tcm = engine.getTransformManager();
+    auto& rm = engine.getRenderableManager();
+    while (mCursor < mData.size() && Tag(mData[mCursor]) != Tag::FRAME) {
+        read(&tag, sizeof(tag));
+        bool ok = true;
+        switch (tag) {
+            case Tag::TIME:
+                ok = read(&mReplayTime, sizeof(mReplayTime));
+                break;
+            case Tag::EVENT: {
+                uint32_t size = 0;
+                ok = read(&size, sizeof(size)) && size <= mData.size() - mCursor;
+                if (ok) {
+                    mEvents.emplace_back(mData.begin() + ptrdiff_t(mCursor),
+                            mData.begin() + ptrdiff_t(mCursor + size));
+                    mCursor += size;
+                }
+                break;
+            }
+            case Tag::TRANSFORM: {
+                int32_t id = 0;
+                mat4f transform;
+                ok = read(&id, sizeof(id)) && read(&transform, sizeof(transform));
+                if (ok) {
+                    auto ti = tcm.getInstance(utils::Entity::import(id));
+                    if (ti.isValid()) {
+                        tcm.setTransform(ti, transform);
+                    }
+                }
+                break;
+            }
+            case Tag::MORPH: {
+                int32_t id = 0;
+                uint32_t offset = 0;
+                uint32_t count = 0;
+                float weights[MAX_MORPH_WEIGHTS];
+                ok = read(&id, sizeof(id)) && read(&offset, sizeof(offset)) &&
+                        read(&count, sizeof(count)) && count <= MAX_MORPH_WEIGHTS &&
+                        read(weights, count * sizeof(float));
+                if (ok) {
+                    auto ri = rm.getInstance(utils::Entity::import(id));
+                    if (ri.isValid()) {
+                        rm.setMorphWeights(ri, weights, count, offset);
+                    }
+                }
+                break;
+            }
+            default:
+                ok = false;
+                break;
+        }
+        if (!ok) {
+            disable("corrupted log");
+            return false;
+        }
+    }
+    return true;
+}
+
+float ReplayLog::frameTime(float wallClockTime) {
+    if (mMode == Mode::REPLAY) {
+        return mReplayTime;
+    }
+    const float time = mFixedStep > 0.0f ? float(mFrameIndex) * mFixedStep : wallClockTime;
+    if (mMode == Mode::RECORD) {
+        const Tag tag = Tag::TIME;
+        write(&tag, sizeof(tag));
+        write(&time, sizeof(time));
+    }
+    return time;
+}
+
+void ReplayLog::recordEvent(const void* event, size_t size) {
+    const Tag tag = Tag::EVENT;
+    const uint32_t size32 = uint32_t(size);
+    write(&tag, sizeof(tag));
+    write(&size32, sizeof(size32));
+    write(event, size);
+}
+
+bool ReplayLog::nextEvent(void* event, size_t size) {
+    if (mEvents.empty()) {
+        return false;
+    }
+    const std::vector<uint8_t>& data = mEvents.front();
+    std::memset(event, 0, size);
+    std::memcpy(event, data.data(), std::min(size, data.size()));
+    mEvents.pop_front();
+    return true;
+}
+
+void ReplayLog::setTransform(TransformManager& tcm, utils::Entity entity,
+        const mat4f& transform) {
+    if (mMode == Mode::REPLAY) {
+        return;
+    }
+    tcm.setTransform(tcm.getInstance(entity), transform);
+    if (mMode == Mode::RECORD) {
+        const Tag tag = Tag::TRANSFORM;
+        const int32_t id = utils::Entity::smuggle(entity);
+        write(&tag, sizeof(tag));
+        write(&id, sizeof(id));
+        write(&transform, sizeof(transform));
+    }
+}
+
+void ReplayLog::setMorphWeights(RenderableManager& rm, utils::Entity entity,
+        const float* weights, size_t count, size_t offset) {
+    if (mMode == Mode::REPLAY) {
+        return;
+    }
+    rm.setMorphWeights(rm.getInstance(entity), weights, count, offset);
+    if (mMode == Mode::RECORD) {
+        const Tag tag = Tag::MORPH;
+        const int32_t id = utils::Entity::smuggle(entity);
+        const uint32_t offset32 = uint32_t(offset);
+        const uint32_t count32 = uint32_t(std::min<size_t>(count, MAX_MORPH_WEIGHTS));
+        write(&tag, sizeof(tag));
+        write(&id, sizeof(id));
+        write(&offset32, sizeof(offset32));
+        write(&count32, sizeof(count32));
+        write(weights, count32 * sizeof(float));
+    }
+}
+
+} // namespace demo
@@ -0,0 +1,131 @@
+#ifndef DEMO_COMMON_REPLAYLOG_H
+#define DEMO_COMMON_REPLAYLOG_H
+
+#include <math/mat4.h>
+
+#include <utils/Entity.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace filament {
+class Engine;
+class RenderableManager;
+class TransformManager;
+}
+
+namespace demo {
+
+// ========================================
+// 输入与变换的录制/回放
+// ========================================
+// 示例的动画由墙钟时间驱动，两次运行渲染的画面不会相同。
+// ReplayLog 把每帧的动画时间、窗口事件以及 setTransform/setMorphWeights 调用
+// 写进一个紧凑的二进制日志；回放时按帧读出：时间取日志中的值，
+// 变换和变形权重直接从日志应用，事件替代真实的窗口事件，
+// 帧与帧之间不再等待墙钟，不同构建之间的性能对比逐帧一致。
+//
+// 通过环境变量选择模式：
+//   DEMO_RECORD=run.rec       录制
+//   DEMO_REPLAY=run.rec       回放，日志结束时 beginFrame() 返回 false
+//   DEMO_FIXED_STEP=0.016667  不回放时使用固定时间步长（秒）代替墙钟
+//
+// 日志格式（主机字节序）：8 字节魔数 "DEMOREC" + uint32 版本，随后是一串记录，
+// 每条记录以 1 字节标签开头：
+//   FRAME      无负载，标记一帧的开始
+//   TIME       float 动画时间（秒）
+//   EVENT      uint32 大小 + 原始事件字节（例如 SDL_Event，指针字段回放后无效）
+//   TRANSFORM  uint32 实体 + 16 个 float（列主序 mat4f）
+//   MORPH      uint32 实体 + uint32 偏移 + uint32 数量 + float 权重
+// 实体按 Entity::smuggle() 的编号保存，要求录制和回放时实体的创建顺序相同。
+class ReplayLog {
+public:
+    enum class Mode {
+        OFF,
+        RECORD,
+        REPLAY,
+    };
+
+    // 根据环境变量选择模式
+    ReplayLog();
+    ReplayLog(Mode mode, const std::string& path, float fixedStep = 0.0f);
+    ~ReplayLog();
+
+    ReplayLog(const ReplayLog&) = delete;
+    ReplayLog& operator=(const ReplayLog&) = delete;
+
+    Mode getMode() const noexcept { return mMode; }
+    uint32_t getFrameIndex() const noexcept { return mFrameIndex; }
+
+    // 每帧开始时（处理事件之前）调用一次。
+    // 回放时读出本帧的所有记录：应用变换和变形权重，缓存事件。回放结束返回 false
+    bool beginFrame(filament::Engine& engine);
+
+    // 本帧的动画时间：回放时返回日志中的值；否则返回 wallClockTime
+    // （设置了固定步长时返回 帧号 * 步长），录制时写入日志
+    float frameTime(float wallClockTime);
+
+    // 代替 while (SDL_PollEvent(&event)) 使用：
+    // 回放时丢弃真实事件（只保持窗口响应），返回日志中的事件；录制时把事件写入日志
+    template<typename Event>
+    bool pollEvent(Event* event, bool (*poll)(Event*)) {
+        if (mMode == Mode::REPLAY) {
+            Event discarded;
+            while (poll(&discarded)) {
+            }
+            return nextEvent(event, sizeof(Event));
+        }
+        if (!poll(event)) {
+            return false;
+        }
+        if (mMode == Mode::RECORD) {
+            recordEvent(event, sizeof(Event));
+        }
+        return true;
+    }
+
+    // 代替 TransformManager::setTransform / RenderableManager::setMorphWeights。
+    // 录制时写入日志；回放时忽略（beginFrame() 已经应用了日志中的值）
+    void setTransform(filament::TransformManager& tcm, utils::Entity entity,
+            const filament::math::mat4f& transform);
+    void setMorphWeights(filament::RenderableManager& rm, utils::Entity entity,
+            const float* weights, size_t count, size_t offset = 0);
+
+private:
+    enum class Tag : uint8_t {
+        FRAME = 1,
+        TIME = 2,
+        EVENT = 3,
+        TRANSFORM = 4,
+        MORPH = 5,
+    };
+
+    void recordEvent(const void* event, size_t size);
+    bool nextEvent(void* event, size_t size);
+    void write(const void* data, size_t size);
+    bool read(void* data, size_t size);
+    void disable(const char* reason);
+
+    Mode mMode = Mode::OFF;
+    std::string mPath;
+    float mFixedStep = 0.0f;
+    uint32_t mFrameIndex = 0;
+    bool mStarted = false;
+
+    // 录制
+    std::ofstream mOut;
+
+    // 回放：整个日志读入内存
+    std::vector<uint8_t> mData;
+    size_t mCursor = 0;
+    float mReplayTime = 0.0f;
+    std::deque<std::vector<uint8_t>> mEvents;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_REPLAYLOG_H
@@ -0,0 +1,575 @@
+#include "ResourceBundle.h"
+#include "Lz4.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+namespace demo {
+
+namespace {
+
+constexpr char BUNDLE_MAGIC[8] = { 'D', 'E', 'M', 'O', 'R', 'B', 'Z', '1' };
+constexpr uint32_t BUNDLE_VERSION = 2;
+constexpr uint64_t BUNDLE_ALIGNMENT = 16;
+// 池中最多保留的空闲缓冲区个数，多余的释放最小的
+constexpr size_t MAX_POOLED_BUFFERS = 4;
+
+// 片段拼接成块后再压缩。LZ4 的匹配窗口就是 64KB，更大的块压缩率几乎不变，只会增加解压量
+constexpr size_t BLOCK_SIZE = 64 * 1024;
+// filamat 分块头：filamat::ChunkType（uint64）+ 数据大小（uint32），见 filament/MaterialChunkType.h
+constexpr size_t MATERIAL_CHUNK_HEADER_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+// 比这小的分块（材质名、混合模式等属性）整个作为一个片段
+constexpr size_t MIN_SPLIT_CHUNK_SIZE = 1024;
+// 片段大小范围和平均大小（2^SEGMENT_MASK_BITS）。片段越小去重越充分，但片段表和序号数组越大，
+// 对示例的材质包 256 字节左右最合适
+constexpr size_t MIN_SEGMENT_SIZE = 64;
+constexpr size_t MAX_SEGMENT_SIZE = 4096;
+constexpr unsigned SEGMENT_MASK_BITS = 8;
+
+// 文件头，所有整数均为小端
+struct BundleHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t blockCount;
+    uint32_t segmentCount;
+    uint32_t reserved[2];
+};
+
+// 条目表和块表的一项，offset 相对于资源包开头
+struct BundleEntry {
+    uint64_t offset;
+    uint32_t storedSize;
+    uint32_t size;
+    uint32_t codec;
+    uint32_t reserved;
+};
+
+// 片段表的一项：位于第 block 个块解压后的 [offset, offset + size)
+struct BundleSegment {
+    uint32_t block;
+    uint32_t offset;
+    uint32_t size;
+};
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+uint64_t hashBytes(const uint8_t* data, size_t size) {
+    // FNV-1a 64 位
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// gear 滚动哈希用的随机表（splitmix64 生成，写入端和格式无关，只影响切点位置）
+struct GearTable {
+    uint64_t values[256];
+    constexpr GearTable() : values() {
+        uint64_t state = 0x9e3779b97f4a7c15ull;
+        for (uint64_t& value : values) {
+            state += 0x9e3779b97f4a7c15ull;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            value = z ^ (z >> 31);
+        }
+    }
+};
+constexpr GearTable GEAR;
+
+// 从 data 开头切出一个片段，返回它的长度。哈希的高位全为 0 时切开，
+// 切点只取决于前 64 个字节左右的内容
+size_t nextSegment(const uint8_t* data, size_t size) {
+    if (size <= MIN_SEGMENT_SIZE) {
+        return size;
+    }
+    constexpr uint64_t mask = ((uint64_t(1) << SEGMENT_MASK_BITS) - 1) << (64 - SEGMENT_MASK_BITS);
+    const size_t limit = std::min(size, MAX_SEGMENT_SIZE);
+    uint64_t hash = 0;
+    for (size_t i = MIN_SEGMENT_SIZE; i < limit; i++) {
+        hash = (hash << 1) + GEAR.values[data[i]];
+        if (!(hash & mask)) {
+            return i + 1;
+        }
+    }
+    return limit;
+}
+
+// 把 filamat 材质包拆成分块（包含分块头），返回每个分块的 [begin, end)。
+// 数据不是完整的分块序列（不是材质包）时返回 false
+bool splitMaterialChunks(const uint8_t* data, size_t size,
+        std::vector<std::pair<size_t, size_t>>& chunks) {
+    chunks.clear();
+    size_t cursor = 0;
+    while (cursor < size) {
+        if (size - cursor < MATERIAL_CHUNK_HEADER_SIZE) {
+            return false;
+        }
+        uint64_t type;
+        uint32_t chunkSize;
+        std::memcpy(&type, data + cursor, sizeof(type));
+        std::memcpy(&chunkSize, data + cursor + sizeof(type), sizeof(chunkSize));
+        // ChunkType 是 8 个可打印字符拼成的整数（"MAT_NAME"、"DIC_TEXT" 等）
+        for (int shift = 0; shift < 64; shift += 8) {
+            const uint8_t c = uint8_t(type >> shift);
+            if (c < 0x20 || c > 0x7e) {
+                return false;
+            }
+        }
+        if (chunkSize > size - cursor - MATERIAL_CHUNK_HEADER_SIZE) {
+            return false;
+        }
+        const size_t end = cursor + MATERIAL_CHUNK_HEADER_SIZE + chunkSize;
+        chunks.emplace_back(cursor, end);
+        cursor = end;
+    }
+    return chunks.size() > 1;
+}
+
+// 一个压缩条目的解压结果。once 保证只解压一次，
+// 同一条目的并发访问者等待第一个访问者完成
+struct CacheSlot {
+    std::once_flag once;
+    std::unique_ptr<uint8_t[]> data;
+    std::atomic<bool> ready{ false };
+};
+
+// 租约归还的空闲缓冲区
+struct PooledBuffer {
+    std::unique_ptr<uint8_t[]> data;
+    size_t capacity;
+};
+
+struct BundleCache {
+    std::mutex lock;
+    // 以条目表项的地址为键，多个资源包可以共用一个缓存
+    std::unordered_map<const void*, std::unique_ptr<CacheSlot>> slots;
+    std::vector<PooledBuffer> pool;
+    BundleStats stats;
+};
+
+// 函数内静态变量：静态初始化阶段的 XXX_DATA 访问也能拿到构造好的缓存
+BundleCache& getCache() {
+    static BundleCache* cache = new BundleCache();
+    return *cache;
+}
+
+// 校验文件头并读出第 index 个条目，entryAddress 返回条目表项的地址（缓存的键）
+bool readEntry(const uint8_t* bundle, uint32_t index, BundleHeader& header, BundleEntry& entry,
+        const uint8_t** entryAddress) {
+    std::memcpy(&header, bundle, sizeof(header));
+    if (std::memcmp(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0 ||
+            header.version != BUNDLE_VERSION || index >= header.entryCount) {
+        std::cerr << "Invalid resource bundle entry: " << index << std::endl;
+        return false;
+    }
+    *entryAddress = bundle + sizeof(BundleHeader) + index * sizeof(BundleEntry);
+    std::memcpy(&entry, *entryAddress, sizeof(entry));
+    return true;
+}
+
+// 把一段存储的数据（NONE 或 LZ4）还原到 dst
+bool decodeStored(const uint8_t* bundle, const BundleEntry& stored, uint8_t* dst) {
+    const uint8_t* src = bundle + stored.offset;
+    switch (BundleCodec(stored.codec)) {
+        case BundleCodec::NONE:
+            if (stored.storedSize != stored.size) {
+                return false;
+            }
+            std::memcpy(dst, src, stored.size);
+            return true;
+        case BundleCodec::LZ4:
+            return lz4Decompress(src, stored.storedSize, dst, stored.size);
+        default:
+            return false;
+    }
+}
+
+// 解压或拼接一个条目到 dst（大小为 entry.size）
+bool decodeEntry(const uint8_t* bundle, const BundleHeader& header, const BundleEntry& entry,
+        uint8_t* dst) {
+    if (BundleCodec(entry.codec) != BundleCodec::CHUNKED) {
+        return decodeStored(bundle, entry, dst);
+    }
+    const uint8_t* blockTable = bundle + sizeof(BundleHeader) +
+            size_t(header.entryCount) * sizeof(BundleEntry);
+    const uint8_t* segmentTable = blockTable + size_t(header.blockCount) * sizeof(BundleEntry);
+
+    // 每个片段在输出中的位置由前面片段的大小决定；按块排序后每个块只需要解压一次
+    struct Piece {
+        BundleSegment segment;
+        size_t position;
+    };
+    const uint8_t* indices = bundle + entry.offset;
+    std::vector<Piece> pieces(entry.storedSize / sizeof(uint32_t));
+    size_t position = 0;
+    for (size_t i = 0; i < pieces.size(); i++) {
+        uint32_t segmentIndex;
+        std::memcpy(&segmentIndex, indices + i * sizeof(uint32_t), sizeof(segmentIndex));
+        if (segmentIndex >= header.segmentCount) {
+            return false;
+        }
+        BundleSegment& segment = pieces[i].segment;
+        std::memcpy(&segment, segmentTable + segmentIndex * sizeof(BundleSegment), sizeof(segment));
+        if (segment.block >= header.blockCount || segment.size > entry.size - position) {
+            return false;
+        }
+        pieces[i].position = position;
+        position += segment.size;
+    }
+    if (position != entry.size) {
+        return false;
+    }
+    std::stable_sort(pieces.begin(), pieces.end(),
+            [](const Piece& a, const Piece& b) { return a.segment.block < b.segment.block; });
+
+    std::unique_ptr<uint8_t[]> scratch;
+    for (size_t i = 0; i < pieces.size();) {
+        const uint32_t blockIndex = pieces[i].segment.block;
+        BundleEntry block;
+        std::memcpy(&block, blockTable + blockIndex * sizeof(BundleEntry), sizeof(block));
+        const uint8_t* content = bundle + block.offset;
+        if (BundleCodec(block.codec) != BundleCodec::NONE) {
+            if (!scratch) {
+                scratch.reset(new uint8_t[BLOCK_SIZE]);
+            }
+            if (block.size > BLOCK_SIZE || !decodeStored(bundle, block, scratch.get())) {
+                return false;
+            }
+            content = scratch.get();
+        }
+        for (; i < pieces.size() && pieces[i].segment.block == blockIndex; i++) {
+            const BundleSegment& segment = pieces[i].segment;
+            if (segment.offset > block.size || segment.size > block.size - segment.offset) {
+                return false;
+            }
+            std::memcpy(dst + pieces[i].position, content + segment.offset, segment.size);
+        }
+    }
+    return true;
+}
+
+// 解压并计入统计，失败时打印原因
+bool decodeWithStats(const uint8_t* bundle, const BundleHeader& header, const BundleEntry& entry,
+        uint32_t index, uint8_t* dst) {
+    TRACE_NAME("decodeBundleEntry");
+    const auto start = std::chrono::steady_clock::now();
+    if (!decodeEntry(bundle, header, entry, dst)) {
+        std::cerr << "Corrupted resource bundle entry: " << index << std::endl;
+        return false;
+    }
+    const double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+    BundleCache& cache = getCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    cache.stats.decodedEntries++;
+    cache.stats.decodedBytes += entry.size;
+    cache.stats.decodeMs += ms;
+    return true;
+}
+
+void decodeToCache(const uint8_t* bundle, const BundleHeader& header, const BundleEntry& entry,
+        uint32_t index, CacheSlot& slot) {
+    std::unique_ptr<uint8_t[]> data(new uint8_t[entry.size]);
+    if (!decodeWithStats(bundle, header, entry, index, data.get())) {
+        return;
+    }
+    slot.data = std::move(data);
+    slot.ready.store(true, std::memory_order_release);
+
+    BundleCache& cache = getCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    cache.stats.cachedBytes += entry.size;
+}
+
+} // anonymous namespace
+
+const uint8_t* getBundleEntry(const uint8_t* bundle, uint32_t index) noexcept {
+    BundleHeader header;
+    BundleEntry entry;
+    const uint8_t* entryAddress;
+    if (!readEntry(bundle, index, header, entry, &entryAddress)) {
+        return nullptr;
+    }
+    if (BundleCodec(entry.codec) == BundleCodec::NONE) {
+        return bundle + entry.offset;
+    }
+
+    CacheSlot* slot;
+    {
+        BundleCache& cache = getCache();
+        std::lock_guard<std::mutex> guard(cache.lock);
+        auto& cached = cache.slots[entryAddress];
+        if (!cached) {
+            cached = std::make_unique<CacheSlot>();
+        }
+        slot = cached.get();
+    }
+    // 解压在锁外进行，不同条目互不阻塞
+    std::call_once(slot->once, decodeToCache, bundle, std::cref(header), std::cref(entry), index,
+            std::ref(*slot));
+    return slot->data.get();
+}
+
+BundleLease acquireBundleEntry(const uint8_t* bundle, uint32_t index) {
+    BundleHeader header;
+    BundleEntry entry;
+    const uint8_t* entryAddress;
+    if (!readEntry(bundle, index, header, entry, &entryAddress)) {
+        return {};
+    }
+    if (BundleCodec(entry.codec) == BundleCodec::NONE) {
+        return BundleLease(bundle + entry.offset, entry.size);
+    }
+
+    BundleLease lease;
+    {
+        BundleCache& cache = getCache();
+        std::lock_guard<std::mutex> guard(cache.lock);
+        // 已经被 getBundleEntry() 缓存的条目直接引用缓存
+        auto cached = cache.slots.find(entryAddress);
+        if (cached != cache.slots.end() && cached->second->ready.load(std::memory_order_acquire)) {
+            return BundleLease(cached->second->data.get(), entry.size);
+        }
+        // 取够大的缓冲区中最小的一个
+        auto best = cache.pool.end();
+        for (auto it = cache.pool.begin(); it != cache.pool.end(); ++it) {
+            if (it->capacity >= entry.size && (best == cache.pool.end() || it->capacity < best->capacity)) {
+                best = it;
+            }
+        }
+        if (best != cache.pool.end()) {
+            lease.mBuffer = std::move(best->data);
+            lease.mCapacity = best->capacity;
+            cache.stats.pooledBytes -= best->capacity;
+            cache.pool.erase(best);
+        }
+    }
+    if (!lease.mBuffer) {
+        lease.mBuffer.reset(new uint8_t[entry.size]);
+        lease.mCapacity = entry.size;
+    }
+    if (!decodeWithStats(bundle, header, entry, index, lease.mBuffer.get())) {
+        return {};
+    }
+    lease.mData = lease.mBuffer.get();
+    lease.mSize = entry.size;
+    return lease;
+}
+
+BundleStats getBundleStats() noexcept {
+    BundleCache& cache = getCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    return cache.stats;
+}
+
+// ========================================
+// BundleLease
+// ========================================
+
+BundleLease::~BundleLease() {
+    release();
+}
+
+BundleLease::BundleLease(BundleLease&& rhs) noexcept
+        : mData(rhs.mData), mSize(rhs.mSize), mBuffer(std::move(rhs.mBuffer)),
+          mCapacity(rhs.mCapacity) {
+    rhs.mData = nullptr;
+    rhs.mSize = 0;
+    rhs.mCapacity = 0;
+}
+
+BundleLease& BundleLease::operator=(BundleLease&& rhs) noexcept {
+    if (this != &rhs) {
+        release();
+        mData = rhs.mData;
+        mSize = rhs.mSize;
+        mBuffer = std::move(rhs.mBuffer);
+        mCapacity = rhs.mCapacity;
+        rhs.mData = nullptr;
+        rhs.mSize = 0;
+        rhs.mCapacity = 0;
+    }
+    return *this;
+}
+
+void BundleLease::release() noexcept {
+    mData = nullptr;
+    mSize = 0;
+    if (!mBuffer) {
+        return;
+    }
+    BundleCache& cache = getCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    cache.pool.push_back({ std::move(mBuffer), mCapacity });
+    cache.stats.pooledBytes += mCapacity;
+    if (cache.pool.size() > MAX_POOLED_BUFFERS) {
+        auto smallest = std::min_element(cache.pool.begin(), cache.pool.end(),
+                [](const PooledBuffer& a, const PooledBuffer& b) { return a.capacity < b.capacity; });
+        cache.stats.pooledBytes -= smallest->capacity;
+        cache.pool.erase(smallest);
+    }
+    mCapacity = 0;
+}
+
+// ========================================
+// ResourceBundleWriter
+// ========================================
+
+ResourceBundleWriter::ResourceBundleWriter(double maxRatio, bool splitMaterials)
+        : mMaxRatio(maxRatio), mSplitMaterials(splitMaterials) {
+}
+
+ResourceBundleWriter::Stored ResourceBundleWriter::compress(const uint8_t* data, size_t size) const {
+    Stored stored{ BundleCodec::LZ4, size, lz4Compress(data, size) };
+    if (double(stored.data.size()) > double(size) * mMaxRatio) {
+        stored.codec = BundleCodec::NONE;
+        stored.data.assign(data, data + size);
+    }
+    return stored;
+}
+
+uint32_t ResourceBundleWriter::addSegment(const uint8_t* data, size_t size, bool* shared) {
+    const uint64_t hash = hashBytes(data, size);
+    const auto range = mSegmentIndex.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const Segment& segment = mSegments[it->second];
+        if (segment.size == size &&
+                std::memcmp(mBlocks[segment.block].data() + segment.offset, data, size) == 0) {
+            *shared = true;
+            return it->second;
+        }
+    }
+    *shared = false;
+    // 新片段追加到最后一个块，放不下时开始一个新块（片段不跨块）
+    if (mBlocks.empty() || mBlocks.back().size() + size > BLOCK_SIZE) {
+        mBlocks.emplace_back();
+        mBlocks.back().reserve(BLOCK_SIZE);
+    }
+    std::vector<uint8_t>& block = mBlocks.back();
+    const uint32_t index = uint32_t(mSegments.size());
+    mSegments.push_back({ uint32_t(mBlocks.size() - 1), uint32_t(block.size()), uint32_t(size) });
+    block.insert(block.end(), data, data + size);
+    mSegmentIndex.emplace(hash, index);
+    return index;
+}
+
+uint32_t ResourceBundleWriter::addEntry(const uint8_t* data, size_t size) {
+    TRACE_NAME("ResourceBundleWriter::addEntry");
+    Entry entry{};
+    entry.info.size = size;
+
+    std::vector<std::pair<size_t, size_t>> chunks;
+    if (mSplitMaterials && splitMaterialChunks(data, size, chunks)) {
+        entry.info.codec = BundleCodec::CHUNKED;
+        std::vector<uint32_t> segments;
+        const auto addSegmentTo = [&](const uint8_t* segmentData, size_t segmentSize) {
+            bool shared = false;
+            segments.push_back(addSegment(segmentData, segmentSize, &shared));
+            if (shared) {
+                entry.info.sharedSegments++;
+            } else {
+                entry.info.newBytes += segmentSize;
+            }
+        };
+        // 先按 ChunkType 切开，切点总在分块边界上；大分块再按内容切成片段
+        for (const auto& [begin, end] : chunks) {
+            if (end - begin < MIN_SPLIT_CHUNK_SIZE) {
+                addSegmentTo(data + begin, end - begin);
+                continue;
+            }
+            addSegmentTo(data + begin, MATERIAL_CHUNK_HEADER_SIZE);
+            for (size_t cursor = begin + MATERIAL_CHUNK_HEADER_SIZE; cursor < end;) {
+                const size_t length = nextSegment(data + cursor, end - cursor);
+                addSegmentTo(data + cursor, length);
+                cursor += length;
+            }
+        }
+        entry.info.segmentCount = uint32_t(segments.size());
+        entry.data.resize(segments.size() * sizeof(uint32_t));
+        std::memcpy(entry.data.data(), segments.data(), entry.data.size());
+    } else {
+        Stored stored = compress(data, size);
+        entry.info.codec = stored.codec;
+        entry.info.newBytes = size;
+        entry.data = std::move(stored.data);
+    }
+    entry.info.storedSize = entry.data.size();
+    mEntries.push_back(std::move(entry));
+    return uint32_t(mEntries.size() - 1);
+}
+
+bool ResourceBundleWriter::write(const std::string& path) const {
+    TRACE_NAME("ResourceBundleWriter::write");
+    BundleHeader header{};
+    std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+    header.version = BUNDLE_VERSION;
+    header.entryCount = uint32_t(mEntries.size());
+    header.blockCount = uint32_t(mBlocks.size());
+    header.segmentCount = uint32_t(mSegments.size());
+
+    std::vector<Stored> blocks;
+    blocks.reserve(mBlocks.size());
+    for (const auto& block : mBlocks) {
+        blocks.push_back(compress(block.data(), block.size()));
+    }
+
+    // 条目表和块表连续存放，之后是片段表，然后是条目数据和块数据
+    std::vector<BundleEntry> table(mEntries.size() + blocks.size());
+    std::vector<const std::vector<uint8_t>*> contents(table.size());
+    std::vector<BundleSegment> segments(mSegments.size());
+    for (size_t i = 0; i < mSegments.size(); i++) {
+        segments[i] = { mSegments[i].block, mSegments[i].offset, mSegments[i].size };
+    }
+    uint64_t offset = alignUp(sizeof(BundleHeader) + table.size() * sizeof(BundleEntry) +
+            segments.size() * sizeof(BundleSegment), BUNDLE_ALIGNMENT);
+    for (size_t i = 0; i < table.size(); i++) {
+        const bool isEntry = i < mEntries.size();
+        const std::vector<uint8_t>& data = isEntry ? mEntries[i].data : blocks[i - mEntries.size()].data;
+        const size_t size = isEntry ? mEntries[i].info.size : blocks[i - mEntries.size()].size;
+        const BundleCodec codec = isEntry ? mEntries[i].info.codec : blocks[i - mEntries.size()].codec;
+        if (size > UINT32_MAX || data.size() > UINT32_MAX) {
+            std::cerr << "Resource bundle entry too large: " << i << std::endl;
+            return false;
+        }
+        table[i] = { offset, uint32_t(data.size()), uint32_t(size), uint32_t(codec), 0 };
+        contents[i] = &data;
+        offset = alignUp(offset + data.size(), BUNDLE_ALIGNMENT);
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Failed to create resource bundle: " << path << std::endl;
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()),
+            std::streamsize(table.size() * sizeof(BundleEntry)));
+    out.write(reinterpret_cast<const char*>(segments.data()),
+            std::streamsize(segments.size() * sizeof(BundleSegment)));
+    const char padding[BUNDLE_ALIGNMENT] = {};
+    for (size_t i = 0; i < table.size(); i++) {
+        const uint64_t position = uint64_t(out.tellp());
+        out.write(padding, std::streamsize(table[i].offset - position));
+        out.write(reinterpret_cast<const char*>(contents[i]->data()),
+                std::streamsize(contents[i]->size()));
+    }
+    if (!out) {
+        std::cerr << "Failed to write resource bundle: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace demo
@@ -0,0 +1,150 @@
+#ifndef DEMO_COMMON_RESOURCEBUNDLE_H
+#define DEMO_COMMON_RESOURCEBUNDLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace demo {
+
+// ========================================
+// 压缩的内嵌资源包
+// ========================================
+// resgen 生成的 resources.S/monkey.S 把所有材质包原样 incbin 进每个可执行文件，
+// 只用到一个材质的示例也要链接并在启动时换入全部数据。
+// demo-bundle 把 resgen 的 .h/.bin 转换成压缩资源包，格式为：
+//
+//   文件头 | 条目表 | 块表 | 片段表 | 条目数据和块数据（每段按 16 字节对齐）
+//
+// 每个条目单独用 LZ4 压缩（压缩收益太小的原样存储），生成的头文件保留
+// resgen 的 XXX_DATA/XXX_SIZE 宏名，XXX_DATA 展开为 getBundleEntry() 调用：
+// 原样存储的条目直接返回包内地址，压缩的条目在第一次访问时解压到缓存，之后返回同一个指针。
+// 缓存在进程退出前不会释放，返回的指针可以像原来的静态数据一样长期持有。
+//
+// 材质包（filamat）先按 filamat::ChunkType 拆成分块，较大的分块（着色器文本和 SPIR-V 字典）
+// 再按内容切成平均几百字节的片段（content-defined chunking，切点只取决于附近的内容，
+// 插入或删除几行不会影响后面的切点）。内容相同的片段在整个资源包中只存一份，
+// 按首次出现的顺序拼接成 64KB 的块分别压缩；条目只记录片段序号，读取时按顺序拼回完整的材质包。
+// 同一个材质的不同变体（SANDBOXLIT/SANDBOXLITFADE/...）的字典大部分内容相同，但整块几乎从不完全相同，
+// 所以只按 ChunkType 整块去重几乎没有收益，必须切得更细。
+
+enum class BundleCodec : uint32_t {
+    NONE = 0,
+    LZ4 = 1,
+    // 条目数据是片段序号数组（uint32），片段位于按 NONE 或 LZ4 存储的块中
+    CHUNKED = 2,
+};
+
+// 返回 bundle 中第 index 个条目的原始数据，线程安全。
+// 不同条目可以在不同线程上并行解压；数据损坏时打印原因并返回 nullptr
+const uint8_t* getBundleEntry(const uint8_t* bundle, uint32_t index) noexcept;
+
+// 临时取出的条目数据。需要长期持有的数据用 getBundleEntry()；
+// 只在一次调用中使用的数据（例如 Material::Builder::package()，数据只需要保持到 build()）
+// 用 acquireBundleEntry()，解压到池中复用的缓冲区，析构时归还，不在缓存中常驻。
+class BundleLease {
+public:
+    BundleLease() = default;
+    // 不持有缓冲区，直接引用 data（原样存储的条目、已缓存的条目、未压缩的 resgen 数据）
+    BundleLease(const uint8_t* data, size_t size) noexcept : mData(data), mSize(size) {}
+    ~BundleLease();
+
+    BundleLease(BundleLease&& rhs) noexcept;
+    BundleLease& operator=(BundleLease&& rhs) noexcept;
+    BundleLease(const BundleLease&) = delete;
+    BundleLease& operator=(const BundleLease&) = delete;
+
+    const uint8_t* data() const noexcept { return mData; }
+    size_t size() const noexcept { return mSize; }
+    explicit operator bool() const noexcept { return mData != nullptr; }
+
+private:
+    friend BundleLease acquireBundleEntry(const uint8_t* bundle, uint32_t index);
+
+    void release() noexcept;
+
+    const uint8_t* mData = nullptr;
+    size_t mSize = 0;
+    std::unique_ptr<uint8_t[]> mBuffer;
+    size_t mCapacity = 0;
+};
+
+// 取出第 index 个条目，线程安全。数据损坏时打印原因并返回空租约
+BundleLease acquireBundleEntry(const uint8_t* bundle, uint32_t index);
+
+// 解压统计，用于启动耗时和内存占用分析
+struct BundleStats {
+    uint32_t decodedEntries = 0;    // 解压（或拼接）过的条目次数，包括租约
+    uint64_t decodedBytes = 0;
+    double decodeMs = 0.0;
+    uint64_t cachedBytes = 0;       // getBundleEntry() 缓存常驻的字节数
+    uint64_t pooledBytes = 0;       // 池中空闲缓冲区的字节数
+};
+
+BundleStats getBundleStats() noexcept;
+
+// ========================================
+// 资源包写入（离线转换）
+// ========================================
+class ResourceBundleWriter {
+public:
+    // 压缩后的大小超过原始大小的 maxRatio 倍时原样存储，
+    // 已经压缩过的数据（PNG、KTX2 等）不值得在运行时再解压一次。
+    // splitMaterials 为 true 时 filamat 材质包按片段去重
+    explicit ResourceBundleWriter(double maxRatio = 0.95, bool splitMaterials = true);
+
+    // 加入一个条目，返回它的序号。数据会被复制（压缩），调用后可以释放
+    uint32_t addEntry(const uint8_t* data, size_t size);
+
+    struct EntryInfo {
+        BundleCodec codec;
+        size_t size;
+        size_t storedSize;          // 条目自身存储的字节数（片段条目只是序号数组）
+        uint32_t segmentCount;      // 片段条目的片段数
+        uint32_t sharedSegments;    // 其中复用已有片段的个数
+        size_t newBytes;            // 首次出现的片段的原始字节数（压缩前）
+    };
+
+    size_t getEntryCount() const noexcept { return mEntries.size(); }
+    const EntryInfo& getEntryInfo(uint32_t index) const noexcept { return mEntries[index].info; }
+    size_t getSegmentCount() const noexcept { return mSegments.size(); }
+    size_t getBlockCount() const noexcept { return mBlocks.size(); }
+
+    // 写出资源包，失败时打印原因并返回 false
+    bool write(const std::string& path) const;
+
+private:
+    struct Stored {
+        BundleCodec codec;
+        size_t size;
+        std::vector<uint8_t> data;
+    };
+    struct Entry {
+        EntryInfo info;
+        std::vector<uint8_t> data;  // 压缩数据或片段序号
+    };
+    struct Segment {
+        uint32_t block;
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    Stored compress(const uint8_t* data, size_t size) const;
+    // 返回片段序号，内容相同的片段只存一份
+    uint32_t addSegment(const uint8_t* data, size_t size, bool* shared);
+
+    double mMaxRatio;
+    bool mSplitMaterials;
+    std::vector<Entry> mEntries;
+    std::vector<Segment> mSegments;
+    // 所有块的原始内容，最后一个块还在填充；写出时才压缩
+    std::vector<std::vector<uint8_t>> mBlocks;
+    std::unordered_multimap<uint64_t, uint32_t> mSegmentIndex;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_RESOURCEBUNDLE_H
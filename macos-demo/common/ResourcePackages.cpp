@@ -0,0 +1,60 @@
+#include "ResourcePackages.h"
+
+#include "EmbeddedResources.h"
+
+#include <cstring>
+
+namespace demo {
+
+namespace {
+
+// resources.h 中的所有材质包，顺序与 resources.S 一致。
+// 取数据可能要解压，包在 lambda 里推迟到 acquire() 时才执行
+#define MATERIAL_PACKAGE(NAME, name) \
+    { name, []() { return ACQUIRE_RESOURCE(RESOURCES, NAME); }, RESOURCES_##NAME##_SIZE }
+
+const ResourcePackage MATERIAL_PACKAGES[] = {
+    MATERIAL_PACKAGE(AIDEFAULTMAT, "aidefaultmat"),
+    MATERIAL_PACKAGE(BAKEDCOLOR, "bakedcolor"),
+    MATERIAL_PACKAGE(BAKEDTEXTURE, "bakedtexture"),
+    MATERIAL_PACKAGE(AOPREVIEW, "aopreview"),
+    MATERIAL_PACKAGE(ARRAYTEXTURE, "arraytexture"),
+    MATERIAL_PACKAGE(GROUNDSHADOW, "groundshadow"),
+    MATERIAL_PACKAGE(HEIGHTFIELD, "heightfield"),
+    MATERIAL_PACKAGE(IMAGE, "image"),
+    MATERIAL_PACKAGE(MIRROR, "mirror"),
+    MATERIAL_PACKAGE(OVERDRAW, "overdraw"),
+    MATERIAL_PACKAGE(SANDBOXCLOTH, "sandboxcloth"),
+    MATERIAL_PACKAGE(SANDBOXLIT, "sandboxlit"),
+    MATERIAL_PACKAGE(SANDBOXLITFADE, "sandboxlitfade"),
+    MATERIAL_PACKAGE(SANDBOXLITTRANSPARENT, "sandboxlittransparent"),
+    MATERIAL_PACKAGE(SANDBOXLITTHINREFRACTION, "sandboxlitthinrefraction"),
+    MATERIAL_PACKAGE(SANDBOXLITTHINREFRACTIONSSR, "sandboxlitthinrefractionssr"),
+    MATERIAL_PACKAGE(SANDBOXLITSOLIDREFRACTION, "sandboxlitsolidrefraction"),
+    MATERIAL_PACKAGE(SANDBOXLITSOLIDREFRACTIONSSR, "sandboxlitsolidrefractionssr"),
+    MATERIAL_PACKAGE(SANDBOXSPECGLOSS, "sandboxspecgloss"),
+    MATERIAL_PACKAGE(SANDBOXSUBSURFACE, "sandboxsubsurface"),
+    MATERIAL_PACKAGE(SANDBOXUNLIT, "sandboxunlit"),
+    MATERIAL_PACKAGE(TEXTUREDLIT, "texturedlit"),
+    MATERIAL_PACKAGE(POINTSPRITES, "pointsprites"),
+};
+
+#undef MATERIAL_PACKAGE
+
+} // anonymous namespace
+
+const ResourcePackage* getMaterialPackages(size_t* count) noexcept {
+    *count = sizeof(MATERIAL_PACKAGES) / sizeof(MATERIAL_PACKAGES[0]);
+    return MATERIAL_PACKAGES;
+}
+
+const ResourcePackage* findMaterialPackage(const char* name) noexcept {
+    for (const auto& package : MATERIAL_PACKAGES) {
+        if (!strcmp(package.name, name)) {
+            return &package;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace demo
@@ -0,0 +1,32 @@
+#ifndef DEMO_COMMON_RESOURCEPACKAGES_H
+#define DEMO_COMMON_RESOURCEPACKAGES_H
+
+#include "ResourceBundle.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace demo {
+
+// ========================================
+// 内嵌资源包索引
+// ========================================
+// EmbeddedResources.h 只提供一组宏（RESOURCES_XXX_DATA/SIZE），
+// 这里把其中的材质包整理成表，方便按名字查找或逐个遍历。
+// 数据通过 acquire() 取得：使用压缩资源包时才解压，遍历表本身不会解压任何材质；
+// 返回的租约保持到 Material::Builder::build() 之后即可释放。
+struct ResourcePackage {
+    const char* name;       // 小写的资源名，例如 "aidefaultmat"
+    BundleLease (*acquire)();
+    size_t size;
+};
+
+// 所有内嵌材质包（.filamat），count 返回数量
+const ResourcePackage* getMaterialPackages(size_t* count) noexcept;
+
+// 按名字查找材质包，找不到时返回 nullptr
+const ResourcePackage* findMaterialPackage(const char* name) noexcept;
+
+} // namespace demo
+
+#endif // DEMO_COMMON_RESOURCEPACKAGES_H
@@ -0,0 +1,164 @@
+#include "SceneBenchmark.h"
+#include "JsonWriter.h"
+#include "Stats.h"
+#include "Trace.h"
+
+#include <filament/Renderer.h>
+
+#include <chrono>
+
+using namespace filament;
+
+namespace demo {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+} // anonymous namespace
+
+BenchmarkResult runSceneBenchmark(const std::string& sceneName, const SceneContext& params,
+        const Engine::Config* config, const BenchmarkOptions& options) {
+    BenchmarkResult result;
+    result.scene = sceneName;
+
+    std::unique_ptr<DemoScene> demoScene = createDemoScene(sceneName);
+    if (!demoScene) {
+        result.error = "unknown scene";
+        return result;
+    }
+
+    SceneContext ctx = params;
+    MemoryLedger memoryLedger(0.0);
+    ctx.memory = &memoryLedger;
+
+    // ========================================
+    // 创建 Engine 和场景
+    // ========================================
+    auto t0 = Clock::now();
+    TRACE_NAME_BEGIN("createHeadlessContext");
+    const bool created = createHeadlessContext(ctx, config);
+    TRACE_NAME_END();
+    if (!created) {
+        result.error = "failed to create engine";
+        return result;
+    }
+    auto t1 = Clock::now();
+    result.engineCreateMs = elapsedMs(t0, t1);
+    result.engineConfig = ctx.engine->getConfig();
+
+    TRACE_NAME_BEGIN("DemoScene::setup");
+    const bool ready = demoScene->setup(ctx);
+    // 等待所有命令（包括缓冲区上传）被后端处理完，setup 耗时才完整
+    ctx.engine->flushAndWait();
+    TRACE_NAME_END();
+    auto t2 = Clock::now();
+    result.setupMs = elapsedMs(t1, t2);
+    result.memory = memoryLedger.snapshot(ctx.engine);
+
+    if (!ready) {
+        result.error = "scene setup failed";
+    } else {
+        // ========================================
+        // 渲染循环：使用固定时间步长驱动动画
+        // ========================================
+        const uint32_t totalFrames = options.warmupFrames + options.frames;
+        result.frameMs.reserve(options.frames);
+        result.updateMs.reserve(options.frames);
+        result.beginFrameMs.reserve(options.frames);
+        result.renderMs.reserve(options.frames);
+        result.endFrameMs.reserve(options.frames);
+
+        FrameTelemetry::Config telemetryConfig;
+        telemetryConfig.dumpOnDestroy = false;
+        result.telemetry = std::make_shared<FrameTelemetry>(sceneName, telemetryConfig);
+
+        for (uint32_t frame = 0; frame < totalFrames; frame++) {
+            const bool measured = frame >= options.warmupFrames;
+            const float time = float(frame) * options.timeStep;
+
+            if (measured) {
+                result.telemetry->beginFrame();
+            }
+            TRACE_NAME(measured ? "frame" : "warmup frame");
+            auto f0 = Clock::now();
+            TRACE_NAME_BEGIN("DemoScene::update");
+            demoScene->update(ctx, time);
+            TRACE_NAME_END();
+            auto f1 = Clock::now();
+            TRACE_NAME_BEGIN("Renderer::beginFrame");
+            const bool rendered = ctx.renderer->beginFrame(ctx.swapChain);
+            TRACE_NAME_END();
+            auto f2 = Clock::now();
+            auto f3 = f2;
+            auto f4 = f2;
+            if (rendered) {
+                TRACE_NAME_BEGIN("Renderer::render");
+                ctx.renderer->render(ctx.view);
+                TRACE_NAME_END();
+                f3 = Clock::now();
+                TRACE_NAME_BEGIN("Renderer::endFrame");
+                ctx.renderer->endFrame();
+                TRACE_NAME_END();
+                f4 = Clock::now();
+            }
+
+            if (!measured) {
+                continue;
+            }
+            result.telemetry->endFrame(*ctx.renderer);
+            if (!rendered) {
+                result.skippedFrames++;
+                continue;
+            }
+            result.updateMs.push_back(elapsedMs(f0, f1));
+            result.beginFrameMs.push_back(elapsedMs(f1, f2));
+            result.renderMs.push_back(elapsedMs(f2, f3));
+            result.endFrameMs.push_back(elapsedMs(f3, f4));
+            result.frameMs.push_back(elapsedMs(f0, f4));
+        }
+        result.ok = true;
+    }
+
+    // ========================================
+    // 清理
+    // ========================================
+    auto t3 = Clock::now();
+    TRACE_NAME_BEGIN("teardown");
+    demoScene->teardown(ctx);
+    destroyHeadlessContext(ctx);
+    TRACE_NAME_END();
+    result.teardownMs = elapsedMs(t3, Clock::now());
+    return result;
+}
+
+void writeBenchmarkResult(JsonWriter& json, const BenchmarkResult& result) {
+    json.beginObject();
+    json.key("scene").value(result.scene);
+    json.key("ok").value(result.ok);
+    if (!result.error.empty()) {
+        json.key("error").value(result.error);
+    }
+    json.key("engineCreateMs").value(result.engineCreateMs);
+    json.key("setupMs").value(result.setupMs);
+    json.key("teardownMs").value(result.teardownMs);
+    json.key("skippedFrames").value(result.skippedFrames);
+    json.key("frameMs");      writeStats(json, computeStats(result.frameMs));
+    json.key("updateMs");     writeStats(json, computeStats(result.updateMs));
+    json.key("beginFrameMs"); writeStats(json, computeStats(result.beginFrameMs));
+    json.key("renderMs");     writeStats(json, computeStats(result.renderMs));
+    json.key("endFrameMs");   writeStats(json, computeStats(result.endFrameMs));
+    if (result.telemetry) {
+        json.key("telemetry");
+        result.telemetry->writeJson(json);
+    }
+    json.key("memory");
+    result.memory.writeJson(json);
+    json.endObject();
+}
+
+} // namespace demo
@@ -0,0 +1,59 @@
+#ifndef DEMO_COMMON_SCENEBENCHMARK_H
+#define DEMO_COMMON_SCENEBENCHMARK_H
+
+#include "DemoScene.h"
+#include "FrameTelemetry.h"
+#include "MemoryLedger.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace demo {
+
+class JsonWriter;
+
+struct BenchmarkOptions {
+    uint32_t frames = 300;          // 计入统计的帧数
+    uint32_t warmupFrames = 10;     // 预热帧数，不计入统计（首帧会触发着色器编译）
+    float timeStep = 1.0f / 60.0f;  // 固定时间步长，保证每次运行渲染相同的画面
+};
+
+// 单个场景的基准测试结果，耗时单位均为毫秒
+struct BenchmarkResult {
+    std::string scene;
+    bool ok = false;
+    std::string error;
+
+    double engineCreateMs = 0.0;    // createHeadlessContext()
+    double setupMs = 0.0;           // DemoScene::setup()
+    double teardownMs = 0.0;        // DemoScene::teardown() + destroyHeadlessContext()
+
+    // Engine 实际使用的配置（Engine::getConfig()），引擎会修正不合法的取值
+    filament::Engine::Config engineConfig;
+
+    std::vector<double> frameMs;        // 整帧 CPU 耗时（update + beginFrame + render + endFrame）
+    std::vector<double> updateMs;       // DemoScene::update()
+    std::vector<double> beginFrameMs;   // Renderer::beginFrame()
+    std::vector<double> renderMs;       // Renderer::render()
+    std::vector<double> endFrameMs;     // Renderer::endFrame()
+    uint32_t skippedFrames = 0;         // beginFrame() 返回 false 的帧数
+
+    // 计时帧的直方图和卡顿统计，包含 getFrameInfoHistory() 报告的后端/GPU 耗时
+    std::shared_ptr<FrameTelemetry> telemetry;
+
+    // setup() 完成后场景登记的资源内存、Engine 对象数量和 RSS
+    MemoryReport memory;
+};
+
+// 在无窗口环境下运行一个场景：创建 Engine -> setup -> 预热 -> 计时 N 帧 -> 销毁
+// ctx 提供尺寸、资源路径等参数，其中的 Filament 对象由本函数创建和销毁
+BenchmarkResult runSceneBenchmark(const std::string& sceneName, const SceneContext& params,
+        const filament::Engine::Config* config, const BenchmarkOptions& options);
+
+// 写出单个结果（统计值，不含原始采样）
+void writeBenchmarkResult(JsonWriter& json, const BenchmarkResult& result);
+
+} // namespace demo
+
+#endif // DEMO_COMMON_SCENEBENCHMARK_H
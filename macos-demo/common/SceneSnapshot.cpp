@@ -0,0 +1,1080 @@
+#include "SceneSnapshot.h"
+#include "DemoScene.h"
+#include "Filamesh.h"
+#include "MemoryLedger.h"
+#include "ResourcePackages.h"
+#include "Trace.h"
+#include "scenes/Scenes.h"
+
+#include <filament/Camera.h>
+#include <filament/IndexBuffer.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/Scene.h>
+#include <filament/Skybox.h>
+#include <filament/Texture.h>
+#include <filament/TransformManager.h>
+
+#include <utils/EntityManager.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace filament;
+using namespace filament::math;
+
+namespace demo {
+
+namespace {
+
+// ========================================
+// 文件格式（小端，所有记录都是 POD，偏移从文件开头算起）
+// ========================================
+constexpr char SNAPSHOT_MAGIC[8] = { 'D', 'E', 'M', 'O', 'S', 'N', 'A', 'P' };
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+constexpr uint32_t SNAPSHOT_ALIGNMENT = 64;
+
+enum Section : uint32_t {
+    STRINGS,            // 以 '\0' 结尾的字符串，count 为字节数
+    MATERIALS,
+    TEXTURES,
+    INSTANCES,
+    PARAMETERS,         // 按材质实例分组
+    VERTEX_BUFFERS,
+    ATTRIBUTES,         // 按顶点缓冲区分组
+    INDEX_BUFFERS,
+    RENDERABLES,
+    PRIMITIVES,         // 按可渲染实体分组
+    LIGHTS,
+    SECTION_COUNT
+};
+
+// SnapshotHeader::flags
+constexpr uint32_t HAS_CAMERA = 0x1;
+constexpr uint32_t HAS_SKYBOX = 0x2;
+
+struct SectionEntry {
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t fileSize;
+    SectionEntry sections[SECTION_COUNT];
+    float cameraModel[16];
+    float cameraFov;            // 垂直视野（度）
+    float cameraNear;
+    float cameraFar;
+    float skybox[4];
+    uint32_t reserved;
+};
+
+struct StringRef {
+    uint32_t offset;            // STRINGS 段内的偏移
+    uint32_t length;            // 不含结尾的 '\0'
+};
+
+struct MaterialRecord {
+    StringRef package;          // ResourcePackages 中的材质包名
+};
+
+// TextureRecord::flags
+constexpr uint32_t TEXTURE_SRGB = 0x1;
+constexpr uint32_t TEXTURE_MIPMAPS = 0x2;
+
+struct TextureRecord {
+    uint32_t width;
+    uint32_t height;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t offset;            // RGBA8 的第 0 级
+    uint64_t size;
+};
+
+struct InstanceRecord {
+    uint32_t material;
+    uint32_t useDefault;
+    uint32_t firstParameter;
+    uint32_t parameterCount;
+};
+
+enum ParameterType : uint32_t {
+    PARAMETER_FLOAT,
+    PARAMETER_FLOAT2,
+    PARAMETER_FLOAT3,
+    PARAMETER_FLOAT4,
+    PARAMETER_INT,
+    PARAMETER_BOOL,
+    PARAMETER_TEXTURE,
+    PARAMETER_TYPE_COUNT
+};
+
+struct ParameterRecord {
+    StringRef name;
+    uint32_t type;
+    uint32_t texture;
+    float value[4];
+    int32_t integer;            // INT 和 BOOL
+    uint32_t sampler;           // backend::SamplerParams 的位模式
+};
+
+struct VertexBufferRecord {
+    uint32_t vertexCount;
+    uint32_t stride;
+    uint32_t firstAttribute;
+    uint32_t attributeCount;
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct AttributeRecord {
+    uint8_t attribute;          // VertexAttribute
+    uint8_t type;               // VertexBuffer::AttributeType
+    uint8_t normalized;
+    uint8_t reserved;
+    uint32_t offset;
+};
+
+struct IndexBufferRecord {
+    uint32_t indexCount;
+    uint32_t indexType;         // IndexBuffer::IndexType
+    uint64_t offset;
+    uint64_t size;
+};
+
+// RenderableRecord::flags
+constexpr uint32_t CAST_SHADOWS = 0x1;
+constexpr uint32_t RECEIVE_SHADOWS = 0x2;
+
+struct RenderableRecord {
+    float transform[16];
+    float center[3];
+    float halfExtent[3];
+    uint32_t firstPrimitive;
+    uint32_t primitiveCount;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+struct PrimitiveRecord {
+    uint32_t vertexBuffer;
+    uint32_t indexBuffer;
+    uint32_t offset;
+    uint32_t count;
+    uint32_t minIndex;
+    uint32_t maxIndex;
+    uint32_t instance;
+    uint32_t reserved;
+};
+
+struct LightRecord {
+    uint32_t type;              // LightManager::Type
+    float color[3];
+    float intensity;
+    float direction[3];
+    float position[3];
+    float falloff;
+    float sunAngularRadius;
+    uint32_t castShadows;
+};
+
+static_assert(sizeof(backend::SamplerParams) == sizeof(uint32_t), "sampler params are stored as 32 bits");
+
+uint64_t alignUp(uint64_t value) {
+    return (value + SNAPSHOT_ALIGNMENT - 1) & ~uint64_t(SNAPSHOT_ALIGNMENT - 1);
+}
+
+// 先补齐到 64 字节，再追加 size 字节，返回数据的偏移
+uint64_t appendAligned(std::vector<uint8_t>& file, const void* data, size_t size) {
+    file.resize(alignUp(file.size()), 0);
+    const uint64_t offset = file.size();
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    file.insert(file.end(), bytes, bytes + size);
+    return offset;
+}
+
+template<typename T>
+SectionEntry appendSection(std::vector<uint8_t>& file, const std::vector<T>& records) {
+    return { appendAligned(file, records.data(), records.size() * sizeof(T)), records.size() };
+}
+
+void storeMatrix(float* out, const mat4f& matrix) {
+    for (size_t column = 0; column < 4; column++) {
+        for (size_t row = 0; row < 4; row++) {
+            out[column * 4 + row] = matrix[column][row];
+        }
+    }
+}
+
+mat4f loadMatrix(const float* in) {
+    mat4f matrix;
+    for (size_t column = 0; column < 4; column++) {
+        for (size_t row = 0; row < 4; row++) {
+            matrix[column][row] = in[column * 4 + row];
+        }
+    }
+    return matrix;
+}
+
+size_t indexSize(uint32_t type) {
+    return type == uint32_t(IndexBuffer::IndexType::USHORT) ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+} // anonymous namespace
+
+// ========================================
+// 快照加载
+// ========================================
+
+// 整个文件的映射。SceneSnapshot 和每个还没完成的上传各持有一个引用，最后一个引用释放时解除映射
+struct SceneSnapshot::Mapping {
+    void* address = nullptr;
+    size_t size = 0;
+    std::atomic<uint32_t> references{ 1 };
+
+    void acquire() noexcept { references.fetch_add(1, std::memory_order_relaxed); }
+
+    // 也用作 BufferDescriptor 的回调
+    static void release(void*, size_t, void* user) {
+        Mapping* mapping = static_cast<Mapping*>(user);
+        if (mapping->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            munmap(mapping->address, mapping->size);
+            delete mapping;
+        }
+    }
+};
+
+SceneSnapshot::~SceneSnapshot() {
+    close();
+}
+
+bool SceneSnapshot::open(const std::string& path) {
+    TRACE_NAME("SceneSnapshot::open");
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open scene snapshot: " << path << " (" << std::strerror(errno) << ")"
+                  << std::endl;
+        return false;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(SnapshotHeader)) {
+        std::cerr << "Not a scene snapshot: " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    const size_t size = size_t(info.st_size);
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // 映射建立后文件描述符就不再需要了
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        std::cerr << "Failed to map scene snapshot: " << path << " (" << std::strerror(errno) << ")"
+                  << std::endl;
+        return false;
+    }
+    // 加载时几乎所有页都会被上传读到，提前预读
+    madvise(address, size, MADV_WILLNEED);
+
+    mMapping = new Mapping;
+    mMapping->address = address;
+    mMapping->size = size;
+    if (!validate(path)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SceneSnapshot::close() {
+    if (mMapping) {
+        Mapping::release(nullptr, 0, mMapping);
+        mMapping = nullptr;
+    }
+}
+
+size_t SceneSnapshot::getFileSize() const noexcept {
+    return mMapping ? mMapping->size : 0;
+}
+
+const uint8_t* SceneSnapshot::data(uint64_t offset) const noexcept {
+    return static_cast<const uint8_t*>(mMapping->address) + offset;
+}
+
+template<typename T>
+const T* SceneSnapshot::records(uint32_t section, uint32_t* count) const noexcept {
+    const auto& header = *static_cast<const SnapshotHeader*>(mMapping->address);
+    if (count) {
+        *count = uint32_t(header.sections[section].count);
+    }
+    return reinterpret_cast<const T*>(data(header.sections[section].offset));
+}
+
+bool SceneSnapshot::validate(const std::string& path) const {
+    const auto& header = *static_cast<const SnapshotHeader*>(mMapping->address);
+    const uint64_t fileSize = mMapping->size;
+    auto fail = [&path](const char* reason) {
+        std::cerr << "Invalid scene snapshot: " << path << " (" << reason << ")" << std::endl;
+        return false;
+    };
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        return fail("bad magic");
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        return fail("unsupported version");
+    }
+    if (header.fileSize != fileSize) {
+        return fail("truncated file");
+    }
+    // 数据范围在文件内，并且按 alignment 对齐（记录可以直接按结构体读取）
+    auto inFile = [fileSize](uint64_t offset, uint64_t size) {
+        return offset % SNAPSHOT_ALIGNMENT == 0 && offset <= fileSize && size <= fileSize - offset;
+    };
+    const size_t recordSizes[SECTION_COUNT] = {
+        1, sizeof(MaterialRecord), sizeof(TextureRecord), sizeof(InstanceRecord),
+        sizeof(ParameterRecord), sizeof(VertexBufferRecord), sizeof(AttributeRecord),
+        sizeof(IndexBufferRecord), sizeof(RenderableRecord), sizeof(PrimitiveRecord),
+        sizeof(LightRecord),
+    };
+    for (uint32_t i = 0; i < SECTION_COUNT; i++) {
+        const SectionEntry& section = header.sections[i];
+        if (section.count > UINT32_MAX || !inFile(section.offset, section.count * recordSizes[i])) {
+            return fail("section out of bounds");
+        }
+    }
+
+    uint32_t stringBytes;
+    const char* strings = records<char>(STRINGS, &stringBytes);
+    auto validString = [strings, stringBytes](const StringRef& ref) {
+        return ref.offset < stringBytes && ref.length < stringBytes - ref.offset &&
+               strings[ref.offset + ref.length] == '\0';
+    };
+
+    uint32_t materialCount, textureCount, instanceCount, parameterCount;
+    uint32_t vertexBufferCount, attributeCount, indexBufferCount, renderableCount, primitiveCount;
+    uint32_t lightCount;
+    const auto* materials = records<MaterialRecord>(MATERIALS, &materialCount);
+    const auto* textures = records<TextureRecord>(TEXTURES, &textureCount);
+    const auto* instances = records<InstanceRecord>(INSTANCES, &instanceCount);
+    const auto* parameters = records<ParameterRecord>(PARAMETERS, &parameterCount);
+    const auto* vertexBuffers = records<VertexBufferRecord>(VERTEX_BUFFERS, &vertexBufferCount);
+    const auto* attributes = records<AttributeRecord>(ATTRIBUTES, &attributeCount);
+    const auto* indexBuffers = records<IndexBufferRecord>(INDEX_BUFFERS, &indexBufferCount);
+    const auto* renderables = records<RenderableRecord>(RENDERABLES, &renderableCount);
+    const auto* primitives = records<PrimitiveRecord>(PRIMITIVES, &primitiveCount);
+    const auto* lights = records<LightRecord>(LIGHTS, &lightCount);
+
+    for (uint32_t i = 0; i < materialCount; i++) {
+        if (!validString(materials[i].package)) {
+            return fail("bad material name");
+        }
+    }
+    for (uint32_t i = 0; i < textureCount; i++) {
+        const TextureRecord& texture = textures[i];
+        if (texture.width == 0 || texture.height == 0 ||
+                texture.size != uint64_t(texture.width) * texture.height * 4 ||
+                !inFile(texture.offset, texture.size)) {
+            return fail("bad texture");
+        }
+    }
+    for (uint32_t i = 0; i < instanceCount; i++) {
+        const InstanceRecord& instance = instances[i];
+        if (instance.material >= materialCount || instance.firstParameter > parameterCount ||
+                instance.parameterCount > parameterCount - instance.firstParameter) {
+            return fail("bad material instance");
+        }
+    }
+    for (uint32_t i = 0; i < parameterCount; i++) {
+        const ParameterRecord& parameter = parameters[i];
+        if (!validString(parameter.name) || parameter.type >= PARAMETER_TYPE_COUNT ||
+                (parameter.type == PARAMETER_TEXTURE && parameter.texture >= textureCount)) {
+            return fail("bad material parameter");
+        }
+    }
+    for (uint32_t i = 0; i < vertexBufferCount; i++) {
+        const VertexBufferRecord& buffer = vertexBuffers[i];
+        // VertexBuffer::Builder::attribute() 的步长是 8 位的
+        if (buffer.vertexCount == 0 || buffer.stride == 0 || buffer.stride > UINT8_MAX ||
+                buffer.size != uint64_t(buffer.vertexCount) * buffer.stride ||
+                !inFile(buffer.offset, buffer.size) || buffer.firstAttribute > attributeCount ||
+                buffer.attributeCount > attributeCount - buffer.firstAttribute) {
+            return fail("bad vertex buffer");
+        }
+        for (uint32_t a = 0; a < buffer.attributeCount; a++) {
+            const AttributeRecord& attribute = attributes[buffer.firstAttribute + a];
+            if (attribute.attribute >= backend::MAX_VERTEX_ATTRIBUTE_COUNT ||
+                    attribute.type > uint8_t(VertexBuffer::AttributeType::HALF4) ||
+                    attribute.offset >= buffer.stride) {
+                return fail("bad vertex attribute");
+            }
+        }
+    }
+    for (uint32_t i = 0; i < indexBufferCount; i++) {
+        const IndexBufferRecord& buffer = indexBuffers[i];
+        if ((buffer.indexType != uint32_t(IndexBuffer::IndexType::USHORT) &&
+                    buffer.indexType != uint32_t(IndexBuffer::IndexType::UINT)) ||
+                buffer.indexCount == 0 || buffer.size != buffer.indexCount * indexSize(buffer.indexType) ||
+                !inFile(buffer.offset, buffer.size)) {
+            return fail("bad index buffer");
+        }
+    }
+    for (uint32_t i = 0; i < primitiveCount; i++) {
+        const PrimitiveRecord& primitive = primitives[i];
+        if (primitive.vertexBuffer >= vertexBufferCount || primitive.indexBuffer >= indexBufferCount ||
+                primitive.instance >= instanceCount ||
+                primitive.offset > indexBuffers[primitive.indexBuffer].indexCount ||
+                primitive.count > indexBuffers[primitive.indexBuffer].indexCount - primitive.offset ||
+                primitive.minIndex > primitive.maxIndex ||
+                primitive.maxIndex >= vertexBuffers[primitive.vertexBuffer].vertexCount) {
+            return fail("bad primitive");
+        }
+    }
+    for (uint32_t i = 0; i < renderableCount; i++) {
+        const RenderableRecord& renderable = renderables[i];
+        if (renderable.primitiveCount == 0 || renderable.firstPrimitive > primitiveCount ||
+                renderable.primitiveCount > primitiveCount - renderable.firstPrimitive) {
+            return fail("bad renderable");
+        }
+    }
+    for (uint32_t i = 0; i < lightCount; i++) {
+        if (lights[i].type > uint32_t(LightManager::Type::SPOT)) {
+            return fail("bad light");
+        }
+    }
+    return true;
+}
+
+bool SceneSnapshot::instantiate(SceneContext& ctx) {
+    TRACE_NAME("SceneSnapshot::instantiate");
+    if (!mMapping) {
+        std::cerr << "Scene snapshot is not open" << std::endl;
+        return false;
+    }
+    Engine& engine = *ctx.engine;
+    const auto& header = *static_cast<const SnapshotHeader*>(mMapping->address);
+    const char* strings = records<char>(STRINGS);
+    mStats = {};
+
+    uint32_t count;
+    const auto* materials = records<MaterialRecord>(MATERIALS, &count);
+    for (uint32_t i = 0; i < count; i++) {
+        const char* name = strings + materials[i].package.offset;
+        const ResourcePackage* package = findMaterialPackage(name);
+        if (!package) {
+            std::cerr << "Material package not found: " << name << std::endl;
+            return false;
+        }
+        Material* material = buildMaterial(ctx, package->acquire(), package->name);
+        if (!material) {
+            return false;
+        }
+        mMaterials.push_back(material);
+    }
+
+    {
+        TRACE_NAME("SceneSnapshot::textures");
+        const auto* textures = records<TextureRecord>(TEXTURES, &count);
+        for (uint32_t i = 0; i < count; i++) {
+            const TextureRecord& record = textures[i];
+            const bool srgb = record.flags & TEXTURE_SRGB;
+            const bool mipmaps = record.flags & TEXTURE_MIPMAPS;
+            Texture* texture = Texture::Builder()
+                .width(record.width)
+                .height(record.height)
+                .levels(mipmaps ? 0xff : 1)
+                .format(srgb ? Texture::InternalFormat::SRGB8_A8 : Texture::InternalFormat::RGBA8)
+                .build(engine);
+            mMapping->acquire();
+            texture->setImage(engine, 0, Texture::PixelBufferDescriptor(data(record.offset),
+                    size_t(record.size), Texture::Format::RGBA, Texture::Type::UBYTE,
+                    &Mapping::release, mMapping));
+            if (mipmaps) {
+                texture->generateMipmaps(engine);
+            }
+            mTextures.push_back(texture);
+            mStats.textures++;
+            mStats.uploads++;
+            mStats.uploadBytes += record.size;
+            if (ctx.memory) {
+                ctx.memory->addTexture("snapshot", texture);
+            }
+        }
+    }
+
+    const auto* parameters = records<ParameterRecord>(PARAMETERS);
+    const auto* instances = records<InstanceRecord>(INSTANCES, &count);
+    for (uint32_t i = 0; i < count; i++) {
+        const InstanceRecord& record = instances[i];
+        Material* material = mMaterials[record.material];
+        MaterialInstance* instance = record.useDefault ? material->getDefaultInstance()
+                                                       : material->createInstance();
+        mInstances.push_back(instance);
+        for (uint32_t p = 0; p < record.parameterCount; p++) {
+            const ParameterRecord& parameter = parameters[record.firstParameter + p];
+            const char* name = strings + parameter.name.offset;
+            const float* v = parameter.value;
+            switch (parameter.type) {
+                case PARAMETER_FLOAT:  instance->setParameter(name, v[0]); break;
+                case PARAMETER_FLOAT2: instance->setParameter(name, float2{ v[0], v[1] }); break;
+                case PARAMETER_FLOAT3: instance->setParameter(name, float3{ v[0], v[1], v[2] }); break;
+                case PARAMETER_FLOAT4: instance->setParameter(name, float4{ v[0], v[1], v[2], v[3] }); break;
+                case PARAMETER_INT:    instance->setParameter(name, parameter.integer); break;
+                case PARAMETER_BOOL:   instance->setParameter(name, parameter.integer != 0); break;
+                case PARAMETER_TEXTURE: {
+                    backend::SamplerParams sampler;
+                    std::memcpy(&sampler, &parameter.sampler, sizeof(sampler));
+                    instance->setParameter(name, mTextures[parameter.texture], TextureSampler(sampler));
+                    break;
+                }
+            }
+        }
+    }
+
+    {
+        TRACE_NAME("SceneSnapshot::buffers");
+        const auto* attributes = records<AttributeRecord>(ATTRIBUTES);
+        const auto* vertexBuffers = records<VertexBufferRecord>(VERTEX_BUFFERS, &count);
+        for (uint32_t i = 0; i < count; i++) {
+            const VertexBufferRecord& record = vertexBuffers[i];
+            VertexBuffer::Builder builder;
+            builder.vertexCount(record.vertexCount).bufferCount(1);
+            for (uint32_t a = 0; a < record.attributeCount; a++) {
+                const AttributeRecord& attribute = attributes[record.firstAttribute + a];
+                const auto type = VertexAttribute(attribute.attribute);
+                builder.attribute(type, 0, VertexBuffer::AttributeType(attribute.type),
+                        attribute.offset, uint8_t(record.stride));
+                if (attribute.normalized) {
+                    builder.normalized(type);
+                }
+            }
+            VertexBuffer* buffer = builder.build(engine);
+            mMapping->acquire();
+            buffer->setBufferAt(engine, 0, VertexBuffer::BufferDescriptor(data(record.offset),
+                    size_t(record.size), &Mapping::release, mMapping));
+            mVertexBuffers.push_back(buffer);
+            mStats.vertexBuffers++;
+            mStats.uploads++;
+            mStats.uploadBytes += record.size;
+            if (ctx.memory) {
+                ctx.memory->addVertexBuffer("snapshot", buffer, record.size);
+            }
+        }
+
+        const auto* indexBuffers = records<IndexBufferRecord>(INDEX_BUFFERS, &count);
+        for (uint32_t i = 0; i < count; i++) {
+            const IndexBufferRecord& record = indexBuffers[i];
+            const auto type = IndexBuffer::IndexType(record.indexType);
+            IndexBuffer* buffer = IndexBuffer::Builder()
+                .indexCount(record.indexCount)
+                .bufferType(type)
+                .build(engine);
+            mMapping->acquire();
+            buffer->setBuffer(engine, IndexBuffer::BufferDescriptor(data(record.offset),
+                    size_t(record.size), &Mapping::release, mMapping));
+            mIndexBuffers.push_back(buffer);
+            mStats.indexBuffers++;
+            mStats.uploads++;
+            mStats.uploadBytes += record.size;
+            if (ctx.memory) {
+                ctx.memory->addIndexBuffer("snapshot", buffer, type);
+            }
+        }
+    }
+
+    auto& entityManager = utils::EntityManager::get();
+    auto& tcm = engine.getTransformManager();
+    const auto* primitives = records<PrimitiveRecord>(PRIMITIVES);
+    const auto* renderables = records<RenderableRecord>(RENDERABLES, &count);
+    for (uint32_t i = 0; i < count; i++) {
+        const RenderableRecord& record = renderables[i];
+        const utils::Entity entity = entityManager.create();
+        RenderableManager::Builder builder(record.primitiveCount);
+        builder.boundingBox({ float3{ record.center[0], record.center[1], record.center[2] },
+                        float3{ record.halfExtent[0], record.halfExtent[1], record.halfExtent[2] } })
+               .castShadows(record.flags & CAST_SHADOWS)
+               .receiveShadows(record.flags & RECEIVE_SHADOWS)
+               .geometryType(RenderableManager::Builder::GeometryType::STATIC);
+        for (uint32_t p = 0; p < record.primitiveCount; p++) {
+            const PrimitiveRecord& primitive = primitives[record.firstPrimitive + p];
+            builder.geometry(p, RenderableManager::PrimitiveType::TRIANGLES,
+                    mVertexBuffers[primitive.vertexBuffer], mIndexBuffers[primitive.indexBuffer],
+                    primitive.offset, primitive.minIndex, primitive.maxIndex, primitive.count);
+            builder.material(p, mInstances[primitive.instance]);
+        }
+        builder.build(engine, entity);
+        tcm.create(entity, {}, loadMatrix(record.transform));
+        ctx.scene->addEntity(entity);
+        mEntities.push_back(entity);
+        mStats.renderables++;
+    }
+
+    const auto* lights = records<LightRecord>(LIGHTS, &count);
+    for (uint32_t i = 0; i < count; i++) {
+        const LightRecord& record = lights[i];
+        const utils::Entity entity = entityManager.create();
+        LightManager::Builder(LightManager::Type(record.type))
+            .color({ record.color[0], record.color[1], record.color[2] })
+            .intensity(record.intensity)
+            .direction({ record.direction[0], record.direction[1], record.direction[2] })
+            .position({ record.position[0], record.position[1], record.position[2] })
+            .falloff(record.falloff)
+            .sunAngularRadius(record.sunAngularRadius)
+            .castShadows(record.castShadows != 0)
+            .build(engine, entity);
+        ctx.scene->addEntity(entity);
+        mEntities.push_back(entity);
+    }
+
+    if (header.flags & HAS_SKYBOX) {
+        mSkybox = Skybox::Builder()
+            .color({ header.skybox[0], header.skybox[1], header.skybox[2], header.skybox[3] })
+            .build(engine);
+        ctx.scene->setSkybox(mSkybox);
+    }
+    if (header.flags & HAS_CAMERA) {
+        ctx.camera->setProjection(header.cameraFov, double(ctx.width) / double(ctx.height),
+                header.cameraNear, header.cameraFar);
+        ctx.camera->setModelMatrix(loadMatrix(header.cameraModel));
+    }
+    return true;
+}
+
+void SceneSnapshot::destroy(SceneContext& ctx) {
+    Engine& engine = *ctx.engine;
+    auto& entityManager = utils::EntityManager::get();
+    for (const utils::Entity entity : mEntities) {
+        ctx.scene->remove(entity);
+        engine.destroy(entity);
+        entityManager.destroy(entity);
+    }
+    mEntities.clear();
+    for (MaterialInstance* instance : mInstances) {
+        if (instance != instance->getMaterial()->getDefaultInstance()) {
+            engine.destroy(instance);
+        }
+    }
+    mInstances.clear();
+    for (Material* material : mMaterials) {
+        if (ctx.memory) {
+            ctx.memory->remove(material);
+        }
+        engine.destroy(material);
+    }
+    mMaterials.clear();
+    for (VertexBuffer* buffer : mVertexBuffers) {
+        if (ctx.memory) {
+            ctx.memory->remove(buffer);
+        }
+        engine.destroy(buffer);
+    }
+    mVertexBuffers.clear();
+    for (IndexBuffer* buffer : mIndexBuffers) {
+        if (ctx.memory) {
+            ctx.memory->remove(buffer);
+        }
+        engine.destroy(buffer);
+    }
+    mIndexBuffers.clear();
+    for (Texture* texture : mTextures) {
+        if (ctx.memory) {
+            ctx.memory->remove(texture);
+        }
+        engine.destroy(texture);
+    }
+    mTextures.clear();
+    if (mSkybox) {
+        ctx.scene->setSkybox(nullptr);
+        engine.destroy(mSkybox);
+        mSkybox = nullptr;
+    }
+}
+
+// ========================================
+// 快照写入
+// ========================================
+
+uint32_t SceneSnapshotWriter::addMaterial(const std::string& package) {
+    mMaterials.push_back(package);
+    return uint32_t(mMaterials.size() - 1);
+}
+
+uint32_t SceneSnapshotWriter::addTexture(const uint8_t* pixels, uint32_t width, uint32_t height,
+        bool srgb, bool mipmaps) {
+    TextureData texture;
+    texture.pixels.assign(pixels, pixels + size_t(width) * height * 4);
+    texture.width = width;
+    texture.height = height;
+    texture.srgb = srgb;
+    texture.mipmaps = mipmaps;
+    mTextures.push_back(std::move(texture));
+    return uint32_t(mTextures.size() - 1);
+}
+
+uint32_t SceneSnapshotWriter::addMaterialInstance(uint32_t material, bool useDefault) {
+    mInstances.push_back({ material, useDefault });
+    return uint32_t(mInstances.size() - 1);
+}
+
+void SceneSnapshotWriter::addParameter(Parameter parameter) {
+    mParameters.push_back(std::move(parameter));
+}
+
+void SceneSnapshotWriter::setParameter(uint32_t instance, const std::string& name, float value) {
+    addParameter({ instance, name, PARAMETER_FLOAT, float4{ value, 0, 0, 0 }, 0, 0, {} });
+}
+
+void SceneSnapshotWriter::setParameter(uint32_t instance, const std::string& name, float2 value) {
+    addParameter({ instance, name, PARAMETER_FLOAT2, float4{ value, 0, 0 }, 0, 0, {} });
+}
+
+void SceneSnapshotWriter::setParameter(uint32_t instance, const std::string& name, float3 value) {
+    addParameter({ instance, name, PARAMETER_FLOAT3, float4{ value, 0 }, 0, 0, {} });
+}
+
+void SceneSnapshotWriter::setParameter(uint32_t instance, const std::string& name, float4 value) {
+    addParameter({ instance, name, PARAMETER_FLOAT4, value, 0, 0, {} });
+}
+
+void SceneSnapshotWriter::setParameter(uint32_t instance, const std::string& name, int32_t value) {
+    addParameter({ instance, name, PARAMETER_INT, float4{ 0 }, value, 0, {} });
+}
+
+void SceneSnapshotWriter::setParameter(uint32_t instance, const std::string& name, bool value) {
+    addParameter({ instance, name, PARAMETER_BOOL, float4{ 0 }, value ? 1 : 0, 0, {} });
+}
+
+void SceneSnapshotWriter::setParameter(uint32_t instance, const std::string& name, uint32_t texture,
+        const TextureSampler& sampler) {
+    addParameter({ instance, name, PARAMETER_TEXTURE, float4{ 0 }, 0, texture, sampler });
+}
+
+uint32_t SceneSnapshotWriter::addMesh(const std::vector<SnapshotAttribute>& layout, uint32_t stride,
+        const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount) {
+    // 找布局完全相同的顶点缓冲区合并，找不到时新建
+    auto sameLayout = [&layout, stride](const VertexData& buffer) {
+        return buffer.stride == stride && buffer.layout.size() == layout.size() &&
+               std::equal(layout.begin(), layout.end(), buffer.layout.begin(),
+                       [](const SnapshotAttribute& a, const SnapshotAttribute& b) {
+                           return a.attribute == b.attribute && a.type == b.type &&
+                                  a.offset == b.offset && a.normalized == b.normalized;
+                       });
+    };
+    auto it = std::find_if(mVertexBuffers.begin(), mVertexBuffers.end(), sameLayout);
+    if (it == mVertexBuffers.end()) {
+        it = mVertexBuffers.insert(mVertexBuffers.end(), VertexData{ layout, stride, 0, {}, {} });
+    }
+    VertexData& buffer = *it;
+
+    Mesh mesh;
+    mesh.vertexBuffer = uint32_t(it - mVertexBuffers.begin());
+    mesh.firstIndex = uint32_t(buffer.indices.size());
+    mesh.indexCount = indexCount;
+    mesh.firstVertex = buffer.vertexCount;
+    mesh.vertexCount = vertexCount;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(vertices);
+    buffer.vertices.insert(buffer.vertices.end(), bytes, bytes + size_t(vertexCount) * stride);
+    buffer.indices.reserve(buffer.indices.size() + indexCount);
+    for (uint32_t i = 0; i < indexCount; i++) {
+        buffer.indices.push_back(mesh.firstVertex + indices[i]);
+    }
+    buffer.vertexCount += vertexCount;
+
+    mMeshes.push_back(mesh);
+    return uint32_t(mMeshes.size() - 1);
+}
+
+bool SceneSnapshotWriter::addFilamesh(const void* data, size_t size,
+        std::vector<Primitive>& primitives, Box& bounds) {
+    FilameshLayout filamesh;
+    const char* error = readFilameshLayout(data, size, filamesh);
+    const FilameshHeader& header = filamesh.header;
+    // 压缩的 filamesh（meshoptimizer 编码）要先解码，这里只接受 ObjImporter/filamesh 工具的未压缩输出
+    if (!error) {
+        error = checkInterleavedFilamesh(header);
+    }
+    if (error) {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const size_t elementSize = filameshIndexElementSize(header);
+    const size_t partsOffset = filamesh.partsOffset;
+    const uint32_t stride = header.stridePosition;
+
+    using Type = VertexBuffer::AttributeType;
+    const Type uvType = (header.flags & FILAMESH_TEXCOORD_SNORM16) ? Type::SHORT2 : Type::HALF2;
+    const bool uvNormalized = header.flags & FILAMESH_TEXCOORD_SNORM16;
+    std::vector<SnapshotAttribute> layout = {
+        { VertexAttribute::POSITION, Type::HALF4, header.offsetPosition, false },
+        { VertexAttribute::TANGENTS, Type::SHORT4, header.offsetTangents, true },
+    };
+    if (header.offsetColor != FILAMESH_NO_ATTRIBUTE) {
+        layout.push_back({ VertexAttribute::COLOR, Type::UBYTE4, header.offsetColor, true });
+    }
+    if (header.offsetUV0 != FILAMESH_NO_ATTRIBUTE) {
+        layout.push_back({ VertexAttribute::UV0, uvType, header.offsetUV0, uvNormalized });
+    }
+    if (header.offsetUV1 != FILAMESH_NO_ATTRIBUTE) {
+        layout.push_back({ VertexAttribute::UV1, uvType, header.offsetUV1, uvNormalized });
+    }
+
+    const uint8_t* indexData = bytes + filamesh.indicesOffset;
+    std::vector<uint32_t> indices(header.indexCount);
+    for (uint32_t i = 0; i < header.indexCount; i++) {
+        if (elementSize == sizeof(uint16_t)) {
+            uint16_t index;
+            std::memcpy(&index, indexData + i * sizeof(index), sizeof(index));
+            indices[i] = index;
+        } else {
+            std::memcpy(&indices[i], indexData + i * sizeof(uint32_t), sizeof(uint32_t));
+        }
+        if (indices[i] >= header.vertexCount) {
+            std::cerr << "Filamesh index out of range" << std::endl;
+            return false;
+        }
+    }
+
+    const uint32_t mesh = addMesh(layout, stride, bytes + sizeof(header), header.vertexCount,
+            indices.data(), header.indexCount);
+    for (uint32_t i = 0; i < header.parts; i++) {
+        FilameshPart part;
+        std::memcpy(&part, bytes + partsOffset + i * sizeof(part), sizeof(part));
+        if (part.offset > header.indexCount || part.indexCount > header.indexCount - part.offset) {
+            std::cerr << "Filamesh part out of range" << std::endl;
+            return false;
+        }
+        primitives.push_back({ mesh, part.offset, part.indexCount, ~0u });
+    }
+    bounds.center = float3{ header.aabb[0], header.aabb[1], header.aabb[2] };
+    bounds.halfExtent = float3{ header.aabb[3], header.aabb[4], header.aabb[5] };
+    return true;
+}
+
+uint32_t SceneSnapshotWriter::addRenderable(const mat4f& transform, const Box& bounds,
+        const std::vector<Primitive>& primitives, bool castShadows, bool receiveShadows) {
+    mRenderables.push_back({ transform, bounds, primitives, castShadows, receiveShadows });
+    return uint32_t(mRenderables.size() - 1);
+}
+
+void SceneSnapshotWriter::addLight(const SnapshotLight& light) {
+    mLights.push_back(light);
+}
+
+void SceneSnapshotWriter::setCamera(float fovDegrees, float near, float far, const mat4f& model) {
+    mHasCamera = true;
+    mFov = fovDegrees;
+    mNear = near;
+    mFar = far;
+    mCameraModel = model;
+}
+
+void SceneSnapshotWriter::setSkybox(float4 color) {
+    mHasSkybox = true;
+    mSkyboxColor = color;
+}
+
+bool SceneSnapshotWriter::write(const std::string& path) const {
+    TRACE_NAME("SceneSnapshotWriter::write");
+    std::string strings;
+    auto addString = [&strings](const std::string& value) {
+        const StringRef ref{ uint32_t(strings.size()), uint32_t(value.size()) };
+        strings.append(value).push_back('\0');
+        return ref;
+    };
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.flags = (mHasCamera ? HAS_CAMERA : 0) | (mHasSkybox ? HAS_SKYBOX : 0);
+    storeMatrix(header.cameraModel, mCameraModel);
+    header.cameraFov = mFov;
+    header.cameraNear = mNear;
+    header.cameraFar = mFar;
+    for (size_t i = 0; i < 4; i++) {
+        header.skybox[i] = mSkyboxColor[i];
+    }
+
+    std::vector<MaterialRecord> materials;
+    for (const std::string& package : mMaterials) {
+        materials.push_back({ addString(package) });
+    }
+
+    // 参数按材质实例分组，同一实例内保持设置顺序
+    std::vector<const Parameter*> sorted;
+    for (const Parameter& parameter : mParameters) {
+        if (parameter.instance >= mInstances.size() ||
+                (parameter.type == PARAMETER_TEXTURE && parameter.texture >= mTextures.size())) {
+            std::cerr << "Snapshot parameter refers to a missing object: " << parameter.name << std::endl;
+            return false;
+        }
+        sorted.push_back(&parameter);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Parameter* a, const Parameter* b) {
+        return a->instance < b->instance;
+    });
+    std::vector<ParameterRecord> parameters;
+    std::vector<InstanceRecord> instances(mInstances.size());
+    for (size_t i = 0; i < mInstances.size(); i++) {
+        if (mInstances[i].material >= mMaterials.size()) {
+            std::cerr << "Snapshot material instance refers to a missing material" << std::endl;
+            return false;
+        }
+        instances[i] = { mInstances[i].material, mInstances[i].useDefault ? 1u : 0u,
+                         uint32_t(parameters.size()), 0 };
+        for (const Parameter* parameter : sorted) {
+            if (parameter->instance != i) {
+                continue;
+            }
+            ParameterRecord record{};
+            record.name = addString(parameter->name);
+            record.type = parameter->type;
+            record.texture = parameter->texture;
+            for (size_t c = 0; c < 4; c++) {
+                record.value[c] = parameter->value[c];
+            }
+            record.integer = parameter->integer;
+            const backend::SamplerParams sampler = parameter->sampler.getSamplerParams();
+            std::memcpy(&record.sampler, &sampler, sizeof(record.sampler));
+            parameters.push_back(record);
+            instances[i].parameterCount++;
+        }
+    }
+
+    // 每个顶点缓冲区配一个索引缓冲区，编号相同
+    std::vector<AttributeRecord> attributes;
+    std::vector<VertexBufferRecord> vertexBuffers;
+    std::vector<IndexBufferRecord> indexBuffers;
+    for (const VertexData& buffer : mVertexBuffers) {
+        vertexBuffers.push_back({ buffer.vertexCount, buffer.stride, uint32_t(attributes.size()),
+                uint32_t(buffer.layout.size()), 0, buffer.vertices.size() });
+        for (const SnapshotAttribute& attribute : buffer.layout) {
+            attributes.push_back({ uint8_t(attribute.attribute), uint8_t(attribute.type),
+                    uint8_t(attribute.normalized), 0, attribute.offset });
+        }
+        const auto type = buffer.vertexCount <= 65536 ? IndexBuffer::IndexType::USHORT
+                                                      : IndexBuffer::IndexType::UINT;
+        indexBuffers.push_back({ uint32_t(buffer.indices.size()), uint32_t(type), 0,
+                buffer.indices.size() * indexSize(uint32_t(type)) });
+    }
+
+    std::vector<RenderableRecord> renderables;
+    std::vector<PrimitiveRecord> primitives;
+    for (const Renderable& renderable : mRenderables) {
+        RenderableRecord record{};
+        storeMatrix(record.transform, renderable.transform);
+        for (size_t c = 0; c < 3; c++) {
+            record.center[c] = renderable.bounds.center[c];
+            record.halfExtent[c] = renderable.bounds.halfExtent[c];
+        }
+        record.firstPrimitive = uint32_t(primitives.size());
+        record.primitiveCount = uint32_t(renderable.primitives.size());
+        record.flags = (renderable.castShadows ? CAST_SHADOWS : 0) |
+                       (renderable.receiveShadows ? RECEIVE_SHADOWS : 0);
+        for (const Primitive& primitive : renderable.primitives) {
+            if (primitive.mesh >= mMeshes.size() || primitive.instance >= mInstances.size()) {
+                std::cerr << "Snapshot primitive refers to a missing mesh or material instance" << std::endl;
+                return false;
+            }
+            const Mesh& mesh = mMeshes[primitive.mesh];
+            const uint32_t count = primitive.count ? primitive.count : mesh.indexCount - primitive.offset;
+            if (primitive.offset > mesh.indexCount || count > mesh.indexCount - primitive.offset) {
+                std::cerr << "Snapshot primitive is out of the mesh's index range" << std::endl;
+                return false;
+            }
+            // Filament 用 min/max 索引限定顶点范围，按实际引用的索引计算
+            const auto& indices = mVertexBuffers[mesh.vertexBuffer].indices;
+            const auto first = indices.begin() + mesh.firstIndex + primitive.offset;
+            const auto range = std::minmax_element(first, first + count);
+            primitives.push_back({ mesh.vertexBuffer, mesh.vertexBuffer, mesh.firstIndex + primitive.offset,
+                    count, count ? *range.first : 0, count ? *range.second : 0, primitive.instance, 0 });
+        }
+        renderables.push_back(record);
+    }
+
+    std::vector<LightRecord> lights;
+    for (const SnapshotLight& light : mLights) {
+        LightRecord record{};
+        record.type = uint32_t(light.type);
+        for (size_t c = 0; c < 3; c++) {
+            record.color[c] = light.color[c];
+            record.direction[c] = light.direction[c];
+            record.position[c] = light.position[c];
+        }
+        record.intensity = light.intensity;
+        record.falloff = light.falloff;
+        record.sunAngularRadius = light.sunAngularRadius;
+        record.castShadows = light.castShadows ? 1 : 0;
+        lights.push_back(record);
+    }
+
+    // 先写数据再写记录表，记录中的数据偏移在这里补上
+    std::vector<uint8_t> file(sizeof(header), 0);
+    for (size_t i = 0; i < mVertexBuffers.size(); i++) {
+        const VertexData& buffer = mVertexBuffers[i];
+        vertexBuffers[i].offset = appendAligned(file, buffer.vertices.data(), buffer.vertices.size());
+        if (indexBuffers[i].indexType == uint32_t(IndexBuffer::IndexType::USHORT)) {
+            std::vector<uint16_t> shortIndices(buffer.indices.begin(), buffer.indices.end());
+            indexBuffers[i].offset = appendAligned(file, shortIndices.data(),
+                    shortIndices.size() * sizeof(uint16_t));
+        } else {
+            indexBuffers[i].offset = appendAligned(file, buffer.indices.data(),
+                    buffer.indices.size() * sizeof(uint32_t));
+        }
+    }
+    std::vector<TextureRecord> textures;
+    for (const TextureData& texture : mTextures) {
+        const uint32_t flags = (texture.srgb ? TEXTURE_SRGB : 0) | (texture.mipmaps ? TEXTURE_MIPMAPS : 0);
+        textures.push_back({ texture.width, texture.height, flags, 0,
+                appendAligned(file, texture.pixels.data(), texture.pixels.size()), texture.pixels.size() });
+    }
+
+    header.sections[STRINGS] = { appendAligned(file, strings.data(), strings.size()), strings.size() };
+    header.sections[MATERIALS] = appendSection(file, materials);
+    header.sections[TEXTURES] = appendSection(file, textures);
+    header.sections[INSTANCES] = appendSection(file, instances);
+    header.sections[PARAMETERS] = appendSection(file, parameters);
+    header.sections[VERTEX_BUFFERS] = appendSection(file, vertexBuffers);
+    header.sections[ATTRIBUTES] = appendSection(file, attributes);
+    header.sections[INDEX_BUFFERS] = appendSection(file, indexBuffers);
+    header.sections[RENDERABLES] = appendSection(file, renderables);
+    header.sections[PRIMITIVES] = appendSection(file, primitives);
+    header.sections[LIGHTS] = appendSection(file, lights);
+    file.resize(alignUp(file.size()), 0);
+    header.fileSize = file.size();
+    std::memcpy(file.data(), &header, sizeof(header));
+
+    // 先写临时文件再改名，中途退出不会留下不完整的快照
+    const std::string temporary = path + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(file.data()), std::streamsize(file.size()));
+        if (!out) {
+            std::cerr << "Failed to write scene snapshot: " << temporary << std::endl;
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to rename scene snapshot: " << path << " (" << std::strerror(errno) << ")"
+                  << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace demo
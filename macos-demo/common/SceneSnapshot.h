@@ -0,0 +1,245 @@
+#ifndef DEMO_COMMON_SCENESNAPSHOT_H
+#define DEMO_COMMON_SCENESNAPSHOT_H
+
+#include <filament/Box.h>
+#include <filament/LightManager.h>
+#include <filament/TextureSampler.h>
+#include <filament/VertexBuffer.h>
+
+#include <math/mat4.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <utils/Entity.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace filament {
+class IndexBuffer;
+class Material;
+class MaterialInstance;
+class Skybox;
+class Texture;
+}
+
+namespace demo {
+
+struct SceneContext;
+
+// ========================================
+// 场景快照（预先准备好的二进制场景）
+// ========================================
+// 场景的 setup() 每次启动都要解析 filamesh、解码贴图、逐个设置材质参数。
+// demo-snapshot 把一个场景准备好之后的全部状态烘焙成一个文件：
+//
+//   文件头（段表、相机、天空盒） | 各个记录表 | 字符串 | 顶点/索引/像素数据（每段按 64 字节对齐）
+//
+// 记录表包括材质（材质包名，运行时从 ResourcePackages 构建）、纹理、材质实例和参数、
+// 顶点缓冲区（单个交错缓冲区）、索引缓冲区、可渲染实体及其图元和光源。
+// 顶点和索引已经是最终的 GPU 布局：布局相同的网格合并进同一个 VertexBuffer，
+// 索引按合并后的位置重新编号，顶点数不超过 65536 时使用 16 位索引。
+//
+// SceneSnapshot 只 mmap 一次、校验段表和偏移，之后直接按记录创建 Filament 对象，不做任何解析：
+// 每个顶点缓冲区、索引缓冲区和纹理只有一次 BufferDescriptor 上传，数据直接引用映射内存。
+// 映射由正在进行的上传共同持有，SceneSnapshot 先于 Engine 销毁也没有问题。
+//
+// 快照只记录静态状态，setup() 中的动画（例如 04-pbr 的自转）不在快照里。
+
+// 烘焙时的一个顶点属性，offset 是交错顶点内的字节偏移
+struct SnapshotAttribute {
+    filament::VertexAttribute attribute;
+    filament::VertexBuffer::AttributeType type;
+    uint32_t offset;
+    bool normalized;
+};
+
+// 一个光源，参数与 LightManager::Builder 一致，color 为线性颜色
+struct SnapshotLight {
+    filament::LightManager::Type type = filament::LightManager::Type::DIRECTIONAL;
+    filament::math::float3 color{ 1.0f };
+    float intensity = 100000.0f;
+    filament::math::float3 direction{ 0.0f, -1.0f, 0.0f };
+    filament::math::float3 position{ 0.0f };
+    float falloff = 1.0f;
+    float sunAngularRadius = 0.545f;
+    bool castShadows = false;
+};
+
+struct SnapshotStats {
+    uint32_t vertexBuffers = 0;
+    uint32_t indexBuffers = 0;
+    uint32_t textures = 0;
+    uint32_t renderables = 0;
+    uint32_t uploads = 0;           // setBufferAt()/setBuffer()/setImage() 的调用次数
+    uint64_t uploadBytes = 0;
+};
+
+// ========================================
+// 快照加载
+// ========================================
+class SceneSnapshot {
+public:
+    SceneSnapshot() = default;
+    ~SceneSnapshot();
+
+    SceneSnapshot(const SceneSnapshot&) = delete;
+    SceneSnapshot& operator=(const SceneSnapshot&) = delete;
+
+    // 映射快照文件并校验文件头、段表和所有偏移，失败时打印原因并返回 false
+    bool open(const std::string& path);
+    // 解除映射，正在上传的数据在上传完成后才真正释放
+    void close();
+
+    bool isOpen() const noexcept { return mMapping != nullptr; }
+    size_t getFileSize() const noexcept;
+
+    // 在 ctx.scene 中创建快照记录的所有对象并设置相机。失败时返回 false，已经创建的对象由 destroy() 清理
+    bool instantiate(SceneContext& ctx);
+    // 销毁 instantiate() 创建的对象
+    void destroy(SceneContext& ctx);
+
+    const SnapshotStats& getStats() const noexcept { return mStats; }
+
+private:
+    struct Mapping;
+
+    template<typename T>
+    const T* records(uint32_t section, uint32_t* count = nullptr) const noexcept;
+    const uint8_t* data(uint64_t offset) const noexcept;
+    bool validate(const std::string& path) const;
+
+    Mapping* mMapping = nullptr;
+    SnapshotStats mStats;
+
+    std::vector<filament::Material*> mMaterials;
+    std::vector<filament::Texture*> mTextures;
+    std::vector<filament::MaterialInstance*> mInstances;
+    std::vector<filament::VertexBuffer*> mVertexBuffers;
+    std::vector<filament::IndexBuffer*> mIndexBuffers;
+    std::vector<utils::Entity> mEntities;   // 可渲染实体和光源
+    filament::Skybox* mSkybox = nullptr;
+};
+
+// ========================================
+// 快照写入（离线烘焙）
+// ========================================
+// add*() 返回新记录的编号，供后续记录引用
+class SceneSnapshotWriter {
+public:
+    // 材质来自 ResourcePackages 中的材质包，例如 "texturedlit"
+    uint32_t addMaterial(const std::string& package);
+
+    // RGBA8 像素（拷贝），mipmaps 为 true 时加载后在 GPU 上生成 mip 链
+    uint32_t addTexture(const uint8_t* pixels, uint32_t width, uint32_t height, bool srgb, bool mipmaps);
+
+    // useDefault 为 true 时使用材质的默认实例，否则加载时创建新实例
+    uint32_t addMaterialInstance(uint32_t material, bool useDefault = false);
+
+    void setParameter(uint32_t instance, const std::string& name, float value);
+    void setParameter(uint32_t instance, const std::string& name, filament::math::float2 value);
+    void setParameter(uint32_t instance, const std::string& name, filament::math::float3 value);
+    void setParameter(uint32_t instance, const std::string& name, filament::math::float4 value);
+    void setParameter(uint32_t instance, const std::string& name, int32_t value);
+    void setParameter(uint32_t instance, const std::string& name, bool value);
+    void setParameter(uint32_t instance, const std::string& name, uint32_t texture,
+            const filament::TextureSampler& sampler);
+
+    // 交错顶点（vertexCount * stride 字节）和三角形索引，布局相同的网格合并进同一个顶点缓冲区。
+    // 返回网格编号，索引是网格内的顶点编号
+    uint32_t addMesh(const std::vector<SnapshotAttribute>& layout, uint32_t stride,
+            const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+
+    // 网格中的一段索引（offset、count 以索引个数计），使用 instance 绘制
+    struct Primitive {
+        uint32_t mesh;
+        uint32_t offset;
+        uint32_t count;
+        uint32_t instance;
+    };
+
+    // 读取未压缩的交错 filamesh（例如 ObjImporter 的缓存），每个 part 成为一个图元，
+    // instance 都设为 ~0u 由调用者填写。失败时打印原因并返回 false
+    bool addFilamesh(const void* data, size_t size, std::vector<Primitive>& primitives,
+            filament::Box& bounds);
+
+    uint32_t addRenderable(const filament::math::mat4f& transform, const filament::Box& bounds,
+            const std::vector<Primitive>& primitives, bool castShadows, bool receiveShadows);
+
+    void addLight(const SnapshotLight& light);
+
+    // 透视相机：垂直视野（度）、近远平面和相机的模型矩阵，宽高比在加载时按 SceneContext 计算
+    void setCamera(float fovDegrees, float near, float far, const filament::math::mat4f& model);
+    void setSkybox(filament::math::float4 color);
+
+    // 写出快照，失败时打印原因并返回 false
+    bool write(const std::string& path) const;
+
+private:
+    struct Parameter {
+        uint32_t instance;
+        std::string name;
+        uint32_t type;
+        filament::math::float4 value;
+        int32_t integer;
+        uint32_t texture;
+        filament::TextureSampler sampler;
+    };
+    struct TextureData {
+        std::vector<uint8_t> pixels;
+        uint32_t width;
+        uint32_t height;
+        bool srgb;
+        bool mipmaps;
+    };
+    struct Instance {
+        uint32_t material;
+        bool useDefault;
+    };
+    struct VertexData {
+        std::vector<SnapshotAttribute> layout;
+        uint32_t stride;
+        uint32_t vertexCount = 0;
+        std::vector<uint8_t> vertices;
+        std::vector<uint32_t> indices;  // 已经按合并后的顶点编号重新编号
+    };
+    struct Mesh {
+        uint32_t vertexBuffer;
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        uint32_t firstVertex;
+        uint32_t vertexCount;
+    };
+    struct Renderable {
+        filament::math::mat4f transform;
+        filament::Box bounds;
+        std::vector<Primitive> primitives;
+        bool castShadows;
+        bool receiveShadows;
+    };
+
+    void addParameter(Parameter parameter);
+
+    std::vector<std::string> mMaterials;
+    std::vector<TextureData> mTextures;
+    std::vector<Instance> mInstances;
+    std::vector<Parameter> mParameters;
+    std::vector<VertexData> mVertexBuffers;
+    std::vector<Mesh> mMeshes;
+    std::vector<Renderable> mRenderables;
+    std::vector<SnapshotLight> mLights;
+    bool mHasCamera = false;
+    float mFov = 45.0f;
+    float mNear = 0.1f;
+    float mFar = 100.0f;
+    filament::math::mat4f mCameraModel;
+    bool mHasSkybox = false;
+    filament::math::float4 mSkyboxColor;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_SCENESNAPSHOT_H
@@ -0,0 +1,101 @@
+#include "StartupProfiler.h"
+#include "JsonWriter.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace demo {
+
+StartupProfiler::StartupProfiler() : mOrigin(Clock::now()) {
+}
+
+size_t StartupProfiler::begin(std::string name, std::string group, uint64_t bytes) {
+    Step step;
+    step.name = std::move(name);
+    step.group = std::move(group);
+    step.bytes = bytes;
+    step.depth = int(mOpen.size());
+    step.startMs = getElapsedMs();
+    mSteps.push_back(std::move(step));
+    mOpen.push_back(mSteps.size() - 1);
+    return mSteps.size() - 1;
+}
+
+void StartupProfiler::end(size_t step, bool ok) {
+    if (step >= mSteps.size()) {
+        return;
+    }
+    mSteps[step].durationMs = getElapsedMs() - mSteps[step].startMs;
+    mSteps[step].ok = ok;
+    mOpen.erase(std::remove(mOpen.begin(), mOpen.end(), step), mOpen.end());
+}
+
+double StartupProfiler::getElapsedMs() const noexcept {
+    return std::chrono::duration<double, std::milli>(Clock::now() - mOrigin).count();
+}
+
+std::vector<std::pair<std::string, double>> StartupProfiler::getGroupTotals() const {
+    std::vector<std::pair<std::string, double>> totals;
+    for (const auto& step : mSteps) {
+        if (step.depth != 0) {
+            continue;
+        }
+        auto it = std::find_if(totals.begin(), totals.end(),
+                [&](const auto& entry) { return entry.first == step.group; });
+        if (it == totals.end()) {
+            totals.emplace_back(step.group, step.durationMs);
+        } else {
+            it->second += step.durationMs;
+        }
+    }
+    // 耗时最多的分组排在前面，也就是最值得并行化或推迟的部分
+    std::stable_sort(totals.begin(), totals.end(),
+            [](const auto& a, const auto& b) { return a.second > b.second; });
+    return totals;
+}
+
+void StartupProfiler::dump(std::ostream& out) const {
+    out << std::fixed << std::setprecision(2);
+    out << "  " << std::left << std::setw(44) << "step" << std::setw(18) << "group"
+        << std::right << std::setw(10) << "start" << std::setw(10) << "ms"
+        << std::setw(12) << "bytes" << '\n';
+    for (const auto& step : mSteps) {
+        const std::string name = std::string(size_t(step.depth) * 2, ' ') + step.name +
+                (step.ok ? "" : " (failed)");
+        out << "  " << std::left << std::setw(44) << name << std::setw(18) << step.group
+            << std::right << std::setw(10) << step.startMs << std::setw(10) << step.durationMs
+            << std::setw(12) << step.bytes << '\n';
+    }
+    out << "  by group:\n";
+    for (const auto& entry : getGroupTotals()) {
+        out << "    " << std::left << std::setw(18) << entry.first
+            << std::right << std::setw(10) << entry.second << '\n';
+    }
+    out << std::defaultfloat << std::flush;
+}
+
+void StartupProfiler::writeJson(JsonWriter& json) const {
+    json.beginObject();
+    json.key("steps").beginArray();
+    for (const auto& step : mSteps) {
+        json.beginObject();
+        json.key("name").value(step.name);
+        json.key("group").value(step.group);
+        json.key("depth").value(step.depth);
+        json.key("startMs").value(step.startMs);
+        json.key("durationMs").value(step.durationMs);
+        json.key("bytes").value(static_cast<unsigned long long>(step.bytes));
+        json.key("ok").value(step.ok);
+        json.endObject();
+    }
+    json.endArray();
+    json.key("groups").beginObject();
+    for (const auto& entry : getGroupTotals()) {
+        json.key(entry.first.c_str()).value(entry.second);
+    }
+    json.endObject();
+    json.endObject();
+}
+
+} // namespace demo
@@ -0,0 +1,84 @@
+#ifndef DEMO_COMMON_STARTUPPROFILER_H
+#define DEMO_COMMON_STARTUPPROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace demo {
+
+class JsonWriter;
+
+// ========================================
+// 冷启动分阶段计时
+// ========================================
+// 记录 Engine 创建、材质构建、网格加载、首帧等初始化步骤的起止时间，
+// 每个步骤带一个分组（例如 "material"、"mesh"），报告中按分组汇总。
+// 时间从构造 StartupProfiler 开始计算，单位毫秒。只在创建它的线程上使用。
+class StartupProfiler {
+public:
+    struct Step {
+        std::string name;
+        std::string group;
+        double startMs = 0.0;
+        double durationMs = 0.0;
+        uint64_t bytes = 0;     // 步骤处理的数据量（例如材质包大小），没有时为 0
+        bool ok = true;
+        int depth = 0;          // 嵌套层数，0 表示顶层步骤
+    };
+
+    StartupProfiler();
+
+    // 开始一个步骤，返回步骤编号；步骤可以嵌套
+    size_t begin(std::string name, std::string group, uint64_t bytes = 0);
+    void end(size_t step, bool ok = true);
+
+    // 从构造开始经过的时间
+    double getElapsedMs() const noexcept;
+
+    const std::vector<Step>& getSteps() const noexcept { return mSteps; }
+
+    // 按分组汇总顶层步骤的耗时（嵌套步骤已经包含在父步骤中，不重复计算）
+    std::vector<std::pair<std::string, double>> getGroupTotals() const;
+
+    void dump(std::ostream& out) const;
+    void writeJson(JsonWriter& json) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point mOrigin;
+    std::vector<Step> mSteps;
+    std::vector<size_t> mOpen;
+};
+
+// 作用域步骤，profiler 为空时什么都不做，方便在场景构建器中选择性地计时
+class StartupStep {
+public:
+    StartupStep(StartupProfiler* profiler, const char* name, const char* group,
+            uint64_t bytes = 0)
+            : mProfiler(profiler),
+              mStep(profiler ? profiler->begin(name, group, bytes) : 0) {
+    }
+    ~StartupStep() { end(); }
+
+    // 提前结束，ok 为 false 表示该步骤失败
+    void end(bool ok = true) {
+        if (mProfiler) {
+            mProfiler->end(mStep, ok);
+            mProfiler = nullptr;
+        }
+    }
+
+    StartupStep(const StartupStep&) = delete;
+    StartupStep& operator=(const StartupStep&) = delete;
+
+private:
+    StartupProfiler* mProfiler;
+    size_t mStep;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_STARTUPPROFILER_H
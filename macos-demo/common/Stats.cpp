@@ -0,0 +1,57 @@
+#include "Stats.h"
+#include "JsonWriter.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace demo {
+
+namespace {
+
+// 最近秩（nearest-rank）分位数，samples 必须已经排序
+double percentile(const std::vector<double>& sorted, double p) {
+    const size_t n = sorted.size();
+    size_t rank = size_t(p * double(n) + 0.5);
+    rank = std::clamp<size_t>(rank, 1, n);
+    return sorted[rank - 1];
+}
+
+} // anonymous namespace
+
+SampleStats computeStats(std::vector<double> samples) {
+    SampleStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    stats.count = samples.size();
+    stats.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / double(samples.size());
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.p50 = percentile(samples, 0.50);
+    stats.p90 = percentile(samples, 0.90);
+    stats.p99 = percentile(samples, 0.99);
+    return stats;
+}
+
+double computePercentile(std::vector<double> samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    return percentile(samples, p);
+}
+
+void writeStats(JsonWriter& json, const SampleStats& stats) {
+    json.beginObject();
+    json.key("count").value(stats.count);
+    json.key("mean").value(stats.mean);
+    json.key("min").value(stats.min);
+    json.key("p50").value(stats.p50);
+    json.key("p90").value(stats.p90);
+    json.key("p99").value(stats.p99);
+    json.key("max").value(stats.max);
+    json.endObject();
+}
+
+} // namespace demo
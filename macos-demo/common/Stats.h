@@ -0,0 +1,33 @@
+#ifndef DEMO_COMMON_STATS_H
+#define DEMO_COMMON_STATS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace demo {
+
+class JsonWriter;
+
+// 一组采样（例如每帧耗时，单位毫秒）的统计结果
+struct SampleStats {
+    size_t count = 0;
+    double mean = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+};
+
+// 计算均值、极值和分位数，samples 按值传入以便原地排序
+SampleStats computeStats(std::vector<double> samples);
+
+// 任意分位数（p 取 0~1，最近秩），samples 为空时返回 0
+double computePercentile(std::vector<double> samples, double p);
+
+// 以 JSON 对象的形式写出统计结果：{"count":..,"mean":..,"min":..,...}
+void writeStats(JsonWriter& json, const SampleStats& stats);
+
+} // namespace demo
+
+#endif // DEMO_COMMON_STATS_H
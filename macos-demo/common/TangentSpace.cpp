@@ -0,0 +1,630 @@
+#include "TangentSpace.h"
+#include "Parallel.h"
+#include "Trace.h"
+
+#include <math/quat.h>
+
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+using namespace filament::math;
+using filament::geometry::TangentSpaceMesh;
+
+namespace demo {
+
+namespace {
+
+using Algorithm = TangentSpaceMesh::Algorithm;
+
+// 焊接的分片数固定，与线程数无关
+constexpr uint32_t WELD_SHARD_BITS = 6;
+constexpr uint32_t WELD_SHARDS = 1u << WELD_SHARD_BITS;
+constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+enum class Mode {
+    PER_VERTEX,     // 只用法线，每个顶点独立
+    SHARED,         // 用三角形累加，不重新焊接
+    REMESH,         // 用三角形，输出新的网格
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 当前线程的 CPU 时间。线程比核多时各块会互相抢占，按墙钟计时的每块耗时没有意义
+double threadCpuMs() {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return double(now.tv_sec) * 1e3 + double(now.tv_nsec) * 1e-6;
+}
+
+uint64_t mix(uint64_t h) noexcept {
+    h ^= h >> 31;
+    h *= 0xbf58476d1ce4e5b9ull;
+    return h ^ (h >> 29);
+}
+
+uint64_t hashFloats(const float* values, size_t count) noexcept {
+    uint64_t h = 0x9e3779b97f4a7c15ull;
+    for (size_t i = 0; i < count; i++) {
+        // 加 0 把 -0 变成 +0，与按 == 比较的结果一致
+        const float value = values[i] + 0.0f;
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        h = mix(h ^ (uint64_t(bits) * 0xc2b2ae3d27d4eb4full));
+    }
+    return h;
+}
+
+// representative[i] 是与元素 i 相同的第一个元素。元素按哈希分到固定数量的分片，每个分片由一个线程独占，
+// 分片内按元素顺序插入开放寻址表，结果与线程数无关（与 ObjImporter 的顶点去重相同）
+template<typename Equal>
+std::vector<uint32_t> findFirstOccurrences(const std::vector<uint64_t>& hashes, uint32_t threadCount,
+        Equal&& equal) {
+    const size_t count = hashes.size();
+    const size_t rangeCount = std::max<size_t>(1, std::min<size_t>(threadCount, count / 4096));
+    const auto rangeBegin = [&](size_t range) { return count * range / rangeCount; };
+    std::vector<uint32_t> counts(rangeCount * WELD_SHARDS, 0);
+    parallelFor(threadCount, rangeCount, [&](size_t begin, size_t end) {
+        for (size_t range = begin; range < end; range++) {
+            uint32_t* rangeCounts = counts.data() + range * WELD_SHARDS;
+            for (size_t i = rangeBegin(range); i < rangeBegin(range + 1); i++) {
+                rangeCounts[hashes[i] >> (64 - WELD_SHARD_BITS)]++;
+            }
+        }
+    });
+
+    // 分片内按元素顺序排列：分片优先，同一分片内区间在前的在前
+    std::vector<uint32_t> offsets(rangeCount * WELD_SHARDS);
+    std::vector<uint32_t> shardBegin(WELD_SHARDS + 1);
+    uint32_t offset = 0;
+    for (uint32_t shard = 0; shard < WELD_SHARDS; shard++) {
+        shardBegin[shard] = offset;
+        for (size_t range = 0; range < rangeCount; range++) {
+            offsets[range * WELD_SHARDS + shard] = offset;
+            offset += counts[range * WELD_SHARDS + shard];
+        }
+    }
+    shardBegin[WELD_SHARDS] = offset;
+    std::vector<uint32_t> order(count);
+    parallelFor(threadCount, rangeCount, [&](size_t begin, size_t end) {
+        for (size_t range = begin; range < end; range++) {
+            uint32_t* rangeOffsets = offsets.data() + range * WELD_SHARDS;
+            for (size_t i = rangeBegin(range); i < rangeBegin(range + 1); i++) {
+                order[rangeOffsets[hashes[i] >> (64 - WELD_SHARD_BITS)]++] = uint32_t(i);
+            }
+        }
+    });
+
+    std::vector<uint32_t> representative(count);
+    parallelFor(threadCount, WELD_SHARDS, [&](size_t begin, size_t end) {
+        std::vector<uint32_t> table;
+        for (size_t shard = begin; shard < end; shard++) {
+            const uint32_t shardCount = shardBegin[shard + 1] - shardBegin[shard];
+            size_t capacity = 16;
+            while (capacity < size_t(shardCount) * 2) {
+                capacity *= 2;
+            }
+            table.assign(capacity, EMPTY_SLOT);
+            for (uint32_t k = shardBegin[shard]; k < shardBegin[shard + 1]; k++) {
+                const uint32_t i = order[k];
+                for (size_t slot = (hashes[i] >> WELD_SHARD_BITS) & (capacity - 1);;
+                        slot = (slot + 1) & (capacity - 1)) {
+                    if (table[slot] == EMPTY_SLOT) {
+                        table[slot] = i;
+                        representative[i] = i;
+                        break;
+                    }
+                    if (hashes[table[slot]] == hashes[i] && equal(table[slot], i)) {
+                        representative[i] = table[slot];
+                        break;
+                    }
+                }
+            }
+        }
+    });
+    return representative;
+}
+
+// 只设置非空的属性，DEFAULT 由 TangentSpaceMesh 按这些属性选择算法
+TangentSpaceMesh* buildTangentSpace(const float3* positions, const float3* normals, const float2* uvs,
+        size_t vertexCount, const uint3* triangles, size_t triangleCount, Algorithm algorithm) {
+    TangentSpaceMesh::Builder builder;
+    builder.vertexCount(vertexCount).algorithm(algorithm);
+    if (positions) {
+        builder.positions(positions);
+    }
+    if (normals) {
+        builder.normals(normals);
+    }
+    if (uvs) {
+        builder.uvs(uvs);
+    }
+    if (triangles) {
+        builder.triangleCount(triangleCount).triangles(triangles);
+    }
+    return builder.build();
+}
+
+// 一个块的重新焊接结果，按块内的顶点编号
+struct ChunkVertices {
+    std::vector<float3> positions;
+    std::vector<float2> uvs;
+    std::vector<quatf> quats;           // 焊接时比较的值
+    std::vector<short4> tangents;       // 输出的值
+};
+
+// 角点引用某个块的某个顶点
+struct CornerVertex {
+    uint32_t chunk;
+    uint32_t vertex;
+};
+
+// 把三角形按重心做 kd 中位数切分：每次沿包围盒最长的轴切开，两边的三角形数与分到的块数成比例。
+// 返回按块排列的三角形编号，块内按编号递增；chunkBegin 有 chunkCount + 1 个元素，triangleChunk 是每个三角形所在的块
+std::vector<uint32_t> partitionTriangles(const TangentSpaceInput& input, uint32_t chunkCount, uint32_t threadCount,
+        std::vector<size_t>& chunkBegin, std::vector<uint32_t>& triangleChunk) {
+    const size_t triangleCount = input.triangleCount;
+    std::vector<float3> centroids(triangleCount);
+    parallelFor(threadCount, triangleCount, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            const uint3& triangle = input.triangles[t];
+            centroids[t] = input.positions[triangle.x] + input.positions[triangle.y] + input.positions[triangle.z];
+        }
+    });
+    std::vector<uint32_t> order(triangleCount);
+    std::iota(order.begin(), order.end(), 0u);
+
+    struct Segment {
+        size_t begin;
+        size_t end;
+        uint32_t firstChunk;
+        uint32_t chunkCount;
+    };
+    std::vector<Segment> segments{ { 0, triangleCount, 0, chunkCount } };
+    chunkBegin.assign(chunkCount + 1, triangleCount);
+    while (!segments.empty()) {
+        // 同一层的段互不重叠，并行切分
+        std::vector<Segment> children(segments.size() * 2);
+        parallelFor(threadCount, segments.size(), [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; s++) {
+                const Segment& segment = segments[s];
+                float3 minimum{ std::numeric_limits<float>::max() };
+                float3 maximum{ std::numeric_limits<float>::lowest() };
+                for (size_t i = segment.begin; i < segment.end; i++) {
+                    minimum = min(minimum, centroids[order[i]]);
+                    maximum = max(maximum, centroids[order[i]]);
+                }
+                const float3 extent = maximum - minimum;
+                const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+                const uint32_t leftChunks = segment.chunkCount / 2;
+                const size_t middle = segment.begin +
+                        (segment.end - segment.begin) * leftChunks / segment.chunkCount;
+                std::nth_element(order.begin() + segment.begin, order.begin() + middle, order.begin() + segment.end,
+                        [&](uint32_t a, uint32_t b) {
+                            const float ca = centroids[a][axis];
+                            const float cb = centroids[b][axis];
+                            return ca < cb || (ca == cb && a < b);
+                        });
+                children[s * 2] = { segment.begin, middle, segment.firstChunk, leftChunks };
+                children[s * 2 + 1] = { middle, segment.end, segment.firstChunk + leftChunks,
+                        segment.chunkCount - leftChunks };
+            }
+        });
+        segments.clear();
+        for (const Segment& child : children) {
+            if (child.chunkCount > 1) {
+                segments.push_back(child);
+            } else {
+                chunkBegin[child.firstChunk] = child.begin;
+            }
+        }
+    }
+    // 块内恢复原来的三角形顺序，halo 合并进来后块内的累加顺序与单线程相同。
+    // 按三角形编号顺序逐个放回所在块的区间，不用排序
+    triangleChunk.resize(triangleCount);
+    parallelFor(threadCount, chunkCount, [&](size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; chunk++) {
+            for (size_t i = chunkBegin[chunk]; i < chunkBegin[chunk + 1]; i++) {
+                triangleChunk[order[i]] = uint32_t(chunk);
+            }
+        }
+    });
+    std::vector<size_t> fill(chunkBegin.begin(), chunkBegin.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        order[fill[triangleChunk[t]]++] = uint32_t(t);
+    }
+    return order;
+}
+
+bool validateInput(const TangentSpaceInput& input, Mode mode, Algorithm algorithm) {
+    const bool hasTriangles = input.positions && input.triangles;
+    bool valid = true;
+    switch (mode) {
+        case Mode::PER_VERTEX:
+            valid = input.normals != nullptr;
+            break;
+        case Mode::SHARED:
+            valid = hasTriangles && input.normals && input.uvs;
+            break;
+        case Mode::REMESH:
+            valid = hasTriangles && (algorithm != Algorithm::MIKKTSPACE || (input.normals && input.uvs));
+            break;
+    }
+    if (!valid) {
+        std::cerr << "Tangent space input is missing attributes required by the algorithm" << std::endl;
+        return false;
+    }
+    if (mode != Mode::PER_VERTEX) {
+        for (size_t t = 0; t < input.triangleCount; t++) {
+            const uint3& triangle = input.triangles[t];
+            if (triangle.x >= input.vertexCount || triangle.y >= input.vertexCount ||
+                    triangle.z >= input.vertexCount) {
+                std::cerr << "Tangent space triangle index out of range" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+bool generateTangentSpace(const TangentSpaceInput& input, const TangentSpaceOptions& options,
+        TangentSpaceOutput& output, TangentSpaceStats* stats) {
+    TRACE_CALL();
+    const auto start = std::chrono::steady_clock::now();
+    TangentSpaceStats localStats;
+    TangentSpaceStats& result = stats ? *stats : localStats;
+    result = {};
+    output = {};
+
+    // 与 TangentSpaceMesh 选择默认算法的规则相同
+    Algorithm algorithm = options.algorithm;
+    Mode mode;
+    if (algorithm == Algorithm::DEFAULT) {
+        if (input.normals) {
+            algorithm = input.uvs && input.positions && input.triangles ? Algorithm::MIKKTSPACE
+                                                                         : Algorithm::FRISVAD;
+            mode = algorithm == Algorithm::MIKKTSPACE ? Mode::REMESH : Mode::PER_VERTEX;
+        } else {
+            // 平面着色没有对应的枚举，仍然交给 DEFAULT
+            mode = Mode::REMESH;
+        }
+    } else if (algorithm == Algorithm::MIKKTSPACE) {
+        mode = Mode::REMESH;
+    } else if (algorithm == Algorithm::LENGYEL) {
+        mode = Mode::SHARED;
+    } else {
+        mode = Mode::PER_VERTEX;
+    }
+    if (!validateInput(input, mode, algorithm)) {
+        return false;
+    }
+    // 平面着色不用法线，也不能把法线交给 TangentSpaceMesh，否则 DEFAULT 会选别的算法
+    const float3* normals = mode == Mode::REMESH && algorithm == Algorithm::DEFAULT ? nullptr : input.normals;
+
+    const uint32_t threadCount = resolveThreadCount(options.threadCount);
+    const size_t workCount = mode == Mode::PER_VERTEX ? input.vertexCount : input.triangleCount;
+    const uint32_t chunkCount = uint32_t(std::clamp<size_t>(
+            workCount / std::max(options.minChunkTriangles, 1u), 1, threadCount));
+    result.chunkCount = chunkCount;
+
+    // 只有一块：直接处理整个网格，就是单线程的结果
+    if (chunkCount == 1) {
+        const auto chunkStart = std::chrono::steady_clock::now();
+        TangentSpaceMesh* mesh = buildTangentSpace(mode == Mode::PER_VERTEX ? nullptr : input.positions, normals,
+                mode == Mode::PER_VERTEX ? nullptr : input.uvs, input.vertexCount,
+                mode == Mode::PER_VERTEX ? nullptr : input.triangles, input.triangleCount, algorithm);
+        output.tangents.resize(mesh->getVertexCount());
+        mesh->getQuats(output.tangents.data());
+        output.remeshed = mesh->remeshed();
+        if (output.remeshed) {
+            output.positions.resize(mesh->getVertexCount());
+            mesh->getPositions(output.positions.data());
+            if (input.uvs) {
+                output.uvs.resize(mesh->getVertexCount());
+                mesh->getUVs(output.uvs.data());
+            }
+            output.triangles.resize(mesh->getTriangleCount());
+            mesh->getTriangles(output.triangles.data());
+        }
+        TangentSpaceMesh::destroy(mesh);
+        result.chunkMs = elapsedMs(chunkStart);
+        result.slowestChunkMs = result.chunkMs;
+        result.totalMs = elapsedMs(start);
+        return true;
+    }
+
+    // 按顶点的算法：顶点切成连续区间
+    if (mode == Mode::PER_VERTEX) {
+        const auto chunkStart = std::chrono::steady_clock::now();
+        output.tangents.resize(input.vertexCount);
+        std::vector<double> chunkTimes(chunkCount, 0.0);
+        parallelFor(threadCount, chunkCount, [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; chunk++) {
+                const double chunkTimer = threadCpuMs();
+                const size_t first = input.vertexCount * chunk / chunkCount;
+                const size_t last = input.vertexCount * (chunk + 1) / chunkCount;
+                TangentSpaceMesh* mesh = buildTangentSpace(nullptr, input.normals + first, nullptr,
+                        last - first, nullptr, 0, algorithm);
+                mesh->getQuats(output.tangents.data() + first);
+                TangentSpaceMesh::destroy(mesh);
+                chunkTimes[chunk] = threadCpuMs() - chunkTimer;
+            }
+        });
+        result.chunkMs = elapsedMs(chunkStart);
+        result.slowestChunkMs = *std::max_element(chunkTimes.begin(), chunkTimes.end());
+        result.totalMs = elapsedMs(start);
+        return true;
+    }
+
+    // 1. 焊接位置、法线和 UV 都相同的顶点（mikktspace 内部也这样焊接），建立代表顶点 -> 三角形的邻接表
+    const auto partitionStart = std::chrono::steady_clock::now();
+    const size_t vertexCount = input.vertexCount;
+    const size_t triangleCount = input.triangleCount;
+    std::vector<uint64_t> vertexHashes(vertexCount);
+    parallelFor(threadCount, vertexCount, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            float key[8] = { input.positions[v].x, input.positions[v].y, input.positions[v].z };
+            if (normals) {
+                std::memcpy(key + 3, &normals[v], sizeof(float3));
+            }
+            if (input.uvs) {
+                std::memcpy(key + 6, &input.uvs[v], sizeof(float2));
+            }
+            vertexHashes[v] = hashFloats(key, 8);
+        }
+    });
+    const std::vector<uint32_t> welded = findFirstOccurrences(vertexHashes, threadCount, [&](uint32_t a, uint32_t b) {
+        return input.positions[a] == input.positions[b] && (!normals || normals[a] == normals[b]) &&
+                (!input.uvs || input.uvs[a] == input.uvs[b]);
+    });
+    vertexHashes = {};
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) {
+            adjacencyOffsets[welded[input.triangles[t][k]] + 1]++;
+        }
+    }
+    std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t t = 0; t < triangleCount; t++) {
+            for (int k = 0; k < 3; k++) {
+                adjacency[fill[welded[input.triangles[t][k]]]++] = uint32_t(t);
+            }
+        }
+    }
+
+    // 2. 空间切分
+    std::vector<size_t> chunkBegin;
+    std::vector<uint32_t> triangleChunk;
+    const std::vector<uint32_t> order = partitionTriangles(input, chunkCount, threadCount, chunkBegin, triangleChunk);
+
+    // 不重新焊接时顶点属于第一个引用它的三角形所在的块，没有被引用的顶点归第 0 块
+    std::vector<uint32_t> vertexChunk;
+    if (mode == Mode::SHARED) {
+        vertexChunk.assign(vertexCount, EMPTY_SLOT);
+        for (size_t t = 0; t < triangleCount; t++) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t& owner = vertexChunk[input.triangles[t][k]];
+                if (owner == EMPTY_SLOT) {
+                    owner = triangleChunk[t];
+                }
+            }
+        }
+    }
+    result.partitionMs = elapsedMs(partitionStart);
+
+    // 3. 每块带上 halo 单独处理
+    const auto chunkStart = std::chrono::steady_clock::now();
+    std::vector<ChunkVertices> chunkVertices(mode == Mode::REMESH ? chunkCount : 0);
+    std::vector<CornerVertex> corners(mode == Mode::REMESH ? triangleCount * 3 : 0);
+    std::vector<size_t> haloCounts(chunkCount, 0);
+    std::vector<double> chunkTimes(chunkCount, 0.0);
+    if (mode == Mode::SHARED) {
+        output.tangents.resize(vertexCount);
+    }
+    parallelFor(threadCount, chunkCount, [&](size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; chunk++) {
+            const double chunkTimer = threadCpuMs();
+            const uint32_t* core = order.data() + chunkBegin[chunk];
+            const size_t coreCount = chunkBegin[chunk + 1] - chunkBegin[chunk];
+            std::vector<uint32_t> halo;
+            for (size_t i = 0; i < coreCount; i++) {
+                for (int k = 0; k < 3; k++) {
+                    const uint32_t w = welded[input.triangles[core[i]][k]];
+                    for (uint32_t a = adjacencyOffsets[w]; a < adjacencyOffsets[w + 1]; a++) {
+                        if (triangleChunk[adjacency[a]] != chunk) {
+                            halo.push_back(adjacency[a]);
+                        }
+                    }
+                }
+            }
+            std::sort(halo.begin(), halo.end());
+            halo.erase(std::unique(halo.begin(), halo.end()), halo.end());
+            haloCounts[chunk] = halo.size();
+            std::vector<uint32_t> triangles(coreCount + halo.size());
+            std::merge(core, core + coreCount, halo.begin(), halo.end(), triangles.begin());
+            halo = {};
+
+            // 块内顶点按原编号排列。块在空间上紧凑，引用的顶点编号大多也集中，
+            // 用 [first, last] 区间上的映射表代替排序和二分查找
+            const bool ownsUnreferenced = mode == Mode::SHARED && chunk == 0;
+            uint32_t first = ownsUnreferenced ? 0 : std::numeric_limits<uint32_t>::max();
+            uint32_t last = ownsUnreferenced ? uint32_t(vertexCount - 1) : 0;
+            for (uint32_t t : triangles) {
+                for (int k = 0; k < 3; k++) {
+                    first = std::min(first, input.triangles[t][k]);
+                    last = std::max(last, input.triangles[t][k]);
+                }
+            }
+            std::vector<uint32_t> localOf(size_t(last - first) + 1, EMPTY_SLOT);
+            for (uint32_t t : triangles) {
+                for (int k = 0; k < 3; k++) {
+                    localOf[input.triangles[t][k] - first] = 0;
+                }
+            }
+            if (ownsUnreferenced) {
+                for (size_t v = 0; v < vertexCount; v++) {
+                    if (vertexChunk[v] == 0) {
+                        localOf[v] = 0;
+                    }
+                }
+            }
+            std::vector<uint32_t> vertices;
+            for (size_t i = 0; i < localOf.size(); i++) {
+                if (localOf[i] != EMPTY_SLOT) {
+                    localOf[i] = uint32_t(vertices.size());
+                    vertices.push_back(first + uint32_t(i));
+                }
+            }
+            const auto localIndex = [&localOf, first](uint32_t v) { return localOf[v - first]; };
+            std::vector<float3> localPositions(vertices.size());
+            std::vector<float3> localNormals(normals ? vertices.size() : 0);
+            std::vector<float2> localUvs(input.uvs ? vertices.size() : 0);
+            for (size_t i = 0; i < vertices.size(); i++) {
+                localPositions[i] = input.positions[vertices[i]];
+                if (normals) {
+                    localNormals[i] = normals[vertices[i]];
+                }
+                if (input.uvs) {
+                    localUvs[i] = input.uvs[vertices[i]];
+                }
+            }
+            std::vector<uint3> localTriangles(triangles.size());
+            for (size_t i = 0; i < triangles.size(); i++) {
+                const uint3& triangle = input.triangles[triangles[i]];
+                localTriangles[i] = uint3{ localIndex(triangle.x), localIndex(triangle.y), localIndex(triangle.z) };
+            }
+
+            TangentSpaceMesh* mesh = buildTangentSpace(localPositions.data(), normals ? localNormals.data() : nullptr,
+                    input.uvs ? localUvs.data() : nullptr, vertices.size(), localTriangles.data(),
+                    localTriangles.size(), algorithm);
+            if (mode == Mode::SHARED) {
+                std::vector<short4> tangents(mesh->getVertexCount());
+                mesh->getQuats(tangents.data());
+                for (size_t i = 0; i < vertices.size(); i++) {
+                    if (vertexChunk[vertices[i]] == chunk) {
+                        output.tangents[vertices[i]] = tangents[i];
+                    }
+                }
+            } else {
+                // TangentSpaceMesh 重新焊接时第 i 个输出三角形对应第 i 个输入三角形，只是顶点重新编号
+                ChunkVertices& out = chunkVertices[chunk];
+                const size_t outputCount = mesh->getVertexCount();
+                out.positions.resize(outputCount);
+                mesh->getPositions(out.positions.data());
+                if (input.uvs) {
+                    out.uvs.resize(outputCount);
+                    mesh->getUVs(out.uvs.data());
+                }
+                out.quats.resize(outputCount);
+                mesh->getQuats(out.quats.data());
+                out.tangents.resize(outputCount);
+                mesh->getQuats(out.tangents.data());
+                std::vector<uint3> outputTriangles(mesh->getTriangleCount());
+                mesh->getTriangles(outputTriangles.data());
+                for (size_t i = 0; i < triangles.size(); i++) {
+                    if (triangleChunk[triangles[i]] != chunk) {
+                        continue;
+                    }
+                    for (int k = 0; k < 3; k++) {
+                        corners[size_t(triangles[i]) * 3 + k] = CornerVertex{ uint32_t(chunk), outputTriangles[i][k] };
+                    }
+                }
+            }
+            TangentSpaceMesh::destroy(mesh);
+            chunkTimes[chunk] = threadCpuMs() - chunkTimer;
+        }
+    });
+    result.haloTriangles = std::accumulate(haloCounts.begin(), haloCounts.end(), size_t(0));
+    result.chunkMs = elapsedMs(chunkStart);
+    result.slowestChunkMs = *std::max_element(chunkTimes.begin(), chunkTimes.end());
+
+    // 4. 重新焊接时按首次出现的顺序焊接完全相同的角点（逐字节比较，与 TangentSpaceMesh 相同）
+    const auto stitchStart = std::chrono::steady_clock::now();
+    if (mode == Mode::REMESH) {
+        const size_t cornerCount = corners.size();
+        std::vector<uint64_t> cornerHashes(cornerCount);
+        const auto cornerKey = [&](uint32_t corner, float key[9]) {
+            const CornerVertex& c = corners[corner];
+            const ChunkVertices& vertices = chunkVertices[c.chunk];
+            std::memcpy(key, &vertices.positions[c.vertex], sizeof(float3));
+            std::memcpy(key + 3, &vertices.quats[c.vertex], sizeof(quatf));
+            if (input.uvs) {
+                std::memcpy(key + 7, &vertices.uvs[c.vertex], sizeof(float2));
+            } else {
+                key[7] = key[8] = 0.0f;
+            }
+        };
+        parallelFor(threadCount, cornerCount, [&](size_t begin, size_t end) {
+            float key[9];
+            for (size_t i = begin; i < end; i++) {
+                cornerKey(uint32_t(i), key);
+                uint64_t h = 0x9e3779b97f4a7c15ull;
+                for (float value : key) {
+                    uint32_t bits;
+                    std::memcpy(&bits, &value, sizeof(bits));
+                    h = mix(h ^ (uint64_t(bits) * 0xc2b2ae3d27d4eb4full));
+                }
+                cornerHashes[i] = h;
+            }
+        });
+        const std::vector<uint32_t> representative = findFirstOccurrences(cornerHashes, threadCount,
+                [&](uint32_t a, uint32_t b) {
+                    float keyA[9];
+                    float keyB[9];
+                    cornerKey(a, keyA);
+                    cornerKey(b, keyB);
+                    return std::memcmp(keyA, keyB, sizeof(keyA)) == 0;
+                });
+        cornerHashes = {};
+
+        // 首次出现的角点按顺序编号
+        std::vector<uint32_t> vertexOf(cornerCount);
+        uint32_t outputCount = 0;
+        for (size_t i = 0; i < cornerCount; i++) {
+            if (representative[i] == i) {
+                vertexOf[i] = outputCount++;
+            }
+        }
+        output.remeshed = true;
+        output.positions.resize(outputCount);
+        output.uvs.resize(input.uvs ? outputCount : 0);
+        output.tangents.resize(outputCount);
+        output.triangles.resize(triangleCount);
+        parallelFor(threadCount, triangleCount, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) {
+                for (int k = 0; k < 3; k++) {
+                    const size_t i = t * 3 + k;
+                    const uint32_t vertex = vertexOf[representative[i]];
+                    output.triangles[t][k] = vertex;
+                    if (representative[i] != i) {
+                        continue;
+                    }
+                    const CornerVertex& c = corners[i];
+                    const ChunkVertices& vertices = chunkVertices[c.chunk];
+                    output.positions[vertex] = vertices.positions[c.vertex];
+                    if (input.uvs) {
+                        output.uvs[vertex] = vertices.uvs[c.vertex];
+                    }
+                    output.tangents[vertex] = vertices.tangents[c.vertex];
+                }
+            }
+        });
+    }
+    result.stitchMs = elapsedMs(stitchStart);
+    result.totalMs = elapsedMs(start);
+    return true;
+}
+
+} // namespace demo
@@ -0,0 +1,80 @@
+#ifndef DEMO_COMMON_TANGENTSPACE_H
+#define DEMO_COMMON_TANGENTSPACE_H
+
+#include <geometry/TangentSpaceMesh.h>
+
+#include <math/vec2.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace demo {
+
+// ========================================
+// 分块并行的切线空间生成
+// ========================================
+// geometry::TangentSpaceMesh 在一个线程上处理整个网格，lucy 这样几百万三角形的扫描模型上
+// 它是 OBJ 导入最慢的一步。这里把网格按空间切成 threadCount 块，每块单独交给 TangentSpaceMesh，
+// 再把各块的结果拼回去，尽量与单线程对整个网格的输出逐位一致：
+//
+//   按顶点的算法（FRISVAD、HUGHES_MOLLER）：顶点切成连续区间，结果天然一致
+//   需要三角形的算法（MIKKTSPACE、LENGYEL、没有法线时的平面着色）：
+//      1. 按三角形重心做 kd 中位数切分，每块三角形数相同、在空间上紧凑
+//      2. 每块除了自己的三角形，还带上与它共享顶点（按位置、法线、UV 焊接）的其他块的三角形（halo），
+//         块内三角形保持原来的相对顺序。一个顶点的切线只取决于包含它的三角形，
+//         所以边界顶点在所属块中看到的三角形和累加顺序与单线程相同
+//      3. 不重新焊接的算法（LENGYEL）：每个顶点只取所属块（第一个引用它的三角形所在的块）的结果
+//      4. 重新焊接的算法（MIKKTSPACE）：按原三角形顺序收集每个角点的位置、UV 和切线四元数，
+//         再按首次出现的顺序焊接完全相同的角点，与 TangentSpaceMesh 内部的焊接规则相同，
+//         顶点编号和三角形都与单线程一致
+//
+// mikktspace 在非流形边（三个以上三角形共享）上配对相邻三角形的方式取决于顶点编号，
+// 这些边附近的切线可能与单线程有微小差别。只有一块时直接调用 TangentSpaceMesh，结果就是单线程的输出。
+
+struct TangentSpaceInput {
+    const filament::math::float3* positions = nullptr;
+    const filament::math::float3* normals = nullptr;
+    const filament::math::float2* uvs = nullptr;        // 可以为空
+    size_t vertexCount = 0;
+    const filament::math::uint3* triangles = nullptr;
+    size_t triangleCount = 0;
+};
+
+struct TangentSpaceOptions {
+    // DEFAULT 按输入选择，与 TangentSpaceMesh 相同：有法线和 UV 时 MIKKTSPACE，只有法线时 FRISVAD，
+    // 没有法线时平面着色
+    filament::geometry::TangentSpaceMesh::Algorithm algorithm =
+            filament::geometry::TangentSpaceMesh::Algorithm::DEFAULT;
+    uint32_t threadCount = 0;           // 0 表示使用全部硬件线程
+    uint32_t minChunkTriangles = 16384; // 每块至少这么多三角形（按顶点的算法为顶点），小网格不切块
+};
+
+struct TangentSpaceOutput {
+    // remeshed 为 false 时顶点与输入一一对应，只有 tangents；为 true 时 positions/uvs/triangles 是新的网格
+    std::vector<filament::math::float3> positions;
+    std::vector<filament::math::float2> uvs;
+    std::vector<filament::math::short4> tangents;
+    std::vector<filament::math::uint3> triangles;
+    bool remeshed = false;
+};
+
+struct TangentSpaceStats {
+    uint32_t chunkCount = 0;
+    size_t haloTriangles = 0;           // 各块额外处理的邻块三角形，总计
+    double partitionMs = 0.0;           // 焊接、切分、收集 halo
+    double chunkMs = 0.0;               // 各块的 TangentSpaceMesh
+    double slowestChunkMs = 0.0;        // 最慢一块的线程 CPU 时间，核数不少于块数时 chunkMs 约等于它
+    double stitchMs = 0.0;              // 拼回结果（重新焊接时包括角点焊接）
+    double totalMs = 0.0;
+};
+
+// 生成切线空间。输入缺少所选算法需要的属性时打印原因并返回 false
+bool generateTangentSpace(const TangentSpaceInput& input, const TangentSpaceOptions& options,
+        TangentSpaceOutput& output, TangentSpaceStats* stats = nullptr);
+
+} // namespace demo
+
+#endif // DEMO_COMMON_TANGENTSPACE_H
@@ -0,0 +1,532 @@
+#include "TextureUploader.h"
+#include "MemoryLedger.h"
+#include "Parallel.h"
+#include "Trace.h"
+
+#include <filament/Engine.h>
+#include <filament/MaterialInstance.h>
+#include <filament/Texture.h>
+
+#include <ktxreader/Ktx2Reader.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+// filament 发行包带有 libstb.a，但没有安装 stb_image.h，这里声明用到的两个函数
+extern "C" {
+unsigned char* stbi_load_from_memory(const unsigned char* buffer, int length, int* x, int* y,
+        int* channelsInFile, int desiredChannels);
+void stbi_image_free(void* data);
+}
+
+using namespace filament;
+using ktxreader::Ktx2Reader;
+
+namespace demo {
+
+namespace {
+
+// 暂存缓冲区按 64KB 取整，尺寸相近的纹理可以复用同一块缓冲区
+constexpr size_t STAGING_GRANULARITY = 64 * 1024;
+
+// Ktx2Reader 按请求顺序选第一个 GPU 支持、转码器也支持的格式。
+// 资源都是 ETC1S 编码，ETC1S 是 ETC1 的子集，转成 ETC2 几乎只是拷贝，画质没有损失，排在最前；
+// 其次是桌面 GPU 的 BC1，最后用 RGBA8 兜底。sRGB 和线性格式各一份，Ktx2Reader 按传输函数过滤
+constexpr Texture::InternalFormat KTX2_FORMATS[] = {
+    Texture::InternalFormat::ETC2_SRGB8,
+    Texture::InternalFormat::ETC2_RGB8,
+    Texture::InternalFormat::DXT1_SRGB,
+    Texture::InternalFormat::DXT1_RGB,
+    Texture::InternalFormat::SRGB8_A8,
+    Texture::InternalFormat::RGBA8,
+};
+
+size_t rgbaSize(uint32_t width, uint32_t height) {
+    return size_t(width) * height * 4;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+struct TextureUploader::Request {
+    enum class Kind { RGBA_FILE, RGBA_MEMORY, KTX2, IMAGE };
+
+    Kind kind = Kind::RGBA_FILE;
+    std::promise<Texture*> promise;
+    std::string path;                   // RGBA_FILE
+    const uint8_t* data = nullptr;      // RGBA_MEMORY 的像素，IMAGE 的压缩图片
+    size_t size = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool srgb = false;
+
+    std::unique_ptr<StagingBuffer> staging;     // RGBA_FILE 读入的像素
+    uint8_t* decoded = nullptr;                 // IMAGE 解码出的像素，由 stbi_image_free() 释放
+    Ktx2Reader::Async* async = nullptr;         // KTX2 的转码状态
+    Texture* texture = nullptr;                 // KTX2 在请求时已经创建的纹理
+    bool failed = false;
+    double decodeMs = 0.0;
+};
+
+// ========================================
+// 暂存缓冲区池
+// ========================================
+
+struct TextureUploader::StagingBuffer {
+    std::unique_ptr<uint8_t[]> data;
+    size_t capacity = 0;
+    // 借出期间持有池，保证 Engine 在 TextureUploader 销毁后释放缓冲区时池仍然存在；
+    // 空闲的缓冲区不持有池，避免循环引用
+    std::shared_ptr<StagingPool> pool;
+};
+
+struct TextureUploader::StagingPool {
+    std::mutex lock;
+    std::vector<std::unique_ptr<StagingBuffer>> free;
+    size_t maxPooledBytes = 0;
+    uint64_t pooledBytes = 0;
+    uint32_t allocations = 0;
+    uint32_t reuses = 0;
+
+    // 取够大的缓冲区中最小的一个，没有时新分配
+    static std::unique_ptr<StagingBuffer> acquire(const std::shared_ptr<StagingPool>& pool, size_t size) {
+        std::unique_ptr<StagingBuffer> buffer;
+        {
+            std::lock_guard<std::mutex> guard(pool->lock);
+            auto best = pool->free.end();
+            for (auto it = pool->free.begin(); it != pool->free.end(); ++it) {
+                if ((*it)->capacity >= size && (best == pool->free.end() || (*it)->capacity < (*best)->capacity)) {
+                    best = it;
+                }
+            }
+            if (best != pool->free.end()) {
+                buffer = std::move(*best);
+                pool->free.erase(best);
+                pool->pooledBytes -= buffer->capacity;
+                pool->reuses++;
+            } else {
+                pool->allocations++;
+            }
+        }
+        if (!buffer) {
+            buffer.reset(new StagingBuffer());
+            buffer->capacity = (size + STAGING_GRANULARITY - 1) / STAGING_GRANULARITY * STAGING_GRANULARITY;
+            buffer->data.reset(new uint8_t[buffer->capacity]);
+        }
+        buffer->pool = pool;
+        return buffer;
+    }
+
+    // PixelBufferDescriptor 的回调，可能在 Filament 的驱动线程上调用
+    static void release(StagingBuffer* buffer) {
+        std::unique_ptr<StagingBuffer> owned(buffer);
+        // 缓冲区是池的最后一个持有者时，池在函数返回时随 self 一起销毁
+        const std::shared_ptr<StagingPool> self = std::move(owned->pool);
+        std::lock_guard<std::mutex> guard(self->lock);
+        self->pooledBytes += owned->capacity;
+        self->free.push_back(std::move(owned));
+        while (self->pooledBytes > self->maxPooledBytes && !self->free.empty()) {
+            auto smallest = std::min_element(self->free.begin(), self->free.end(),
+                    [](const std::unique_ptr<StagingBuffer>& a, const std::unique_ptr<StagingBuffer>& b) {
+                        return a->capacity < b->capacity;
+                    });
+            self->pooledBytes -= (*smallest)->capacity;
+            self->free.erase(smallest);
+        }
+    }
+};
+
+// ========================================
+// TextureUploader
+// ========================================
+
+TextureUploader::TextureUploader(Engine& engine, uint32_t threadCount, size_t maxPooledBytes)
+        : mEngine(engine), mPool(std::make_shared<StagingPool>()) {
+    mPool->maxPooledBytes = maxPooledBytes;
+    const uint32_t workers = resolveThreadCount(threadCount);
+    mWorkers.reserve(workers);
+    for (uint32_t i = 0; i < workers; i++) {
+        mWorkers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+TextureUploader::~TextureUploader() {
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        mStopping = true;
+    }
+    mWorkCondition.notify_all();
+    for (auto& worker : mWorkers) {
+        worker.join();
+    }
+    // 没有提交的请求不再上传，暂存缓冲区随请求释放。KTX2 的纹理在请求时已经创建，这里销毁
+    for (auto* queue : { &mWork, &mReady }) {
+        for (auto& request : *queue) {
+            if (request->async) {
+                mKtxReader->asyncDestroy(&request->async);
+                mEngine.destroy(request->texture);
+            }
+            if (request->decoded) {
+                stbi_image_free(request->decoded);
+            }
+            request->promise.set_value(nullptr);
+        }
+        queue->clear();
+    }
+}
+
+TextureFuture TextureUploader::enqueue(std::unique_ptr<Request> request, bool needsWorker) {
+    TextureFuture future = request->promise.get_future().share();
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        (needsWorker ? mWork : mReady).push_back(std::move(request));
+        mOutstanding++;
+        mStats.requested++;
+    }
+    if (needsWorker) {
+        mWorkCondition.notify_one();
+    }
+    return future;
+}
+
+TextureFuture TextureUploader::loadRGBA(const std::string& path, uint32_t width, uint32_t height) {
+    std::unique_ptr<Request> request(new Request());
+    request->kind = Request::Kind::RGBA_FILE;
+    request->path = path;
+    request->width = width;
+    request->height = height;
+    return enqueue(std::move(request), true);
+}
+
+TextureFuture TextureUploader::uploadRGBA(const uint8_t* pixels, size_t size, uint32_t width, uint32_t height) {
+    std::unique_ptr<Request> request(new Request());
+    request->kind = Request::Kind::RGBA_MEMORY;
+    request->width = width;
+    request->height = height;
+    request->data = pixels;
+    request->size = size;
+    if (size != rgbaSize(width, height)) {
+        std::cerr << "Texture size mismatch. Expected: " << rgbaSize(width, height)
+                  << ", Got: " << size << std::endl;
+        request->failed = true;
+    }
+    return enqueue(std::move(request), false);
+}
+
+TextureFuture TextureUploader::loadKtx2(const void* data, size_t size, bool srgb) {
+    TRACE_NAME("TextureUploader::loadKtx2");
+    if (!mKtxReader) {
+        mKtxReader.reset(new Ktx2Reader(mEngine, true));
+        for (Texture::InternalFormat format : KTX2_FORMATS) {
+            // 转码器没有编译进对应格式时返回 FORMAT_UNSUPPORTED，跳过即可
+            mKtxReader->requestFormat(format);
+        }
+    }
+
+    std::unique_ptr<Request> request(new Request());
+    request->kind = Request::Kind::KTX2;
+    request->size = size;
+    request->srgb = srgb;
+    request->async = mKtxReader->asyncCreate(data, size,
+            srgb ? Ktx2Reader::TransferFunction::sRGB : Ktx2Reader::TransferFunction::LINEAR);
+    if (!request->async) {
+        std::cerr << "Failed to create KTX2 texture (" << size << " bytes)" << std::endl;
+        request->failed = true;
+        return enqueue(std::move(request), false);
+    }
+    request->texture = request->async->getTexture();
+    mTranscoding.push_back(request.get());
+    return enqueue(std::move(request), true);
+}
+
+TextureFuture TextureUploader::decodeImage(const void* data, size_t size, bool srgb) {
+    std::unique_ptr<Request> request(new Request());
+    request->kind = Request::Kind::IMAGE;
+    request->data = static_cast<const uint8_t*>(data);
+    request->size = size;
+    request->srgb = srgb;
+    return enqueue(std::move(request), true);
+}
+
+void TextureUploader::workerLoop() {
+    for (;;) {
+        std::unique_ptr<Request> request;
+        {
+            std::unique_lock<std::mutex> lock(mLock);
+            mWorkCondition.wait(lock, [this]() { return mStopping || !mWork.empty(); });
+            if (mStopping) {
+                return;
+            }
+            request = std::move(mWork.front());
+            mWork.pop_front();
+        }
+        const auto start = std::chrono::steady_clock::now();
+        request->failed = request->kind == Request::Kind::RGBA_FILE ? !readFile(*request) : !decode(*request);
+        request->decodeMs = elapsedMs(start);
+        {
+            std::lock_guard<std::mutex> guard(mLock);
+            if (!request->failed && request->kind == Request::Kind::RGBA_FILE) {
+                mStats.bytesRead += rgbaSize(request->width, request->height);
+            }
+            mStats.decodeMs += request->decodeMs;
+            mReady.push_back(std::move(request));
+        }
+        mReadyCondition.notify_one();
+    }
+}
+
+bool TextureUploader::readFile(Request& request) {
+    TRACE_NAME("TextureUploader::read");
+    std::ifstream file(request.path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open texture file: " << request.path << std::endl;
+        return false;
+    }
+    const size_t size = rgbaSize(request.width, request.height);
+    const auto fileSize = size_t(file.tellg());
+    if (fileSize != size) {
+        std::cerr << "Texture file size mismatch. Expected: " << size
+                  << ", Got: " << fileSize << std::endl;
+        return false;
+    }
+    request.staging = StagingPool::acquire(mPool, size);
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(request.staging->data.get()), std::streamsize(size));
+    if (size_t(file.gcount()) != size) {
+        std::cerr << "Failed to read texture file: " << request.path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool TextureUploader::decode(Request& request) {
+    if (request.kind == Request::Kind::KTX2) {
+        TRACE_NAME("TextureUploader::transcode");
+        const Ktx2Reader::Result result = request.async->doTranscoding();
+        if (result != Ktx2Reader::Result::SUCCESS) {
+            std::cerr << "Failed to transcode KTX2 texture (" << request.size << " bytes)" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    TRACE_NAME("TextureUploader::decode");
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    request.decoded = stbi_load_from_memory(request.data, int(request.size), &width, &height, &channels, 4);
+    if (!request.decoded) {
+        std::cerr << "Failed to decode image (" << request.size << " bytes)" << std::endl;
+        return false;
+    }
+    request.width = uint32_t(width);
+    request.height = uint32_t(height);
+    return true;
+}
+
+Texture* TextureUploader::submit(Request& request) {
+    if (request.kind == Request::Kind::KTX2 && request.async) {
+        // 上传最后几个 mip 层级，之后 Async 只剩下原始数据的拷贝，可以释放
+        TRACE_NAME("TextureUploader::uploadImages");
+        request.async->uploadImages();
+        mKtxReader->asyncDestroy(&request.async);
+        mTranscoding.erase(std::find(mTranscoding.begin(), mTranscoding.end(), &request));
+        if (request.failed) {
+            mEngine.destroy(request.texture);
+            return nullptr;
+        }
+        return request.texture;
+    }
+    if (request.failed) {
+        return nullptr;
+    }
+
+    TRACE_NAME("TextureUploader::submit");
+    const size_t size = rgbaSize(request.width, request.height);
+    if (request.kind == Request::Kind::IMAGE) {
+        // levels 超出上限时 Builder 会截断到完整 mip 链的层数
+        Texture* texture = Texture::Builder()
+            .width(request.width)
+            .height(request.height)
+            .levels(0xff)
+            .format(request.srgb ? Texture::InternalFormat::SRGB8_A8 : Texture::InternalFormat::RGBA8)
+            .build(mEngine);
+        uint8_t* decoded = request.decoded;
+        request.decoded = nullptr;
+        texture->setImage(mEngine, 0, Texture::PixelBufferDescriptor(decoded, size,
+                Texture::Format::RGBA, Texture::Type::UBYTE,
+                [](void* buffer, size_t, void*) { stbi_image_free(buffer); }));
+        texture->generateMipmaps(mEngine);
+        return texture;
+    }
+
+    Texture* texture = Texture::Builder()
+        .width(request.width)
+        .height(request.height)
+        .levels(1)
+        .format(Texture::InternalFormat::RGBA8)
+        .build(mEngine);
+
+    if (request.staging) {
+        // 上传完成后回调把缓冲区还给池，缓冲区的所有权交给回调
+        StagingBuffer* staging = request.staging.release();
+        texture->setImage(mEngine, 0, Texture::PixelBufferDescriptor(staging->data.get(), size,
+                Texture::Format::RGBA, Texture::Type::UBYTE,
+                [](void*, size_t, void* user) { StagingPool::release(static_cast<StagingBuffer*>(user)); },
+                staging));
+    } else {
+        texture->setImage(mEngine, 0, Texture::PixelBufferDescriptor(request.data, size,
+                Texture::Format::RGBA, Texture::Type::UBYTE));
+    }
+    return texture;
+}
+
+size_t TextureUploader::pump() {
+    // 转码中的 KTX2 纹理先上传已经完成的 mip 层级，uploadImages() 可以和 doTranscoding() 同时进行
+    for (Request* request : mTranscoding) {
+        request->async->uploadImages();
+    }
+
+    std::deque<std::unique_ptr<Request>> ready;
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        ready.swap(mReady);
+    }
+    if (ready.empty()) {
+        return 0;
+    }
+
+    uint32_t uploaded = 0;
+    uint64_t bytesUploaded = 0;
+    for (auto& request : ready) {
+        Texture* texture = submit(*request);
+        if (texture) {
+            uploaded++;
+            bytesUploaded += request->kind == Request::Kind::KTX2 ? request->size
+                    : rgbaSize(request->width, request->height);
+        }
+        request->promise.set_value(texture);
+    }
+
+    std::lock_guard<std::mutex> guard(mLock);
+    mOutstanding -= ready.size();
+    mStats.uploaded += uploaded;
+    mStats.failed += uint32_t(ready.size()) - uploaded;
+    mStats.bytesUploaded += bytesUploaded;
+    return ready.size();
+}
+
+Texture* TextureUploader::wait(const TextureFuture& future) {
+    if (!future.valid()) {
+        return nullptr;
+    }
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        if (!pump()) {
+            std::unique_lock<std::mutex> lock(mLock);
+            mReadyCondition.wait(lock, [this]() { return !mReady.empty(); });
+        }
+    }
+    return future.get();
+}
+
+void TextureUploader::waitAll() {
+    for (;;) {
+        pump();
+        std::unique_lock<std::mutex> lock(mLock);
+        if (!mOutstanding) {
+            return;
+        }
+        mReadyCondition.wait(lock, [this]() { return !mReady.empty(); });
+    }
+}
+
+TextureUploadStats TextureUploader::getStats() const {
+    TextureUploadStats stats;
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        stats = mStats;
+    }
+    std::lock_guard<std::mutex> guard(mPool->lock);
+    stats.stagingAllocations = mPool->allocations;
+    stats.stagingReuses = mPool->reuses;
+    stats.pooledBytes = mPool->pooledBytes;
+    return stats;
+}
+
+Texture* createSolidTexture(Engine& engine, uint8_t r, uint8_t g, uint8_t b, uint8_t a, bool srgb) {
+    Texture* texture = Texture::Builder()
+        .width(1)
+        .height(1)
+        .levels(1)
+        .format(srgb ? Texture::InternalFormat::SRGB8_A8 : Texture::InternalFormat::RGBA8)
+        .build(engine);
+    uint8_t* pixel = new uint8_t[4]{ r, g, b, a };
+    texture->setImage(engine, 0, Texture::PixelBufferDescriptor(pixel, 4,
+            Texture::Format::RGBA, Texture::Type::UBYTE,
+            [](void* buffer, size_t, void*) { delete[] static_cast<uint8_t*>(buffer); }));
+    return texture;
+}
+
+// ========================================
+// TextureBindings
+// ========================================
+
+void TextureBindings::add(MaterialInstance* instance, const char* parameter, TextureFuture future,
+        Texture* placeholder, const TextureSampler& sampler) {
+    instance->setParameter(parameter, placeholder, sampler);
+    mBindings.push_back({ instance, parameter, std::move(future), placeholder, sampler });
+}
+
+size_t TextureBindings::update(Engine& engine, MemoryLedger* memory) {
+    size_t pending = 0;
+    for (Binding& binding : mBindings) {
+        if (!binding.pending) {
+            continue;
+        }
+        if (binding.future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            pending++;
+            continue;
+        }
+        binding.pending = false;
+        binding.texture = binding.future.get();
+        if (!binding.texture) {
+            continue;
+        }
+        // 占位纹理解除绑定后才能销毁
+        binding.instance->setParameter(binding.parameter, binding.texture, binding.sampler);
+        engine.destroy(binding.placeholder);
+        binding.placeholder = nullptr;
+        if (memory) {
+            memory->addTexture(binding.parameter, binding.texture);
+        }
+    }
+    return pending;
+}
+
+void TextureBindings::destroy(Engine& engine, MemoryLedger* memory) {
+    for (Binding& binding : mBindings) {
+        // 已经兑现但还没有绑定的纹理也归这里销毁；没有兑现的由 TextureUploader 析构时销毁
+        if (binding.pending && binding.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            if (Texture* texture = binding.future.get()) {
+                engine.destroy(texture);
+            }
+        }
+        if (binding.texture) {
+            if (memory) {
+                memory->remove(binding.texture);
+            }
+            engine.destroy(binding.texture);
+        }
+        if (binding.placeholder) {
+            engine.destroy(binding.placeholder);
+        }
+    }
+    mBindings.clear();
+}
+
+} // namespace demo
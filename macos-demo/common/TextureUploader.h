@@ -0,0 +1,166 @@
+#ifndef DEMO_COMMON_TEXTUREUPLOADER_H
+#define DEMO_COMMON_TEXTUREUPLOADER_H
+
+#include <filament/TextureSampler.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace filament {
+class Engine;
+class MaterialInstance;
+class Texture;
+}
+
+namespace ktxreader {
+class Ktx2Reader;
+}
+
+namespace demo {
+
+class MemoryLedger;
+
+// ========================================
+// 异步纹理上传
+// ========================================
+// 每张纹理原来都在引擎线程上同步读文件、new 一块像素缓冲区、上传后由回调 delete。
+// 加载几百张纹理时，读文件全部串行，缓冲区反复分配释放。TextureUploader 把这几步拆开：
+//
+//   1. loadRGBA() 把请求交给工作线程，立即返回一个 TextureFuture
+//   2. 工作线程从暂存缓冲区池取一块缓冲区，把文件读（解码）进去
+//   3. 引擎线程调用 pump()：创建 Texture，setImage() 提交暂存缓冲区，兑现 future。
+//      PixelBufferDescriptor 的回调在上传完成后把缓冲区还给池，下一张纹理直接复用
+//
+// Filament 的 Engine 不是线程安全的，Texture 的创建和 setImage() 只在调用 pump()/wait() 的线程上进行。
+// 暂存缓冲区池由上传中的缓冲区共同持有，TextureUploader 先于 Engine 销毁时，
+// Engine 之后释放的缓冲区仍然能安全地还回池里。析构时不访问 Engine，未完成的 future 兑现为 nullptr。
+//
+// 压缩纹理走同样的路径：loadKtx2() 在引擎线程上用 Ktx2Reader::asyncCreate() 创建 Texture 并选定格式，
+// 工作线程上 doTranscoding()，每次 pump() 都上传已经转码完成的 mip 层级；decodeImage() 在工作线程上
+// 用 stb_image 解码 PNG/JPEG，pump() 上传后生成 mip 链。有 KTX2 请求时 TextureUploader 必须先于 Engine 销毁。
+//
+// 与 Parallel.h 的一次性 parallelFor 不同，纹理请求在整个加载过程中陆续到达，这里使用常驻的工作线程。
+
+using TextureFuture = std::shared_future<filament::Texture*>;
+
+struct TextureUploadStats {
+    uint32_t requested = 0;
+    uint32_t uploaded = 0;
+    uint32_t failed = 0;
+    uint64_t bytesRead = 0;         // 工作线程从文件读入的字节数
+    uint64_t bytesUploaded = 0;     // setImage() 提交的字节数（包括直接引用的内存）
+    uint32_t stagingAllocations = 0;    // 新分配的暂存缓冲区数
+    uint32_t stagingReuses = 0;         // 从池中复用的次数
+    uint64_t pooledBytes = 0;           // 当前池中空闲缓冲区的总容量
+    double decodeMs = 0.0;              // 工作线程上读取、解码和转码的总耗时
+};
+
+class TextureUploader {
+public:
+    // threadCount 为 0 时使用全部硬件线程。池中空闲缓冲区的总容量超过 maxPooledBytes 时释放最小的缓冲区
+    explicit TextureUploader(filament::Engine& engine, uint32_t threadCount = 0,
+            size_t maxPooledBytes = 64u << 20);
+    ~TextureUploader();
+
+    TextureUploader(const TextureUploader&) = delete;
+    TextureUploader& operator=(const TextureUploader&) = delete;
+
+    // 在工作线程上读取原始 RGBA8 文件，文件大小必须等于 width * height * 4。失败时 future 兑现为 nullptr
+    TextureFuture loadRGBA(const std::string& path, uint32_t width, uint32_t height);
+
+    // 直接上传调用者的像素数据（例如资源包的映射内存），不经过工作线程和暂存缓冲区。
+    // pixels 必须比 Engine 活得更久
+    TextureFuture uploadRGBA(const uint8_t* pixels, size_t size, uint32_t width, uint32_t height);
+
+    // KTX2（Basis Universal）纹理，必须在引擎线程上调用。Ktx2Reader 会拷贝 data，调用后即可释放。
+    // 按 GPU 支持情况选择压缩格式（见 TextureUploader.cpp 中的 KTX2_FORMATS），都不支持时转码为 RGBA8
+    TextureFuture loadKtx2(const void* data, size_t size, bool srgb);
+
+    // stb_image 支持的图片（PNG、JPEG 等），解码为 RGBA8 并生成完整的 mip 链。data 必须保持到 future 兑现
+    TextureFuture decodeImage(const void* data, size_t size, bool srgb);
+
+    // 在引擎线程上提交所有已经读完的纹理，返回本次兑现的 future 数量
+    size_t pump();
+
+    // 反复 pump() 直到 future 兑现，返回纹理（失败时为 nullptr）
+    filament::Texture* wait(const TextureFuture& future);
+
+    // 等待所有已提交的请求完成
+    void waitAll();
+
+    TextureUploadStats getStats() const;
+
+private:
+    struct StagingPool;
+    struct StagingBuffer;
+    // 一个纹理请求，从工作队列经过读取/解码后进入就绪队列
+    struct Request;
+
+    TextureFuture enqueue(std::unique_ptr<Request> request, bool needsWorker);
+    void workerLoop();
+    bool readFile(Request& request);
+    bool decode(Request& request);
+    filament::Texture* submit(Request& request);
+
+    filament::Engine& mEngine;
+    std::shared_ptr<StagingPool> mPool;
+    std::vector<std::thread> mWorkers;
+    std::unique_ptr<ktxreader::Ktx2Reader> mKtxReader;     // 第一次 loadKtx2() 时创建
+    std::vector<Request*> mTranscoding;                     // 正在转码的 KTX2 请求，只在引擎线程上访问
+
+    mutable std::mutex mLock;
+    std::condition_variable mWorkCondition;
+    std::condition_variable mReadyCondition;
+    std::deque<std::unique_ptr<Request>> mWork;
+    std::deque<std::unique_ptr<Request>> mReady;
+    size_t mOutstanding = 0;    // 已请求但还没有兑现的数量
+    bool mStopping = false;
+    TextureUploadStats mStats;
+};
+
+// 1x1 的纯色纹理，在真正的贴图就绪之前绑定到材质，例如法线贴图用 (128, 128, 255)
+filament::Texture* createSolidTexture(filament::Engine& engine, uint8_t r, uint8_t g, uint8_t b,
+        uint8_t a, bool srgb);
+
+// ========================================
+// 逐步绑定的材质贴图
+// ========================================
+// 每个材质参数先绑定占位纹理，第一帧不必等待解码；future 兑现后换成真正的纹理并销毁占位纹理。
+// 加载失败的参数保留占位纹理
+class TextureBindings {
+public:
+    // placeholder 立即绑定到 instance 的 parameter，所有权交给 TextureBindings
+    void add(filament::MaterialInstance* instance, const char* parameter, TextureFuture future,
+            filament::Texture* placeholder, const filament::TextureSampler& sampler);
+
+    // 在引擎线程上调用（通常紧跟 TextureUploader::pump()），绑定已经就绪的纹理，返回还在等待的数量。
+    // memory 非空时以参数名登记绑定的纹理
+    size_t update(filament::Engine& engine, MemoryLedger* memory = nullptr);
+
+    // 销毁所有纹理。材质实例引用的纹理不能先销毁，要在销毁材质实例之后调用
+    void destroy(filament::Engine& engine, MemoryLedger* memory = nullptr);
+
+private:
+    struct Binding {
+        filament::MaterialInstance* instance;
+        const char* parameter;
+        TextureFuture future;
+        filament::Texture* placeholder;
+        filament::TextureSampler sampler;
+        filament::Texture* texture = nullptr;
+        bool pending = true;
+    };
+    std::vector<Binding> mBindings;
+};
+
+} // namespace demo
+
+#endif // DEMO_COMMON_TEXTUREUPLOADER_H
@@ -0,0 +1,265 @@
+#include "Trace.h"
+#include "JsonWriter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace demo {
+
+namespace {
+
+enum class EventType : uint8_t {
+    BEGIN,      // "B"
+    END,        // "E"
+    COUNTER,    // "C"
+    COMPLETE,   // "X"
+};
+
+struct Event {
+    int64_t timestamp;      // ns
+    int64_t arg;            // COUNTER: 数值；COMPLETE: 持续时间 (ns)
+    const char* name;
+    const char* track;      // 只有 COMPLETE 使用
+    EventType type;
+    TraceCategory category;
+};
+
+// 每个线程独占一个环形缓冲区：只有所属线程写入，导出时才由其他线程读取
+struct ThreadBuffer {
+    ThreadBuffer(uint32_t tid, size_t capacity)
+            : tid(tid), capacity(capacity), events(new Event[capacity]) {
+    }
+
+    void push(const Event& event) noexcept {
+        const uint64_t index = writeIndex.load(std::memory_order_relaxed);
+        events[index % capacity] = event;
+        writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    const uint32_t tid;
+    const size_t capacity;
+    std::unique_ptr<Event[]> events;
+    std::atomic<uint64_t> writeIndex{ 0 };
+    std::atomic<const char*> name{ nullptr };
+    ThreadBuffer* next = nullptr;   // 全局链表，只在头部插入
+};
+
+std::atomic<bool> gEnabled{ false };
+std::atomic<size_t> gCapacity{ 64 * 1024 };
+std::atomic<uint32_t> gNextTid{ 1 };
+std::atomic<ThreadBuffer*> gBuffers{ nullptr };
+
+// 线程第一次写入时分配缓冲区并无锁地挂到全局链表上。
+// 缓冲区在进程结束前不会释放，线程退出后它记录的事件仍然可以导出。
+ThreadBuffer* getThreadBuffer() noexcept {
+    thread_local ThreadBuffer* tBuffer = nullptr;
+    if (!tBuffer) {
+        tBuffer = new ThreadBuffer(gNextTid.fetch_add(1, std::memory_order_relaxed),
+                gCapacity.load(std::memory_order_relaxed));
+        ThreadBuffer* head = gBuffers.load(std::memory_order_relaxed);
+        do {
+            tBuffer->next = head;
+        } while (!gBuffers.compare_exchange_weak(head, tBuffer,
+                std::memory_order_release, std::memory_order_relaxed));
+    }
+    return tBuffer;
+}
+
+const char* categoryName(TraceCategory category) {
+    switch (category) {
+        case TraceCategory::DEMO:     return "demo";
+        case TraceCategory::FILAMENT: return "filament";
+    }
+    return "demo";
+}
+
+// 独立轨道（COMPLETE 事件）使用的虚拟线程号，从这里开始分配
+constexpr uint32_t TRACK_TID_BASE = 10000;
+
+} // anonymous namespace
+
+void Trace::start(size_t eventsPerThread) {
+    gCapacity.store(eventsPerThread ? eventsPerThread : 1, std::memory_order_relaxed);
+    gEnabled.store(true, std::memory_order_release);
+}
+
+void Trace::stop() {
+    gEnabled.store(false, std::memory_order_release);
+}
+
+bool Trace::isEnabled() noexcept {
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+void Trace::setThreadName(const char* name) {
+    getThreadBuffer()->name.store(name, std::memory_order_relaxed);
+}
+
+int64_t Trace::now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::begin(const char* name, TraceCategory category) noexcept {
+    getThreadBuffer()->push({ now(), 0, name, nullptr, EventType::BEGIN, category });
+}
+
+void Trace::end(TraceCategory category) noexcept {
+    getThreadBuffer()->push({ now(), 0, nullptr, nullptr, EventType::END, category });
+}
+
+void Trace::counter(const char* name, int64_t value) noexcept {
+    getThreadBuffer()->push({ now(), value, name, nullptr, EventType::COUNTER, TraceCategory::DEMO });
+}
+
+void Trace::complete(const char* name, const char* track, int64_t startNs, int64_t durationNs,
+        TraceCategory category) noexcept {
+    getThreadBuffer()->push({ startNs, durationNs, name, track, EventType::COMPLETE, category });
+}
+
+void Trace::clear() {
+    for (ThreadBuffer* b = gBuffers.load(std::memory_order_acquire); b; b = b->next) {
+        b->writeIndex.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool Trace::writeChromeJson(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open trace file: " << path << std::endl;
+        return false;
+    }
+
+    // Chrome trace 的时间单位是微秒
+    auto toUs = [](int64_t ns) { return double(ns) / 1000.0; };
+    const int pid = 1;
+    std::vector<const char*> tracks;
+
+    JsonWriter json(file);
+    json.beginObject();
+    json.key("displayTimeUnit").value("ms");
+    json.key("traceEvents").beginArray();
+
+    for (ThreadBuffer* b = gBuffers.load(std::memory_order_acquire); b; b = b->next) {
+        const uint64_t written = b->writeIndex.load(std::memory_order_acquire);
+        const uint64_t count = std::min<uint64_t>(written, b->capacity);
+        const uint64_t first = written - count;
+
+        if (const char* name = b->name.load(std::memory_order_relaxed)) {
+            json.beginObject();
+            json.key("ph").value("M");
+            json.key("name").value("thread_name");
+            json.key("pid").value(pid);
+            json.key("tid").value(b->tid);
+            json.key("args").beginObject().key("name").value(name).endObject();
+            json.endObject();
+        }
+
+        // 环形缓冲区覆盖后，开头可能出现没有对应 BEGIN 的 END，跳过它们
+        int depth = 0;
+        for (uint64_t i = first; i < written; i++) {
+            const Event& e = b->events[i % b->capacity];
+            switch (e.type) {
+                case EventType::BEGIN:
+                    depth++;
+                    json.beginObject();
+                    json.key("ph").value("B");
+                    json.key("name").value(e.name);
+                    json.key("cat").value(categoryName(e.category));
+                    json.key("ts").value(toUs(e.timestamp));
+                    json.key("pid").value(pid);
+                    json.key("tid").value(b->tid);
+                    json.endObject();
+                    break;
+                case EventType::END:
+                    if (depth == 0) {
+                        break;
+                    }
+                    depth--;
+                    json.beginObject();
+                    json.key("ph").value("E");
+                    json.key("ts").value(toUs(e.timestamp));
+                    json.key("pid").value(pid);
+                    json.key("tid").value(b->tid);
+                    json.endObject();
+                    break;
+                case EventType::COUNTER:
+                    json.beginObject();
+                    json.key("ph").value("C");
+                    json.key("name").value(e.name);
+                    json.key("ts").value(toUs(e.timestamp));
+                    json.key("pid").value(pid);
+                    json.key("args").beginObject().key("value").value(e.arg).endObject();
+                    json.endObject();
+                    break;
+                case EventType::COMPLETE: {
+                    size_t track = 0;
+                    while (track < tracks.size() && tracks[track] != e.track) {
+                        track++;
+                    }
+                    if (track == tracks.size()) {
+                        tracks.push_back(e.track);
+                    }
+                    json.beginObject();
+                    json.key("ph").value("X");
+                    json.key("name").value(e.name);
+                    json.key("cat").value(categoryName(e.category));
+                    json.key("ts").value(toUs(e.timestamp));
+                    json.key("dur").value(toUs(e.arg));
+                    json.key("pid").value(pid);
+                    json.key("tid").value(TRACK_TID_BASE + uint32_t(track));
+                    json.endObject();
+                    break;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < tracks.size(); i++) {
+        json.beginObject();
+        json.key("ph").value("M");
+        json.key("name").value("thread_name");
+        json.key("pid").value(pid);
+        json.key("tid").value(TRACK_TID_BASE + uint32_t(i));
+        json.key("args").beginObject().key("name").value(tracks[i]).endObject();
+        json.endObject();
+    }
+
+    json.endArray();
+    json.endObject();
+    file << std::endl;
+    return file.good();
+}
+
+// ========================================
+// TraceSession
+// ========================================
+
+TraceSession::TraceSession()
+        : TraceSession(std::getenv("DEMO_TRACE") ? std::getenv("DEMO_TRACE") : "") {
+}
+
+TraceSession::TraceSession(std::string path) : mPath(std::move(path)) {
+    if (!mPath.empty()) {
+        Trace::setThreadName("main");
+        Trace::start();
+    }
+}
+
+TraceSession::~TraceSession() {
+    if (mPath.empty()) {
+        return;
+    }
+    Trace::stop();
+    if (Trace::writeChromeJson(mPath)) {
+        std::cerr << "Trace written to " << mPath << std::endl;
+    }
+}
+
+} // namespace demo
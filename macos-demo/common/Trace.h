@@ -0,0 +1,129 @@
+#ifndef DEMO_COMMON_TRACE_H
+#define DEMO_COMMON_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ========================================
+// 进程内的 Chrome/Perfetto trace 记录器
+// ========================================
+// utils/Systrace.h 在 Linux（以及默认配置的 macOS）上全部展开为空宏，
+// 预编译的 filament 库里的 SYSTRACE 区间无法导出。这里提供一套同样用法的宏，
+// 记录 demo 自己的阶段（事件处理、动画更新、beginFrame/render/endFrame、资源加载），
+// 输出 Chrome JSON trace，可以直接拖进 chrome://tracing 或 ui.perfetto.dev 查看。
+//
+// 每个线程写入自己的环形缓冲区，写入路径没有锁；缓冲区写满后覆盖最旧的事件。
+// 事件名必须是字符串常量（只保存指针），与 SYSTRACE_NAME 的约定一致。
+//
+// 用法：
+//   demo::TraceSession traceSession;       // 设置了 DEMO_TRACE=out.json 时开始记录，析构时写文件
+//   TRACE_CALL();                          // 记录当前函数
+//   TRACE_NAME("Renderer::render");        // 记录到当前作用域结束
+//   TRACE_NAME_BEGIN("load"); ... TRACE_NAME_END();
+//   TRACE_VALUE64("textureBytes", bytes);  // 计数器轨道
+
+namespace demo {
+
+// 事件分类，对应 Chrome trace 的 "cat" 字段
+enum class TraceCategory : uint8_t {
+    DEMO,       // demo 主循环和场景搭建
+    FILAMENT,   // 从 Renderer::getFrameInfoHistory() 还原的 filament 后端帧
+};
+
+class Trace {
+public:
+    // 开始记录，eventsPerThread 为每个线程环形缓冲区的容量
+    static void start(size_t eventsPerThread = 64 * 1024);
+    // 停止记录，已经记录的事件保留到 clear()
+    static void stop();
+    static bool isEnabled() noexcept;
+
+    // 当前线程在 trace 中显示的名字（name 必须是字符串常量）
+    static void setThreadName(const char* name);
+
+    static void begin(const char* name, TraceCategory category = TraceCategory::DEMO) noexcept;
+    static void end(TraceCategory category = TraceCategory::DEMO) noexcept;
+    static void counter(const char* name, int64_t value) noexcept;
+
+    // 记录一个已知起止时间的区间，显示在名为 track 的独立轨道上（track 必须是字符串常量）
+    // 时间戳使用 now() 的时间基准，单位纳秒
+    static void complete(const char* name, const char* track, int64_t startNs, int64_t durationNs,
+            TraceCategory category = TraceCategory::FILAMENT) noexcept;
+
+    // trace 使用的时钟：steady_clock 纳秒
+    static int64_t now() noexcept;
+
+    // 导出为 Chrome JSON trace（应在 stop() 之后、或其他线程不再写入时调用）
+    static bool writeChromeJson(const std::string& path);
+    // 丢弃所有已记录的事件
+    static void clear();
+};
+
+// 作用域区间，由 TRACE_NAME / TRACE_CALL 使用
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) noexcept : mActive(Trace::isEnabled()) {
+        if (mActive) {
+            Trace::begin(name);
+        }
+    }
+    ~TraceScope() noexcept {
+        if (mActive) {
+            Trace::end();
+        }
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    bool mActive;
+};
+
+// 从环境变量 DEMO_TRACE 读取输出路径：设置了就在构造时开始记录，析构时写出文件
+class TraceSession {
+public:
+    TraceSession();
+    explicit TraceSession(std::string path);
+    ~TraceSession();
+    TraceSession(const TraceSession&) = delete;
+    TraceSession& operator=(const TraceSession&) = delete;
+
+private:
+    std::string mPath;
+};
+
+} // namespace demo
+
+#ifndef DEMO_TRACE_ENABLED
+#define DEMO_TRACE_ENABLED 1
+#endif
+
+#if DEMO_TRACE_ENABLED
+
+#define DEMO_TRACE_CONCAT_(a, b) a##b
+#define DEMO_TRACE_CONCAT(a, b) DEMO_TRACE_CONCAT_(a, b)
+
+#define TRACE_NAME(name) ::demo::TraceScope DEMO_TRACE_CONCAT(__demo_trace_, __LINE__)(name)
+#define TRACE_CALL() TRACE_NAME(__func__)
+#define TRACE_NAME_BEGIN(name) \
+    do { if (::demo::Trace::isEnabled()) ::demo::Trace::begin(name); } while (0)
+#define TRACE_NAME_END() \
+    do { if (::demo::Trace::isEnabled()) ::demo::Trace::end(); } while (0)
+#define TRACE_VALUE32(name, val) \
+    do { if (::demo::Trace::isEnabled()) ::demo::Trace::counter(name, int64_t(int32_t(val))); } while (0)
+#define TRACE_VALUE64(name, val) \
+    do { if (::demo::Trace::isEnabled()) ::demo::Trace::counter(name, int64_t(val)); } while (0)
+
+#else
+
+#define TRACE_NAME(name)
+#define TRACE_CALL()
+#define TRACE_NAME_BEGIN(name)
+#define TRACE_NAME_END()
+#define TRACE_VALUE32(name, val)
+#define TRACE_VALUE64(name, val)
+
+#endif // DEMO_TRACE_ENABLED
+
+#endif // DEMO_COMMON_TRACE_H
@@ -0,0 +1,251 @@
+#include "VertexPacker.h"
+#include "Trace.h"
+
+#include <geometry/SurfaceOrientation.h>
+#include <geometry/Transcoder.h>
+
+#include <math/half.h>
+#include <math/mat3.h>
+#include <math/norm.h>
+#include <math/quat.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+using namespace filament;
+using namespace filament::math;
+using filament::geometry::ComponentType;
+using filament::geometry::SurfaceOrientation;
+using filament::geometry::Transcoder;
+
+namespace demo {
+
+namespace {
+
+constexpr float SNORM16_STEP = 1.0f / 32767.0f;
+constexpr float UNORM16_STEP = 1.0f / 65535.0f;
+
+template<typename T>
+void store(uint8_t* vertex, uint32_t offset, const T& value) {
+    std::memcpy(vertex + offset, &value, sizeof(T));
+}
+
+// half 在 |v| 附近的舍入误差上限（半个 ULP，10 位尾数）
+float halfRoundingBound(float magnitude) {
+    if (magnitude < 6.1035156e-05f) {       // 非规格化数，ULP 固定为 2^-24
+        return std::ldexp(1.0f, -25);
+    }
+    return std::ldexp(1.0f, int(std::floor(std::log2(magnitude))) - 11);
+}
+
+// 用 Transcoder 把交错缓冲区中的一个属性解回紧密排列的 float
+std::vector<float> decodeAttribute(const PackedVertices& packed, uint32_t offset, ComponentType type,
+        bool normalized, uint32_t componentCount) {
+    std::vector<float> decoded(size_t(packed.vertexCount) * componentCount);
+    const Transcoder transcode({ type, normalized, componentCount, packed.stride });
+    transcode(decoded.data(), packed.data.data() + offset, packed.vertexCount);
+    return decoded;
+}
+
+} // anonymous namespace
+
+void PackedVertices::applyLayout(VertexBuffer::Builder& builder, uint8_t bufferIndex) const {
+    for (const PackedAttribute& attribute : attributes) {
+        builder.attribute(attribute.attribute, bufferIndex, attribute.type, attribute.offset, uint8_t(stride));
+        if (attribute.normalized) {
+            builder.normalized(attribute.attribute, true);
+        }
+    }
+}
+
+bool packVertices(const VertexPackInput& input, const VertexPackOptions& options, PackedVertices& out) {
+    TRACE_CALL();
+    if (!input.positions || input.vertexCount == 0 ||
+            input.vertexCount > std::numeric_limits<uint32_t>::max()) {
+        std::cerr << "Cannot pack vertices: positions are missing" << std::endl;
+        return false;
+    }
+    const size_t vertexCount = input.vertexCount;
+    out = {};
+    out.vertexCount = uint32_t(vertexCount);
+    out.position = options.position;
+    out.uv = options.uv;
+
+    // USHORT2 只能表示 [0, 1]，UV 超出范围（平铺贴图）时退回 HALF2
+    float uvMagnitude = 0.0f;
+    if (input.uvs) {
+        bool unitRange = true;
+        for (size_t i = 0; i < vertexCount; i++) {
+            const float2 uv = input.uvs[i];
+            unitRange = unitRange && uv.x >= 0.0f && uv.x <= 1.0f && uv.y >= 0.0f && uv.y <= 1.0f;
+            uvMagnitude = std::max({ uvMagnitude, std::abs(uv.x), std::abs(uv.y) });
+        }
+        if (out.uv == UvPacking::USHORT2 && !unitRange) {
+            out.uv = UvPacking::HALF2;
+        }
+    }
+
+    // 布局：位置 | 切线四元数 | UV，全部 4 字节对齐
+    uint32_t offset = 0;
+    const uint32_t positionOffset = offset;
+    switch (out.position) {
+        case PositionPacking::FLOAT3:
+            out.attributes.push_back({ VertexAttribute::POSITION, VertexBuffer::AttributeType::FLOAT3, offset, false });
+            offset += sizeof(float3);
+            break;
+        case PositionPacking::HALF4:
+            out.attributes.push_back({ VertexAttribute::POSITION, VertexBuffer::AttributeType::HALF4, offset, false });
+            offset += sizeof(half4);
+            break;
+        case PositionPacking::SHORT4:
+            out.attributes.push_back({ VertexAttribute::POSITION, VertexBuffer::AttributeType::SHORT4, offset, true });
+            offset += sizeof(short4);
+            break;
+    }
+    const uint32_t tangentOffset = offset;
+    if (input.normals) {
+        out.attributes.push_back({ VertexAttribute::TANGENTS, VertexBuffer::AttributeType::SHORT4, offset, true });
+        offset += sizeof(short4);
+    }
+    const uint32_t uvOffset = offset;
+    if (input.uvs) {
+        switch (out.uv) {
+            case UvPacking::FLOAT2:
+                out.attributes.push_back({ VertexAttribute::UV0, VertexBuffer::AttributeType::FLOAT2, offset, false });
+                offset += sizeof(float2);
+                break;
+            case UvPacking::HALF2:
+                out.attributes.push_back({ VertexAttribute::UV0, VertexBuffer::AttributeType::HALF2, offset, false });
+                offset += sizeof(half2);
+                break;
+            case UvPacking::USHORT2:
+                out.attributes.push_back({ VertexAttribute::UV0, VertexBuffer::AttributeType::USHORT2, offset, true });
+                offset += sizeof(ushort2);
+                break;
+        }
+    }
+    out.stride = offset;
+    out.data.resize(vertexCount * out.stride);
+
+    // 位置相对 AABB：平移到中心，按最大半边长统一缩放
+    float3 minimum = input.positions[0];
+    float3 maximum = input.positions[0];
+    for (size_t i = 1; i < vertexCount; i++) {
+        minimum = min(minimum, input.positions[i]);
+        maximum = max(maximum, input.positions[i]);
+    }
+    const float3 center = (minimum + maximum) * 0.5f;
+    const float3 halfExtent = (maximum - minimum) * 0.5f;
+    float scale = std::max({ halfExtent.x, halfExtent.y, halfExtent.z });
+    if (!(scale > 0.0f)) {
+        scale = 1.0f;   // 所有顶点重合
+    }
+    if (out.position == PositionPacking::FLOAT3) {
+        out.decode = mat4f();
+        out.bounds = Box().set(minimum, maximum);
+    } else {
+        out.decode = mat4f::translation(center) * mat4f::scaling(scale);
+        out.bounds = Box().set(-halfExtent / scale, halfExtent / scale);
+    }
+
+    for (size_t i = 0; i < vertexCount; i++) {
+        uint8_t* vertex = out.data.data() + i * out.stride;
+        const float3 p = (input.positions[i] - center) / scale;
+        switch (out.position) {
+            case PositionPacking::FLOAT3:
+                store(vertex, positionOffset, input.positions[i]);
+                break;
+            case PositionPacking::HALF4:
+                store(vertex, positionOffset, half4(float4(p, 1.0f)));
+                break;
+            case PositionPacking::SHORT4:
+                store(vertex, positionOffset, packSnorm16(float4(p, 1.0f)));
+                break;
+        }
+        if (input.uvs) {
+            const float2 uv = input.uvs[i];
+            switch (out.uv) {
+                case UvPacking::FLOAT2:
+                    store(vertex, uvOffset, uv);
+                    break;
+                case UvPacking::HALF2:
+                    store(vertex, uvOffset, half2(uv));
+                    break;
+                case UvPacking::USHORT2:
+                    store(vertex, uvOffset, ushort2{ packUnorm16(uv.x), packUnorm16(uv.y) });
+                    break;
+            }
+        }
+    }
+
+    if (input.normals) {
+        SurfaceOrientation::Builder builder;
+        builder.vertexCount(vertexCount).normals(input.normals);
+        if (input.tangents) {
+            builder.tangents(input.tangents);
+        } else if (input.uvs && input.triangles && input.triangleCount) {
+            builder.uvs(input.uvs)
+                    .positions(input.positions)
+                    .triangleCount(input.triangleCount)
+                    .triangles(input.triangles);
+        }
+        SurfaceOrientation* orientation = builder.build();
+        if (!orientation) {
+            std::cerr << "Cannot pack vertices: incomplete tangent frame data" << std::endl;
+            return false;
+        }
+        orientation->getQuats(reinterpret_cast<short4*>(out.data.data() + tangentOffset), vertexCount,
+                out.stride);
+        delete orientation;
+    }
+
+    // ========================================
+    // 误差：用 Transcoder 解回 float 与输入比较
+    // ========================================
+    VertexPackStats& stats = out.stats;
+    stats.packedStride = out.stride;
+    stats.floatStride = uint32_t(sizeof(float3) + (input.normals ? sizeof(float4) : 0) +
+            (input.uvs ? sizeof(float2) : 0));
+
+    if (out.position != PositionPacking::FLOAT3) {
+        const bool snorm = out.position == PositionPacking::SHORT4;
+        const std::vector<float> decoded = decodeAttribute(out, positionOffset,
+                snorm ? ComponentType::SHORT : ComponentType::HALF, snorm, 4);
+        for (size_t i = 0; i < vertexCount; i++) {
+            const float3 p = center + float3{ decoded[i * 4], decoded[i * 4 + 1], decoded[i * 4 + 2] } * scale;
+            const float3 error = abs(p - input.positions[i]);
+            stats.positionError = std::max({ stats.positionError, error.x, error.y, error.z });
+        }
+        stats.positionBound = scale * (snorm ? SNORM16_STEP * 0.5f : halfRoundingBound(1.0f));
+    }
+
+    if (input.uvs && out.uv != UvPacking::FLOAT2) {
+        const bool unorm = out.uv == UvPacking::USHORT2;
+        const std::vector<float> decoded = decodeAttribute(out, uvOffset,
+                unorm ? ComponentType::USHORT : ComponentType::HALF, unorm, 2);
+        for (size_t i = 0; i < vertexCount; i++) {
+            stats.uvError = std::max({ stats.uvError, std::abs(decoded[i * 2] - input.uvs[i].x),
+                    std::abs(decoded[i * 2 + 1] - input.uvs[i].y) });
+        }
+        stats.uvBound = unorm ? UNORM16_STEP * 0.5f : halfRoundingBound(uvMagnitude);
+    }
+
+    if (input.normals) {
+        const std::vector<float> decoded = decodeAttribute(out, tangentOffset, ComponentType::SHORT, true, 4);
+        float minCosine = 1.0f;
+        for (size_t i = 0; i < vertexCount; i++) {
+            const quatf q = normalize(quatf{ decoded[i * 4 + 3], decoded[i * 4], decoded[i * 4 + 1],
+                    decoded[i * 4 + 2] });
+            const float3 normal = mat3f(q)[2];
+            const float3 expected = normalize(input.normals[i]);
+            minCosine = std::min(minCosine, dot(normal, expected));
+        }
+        stats.normalErrorDegrees = std::acos(std::clamp(minCosine, -1.0f, 1.0f)) * float(180.0 / M_PI);
+    }
+    return true;
+}
+
+} // namespace demo
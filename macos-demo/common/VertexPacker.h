@@ -0,0 +1,98 @@
+#ifndef DEMO_COMMON_VERTEXPACKER_H
+#define DEMO_COMMON_VERTEXPACKER_H
+
+#include <filament/Box.h>
+#include <filament/VertexBuffer.h>
+
+#include <math/mat4.h>
+#include <math/vec2.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace demo {
+
+// ========================================
+// 顶点属性量化打包
+// ========================================
+// 示例里手写的网格按 float 上传（例如 02-cube-map 的 { float3 position; float2 uv; }，20 字节），
+// geometry::Transcoder 只能把压缩格式解回 float。packVertices() 做相反的方向，输出一个交错缓冲区：
+//
+//   位置   SHORT4（归一化）或 HALF4，相对网格 AABB：中心平移到原点、按最大半边长缩放到 [-1, 1]，
+//          decode 矩阵把打包空间变回模型空间，乘在实体变换的右边；各轴使用同一个缩放，法线不受影响
+//   切线   有法线时用 geometry::SurfaceOrientation 生成 short4 四元数（TANGENTS，归一化），
+//          切线来自输入的 tangents，或者由 UV + 三角形按 Lengyel 的方法计算
+//   UV     USHORT2（归一化，UV 必须都在 [0, 1] 内，否则退回 HALF2）或 HALF2
+//
+// 打包后用 geometry::Transcoder 把每个属性解回 float，与输入比较得到实测的最大误差，
+// 位置和 UV 同时给出量化的理论误差上限；法线误差是解码的四元数法线与输入法线的最大夹角。
+
+enum class PositionPacking : uint8_t {
+    FLOAT3,     // 不量化，decode 为单位矩阵
+    HALF4,
+    SHORT4,
+};
+
+enum class UvPacking : uint8_t {
+    FLOAT2,
+    HALF2,
+    USHORT2,
+};
+
+struct VertexPackOptions {
+    PositionPacking position = PositionPacking::SHORT4;
+    UvPacking uv = UvPacking::USHORT2;
+};
+
+// 输入的顶点属性，除 positions 外都可以为空
+struct VertexPackInput {
+    size_t vertexCount = 0;
+    const filament::math::float3* positions = nullptr;
+    const filament::math::float2* uvs = nullptr;
+    const filament::math::float3* normals = nullptr;    // 非空时输出 TANGENTS
+    const filament::math::float4* tangents = nullptr;   // w 的符号决定副切线方向
+    size_t triangleCount = 0;
+    const filament::math::uint3* triangles = nullptr;   // 没有 tangents 时与 uvs 一起计算切线
+};
+
+struct PackedAttribute {
+    filament::VertexAttribute attribute;
+    filament::VertexBuffer::AttributeType type;
+    uint32_t offset;
+    bool normalized;
+};
+
+struct VertexPackStats {
+    uint32_t floatStride = 0;       // 同样的属性都用 float 存储时的步长（TANGENTS 按 FLOAT4 计）
+    uint32_t packedStride = 0;
+    float positionError = 0.0f;     // 解码后位置各分量的最大误差（模型空间单位）
+    float positionBound = 0.0f;     // 量化的理论误差上限（模型空间单位）
+    float uvError = 0.0f;
+    float uvBound = 0.0f;
+    float normalErrorDegrees = 0.0f;
+};
+
+struct PackedVertices {
+    std::vector<uint8_t> data;      // vertexCount * stride 字节
+    uint32_t vertexCount = 0;
+    uint32_t stride = 0;
+    std::vector<PackedAttribute> attributes;
+    PositionPacking position = PositionPacking::FLOAT3;
+    UvPacking uv = UvPacking::FLOAT2;  // 实际使用的格式（USHORT2 可能退回 HALF2）
+    filament::math::mat4f decode;   // 打包空间到模型空间
+    filament::Box bounds;           // 打包空间中的包围盒，交给 RenderableManager::Builder
+    VertexPackStats stats;
+
+    // 在 builder 的 bufferIndex 号缓冲区上声明所有属性（包括 normalized 标志）
+    void applyLayout(filament::VertexBuffer::Builder& builder, uint8_t bufferIndex = 0) const;
+};
+
+// 失败（没有位置、SurfaceOrientation 缺少数据）时打印原因并返回 false
+bool packVertices(const VertexPackInput& input, const VertexPackOptions& options, PackedVertices& out);
+
+} // namespace demo
+
+#endif // DEMO_COMMON_VERTEXPACKER_H
@@ -0,0 +1,189 @@
+#include "Scenes.h"
+#include "../MemoryLedger.h"
+#include "../StartupProfiler.h"
+#include "../VertexPacker.h"
+
+#include "../EmbeddedResources.h"
+
+#include <filament/Camera.h>
+#include <filament/IndexBuffer.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/Scene.h>
+#include <filament/Texture.h>
+#include <filament/TextureSampler.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+
+#include <utils/EntityManager.h>
+
+#include <vector>
+
+using namespace filament;
+using namespace filament::math;
+using utils::Entity;
+
+namespace demo {
+
+namespace {
+
+struct Vertex {
+    float3 position;
+    float2 uv;
+};
+
+static const Vertex CUBE_VERTICES[24] = {
+    // 前面 (Z = 0.5)
+    {{-0.5, -0.5,  0.5}, {0, 0}}, {{ 0.5, -0.5,  0.5}, {1, 0}},
+    {{ 0.5,  0.5,  0.5}, {1, 1}}, {{-0.5,  0.5,  0.5}, {0, 1}},
+    // 后面 (Z = -0.5)
+    {{-0.5, -0.5, -0.5}, {0, 0}}, {{ 0.5, -0.5, -0.5}, {1, 0}},
+    {{ 0.5,  0.5, -0.5}, {1, 1}}, {{-0.5,  0.5, -0.5}, {0, 1}},
+    // 右面 (X = 0.5)
+    {{ 0.5, -0.5, -0.5}, {0, 0}}, {{ 0.5, -0.5,  0.5}, {1, 0}},
+    {{ 0.5,  0.5,  0.5}, {1, 1}}, {{ 0.5,  0.5, -0.5}, {0, 1}},
+    // 左面 (X = -0.5)
+    {{-0.5, -0.5, -0.5}, {0, 0}}, {{-0.5, -0.5,  0.5}, {1, 0}},
+    {{-0.5,  0.5,  0.5}, {1, 1}}, {{-0.5,  0.5, -0.5}, {0, 1}},
+    // 上面 (Y = 0.5)
+    {{-0.5,  0.5, -0.5}, {0, 0}}, {{ 0.5,  0.5, -0.5}, {1, 0}},
+    {{ 0.5,  0.5,  0.5}, {1, 1}}, {{-0.5,  0.5,  0.5}, {0, 1}},
+    // 下面 (Y = -0.5)
+    {{-0.5, -0.5, -0.5}, {0, 0}}, {{ 0.5, -0.5, -0.5}, {1, 0}},
+    {{ 0.5, -0.5,  0.5}, {1, 1}}, {{-0.5, -0.5,  0.5}, {0, 1}},
+};
+
+static const uint16_t CUBE_INDICES[36] = {
+    0, 1, 2,  0, 2, 3,
+    4, 5, 6,  4, 6, 7,
+    8, 9, 10,  8, 10, 11,
+    12, 13, 14,  12, 14, 15,
+    16, 17, 18,  16, 18, 19,
+    20, 21, 22,  20, 22, 23,
+};
+
+// 02-cube-map：使用 BAKEDTEXTURE 材质和 200x200 RGBA 纹理的立方体
+class CubeMapScene : public DemoScene {
+public:
+    const char* getName() const noexcept override { return "02-cube-map"; }
+
+    bool setup(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+
+        // 位置量化为 SHORT4、UV 量化为 USHORT2，每个顶点 12 字节（float 布局 20 字节）
+        float3 positions[24];
+        float2 uvs[24];
+        for (size_t i = 0; i < 24; i++) {
+            positions[i] = CUBE_VERTICES[i].position;
+            uvs[i] = CUBE_VERTICES[i].uv;
+        }
+        VertexPackInput input;
+        input.vertexCount = 24;
+        input.positions = positions;
+        input.uvs = uvs;
+        PackedVertices packed;
+        if (!packVertices(input, {}, packed)) {
+            return false;
+        }
+        mDecode = packed.decode;
+        VertexBuffer::Builder vertexBuilder;
+        vertexBuilder.vertexCount(24).bufferCount(1);
+        packed.applyLayout(vertexBuilder);
+        mVertexBuffer = vertexBuilder.build(engine);
+        // 打包结果的所有权交给上传完成回调
+        auto* vertices = new std::vector<uint8_t>(std::move(packed.data));
+        mVertexBuffer->setBufferAt(engine, 0, VertexBuffer::BufferDescriptor(vertices->data(), vertices->size(),
+                [](void*, size_t, void* user) { delete static_cast<std::vector<uint8_t>*>(user); }, vertices));
+
+        mIndexBuffer = IndexBuffer::Builder()
+            .indexCount(36)
+            .bufferType(IndexBuffer::IndexType::USHORT)
+            .build(engine);
+        mIndexBuffer->setBuffer(engine,
+                IndexBuffer::BufferDescriptor(CUBE_INDICES, sizeof(CUBE_INDICES), nullptr));
+        if (ctx.memory) {
+            ctx.memory->addVertexBuffer("cube", mVertexBuffer, size_t(packed.stride) * 24);
+            ctx.memory->addIndexBuffer("cube", mIndexBuffer, IndexBuffer::IndexType::USHORT);
+        }
+
+        StartupStep textureStep(ctx.profiler, "loadRGBATexture", "texture", 200 * 200 * 4);
+        mTexture = loadRGBATexture(ctx, "rgba8_200x200.rgba", 200, 200);
+        textureStep.end(mTexture != nullptr);
+        if (!mTexture) {
+            return false;
+        }
+        if (ctx.memory) {
+            ctx.memory->addTexture("rgba8_200x200", mTexture);
+        }
+
+        mMaterial = buildMaterial(ctx, ACQUIRE_RESOURCE(RESOURCES, BAKEDTEXTURE), "bakedtexture");
+        if (!mMaterial) {
+            return false;
+        }
+
+        TextureSampler sampler(TextureSampler::MinFilter::LINEAR, TextureSampler::MagFilter::LINEAR);
+        sampler.setWrapModeS(TextureSampler::WrapMode::CLAMP_TO_EDGE);
+        sampler.setWrapModeT(TextureSampler::WrapMode::CLAMP_TO_EDGE);
+        MaterialInstance* materialInstance = mMaterial->getDefaultInstance();
+        materialInstance->setParameter("albedo", mTexture, sampler);
+
+        mRenderable = utils::EntityManager::get().create();
+        RenderableManager::Builder(1)
+            .boundingBox(packed.bounds)
+            .material(0, materialInstance)
+            .geometry(0, RenderableManager::PrimitiveType::TRIANGLES, mVertexBuffer, mIndexBuffer)
+            .culling(false)
+            .receiveShadows(false)
+            .castShadows(false)
+            .build(engine, mRenderable);
+        ctx.scene->addEntity(mRenderable);
+        auto& tcm = engine.getTransformManager();
+        tcm.setTransform(tcm.getInstance(mRenderable), mDecode);
+
+        ctx.camera->setProjection(45.0, double(ctx.width) / double(ctx.height), 0.1, 100.0);
+        ctx.camera->setModelMatrix(mat4f::translation(float3{ 0, 0, 3 }));
+        return true;
+    }
+
+    void update(SceneContext& ctx, float time) override {
+        auto& tcm = ctx.engine->getTransformManager();
+        tcm.setTransform(tcm.getInstance(mRenderable), twoPhaseRotation(time) * mDecode);
+    }
+
+    void teardown(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+        if (ctx.memory) {
+            ctx.memory->remove(mVertexBuffer);
+            ctx.memory->remove(mIndexBuffer);
+            ctx.memory->remove(mTexture);
+            ctx.memory->remove(mMaterial);
+        }
+        if (mRenderable) {
+            ctx.scene->remove(mRenderable);
+            engine.destroy(mRenderable);
+            utils::EntityManager::get().destroy(mRenderable);
+            mRenderable = {};
+        }
+        if (mMaterial)     { engine.destroy(mMaterial);     mMaterial = nullptr; }
+        if (mTexture)      { engine.destroy(mTexture);      mTexture = nullptr; }
+        if (mVertexBuffer) { engine.destroy(mVertexBuffer); mVertexBuffer = nullptr; }
+        if (mIndexBuffer)  { engine.destroy(mIndexBuffer);  mIndexBuffer = nullptr; }
+    }
+
+private:
+    VertexBuffer* mVertexBuffer = nullptr;
+    IndexBuffer* mIndexBuffer = nullptr;
+    Texture* mTexture = nullptr;
+    Material* mMaterial = nullptr;
+    Entity mRenderable;
+    mat4f mDecode;                      // 量化位置解回模型空间，乘在旋转的右边
+};
+
+} // anonymous namespace
+
+std::unique_ptr<DemoScene> createCubeMapScene() {
+    return std::make_unique<CubeMapScene>();
+}
+
+} // namespace demo
@@ -0,0 +1,142 @@
+#include "Scenes.h"
+#include "../MappedMesh.h"
+#include "../MemoryLedger.h"
+#include "../ObjImporter.h"
+#include "../PackFile.h"
+#include "../StartupProfiler.h"
+
+#include "../EmbeddedResources.h"
+
+#include <filament/Camera.h>
+#include <filament/IndexBuffer.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/Scene.h>
+#include <filament/Skybox.h>
+#include <filament/Texture.h>
+#include <filament/TextureSampler.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+
+#include <filameshio/MeshReader.h>
+
+#include <utils/EntityManager.h>
+
+#include <iostream>
+
+using namespace filament;
+using namespace filament::math;
+using namespace filamesh;
+
+namespace demo {
+
+namespace {
+
+// 02-cube-obj：从 filamesh 文件加载的立方体，使用 BAKEDTEXTURE 材质
+class CubeObjScene : public DemoScene {
+public:
+    const char* getName() const noexcept override { return "02-cube-obj"; }
+
+    bool setup(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+
+        mMaterial = buildMaterial(ctx, ACQUIRE_RESOURCE(RESOURCES, BAKEDTEXTURE), "bakedtexture");
+        if (!mMaterial) {
+            return false;
+        }
+        MaterialInstance* materialInstance = mMaterial->getDefaultInstance();
+
+        // 文件映射直接交给 MeshReader，上传完成后在回调中解除映射；
+        // 资源包中有 cube.filamesh 时直接使用包内数据。filameshPath 是 OBJ 时先导入（命中缓存时只计算哈希）
+        const bool fromPack = ctx.pack && ctx.pack->find("cube.filamesh");
+        std::string meshPath = ctx.filameshPath;
+        if (!fromPack) {
+            StartupStep importStep(ctx.profiler, "resolveMeshPath", "mesh");
+            meshPath = resolveMeshPath(ctx.filameshPath);
+            importStep.end(!meshPath.empty());
+            if (meshPath.empty()) {
+                return false;
+            }
+        }
+        StartupStep meshStep(ctx.profiler, "loadMappedMesh", "mesh");
+        MappedMesh mapped = fromPack
+                ? loadMappedMesh(engine, *ctx.pack, "cube.filamesh", materialInstance)
+                : loadMappedMesh(engine, meshPath, materialInstance);
+        meshStep.end(mapped.isValid());
+        if (!mapped.isValid()) {
+            return false;
+        }
+        mMesh = mapped.mesh;
+        if (ctx.memory) {
+            ctx.memory->addVertexBuffer("cube.filamesh", mMesh.vertexBuffer, mapped.vertexBytes);
+            ctx.memory->addIndexBuffer("cube.filamesh", mMesh.indexBuffer, mapped.indexType);
+        }
+
+        StartupStep textureStep(ctx.profiler, "loadRGBATexture", "texture", 200 * 200 * 4);
+        mTexture = loadRGBATexture(ctx, "rgba8_200x200.rgba", 200, 200);
+        textureStep.end(mTexture != nullptr);
+        if (mTexture) {
+            if (ctx.memory) {
+                ctx.memory->addTexture("rgba8_200x200", mTexture);
+            }
+            TextureSampler sampler(TextureSampler::MinFilter::LINEAR, TextureSampler::MagFilter::LINEAR);
+            sampler.setWrapModeS(TextureSampler::WrapMode::CLAMP_TO_EDGE);
+            sampler.setWrapModeT(TextureSampler::WrapMode::CLAMP_TO_EDGE);
+            materialInstance->setParameter("albedo", mTexture, sampler);
+        }
+
+        ctx.scene->addEntity(mMesh.renderable);
+
+        mSkybox = Skybox::Builder().color({0.1, 0.1, 0.2, 1.0}).build(engine);
+        ctx.scene->setSkybox(mSkybox);
+
+        ctx.camera->setProjection(45.0, double(ctx.width) / double(ctx.height), 0.1, 100.0);
+        ctx.camera->setModelMatrix(mat4f::translation(float3{ 0, 0, 3 }));
+        return true;
+    }
+
+    void update(SceneContext& ctx, float time) override {
+        auto& tcm = ctx.engine->getTransformManager();
+        tcm.setTransform(tcm.getInstance(mMesh.renderable), twoPhaseRotation(time));
+    }
+
+    void teardown(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+        if (ctx.memory) {
+            ctx.memory->remove(mMesh.vertexBuffer);
+            ctx.memory->remove(mMesh.indexBuffer);
+            ctx.memory->remove(mTexture);
+            ctx.memory->remove(mMaterial);
+        }
+        if (mMesh.renderable) {
+            ctx.scene->remove(mMesh.renderable);
+            engine.destroy(mMesh.renderable);
+            utils::EntityManager::get().destroy(mMesh.renderable);
+            mMesh.renderable = {};
+        }
+        if (mMesh.vertexBuffer) { engine.destroy(mMesh.vertexBuffer); mMesh.vertexBuffer = nullptr; }
+        if (mMesh.indexBuffer)  { engine.destroy(mMesh.indexBuffer);  mMesh.indexBuffer = nullptr; }
+        if (mTexture)  { engine.destroy(mTexture);  mTexture = nullptr; }
+        if (mMaterial) { engine.destroy(mMaterial); mMaterial = nullptr; }
+        if (mSkybox) {
+            ctx.scene->setSkybox(nullptr);
+            engine.destroy(mSkybox);
+            mSkybox = nullptr;
+        }
+    }
+
+private:
+    MeshReader::Mesh mMesh;
+    Material* mMaterial = nullptr;
+    Texture* mTexture = nullptr;
+    Skybox* mSkybox = nullptr;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<DemoScene> createCubeObjScene() {
+    return std::make_unique<CubeObjScene>();
+}
+
+} // namespace demo
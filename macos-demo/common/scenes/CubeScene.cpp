@@ -0,0 +1,174 @@
+#include "Scenes.h"
+#include "../MemoryLedger.h"
+
+#include <filament/Camera.h>
+#include <filament/IndexBuffer.h>
+#include <filament/Material.h>
+#include <filament/RenderableManager.h>
+#include <filament/Scene.h>
+#include <filament/Skybox.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+
+#include <utils/EntityManager.h>
+
+using namespace filament;
+using namespace filament::math;
+using utils::Entity;
+
+namespace demo {
+
+namespace {
+
+// 与 02-cube 相同的预编译材质
+static constexpr uint8_t BAKED_COLOR_PACKAGE[] = {
+#include "../../01-triangle/bakedColor.inc"
+};
+
+struct Vertex {
+    float3 position;
+    uint32_t color;   // 0xAARRGGBB
+};
+
+// 每个面 4 个独立顶点，保证每个面都是纯色
+static const Vertex CUBE_VERTICES[24] = {
+    // 前面 (红色)
+    {{-0.5f, -0.5f,  0.5f}, 0xffff0000u},
+    {{ 0.5f, -0.5f,  0.5f}, 0xffff0000u},
+    {{ 0.5f,  0.5f,  0.5f}, 0xffff0000u},
+    {{-0.5f,  0.5f,  0.5f}, 0xffff0000u},
+    // 后面 (绿色)
+    {{-0.5f, -0.5f, -0.5f}, 0xff00ff00u},
+    {{ 0.5f, -0.5f, -0.5f}, 0xff00ff00u},
+    {{ 0.5f,  0.5f, -0.5f}, 0xff00ff00u},
+    {{-0.5f,  0.5f, -0.5f}, 0xff00ff00u},
+    // 左面 (蓝色)
+    {{-0.5f, -0.5f, -0.5f}, 0xff0000ffu},
+    {{-0.5f, -0.5f,  0.5f}, 0xff0000ffu},
+    {{-0.5f,  0.5f,  0.5f}, 0xff0000ffu},
+    {{-0.5f,  0.5f, -0.5f}, 0xff0000ffu},
+    // 右面 (黄色)
+    {{ 0.5f, -0.5f, -0.5f}, 0xffffff00u},
+    {{ 0.5f, -0.5f,  0.5f}, 0xffffff00u},
+    {{ 0.5f,  0.5f,  0.5f}, 0xffffff00u},
+    {{ 0.5f,  0.5f, -0.5f}, 0xffffff00u},
+    // 下面 (紫色)
+    {{-0.5f, -0.5f, -0.5f}, 0xffff00ffu},
+    {{ 0.5f, -0.5f, -0.5f}, 0xffff00ffu},
+    {{ 0.5f, -0.5f,  0.5f}, 0xffff00ffu},
+    {{-0.5f, -0.5f,  0.5f}, 0xffff00ffu},
+    // 上面 (青色)
+    {{-0.5f,  0.5f, -0.5f}, 0xff00ffffu},
+    {{ 0.5f,  0.5f, -0.5f}, 0xff00ffffu},
+    {{ 0.5f,  0.5f,  0.5f}, 0xff00ffffu},
+    {{-0.5f,  0.5f,  0.5f}, 0xff00ffffu},
+};
+
+static constexpr uint16_t CUBE_INDICES[36] = {
+    0, 1, 2,  0, 2, 3,
+    4, 6, 5,  4, 7, 6,
+    8, 9, 10,  8, 10, 11,
+    12, 14, 13,  12, 15, 14,
+    16, 17, 18,  16, 18, 19,
+    20, 22, 21,  20, 23, 22
+};
+
+// 02-cube：先绕 X 轴倾斜、再绕 Y 轴旋转的六色立方体
+class CubeScene : public DemoScene {
+public:
+    const char* getName() const noexcept override { return "02-cube"; }
+
+    bool setup(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+
+        mSkybox = Skybox::Builder().color({0.1, 0.125, 0.25, 1.0}).build(engine);
+        ctx.scene->setSkybox(mSkybox);
+
+        mVertexBuffer = VertexBuffer::Builder()
+            .vertexCount(24)
+            .bufferCount(1)
+            .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3, 0, 16)
+            .attribute(VertexAttribute::COLOR, 0, VertexBuffer::AttributeType::UBYTE4, 12, 16)
+            .normalized(VertexAttribute::COLOR)
+            .build(engine);
+        mVertexBuffer->setBufferAt(engine, 0,
+                VertexBuffer::BufferDescriptor(CUBE_VERTICES, sizeof(CUBE_VERTICES), nullptr));
+
+        mIndexBuffer = IndexBuffer::Builder()
+            .indexCount(36)
+            .bufferType(IndexBuffer::IndexType::USHORT)
+            .build(engine);
+        mIndexBuffer->setBuffer(engine,
+                IndexBuffer::BufferDescriptor(CUBE_INDICES, sizeof(CUBE_INDICES), nullptr));
+        if (ctx.memory) {
+            ctx.memory->addVertexBuffer("cube", mVertexBuffer, sizeof(CUBE_VERTICES));
+            ctx.memory->addIndexBuffer("cube", mIndexBuffer, IndexBuffer::IndexType::USHORT);
+        }
+
+        mMaterial = buildMaterial(ctx,
+                BAKED_COLOR_PACKAGE, sizeof(BAKED_COLOR_PACKAGE), "bakedcolor");
+        if (!mMaterial) {
+            return false;
+        }
+
+        mRenderable = utils::EntityManager::get().create();
+        RenderableManager::Builder(1)
+            .boundingBox({{ -1, -1, -1 }, { 1, 1, 1 }})
+            .material(0, mMaterial->getDefaultInstance())
+            .geometry(0, RenderableManager::PrimitiveType::TRIANGLES, mVertexBuffer, mIndexBuffer, 0, 36)
+            .culling(false)
+            .receiveShadows(false)
+            .castShadows(false)
+            .build(engine, mRenderable);
+        ctx.scene->addEntity(mRenderable);
+
+        ctx.camera->setProjection(45.0, double(ctx.width) / double(ctx.height), 0.1, 100.0);
+        ctx.camera->setModelMatrix(mat4f::translation(float3{ 0, 0.3, 3 }));
+        return true;
+    }
+
+    void update(SceneContext& ctx, float time) override {
+        auto& tcm = ctx.engine->getTransformManager();
+        const mat4f initialTilt = mat4f::rotation(0.3f, float3{ 1, 0, 0 });
+        const mat4f rotation = mat4f::rotation(time, float3{ 0, 1, 0 });
+        tcm.setTransform(tcm.getInstance(mRenderable), rotation * initialTilt);
+    }
+
+    void teardown(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+        if (ctx.memory) {
+            ctx.memory->remove(mVertexBuffer);
+            ctx.memory->remove(mIndexBuffer);
+            ctx.memory->remove(mMaterial);
+        }
+        if (mRenderable) {
+            ctx.scene->remove(mRenderable);
+            engine.destroy(mRenderable);
+            utils::EntityManager::get().destroy(mRenderable);
+            mRenderable = {};
+        }
+        if (mMaterial)     { engine.destroy(mMaterial);     mMaterial = nullptr; }
+        if (mVertexBuffer) { engine.destroy(mVertexBuffer); mVertexBuffer = nullptr; }
+        if (mIndexBuffer)  { engine.destroy(mIndexBuffer);  mIndexBuffer = nullptr; }
+        if (mSkybox) {
+            ctx.scene->setSkybox(nullptr);
+            engine.destroy(mSkybox);
+            mSkybox = nullptr;
+        }
+    }
+
+private:
+    Skybox* mSkybox = nullptr;
+    VertexBuffer* mVertexBuffer = nullptr;
+    IndexBuffer* mIndexBuffer = nullptr;
+    Material* mMaterial = nullptr;
+    Entity mRenderable;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<DemoScene> createCubeScene() {
+    return std::make_unique<CubeScene>();
+}
+
+} // namespace demo
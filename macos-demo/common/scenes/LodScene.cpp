@@ -0,0 +1,224 @@
+#include "Scenes.h"
+#include "../MemoryLedger.h"
+#include "../MeshLod.h"
+#include "../ObjImporter.h"
+#include "../StartupProfiler.h"
+
+#include "../EmbeddedResources.h"
+
+#include <filament/Camera.h>
+#include <filament/Color.h>
+#include <filament/IndexBuffer.h>
+#include <filament/LightManager.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/Scene.h>
+#include <filament/Skybox.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+
+#include <filameshio/MeshReader.h>
+
+#include <utils/EntityManager.h>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using namespace filament;
+using namespace filament::math;
+using namespace filamesh;
+using utils::Entity;
+
+namespace demo {
+
+namespace {
+
+// 网格的实例排成 GRID_SIZE x GRID_SIZE 的方阵，每个实例缩放到单位半径，间距 SPACING
+constexpr int GRID_SIZE = 8;
+constexpr float SPACING = 3.0f;
+// 相机在 CAMERA_PERIOD 秒内从方阵边缘退到远处再回来
+constexpr float CAMERA_PERIOD = 20.0f;
+constexpr float CAMERA_NEAR = 2.0f;
+constexpr float CAMERA_FAR = 80.0f;
+
+// lod:<path>：一个网格的 LOD 链（见 common/MeshLod.h）铺成方阵，相机来回推拉，
+// LodSelector 每帧按屏幕误差切换各实例绘制的索引区间。lod-off:<path> 场景完全相同但总是画第 0 级，用于对比。
+// path 可以是 .obj（由 ObjImporter 导入）或 filamesh；文件里没有 LOD 表时加载时生成
+class LodScene : public DemoScene {
+public:
+    LodScene(const std::string& path, bool enabled)
+            : mPath(path), mName((enabled ? "lod:" : "lod-off:") + path), mEnabled(enabled) {}
+
+    const char* getName() const noexcept override { return mName.c_str(); }
+
+    bool setup(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+
+        mSkybox = Skybox::Builder().color({0.1, 0.125, 0.25, 1.0}).build(engine);
+        ctx.scene->setSkybox(mSkybox);
+
+        StartupStep importStep(ctx.profiler, "resolveMeshPath", "mesh");
+        const std::string meshPath = resolveMeshPath(mPath);
+        importStep.end(!meshPath.empty());
+        if (meshPath.empty()) {
+            return false;
+        }
+        // 文件数据交给 MeshReader 上传，上传完成后在回调中释放
+        auto* file = new std::vector<uint8_t>();
+        {
+            std::ifstream in(meshPath, std::ios::binary);
+            if (!in) {
+                std::cerr << "Failed to open filamesh file: " << meshPath << std::endl;
+                delete file;
+                return false;
+            }
+            file->assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        LodTable table;
+        if (!readFilameshLods(file->data(), file->size(), table)) {
+            StartupStep lodStep(ctx.profiler, "appendFilameshLods", "mesh", file->size());
+            const bool built = appendFilameshLods(*file, LodOptions{}) &&
+                    readFilameshLods(file->data(), file->size(), table);
+            lodStep.end(built);
+            if (!built) {
+                std::cerr << "Failed to build LOD chain: " << meshPath << std::endl;
+                delete file;
+                return false;
+            }
+        }
+
+        mMaterial = buildMaterial(ctx, ACQUIRE_RESOURCE(RESOURCES, AIDEFAULTMAT), "aidefaultmat");
+        if (!mMaterial) {
+            delete file;
+            return false;
+        }
+        mMaterialInstance = mMaterial->createInstance();
+        mMaterialInstance->setParameter("baseColor", RgbType::sRGB, float3{ 0.8f, 0.75f, 0.7f });
+        mMaterialInstance->setParameter("metallic", 0.0f);
+        mMaterialInstance->setParameter("roughness", 0.5f);
+        mMaterialInstance->setParameter("reflectance", 0.5f);
+
+        StartupStep meshStep(ctx.profiler, "MeshReader::loadMeshFromBuffer", "mesh", file->size());
+        MeshReader::Mesh mesh = MeshReader::loadMeshFromBuffer(&engine, file->data(),
+                [](void*, size_t, void* user) { delete static_cast<std::vector<uint8_t>*>(user); },
+                file, mMaterialInstance);
+        meshStep.end(!mesh.renderable.isNull());
+        if (!mesh.renderable) {
+            return false;
+        }
+        mVertexBuffer = mesh.vertexBuffer;
+        mIndexBuffer = mesh.indexBuffer;
+        if (ctx.memory) {
+            ctx.memory->addFilamesh(mPath, file->data(), mVertexBuffer, mIndexBuffer);
+        }
+
+        // MeshReader 的实体只用来取包围盒，方阵中的实例共享它的顶点/索引缓冲区
+        auto& rcm = engine.getRenderableManager();
+        auto& tcm = engine.getTransformManager();
+        const Box bounds = rcm.getAxisAlignedBoundingBox(rcm.getInstance(mesh.renderable));
+        engine.destroy(mesh.renderable);
+        utils::EntityManager::get().destroy(mesh.renderable);
+        const float radius = std::max(length(bounds.halfExtent), 1e-6f);
+        const mat4f unitScale = mat4f::scaling(1.0f / radius) * mat4f::translation(-bounds.center);
+
+        const float gridOffset = (GRID_SIZE - 1) * SPACING * 0.5f;
+        for (int row = 0; row < GRID_SIZE; row++) {
+            for (int column = 0; column < GRID_SIZE; column++) {
+                const Entity entity = utils::EntityManager::get().create();
+                RenderableManager::Builder builder(table.partCount);
+                builder.boundingBox(bounds).culling(true).castShadows(false).receiveShadows(false);
+                for (uint32_t part = 0; part < table.partCount; part++) {
+                    const LodLevel& lod = table.part(part)[0];
+                    builder.geometry(part, RenderableManager::PrimitiveType::TRIANGLES,
+                            mVertexBuffer, mIndexBuffer, lod.offset, lod.indexCount);
+                    builder.material(part, mMaterialInstance);
+                }
+                builder.build(engine, entity);
+                tcm.setTransform(tcm.getInstance(entity), mat4f::translation(float3{
+                        column * SPACING - gridOffset, 0.0f, -row * SPACING }) * unitScale);
+                ctx.scene->addEntity(entity);
+                mSelector.add(entity, mVertexBuffer, mIndexBuffer, table.levels.data(), table.partCount,
+                        table.levelCount, bounds);
+                mInstances.push_back(entity);
+            }
+        }
+
+        mLight = utils::EntityManager::get().create();
+        LightManager::Builder(LightManager::Type::SUN)
+            .color(Color::toLinear<ACCURATE>(sRGBColor(0.98f, 0.92f, 0.89f)))
+            .intensity(110000.0f)
+            .direction({ 0.7f, -1.0f, -0.8f })
+            .sunAngularRadius(1.9f)
+            .castShadows(false)
+            .build(engine, mLight);
+        ctx.scene->addEntity(mLight);
+
+        ctx.camera->setProjection(45.0, double(ctx.width) / double(ctx.height), 0.1, 200.0);
+        return true;
+    }
+
+    void update(SceneContext& ctx, float time) override {
+        // 相机先就位，选择器按这一帧的相机计算屏幕误差
+        const float phase = 0.5f - 0.5f * std::cos(time * 2.0f * float(M_PI) / CAMERA_PERIOD);
+        const float distance = CAMERA_NEAR + (CAMERA_FAR - CAMERA_NEAR) * phase;
+        ctx.camera->lookAt(float3{ 0.0f, 2.0f, distance }, float3{ 0.0f, 0.0f, distance - 10.0f },
+                float3{ 0.0f, 1.0f, 0.0f });
+        if (mEnabled) {
+            mSelector.update(*ctx.engine, *ctx.camera, ctx.height);
+        }
+    }
+
+    void teardown(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+        if (ctx.memory) {
+            ctx.memory->remove(mVertexBuffer);
+            ctx.memory->remove(mIndexBuffer);
+            ctx.memory->remove(mMaterial);
+        }
+        mSelector.clear();
+        for (Entity entity : mInstances) {
+            ctx.scene->remove(entity);
+            engine.destroy(entity);
+            utils::EntityManager::get().destroy(entity);
+        }
+        mInstances.clear();
+        if (mVertexBuffer) { engine.destroy(mVertexBuffer); mVertexBuffer = nullptr; }
+        if (mIndexBuffer)  { engine.destroy(mIndexBuffer);  mIndexBuffer = nullptr; }
+        if (mLight) {
+            ctx.scene->remove(mLight);
+            engine.destroy(mLight);
+            utils::EntityManager::get().destroy(mLight);
+            mLight = {};
+        }
+        if (mMaterialInstance) { engine.destroy(mMaterialInstance); mMaterialInstance = nullptr; }
+        if (mMaterial)         { engine.destroy(mMaterial);         mMaterial = nullptr; }
+        if (mSkybox) {
+            ctx.scene->setSkybox(nullptr);
+            engine.destroy(mSkybox);
+            mSkybox = nullptr;
+        }
+    }
+
+private:
+    std::string mPath;
+    std::string mName;
+    bool mEnabled;
+    Skybox* mSkybox = nullptr;
+    VertexBuffer* mVertexBuffer = nullptr;
+    IndexBuffer* mIndexBuffer = nullptr;
+    Material* mMaterial = nullptr;
+    MaterialInstance* mMaterialInstance = nullptr;
+    std::vector<Entity> mInstances;
+    LodSelector mSelector;
+    Entity mLight;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<DemoScene> createLodScene(const std::string& path, bool enabled) {
+    return std::make_unique<LodScene>(path, enabled);
+}
+
+} // namespace demo
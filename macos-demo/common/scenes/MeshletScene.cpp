@@ -0,0 +1,244 @@
+#include "Scenes.h"
+#include "../MemoryLedger.h"
+#include "../Meshlet.h"
+#include "../ObjImporter.h"
+#include "../StartupProfiler.h"
+
+#include "../EmbeddedResources.h"
+
+#include <filament/Camera.h>
+#include <filament/Color.h>
+#include <filament/IndexBuffer.h>
+#include <filament/LightManager.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/Scene.h>
+#include <filament/Skybox.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+
+#include <filameshio/MeshReader.h>
+
+#include <utils/EntityManager.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using namespace filament;
+using namespace filament::math;
+using namespace filamesh;
+using utils::Entity;
+
+namespace demo {
+
+namespace {
+
+// 剔除结果轮流写入 INDEX_BUFFER_COUNT 个索引缓冲区，避免覆盖 GPU 还在读的那一个
+constexpr size_t INDEX_BUFFER_COUNT = 3;
+// 相机在 CAMERA_PERIOD 秒内绕网格转一圈，离中心 CAMERA_DISTANCE（网格缩放到单位半径），
+// 靠得足够近，总有一部分网格在视锥外
+constexpr float CAMERA_PERIOD = 12.0f;
+constexpr float CAMERA_DISTANCE = 1.1f;
+
+// meshlet:<path>：网格切成簇（见 common/Meshlet.h），每帧在 CPU 上按视锥和法线锥剔除，
+// 留下的簇的索引上传到一个索引缓冲区再画。meshlet-off:<path> 场景完全相同但画完整的索引缓冲区，用于对比。
+// path 可以是 .obj（由 ObjImporter 导入）或未压缩的 filamesh
+class MeshletScene : public DemoScene {
+public:
+    MeshletScene(const std::string& path, bool enabled)
+            : mPath(path), mName((enabled ? "meshlet:" : "meshlet-off:") + path), mEnabled(enabled) {}
+
+    const char* getName() const noexcept override { return mName.c_str(); }
+
+    bool setup(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+
+        mSkybox = Skybox::Builder().color({0.1, 0.125, 0.25, 1.0}).build(engine);
+        ctx.scene->setSkybox(mSkybox);
+
+        StartupStep importStep(ctx.profiler, "resolveMeshPath", "mesh");
+        const std::string meshPath = resolveMeshPath(mPath);
+        importStep.end(!meshPath.empty());
+        if (meshPath.empty()) {
+            return false;
+        }
+        // 文件数据交给 MeshReader 上传，上传完成后在回调中释放
+        auto* file = new std::vector<uint8_t>();
+        {
+            std::ifstream in(meshPath, std::ios::binary);
+            if (!in) {
+                std::cerr << "Failed to open filamesh file: " << meshPath << std::endl;
+                delete file;
+                return false;
+            }
+            file->assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        // 簇要在 MeshReader 接管文件数据之前建好
+        StartupStep meshletStep(ctx.profiler, "buildFilameshMeshlets", "mesh", file->size());
+        const bool built = buildFilameshMeshlets(file->data(), file->size(), MeshletOptions{}, mMeshlets);
+        meshletStep.end(built);
+        if (!built) {
+            std::cerr << "Failed to build meshlets: " << meshPath << std::endl;
+            delete file;
+            return false;
+        }
+
+        mMaterial = buildMaterial(ctx, ACQUIRE_RESOURCE(RESOURCES, AIDEFAULTMAT), "aidefaultmat");
+        if (!mMaterial) {
+            delete file;
+            return false;
+        }
+        mMaterialInstance = mMaterial->createInstance();
+        mMaterialInstance->setParameter("baseColor", RgbType::sRGB, float3{ 0.8f, 0.75f, 0.7f });
+        mMaterialInstance->setParameter("metallic", 0.0f);
+        mMaterialInstance->setParameter("roughness", 0.5f);
+        mMaterialInstance->setParameter("reflectance", 0.5f);
+
+        StartupStep meshStep(ctx.profiler, "MeshReader::loadMeshFromBuffer", "mesh", file->size());
+        MeshReader::Mesh mesh = MeshReader::loadMeshFromBuffer(&engine, file->data(),
+                [](void*, size_t, void* user) { delete static_cast<std::vector<uint8_t>*>(user); },
+                file, mMaterialInstance);
+        meshStep.end(!mesh.renderable.isNull());
+        if (!mesh.renderable) {
+            return false;
+        }
+        mRenderable = mesh.renderable;
+        mVertexBuffer = mesh.vertexBuffer;
+        mIndexBuffer = mesh.indexBuffer;
+        if (ctx.memory) {
+            ctx.memory->addFilamesh(mPath, file->data(), mVertexBuffer, mIndexBuffer);
+        }
+
+        if (mEnabled) {
+            for (auto& buffer : mCulledBuffers) {
+                buffer = IndexBuffer::Builder()
+                    .indexCount(uint32_t(std::max<size_t>(mMeshlets.indices.size(), 3)))
+                    .bufferType(IndexBuffer::IndexType::UINT)
+                    .build(engine);
+                if (ctx.memory) {
+                    ctx.memory->addIndexBuffer(mPath, buffer, IndexBuffer::IndexType::UINT);
+                }
+            }
+        }
+
+        auto& rcm = engine.getRenderableManager();
+        auto& tcm = engine.getTransformManager();
+        const Box bounds = rcm.getAxisAlignedBoundingBox(rcm.getInstance(mRenderable));
+        const float radius = std::max(length(bounds.halfExtent), 1e-6f);
+        mModel = mat4f::scaling(1.0f / radius) * mat4f::translation(-bounds.center);
+        tcm.setTransform(tcm.getInstance(mRenderable), mModel);
+        ctx.scene->addEntity(mRenderable);
+
+        mLight = utils::EntityManager::get().create();
+        LightManager::Builder(LightManager::Type::SUN)
+            .color(Color::toLinear<ACCURATE>(sRGBColor(0.98f, 0.92f, 0.89f)))
+            .intensity(110000.0f)
+            .direction({ 0.7f, -1.0f, -0.8f })
+            .sunAngularRadius(1.9f)
+            .castShadows(false)
+            .build(engine, mLight);
+        ctx.scene->addEntity(mLight);
+
+        ctx.camera->setProjection(45.0, double(ctx.width) / double(ctx.height), 0.05, 20.0);
+        return true;
+    }
+
+    void update(SceneContext& ctx, float time) override {
+        const float angle = time * 2.0f * float(M_PI) / CAMERA_PERIOD;
+        const float3 eye{ CAMERA_DISTANCE * std::sin(angle), 0.3f * std::sin(angle * 2.0f),
+                CAMERA_DISTANCE * std::cos(angle) };
+        ctx.camera->lookAt(eye, float3{ 0.0f, 0.2f, 0.0f }, float3{ 0.0f, 1.0f, 0.0f });
+        if (!mEnabled) {
+            return;
+        }
+
+        // 视锥和相机位置都变到模型空间，簇的包围盒不用逐帧变换
+        Engine& engine = *ctx.engine;
+        const mat4f viewProjection = mat4f(ctx.camera->getCullingProjectionMatrix() * ctx.camera->getViewMatrix());
+        const float4 modelEye = inverse(mModel) * float4(eye, 1.0f);
+        auto* output = new std::vector<uint32_t>(mMeshlets.indices.size());
+        const size_t count = mCuller.cull(mMeshlets, viewProjection * mModel, modelEye.xyz, output->data(), mRanges);
+
+        // 剔除结果交给上传完成回调释放
+        IndexBuffer* buffer = mCulledBuffers[mFrame++ % INDEX_BUFFER_COUNT];
+        if (count == 0) {
+            delete output;
+        } else {
+            buffer->setBuffer(engine, IndexBuffer::BufferDescriptor(output->data(), count * sizeof(uint32_t),
+                    [](void*, size_t, void* user) { delete static_cast<std::vector<uint32_t>*>(user); }, output));
+        }
+        auto& rcm = engine.getRenderableManager();
+        const auto instance = rcm.getInstance(mRenderable);
+        for (size_t part = 0; part < mRanges.size(); part++) {
+            rcm.setGeometryAt(instance, part, RenderableManager::PrimitiveType::TRIANGLES, mVertexBuffer, buffer,
+                    mRanges[part].offset, mRanges[part].indexCount);
+        }
+    }
+
+    void teardown(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+        if (ctx.memory) {
+            ctx.memory->remove(mVertexBuffer);
+            ctx.memory->remove(mIndexBuffer);
+            for (IndexBuffer* buffer : mCulledBuffers) {
+                ctx.memory->remove(buffer);
+            }
+            ctx.memory->remove(mMaterial);
+        }
+        if (mRenderable) {
+            ctx.scene->remove(mRenderable);
+            engine.destroy(mRenderable);
+            utils::EntityManager::get().destroy(mRenderable);
+            mRenderable = {};
+        }
+        for (IndexBuffer*& buffer : mCulledBuffers) {
+            if (buffer) { engine.destroy(buffer); buffer = nullptr; }
+        }
+        if (mVertexBuffer) { engine.destroy(mVertexBuffer); mVertexBuffer = nullptr; }
+        if (mIndexBuffer)  { engine.destroy(mIndexBuffer);  mIndexBuffer = nullptr; }
+        if (mLight) {
+            ctx.scene->remove(mLight);
+            engine.destroy(mLight);
+            utils::EntityManager::get().destroy(mLight);
+            mLight = {};
+        }
+        if (mMaterialInstance) { engine.destroy(mMaterialInstance); mMaterialInstance = nullptr; }
+        if (mMaterial)         { engine.destroy(mMaterial);         mMaterial = nullptr; }
+        if (mSkybox) {
+            ctx.scene->setSkybox(nullptr);
+            engine.destroy(mSkybox);
+            mSkybox = nullptr;
+        }
+        mMeshlets = {};
+    }
+
+private:
+    std::string mPath;
+    std::string mName;
+    bool mEnabled;
+    Skybox* mSkybox = nullptr;
+    VertexBuffer* mVertexBuffer = nullptr;
+    IndexBuffer* mIndexBuffer = nullptr;
+    IndexBuffer* mCulledBuffers[INDEX_BUFFER_COUNT] = {};
+    Material* mMaterial = nullptr;
+    MaterialInstance* mMaterialInstance = nullptr;
+    Entity mRenderable;
+    Entity mLight;
+    mat4f mModel;
+    MeshletMesh mMeshlets;
+    MeshletCuller mCuller;
+    std::vector<MeshletRange> mRanges;
+    size_t mFrame = 0;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<DemoScene> createMeshletScene(const std::string& path, bool enabled) {
+    return std::make_unique<MeshletScene>(path, enabled);
+}
+
+} // namespace demo
@@ -0,0 +1,177 @@
+#include "Scenes.h"
+#include "../MemoryLedger.h"
+
+#include <filament/Camera.h>
+#include <filament/IndexBuffer.h>
+#include <filament/Material.h>
+#include <filament/MorphTargetBuffer.h>
+#include <filament/RenderableManager.h>
+#include <filament/Scene.h>
+#include <filament/Skybox.h>
+#include <filament/VertexBuffer.h>
+
+#include <utils/EntityManager.h>
+
+#include <cmath>
+
+using namespace filament;
+using namespace filament::math;
+using utils::Entity;
+
+namespace demo {
+
+namespace {
+
+// 与 03-morphing 相同的预编译材质
+static constexpr uint8_t BAKED_COLOR_PACKAGE[] = {
+#include "../../01-triangle/bakedColor.inc"
+};
+
+struct Vertex {
+    float2 position;
+    uint32_t color;   // 0xAARRGGBB
+};
+
+static const Vertex TRIANGLE_VERTICES[3] = {
+    {{ 1.0f,  0.0f},   0xffff0000u},
+    {{-0.5f,  0.866f}, 0xff00ff00u},
+    {{-0.5f, -0.866f}, 0xff0000ffu},
+};
+
+static const float3 MORPH_TARGET_1[3] = {
+    {-2.0f, 0.0f, 0.0f},
+    { 0.0f, 2.0f, 0.0f},
+    { 1.0f, 0.0f, 0.0f},
+};
+
+static const float3 MORPH_TARGET_2[3] = {
+    { 0.0f, 2.0f, 0.0f},
+    {-2.0f, 0.0f, 0.0f},
+    { 1.0f, 0.0f, 0.0f},
+};
+
+static const short4 MORPH_TANGENTS[3] = {
+    {0, 0, 0, 0},
+    {0, 0, 0, 0},
+    {0, 0, 0, 0},
+};
+
+static constexpr uint16_t TRIANGLE_INDICES[3] = { 0, 1, 2 };
+
+// 03-morphing：在两个变形目标之间按 sin(time) 插值的三角形
+class MorphingScene : public DemoScene {
+public:
+    const char* getName() const noexcept override { return "03-morphing"; }
+
+    bool setup(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+
+        mSkybox = Skybox::Builder().color({0.1, 0.125, 0.25, 1.0}).build(engine);
+        ctx.scene->setSkybox(mSkybox);
+
+        mVertexBuffer = VertexBuffer::Builder()
+            .vertexCount(3)
+            .bufferCount(1)
+            .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT2, 0, 12)
+            .attribute(VertexAttribute::COLOR, 0, VertexBuffer::AttributeType::UBYTE4, 8, 12)
+            .normalized(VertexAttribute::COLOR)
+            .build(engine);
+        mVertexBuffer->setBufferAt(engine, 0,
+                VertexBuffer::BufferDescriptor(TRIANGLE_VERTICES, sizeof(TRIANGLE_VERTICES), nullptr));
+
+        mIndexBuffer = IndexBuffer::Builder()
+            .indexCount(3)
+            .bufferType(IndexBuffer::IndexType::USHORT)
+            .build(engine);
+        mIndexBuffer->setBuffer(engine,
+                IndexBuffer::BufferDescriptor(TRIANGLE_INDICES, sizeof(TRIANGLE_INDICES), nullptr));
+
+        mMorphTargetBuffer = MorphTargetBuffer::Builder()
+            .vertexCount(3)
+            .count(2)
+            .build(engine);
+        mMorphTargetBuffer->setPositionsAt(engine, 0, MORPH_TARGET_1, 3, 0);
+        mMorphTargetBuffer->setTangentsAt(engine, 0, MORPH_TANGENTS, 3, 0);
+        mMorphTargetBuffer->setPositionsAt(engine, 1, MORPH_TARGET_2, 3, 0);
+        mMorphTargetBuffer->setTangentsAt(engine, 1, MORPH_TANGENTS, 3, 0);
+        if (ctx.memory) {
+            ctx.memory->addVertexBuffer("triangle", mVertexBuffer, sizeof(TRIANGLE_VERTICES));
+            ctx.memory->addIndexBuffer("triangle", mIndexBuffer, IndexBuffer::IndexType::USHORT);
+            ctx.memory->addMorphTargetBuffer("triangle", mMorphTargetBuffer);
+        }
+
+        mMaterial = buildMaterial(ctx,
+                BAKED_COLOR_PACKAGE, sizeof(BAKED_COLOR_PACKAGE), "bakedcolor");
+        if (!mMaterial) {
+            return false;
+        }
+
+        mRenderable = utils::EntityManager::get().create();
+        RenderableManager::Builder(1)
+            .boundingBox({{ -1, -1, -1 }, { 1, 1, 1 }})
+            .material(0, mMaterial->getDefaultInstance())
+            .geometry(0, RenderableManager::PrimitiveType::TRIANGLES, mVertexBuffer, mIndexBuffer, 0, 3)
+            .culling(false)
+            .receiveShadows(false)
+            .castShadows(false)
+            .morphing(mMorphTargetBuffer)
+            .build(engine, mRenderable);
+        ctx.scene->addEntity(mRenderable);
+
+        constexpr float ZOOM = 1.5f;
+        const float aspect = float(ctx.width) / float(ctx.height);
+        ctx.camera->setProjection(Camera::Projection::ORTHO,
+            -aspect * ZOOM, aspect * ZOOM,
+            -ZOOM, ZOOM,
+            0, 1);
+        return true;
+    }
+
+    void update(SceneContext& ctx, float time) override {
+        const float morphWeight = float(std::sin(time) / 2.0f + 0.5f);
+        const float weights[] = { 1.0f - morphWeight, morphWeight };
+        auto& rm = ctx.engine->getRenderableManager();
+        rm.setMorphWeights(rm.getInstance(mRenderable), weights, 2, 0);
+    }
+
+    void teardown(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+        if (ctx.memory) {
+            ctx.memory->remove(mVertexBuffer);
+            ctx.memory->remove(mIndexBuffer);
+            ctx.memory->remove(mMorphTargetBuffer);
+            ctx.memory->remove(mMaterial);
+        }
+        if (mRenderable) {
+            ctx.scene->remove(mRenderable);
+            engine.destroy(mRenderable);
+            utils::EntityManager::get().destroy(mRenderable);
+            mRenderable = {};
+        }
+        if (mMaterial)          { engine.destroy(mMaterial);          mMaterial = nullptr; }
+        if (mVertexBuffer)      { engine.destroy(mVertexBuffer);      mVertexBuffer = nullptr; }
+        if (mIndexBuffer)       { engine.destroy(mIndexBuffer);       mIndexBuffer = nullptr; }
+        if (mMorphTargetBuffer) { engine.destroy(mMorphTargetBuffer); mMorphTargetBuffer = nullptr; }
+        if (mSkybox) {
+            ctx.scene->setSkybox(nullptr);
+            engine.destroy(mSkybox);
+            mSkybox = nullptr;
+        }
+    }
+
+private:
+    Skybox* mSkybox = nullptr;
+    VertexBuffer* mVertexBuffer = nullptr;
+    IndexBuffer* mIndexBuffer = nullptr;
+    MorphTargetBuffer* mMorphTargetBuffer = nullptr;
+    Material* mMaterial = nullptr;
+    Entity mRenderable;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<DemoScene> createMorphingScene() {
+    return std::make_unique<MorphingScene>();
+}
+
+} // namespace demo
@@ -0,0 +1,186 @@
+#include "Scenes.h"
+#include "../MemoryLedger.h"
+#include "../StartupProfiler.h"
+#include "../TextureUploader.h"
+#include "../Trace.h"
+
+#include "../EmbeddedResources.h"
+
+#include <filament/Camera.h>
+#include <filament/Color.h>
+#include <filament/IndexBuffer.h>
+#include <filament/LightManager.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/Scene.h>
+#include <filament/Skybox.h>
+#include <filament/Texture.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+
+#include <filameshio/MeshReader.h>
+
+#include <utils/EntityManager.h>
+
+using namespace filament;
+using namespace filament::math;
+using namespace filamesh;
+using utils::Entity;
+
+namespace demo {
+
+namespace {
+
+// 04-pbr：TEXTUREDLIT 材质的猴头模型，太阳光照明。
+// 贴图在工作线程上转码/解码，setup() 只绑定占位纹理，update() 中逐张替换
+class PbrScene : public DemoScene {
+public:
+    const char* getName() const noexcept override { return "04-pbr"; }
+
+    bool setup(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+
+        mSkybox = Skybox::Builder().color({0.1, 0.125, 0.25, 1.0}).build(engine);
+        ctx.scene->setSkybox(mSkybox);
+
+        StartupStep meshStep(ctx.profiler, "MeshReader::loadMeshFromBuffer", "mesh",
+                MONKEY_SUZANNE_SIZE);
+        TRACE_NAME_BEGIN("MeshReader::loadMeshFromBuffer");
+        mMesh = MeshReader::loadMeshFromBuffer(&engine, MONKEY_SUZANNE_DATA, nullptr, nullptr, nullptr);
+        TRACE_NAME_END();
+        meshStep.end(!mMesh.renderable.isNull());
+        if (!mMesh.renderable) {
+            return false;
+        }
+        if (ctx.memory) {
+            ctx.memory->addFilamesh("monkey", MONKEY_SUZANNE_DATA, mMesh.vertexBuffer, mMesh.indexBuffer);
+        }
+
+        // 没有共享的 TextureUploader 时场景自己创建一个
+        if (!ctx.textures) {
+            mOwnTextures.reset(new TextureUploader(engine));
+        }
+        TextureUploader& textures = ctx.textures ? *ctx.textures : *mOwnTextures;
+        StartupStep textureStep(ctx.profiler, "TextureUploader::loadKtx2", "texture",
+                MONKEY_ALBEDO_SIZE + MONKEY_ROUGHNESS_SIZE + MONKEY_METALLIC_SIZE + MONKEY_AO_SIZE);
+        const TextureFuture albedo = textures.loadKtx2(
+                ACQUIRE_RESOURCE(MONKEY, ALBEDO).data(), MONKEY_ALBEDO_SIZE, true);
+        const TextureFuture roughness = textures.loadKtx2(
+                ACQUIRE_RESOURCE(MONKEY, ROUGHNESS).data(), MONKEY_ROUGHNESS_SIZE, false);
+        const TextureFuture metallic = textures.loadKtx2(
+                ACQUIRE_RESOURCE(MONKEY, METALLIC).data(), MONKEY_METALLIC_SIZE, false);
+        const TextureFuture ao = textures.loadKtx2(
+                ACQUIRE_RESOURCE(MONKEY, AO).data(), MONKEY_AO_SIZE, false);
+        const TextureFuture normal = textures.decodeImage(MONKEY_NORMAL_DATA, MONKEY_NORMAL_SIZE, false);
+        textureStep.end(true);
+
+        mMaterial = buildMaterial(ctx, ACQUIRE_RESOURCE(RESOURCES, TEXTUREDLIT), "texturedlit");
+        if (!mMaterial) {
+            return false;
+        }
+
+        mMaterialInstance = mMaterial->createInstance();
+        mMaterialInstance->setParameter("clearCoat", 0.0f);
+        const TextureSampler sampler(TextureSampler::MinFilter::LINEAR_MIPMAP_LINEAR,
+                TextureSampler::MagFilter::LINEAR);
+        mTextureBindings.add(mMaterialInstance, "albedo", albedo,
+                createSolidTexture(engine, 204, 204, 204, 255, true), sampler);
+        mTextureBindings.add(mMaterialInstance, "roughness", roughness,
+                createSolidTexture(engine, 128, 128, 128, 255, false), sampler);
+        mTextureBindings.add(mMaterialInstance, "metallic", metallic,
+                createSolidTexture(engine, 0, 0, 0, 255, false), sampler);
+        mTextureBindings.add(mMaterialInstance, "ao", ao,
+                createSolidTexture(engine, 255, 255, 255, 255, false), sampler);
+        mTextureBindings.add(mMaterialInstance, "normal", normal,
+                createSolidTexture(engine, 128, 128, 255, 255, false), sampler);
+
+        auto& rcm = engine.getRenderableManager();
+        auto& tcm = engine.getTransformManager();
+        auto ri = rcm.getInstance(mMesh.renderable);
+        rcm.setMaterialInstanceAt(ri, 0, mMaterialInstance);
+        rcm.setCastShadows(ri, false);
+
+        auto ti = tcm.getInstance(mMesh.renderable);
+        mTransform = mat4f{ mat3f(1), float3(0, 0, -4) } * tcm.getWorldTransform(ti);
+        tcm.setTransform(ti, mTransform);
+        ctx.scene->addEntity(mMesh.renderable);
+
+        mLight = utils::EntityManager::get().create();
+        LightManager::Builder(LightManager::Type::SUN)
+            .color(Color::toLinear<ACCURATE>(sRGBColor(0.98f, 0.92f, 0.89f)))
+            .intensity(110000.0f)
+            .direction({ 0.7f, -1.0f, -0.8f })
+            .sunAngularRadius(1.9f)
+            .castShadows(false)
+            .build(engine, mLight);
+        ctx.scene->addEntity(mLight);
+
+        ctx.camera->setProjection(45.0, double(ctx.width) / double(ctx.height), 0.1, 100.0);
+        ctx.camera->setModelMatrix(mat4f::translation(float3{ 0, 0, 3 }));
+        return true;
+    }
+
+    void update(SceneContext& ctx, float time) override {
+        (ctx.textures ? *ctx.textures : *mOwnTextures).pump();
+        mTextureBindings.update(*ctx.engine, ctx.memory);
+
+        auto& tcm = ctx.engine->getTransformManager();
+        tcm.setTransform(tcm.getInstance(mMesh.renderable),
+                mTransform * mat4f::rotation(time, float3{ 0, 1, 0 }));
+    }
+
+    void teardown(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+        if (ctx.memory) {
+            ctx.memory->remove(mMesh.vertexBuffer);
+            ctx.memory->remove(mMesh.indexBuffer);
+            ctx.memory->remove(mMaterial);
+        }
+        if (mMesh.renderable) {
+            ctx.scene->remove(mMesh.renderable);
+            engine.destroy(mMesh.renderable);
+            utils::EntityManager::get().destroy(mMesh.renderable);
+            mMesh.renderable = {};
+        }
+        if (mMesh.vertexBuffer) { engine.destroy(mMesh.vertexBuffer); mMesh.vertexBuffer = nullptr; }
+        if (mMesh.indexBuffer)  { engine.destroy(mMesh.indexBuffer);  mMesh.indexBuffer = nullptr; }
+        if (mLight) {
+            ctx.scene->remove(mLight);
+            engine.destroy(mLight);
+            utils::EntityManager::get().destroy(mLight);
+            mLight = {};
+        }
+        if (mMaterialInstance) { engine.destroy(mMaterialInstance); mMaterialInstance = nullptr; }
+        if (mMaterial)         { engine.destroy(mMaterial);         mMaterial = nullptr; }
+        // 共享的 TextureUploader 里还没兑现的请求先处理完，贴图由 mTextureBindings 销毁
+        if (ctx.textures) {
+            ctx.textures->waitAll();
+        }
+        mOwnTextures.reset();
+        mTextureBindings.destroy(engine, ctx.memory);
+        if (mSkybox) {
+            ctx.scene->setSkybox(nullptr);
+            engine.destroy(mSkybox);
+            mSkybox = nullptr;
+        }
+    }
+
+private:
+    Skybox* mSkybox = nullptr;
+    MeshReader::Mesh mMesh;
+    Material* mMaterial = nullptr;
+    MaterialInstance* mMaterialInstance = nullptr;
+    std::unique_ptr<TextureUploader> mOwnTextures;
+    TextureBindings mTextureBindings;
+    Entity mLight;
+    mat4f mTransform;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<DemoScene> createPbrScene() {
+    return std::make_unique<PbrScene>();
+}
+
+} // namespace demo
@@ -0,0 +1,106 @@
+#include "Scenes.h"
+#include "../MemoryLedger.h"
+#include "../PackFile.h"
+#include "../StartupProfiler.h"
+#include "../TextureUploader.h"
+#include "../Trace.h"
+
+#include <filament/Material.h>
+#include <filament/Texture.h>
+
+#include <fstream>
+#include <iostream>
+
+using namespace filament;
+
+namespace demo {
+
+Texture* loadRGBATexture(Engine& engine, const std::string& path,
+        uint32_t width, uint32_t height) {
+    TRACE_CALL();
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open texture file: " << path << std::endl;
+        return nullptr;
+    }
+
+    // 像素数据必须存活到上传完成，因此放在堆上，由 PixelBufferDescriptor 的回调释放
+    const size_t size = size_t(width) * height * 4;
+    uint8_t* pixels = new uint8_t[size];
+    file.read(reinterpret_cast<char*>(pixels), std::streamsize(size));
+    if (size_t(file.gcount()) != size) {
+        std::cerr << "Texture file size mismatch. Expected: " << size
+                  << ", Got: " << file.gcount() << std::endl;
+        delete[] pixels;
+        return nullptr;
+    }
+
+    Texture* texture = Texture::Builder()
+        .width(width)
+        .height(height)
+        .levels(1)
+        .format(Texture::InternalFormat::RGBA8)
+        .build(engine);
+
+    Texture::PixelBufferDescriptor buffer(pixels, size,
+        Texture::Format::RGBA, Texture::Type::UBYTE,
+        [](void* buffer, size_t, void*) { delete[] static_cast<uint8_t*>(buffer); });
+    texture->setImage(engine, 0, std::move(buffer));
+    return texture;
+}
+
+Texture* loadRGBATexture(SceneContext& ctx, const std::string& name,
+        uint32_t width, uint32_t height) {
+    const PackView data = ctx.pack ? ctx.pack->find(name) : PackView{};
+    if (!data && ctx.textures) {
+        TRACE_CALL();
+        return ctx.textures->wait(ctx.textures->loadRGBA(ctx.assetRoot + "/" + name, width, height));
+    }
+    if (!data) {
+        return loadRGBATexture(*ctx.engine, ctx.assetRoot + "/" + name, width, height);
+    }
+
+    TRACE_CALL();
+    const size_t size = size_t(width) * height * 4;
+    if (data.size != size) {
+        std::cerr << "Texture file size mismatch. Expected: " << size
+                  << ", Got: " << data.size << std::endl;
+        return nullptr;
+    }
+
+    Texture* texture = Texture::Builder()
+        .width(width)
+        .height(height)
+        .levels(1)
+        .format(Texture::InternalFormat::RGBA8)
+        .build(*ctx.engine);
+
+    // 资源包的映射比 Engine 活得更久，不需要释放回调
+    Texture::PixelBufferDescriptor buffer(data.data, size,
+        Texture::Format::RGBA, Texture::Type::UBYTE);
+    texture->setImage(*ctx.engine, 0, std::move(buffer));
+    return texture;
+}
+
+Material* buildMaterial(SceneContext& ctx, const void* package, size_t size, const char* name) {
+    TRACE_NAME("Material::build");
+    StartupStep step(ctx.profiler, name, "material", size);
+    Material* material = Material::Builder()
+        .package(package, size)
+        .build(*ctx.engine);
+    step.end(material != nullptr);
+    if (ctx.memory) {
+        ctx.memory->addMaterial(name, material, size);
+    }
+    return material;
+}
+
+Material* buildMaterial(SceneContext& ctx, const BundleLease& package, const char* name) {
+    if (!package) {
+        std::cerr << "Failed to load material package: " << name << std::endl;
+        return nullptr;
+    }
+    return buildMaterial(ctx, package.data(), package.size(), name);
+}
+
+} // namespace demo
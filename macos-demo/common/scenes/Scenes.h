@@ -0,0 +1,76 @@
+#ifndef DEMO_COMMON_SCENES_SCENES_H
+#define DEMO_COMMON_SCENES_SCENES_H
+
+#include "../DemoScene.h"
+#include "../ResourceBundle.h"
+
+#include <math/mat4.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+
+namespace filament {
+class Material;
+class Texture;
+}
+
+namespace demo {
+
+// 各示例场景的工厂函数，实现位于 scenes/ 目录下对应的源文件
+std::unique_ptr<DemoScene> createTriangleScene();   // 01-triangle
+std::unique_ptr<DemoScene> createCubeScene();       // 02-cube
+std::unique_ptr<DemoScene> createCubeMapScene();    // 02-cube-map
+std::unique_ptr<DemoScene> createCubeObjScene();    // 02-cube-obj
+std::unique_ptr<DemoScene> createMorphingScene();   // 03-morphing
+std::unique_ptr<DemoScene> createPbrScene();        // 04-pbr
+
+// demo-snapshot 烘焙的场景快照，path 为快照文件路径（createDemoScene("snapshot:<path>")）
+std::unique_ptr<DemoScene> createSnapshotScene(const std::string& path);
+
+// 网格 LOD 方阵，path 为 .obj 或 filamesh 文件路径；enabled 为 false 时总是画第 0 级
+// （createDemoScene("lod:<path>") / createDemoScene("lod-off:<path>")）
+std::unique_ptr<DemoScene> createLodScene(const std::string& path, bool enabled);
+
+// 近距离环绕一个网格并每帧做 CPU 簇剔除，path 为 .obj 或未压缩的 filamesh 文件路径；enabled 为 false 时画完整网格
+// （createDemoScene("meshlet:<path>") / createDemoScene("meshlet-off:<path>")）
+std::unique_ptr<DemoScene> createMeshletScene(const std::string& path, bool enabled);
+
+// 读取原始 RGBA8 文件并创建纹理（02-cube-map、02-cube-obj 共用）
+// 像素数据在上传完成后由回调释放，失败时返回 nullptr
+filament::Texture* loadRGBATexture(filament::Engine& engine, const std::string& path,
+        uint32_t width, uint32_t height);
+
+// 同上，name 为相对 ctx.assetRoot 的路径。ctx.pack 中有该文件时直接上传映射内存，不做拷贝；
+// 否则 ctx.textures 非空时由它读取文件
+filament::Texture* loadRGBATexture(SceneContext& ctx, const std::string& name,
+        uint32_t width, uint32_t height);
+
+// 从材质包构建材质，name 为材质包名（字符串常量）。
+// 同时记录 trace 区间，ctx.profiler 非空时记录启动步骤，ctx.memory 非空时以 name 登记材质包大小
+filament::Material* buildMaterial(SceneContext& ctx, const void* package, size_t size,
+        const char* name);
+
+// 同上，材质包来自 ACQUIRE_RESOURCE()。租约只需要活到函数返回，临时对象即可
+filament::Material* buildMaterial(SceneContext& ctx, const BundleLease& package, const char* name);
+
+// 02-cube-map / 02-cube-obj 的分阶段旋转：前 8 秒绕 Y 轴转一圈，后 8 秒绕 X 轴转一圈
+inline filament::math::mat4f twoPhaseRotation(float time) {
+    using namespace filament::math;
+    constexpr float TWO_PI = 2.0f * float(M_PI);
+    const float rotationTime = std::fmod(time, 16.0f);
+    float horizontalRotation;
+    float verticalRotation = 0.0f;
+    if (rotationTime < 8.0f) {
+        horizontalRotation = (rotationTime / 8.0f) * TWO_PI;
+    } else {
+        horizontalRotation = TWO_PI;
+        verticalRotation = ((rotationTime - 8.0f) / 8.0f) * TWO_PI;
+    }
+    return mat4f::rotation(horizontalRotation, float3{ 0, 1, 0 }) *
+           mat4f::rotation(verticalRotation, float3{ 1, 0, 0 });
+}
+
+} // namespace demo
+
+#endif // DEMO_COMMON_SCENES_SCENES_H
@@ -0,0 +1,54 @@
+#include "Scenes.h"
+#include "../SceneSnapshot.h"
+#include "../StartupProfiler.h"
+
+using namespace filament;
+
+namespace demo {
+
+namespace {
+
+// snapshot:<path>：demo-snapshot 烘焙的场景快照（见 common/SceneSnapshot.h）。
+// 快照只记录静态状态，update() 不做任何事
+class SnapshotScene : public DemoScene {
+public:
+    explicit SnapshotScene(const std::string& path) : mPath(path), mName("snapshot:" + path) {}
+
+    const char* getName() const noexcept override { return mName.c_str(); }
+
+    bool setup(SceneContext& ctx) override {
+        StartupStep openStep(ctx.profiler, "SceneSnapshot::open", "snapshot");
+        const bool opened = mSnapshot.open(mPath);
+        openStep.end(opened);
+        if (!opened) {
+            return false;
+        }
+        StartupStep instantiateStep(ctx.profiler, "SceneSnapshot::instantiate", "snapshot",
+                mSnapshot.getFileSize());
+        const bool instantiated = mSnapshot.instantiate(ctx);
+        instantiateStep.end(instantiated);
+        return instantiated;
+    }
+
+    void update(SceneContext&, float) override {
+    }
+
+    void teardown(SceneContext& ctx) override {
+        mSnapshot.destroy(ctx);
+        // 还没完成的上传各自持有映射，这里只释放场景自己的引用
+        mSnapshot.close();
+    }
+
+private:
+    std::string mPath;
+    std::string mName;
+    SceneSnapshot mSnapshot;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<DemoScene> createSnapshotScene(const std::string& path) {
+    return std::make_unique<SnapshotScene>(path);
+}
+
+} // namespace demo
@@ -0,0 +1,141 @@
+#include "Scenes.h"
+#include "../MemoryLedger.h"
+
+#include <filament/Camera.h>
+#include <filament/IndexBuffer.h>
+#include <filament/Material.h>
+#include <filament/RenderableManager.h>
+#include <filament/Scene.h>
+#include <filament/Skybox.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+
+#include <utils/EntityManager.h>
+
+using namespace filament;
+using namespace filament::math;
+using utils::Entity;
+
+namespace demo {
+
+namespace {
+
+// 与 01-triangle 相同的预编译材质
+static constexpr uint8_t BAKED_COLOR_PACKAGE[] = {
+#include "../../01-triangle/bakedColor.inc"
+};
+
+struct Vertex {
+    float2 position;
+    uint32_t color;   // 0xAARRGGBB
+};
+
+static const Vertex TRIANGLE_VERTICES[3] = {
+    {{ 1.0f,  0.0f},   0xffff0000u},
+    {{-0.5f,  0.866f}, 0xff00ff00u},
+    {{-0.5f, -0.866f}, 0xff0000ffu},
+};
+
+static constexpr uint16_t TRIANGLE_INDICES[3] = { 0, 1, 2 };
+
+// 01-triangle：绕 Z 轴旋转的彩色三角形，正交投影
+class TriangleScene : public DemoScene {
+public:
+    const char* getName() const noexcept override { return "01-triangle"; }
+
+    bool setup(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+
+        mSkybox = Skybox::Builder().color({0.1, 0.125, 0.25, 1.0}).build(engine);
+        ctx.scene->setSkybox(mSkybox);
+
+        mVertexBuffer = VertexBuffer::Builder()
+            .vertexCount(3)
+            .bufferCount(1)
+            .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT2, 0, 12)
+            .attribute(VertexAttribute::COLOR, 0, VertexBuffer::AttributeType::UBYTE4, 8, 12)
+            .normalized(VertexAttribute::COLOR)
+            .build(engine);
+        mVertexBuffer->setBufferAt(engine, 0,
+                VertexBuffer::BufferDescriptor(TRIANGLE_VERTICES, sizeof(TRIANGLE_VERTICES), nullptr));
+
+        mIndexBuffer = IndexBuffer::Builder()
+            .indexCount(3)
+            .bufferType(IndexBuffer::IndexType::USHORT)
+            .build(engine);
+        mIndexBuffer->setBuffer(engine,
+                IndexBuffer::BufferDescriptor(TRIANGLE_INDICES, sizeof(TRIANGLE_INDICES), nullptr));
+        if (ctx.memory) {
+            ctx.memory->addVertexBuffer("triangle", mVertexBuffer, sizeof(TRIANGLE_VERTICES));
+            ctx.memory->addIndexBuffer("triangle", mIndexBuffer, IndexBuffer::IndexType::USHORT);
+        }
+
+        mMaterial = buildMaterial(ctx,
+                BAKED_COLOR_PACKAGE, sizeof(BAKED_COLOR_PACKAGE), "bakedcolor");
+        if (!mMaterial) {
+            return false;
+        }
+
+        mRenderable = utils::EntityManager::get().create();
+        RenderableManager::Builder(1)
+            .boundingBox({{ -1, -1, -1 }, { 1, 1, 1 }})
+            .material(0, mMaterial->getDefaultInstance())
+            .geometry(0, RenderableManager::PrimitiveType::TRIANGLES, mVertexBuffer, mIndexBuffer, 0, 3)
+            .culling(false)
+            .receiveShadows(false)
+            .castShadows(false)
+            .build(engine, mRenderable);
+        ctx.scene->addEntity(mRenderable);
+
+        constexpr float ZOOM = 1.5f;
+        const float aspect = float(ctx.width) / float(ctx.height);
+        ctx.camera->setProjection(Camera::Projection::ORTHO,
+            -aspect * ZOOM, aspect * ZOOM,
+            -ZOOM, ZOOM,
+            0, 1);
+        return true;
+    }
+
+    void update(SceneContext& ctx, float time) override {
+        auto& tcm = ctx.engine->getTransformManager();
+        tcm.setTransform(tcm.getInstance(mRenderable), mat4f::rotation(time, float3{ 0, 0, 1 }));
+    }
+
+    void teardown(SceneContext& ctx) override {
+        Engine& engine = *ctx.engine;
+        if (ctx.memory) {
+            ctx.memory->remove(mVertexBuffer);
+            ctx.memory->remove(mIndexBuffer);
+            ctx.memory->remove(mMaterial);
+        }
+        if (mRenderable) {
+            ctx.scene->remove(mRenderable);
+            engine.destroy(mRenderable);
+            utils::EntityManager::get().destroy(mRenderable);
+            mRenderable = {};
+        }
+        if (mMaterial)     { engine.destroy(mMaterial);     mMaterial = nullptr; }
+        if (mVertexBuffer) { engine.destroy(mVertexBuffer); mVertexBuffer = nullptr; }
+        if (mIndexBuffer)  { engine.destroy(mIndexBuffer);  mIndexBuffer = nullptr; }
+        if (mSkybox) {
+            ctx.scene->setSkybox(nullptr);
+            engine.destroy(mSkybox);
+            mSkybox = nullptr;
+        }
+    }
+
+private:
+    Skybox* mSkybox = nullptr;
+    VertexBuffer* mVertexBuffer = nullptr;
+    IndexBuffer* mIndexBuffer = nullptr;
+    Material* mMaterial = nullptr;
+    Entity mRenderable;
+};
+
+} // anonymous namespace
+
+std::unique_ptr<DemoScene> createTriangleScene() {
+    return std::make_unique<TriangleScene>();
+}
+
+} // namespace demo
@@ -0,0 +1,371 @@
+// ========================================
+// demo-flythrough：相机飞行路径基准测试
+// ========================================
+// 示例里的相机都是固定的，看不出视锥裁剪和远近变化带来的开销。
+// 这个工具加载 macos-demo/models 下的大模型，沿着环绕注视点插值（与 camutils
+// ORBIT 模式相同的参数）得到的相机路径以固定时间步长渲染，按路径段统计帧耗时。
+//
+// 用法：
+//   demo-flythrough [--model models/FlightHelmet/FlightHelmet.gltf]...
+//                   [--path camera.path] [--time-step 0.016667] [--warmup 10]
+//                   [--backend noop|opengl|vulkan|metal]
+//                   [--width 800] [--height 600] [--assets macos-demo] [--pack demo.pack]
+//                   [--texture-threads 0] [--output flythrough.json]
+// 不指定 --model 时依次运行 FlightHelmet、BusterDrone、lucy、shader_ball。
+// 路径文件格式见 common/CameraPath.h，不指定时使用内置路径。
+
+#include "../common/CameraPath.h"
+#include "../common/DemoScene.h"
+#include "../common/FrameTelemetry.h"
+#include "../common/GltfLoader.h"
+#include "../common/GltfTextureProvider.h"
+#include "../common/JsonWriter.h"
+#include "../common/PackFile.h"
+#include "../common/Stats.h"
+#include "../common/Trace.h"
+
+#include <filament/Camera.h>
+#include <filament/LightManager.h>
+#include <filament/Renderer.h>
+#include <filament/Scene.h>
+
+#include <gltfio/FilamentAsset.h>
+
+#include <utils/EntityManager.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace demo;
+using namespace filament;
+using namespace filament::math;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 默认测试的模型，相对于 --assets 目录
+const char* const DEFAULT_MODELS[] = {
+    "models/FlightHelmet/FlightHelmet.gltf",
+    "models/BusterDrone/scene.gltf",
+    "models/lucy/lucy.glb",
+    "models/shader_ball/shader_ball.gltf",
+};
+
+struct Options {
+    SceneContext params;
+    Engine::Backend backend = Engine::Backend::NOOP;
+    std::string backendName = "noop";
+    float timeStep = 1.0f / 60.0f;
+    uint32_t warmupFrames = 10;
+    uint32_t textureThreads = 0;
+    std::vector<CameraKey> keys;
+};
+
+struct SegmentResult {
+    double duration = 0.0;
+    std::vector<double> frameMs;
+    uint32_t skippedFrames = 0;
+    std::shared_ptr<FrameTelemetry> telemetry;
+};
+
+struct ModelResult {
+    std::string model;
+    bool ok = false;
+    std::string error;
+    double loadMs = 0.0;
+    uint32_t textureThreads = 0;
+    GltfTextureStats textures;
+    size_t renderableCount = 0;
+    float radius = 0.0f;
+    std::vector<SegmentResult> segments;
+};
+
+// 渲染一帧，返回 CPU 耗时（毫秒），beginFrame() 返回 false 时返回负数
+double renderFrame(SceneContext& ctx) {
+    TRACE_NAME("frame");
+    const auto start = Clock::now();
+    if (!ctx.renderer->beginFrame(ctx.swapChain)) {
+        return -1.0;
+    }
+    ctx.renderer->render(ctx.view);
+    ctx.renderer->endFrame();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+ModelResult runModel(const std::string& model, const Options& options) {
+    ModelResult result;
+    result.model = model;
+
+    SceneContext ctx = options.params;
+    if (!createHeadlessContext(ctx, nullptr, options.backend)) {
+        result.error = "failed to create engine";
+        return result;
+    }
+
+    {
+        // GltfLoader 必须在 Engine 之前销毁
+        GltfLoader loader(*ctx.engine, options.textureThreads);
+        const auto loadStart = Clock::now();
+        // 指定资源包时模型路径就是包内路径
+        gltfio::FilamentAsset* asset = ctx.pack ? loader.load(*ctx.pack, model)
+                : loader.load(ctx.assetRoot + "/" + model);
+        ctx.engine->flushAndWait();
+        result.loadMs = std::chrono::duration<double, std::milli>(Clock::now() - loadStart).count();
+        result.textureThreads = loader.getTextureProvider().getThreadCount();
+        result.textures = loader.getTextureProvider().getStats();
+
+        if (!asset) {
+            result.error = "failed to load model";
+        } else {
+            ctx.scene->addEntities(asset->getEntities(), asset->getEntityCount());
+            result.renderableCount = asset->getRenderableEntityCount();
+
+            utils::Entity sun = utils::EntityManager::get().create();
+            LightManager::Builder(LightManager::Type::SUN)
+                .color(Color::toLinear<ACCURATE>(sRGBColor(0.98f, 0.92f, 0.89f)))
+                .intensity(110000.0f)
+                .direction({ 0.6f, -1.0f, -0.8f })
+                .castShadows(true)
+                .build(*ctx.engine, sun);
+            ctx.scene->addEntity(sun);
+
+            // 路径坐标以包围球为单位，近远平面也按模型尺寸设置
+            const Aabb bounds = asset->getBoundingBox();
+            result.radius = std::max(length(bounds.extent()), 1e-3f);
+            const double aspect = double(ctx.width) / double(ctx.height);
+            ctx.camera->setProjection(45.0, aspect, 0.01 * result.radius, 100.0 * result.radius);
+            CameraPath path(options.keys, bounds.center(), result.radius, ctx.width, ctx.height);
+
+            float3 eye;
+            float3 target;
+            float3 up;
+            path.evaluate(0, 0.0, &eye, &target, &up);
+            ctx.camera->lookAt(eye, target, up);
+            for (uint32_t i = 0; i < options.warmupFrames; i++) {
+                renderFrame(ctx);
+            }
+
+            // ========================================
+            // 逐段沿路径渲染
+            // ========================================
+            FrameTelemetry::Config telemetryConfig;
+            telemetryConfig.dumpOnDestroy = false;
+            for (size_t segment = 0; segment < path.getSegmentCount(); segment++) {
+                TRACE_NAME("segment");
+                SegmentResult segmentResult;
+                segmentResult.duration = path.getSegmentDuration(segment);
+                segmentResult.telemetry = std::make_shared<FrameTelemetry>(
+                        model + "#" + std::to_string(segment), telemetryConfig);
+
+                const uint32_t steps = std::max(1u,
+                        uint32_t(std::lround(segmentResult.duration / options.timeStep)));
+                // 最后一段额外渲染终点
+                const bool last = segment + 1 == path.getSegmentCount();
+                for (uint32_t step = 0; step < steps + (last ? 1 : 0); step++) {
+                    path.evaluate(segment, double(step) / double(steps), &eye, &target, &up);
+                    ctx.camera->lookAt(eye, target, up);
+
+                    segmentResult.telemetry->beginFrame();
+                    const double ms = renderFrame(ctx);
+                    segmentResult.telemetry->endFrame(*ctx.renderer);
+                    if (ms < 0.0) {
+                        segmentResult.skippedFrames++;
+                    } else {
+                        segmentResult.frameMs.push_back(ms);
+                    }
+                }
+                result.segments.push_back(std::move(segmentResult));
+            }
+            result.ok = true;
+
+            ctx.scene->remove(sun);
+            ctx.engine->destroy(sun);
+            utils::EntityManager::get().destroy(sun);
+            ctx.scene->removeEntities(asset->getEntities(), asset->getEntityCount());
+            loader.destroy(asset);
+        }
+    }
+
+    destroyHeadlessContext(ctx);
+    return result;
+}
+
+void writeModelResult(JsonWriter& json, const ModelResult& result) {
+    json.beginObject();
+    json.key("model").value(result.model);
+    json.key("ok").value(result.ok);
+    if (!result.error.empty()) {
+        json.key("error").value(result.error);
+    }
+    json.key("loadMs").value(result.loadMs);
+    json.key("textures").beginObject();
+    json.key("threads").value(result.textureThreads);
+    json.key("decoded").value(result.textures.decoded);
+    json.key("failed").value(result.textures.failed);
+    json.key("steals").value(result.textures.steals);
+    json.key("decodeMs").value(result.textures.decodeMs);
+    json.key("peakPendingBytes").value(static_cast<unsigned long long>(result.textures.peakPendingBytes));
+    json.endObject();
+    json.key("renderables").value(static_cast<unsigned long>(result.renderableCount));
+    json.key("radius").value(double(result.radius));
+
+    std::vector<double> all;
+    json.key("segments").beginArray();
+    for (size_t i = 0; i < result.segments.size(); i++) {
+        const SegmentResult& segment = result.segments[i];
+        all.insert(all.end(), segment.frameMs.begin(), segment.frameMs.end());
+        json.beginObject();
+        json.key("segment").value(static_cast<unsigned long>(i));
+        json.key("durationSeconds").value(segment.duration);
+        json.key("skippedFrames").value(segment.skippedFrames);
+        json.key("frameMs"); writeStats(json, computeStats(segment.frameMs));
+        json.key("telemetry"); segment.telemetry->writeJson(json);
+        json.endObject();
+    }
+    json.endArray();
+    json.key("frameMs"); writeStats(json, computeStats(all));
+    json.endObject();
+}
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options]\n"
+              << "  --model <file>       glTF/glb relative to --assets (may be repeated)\n"
+              << "  --path <file>        camera path file (default: built-in orbit/dolly path)\n"
+              << "  --time-step <s>      fixed time step along the path (default 1/60)\n"
+              << "  --warmup <n>         frames rendered at the first key before measuring (default 10)\n"
+              << "  --backend <name>     noop, opengl, vulkan or metal (default noop)\n"
+              << "  --width <n>          swapchain width (default 800)\n"
+              << "  --height <n>         swapchain height (default 600)\n"
+              << "  --assets <dir>       macos-demo directory (default macos-demo)\n"
+              << "  --pack <file>        load models from a demo-pack archive instead of --assets\n"
+              << "  --texture-threads <n> PNG/JPEG decode threads, 0 = all hardware threads (default 0)\n"
+              << "  --output <file>      write JSON to file instead of stdout\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    TraceSession traceSession;
+    Options options;
+    std::vector<std::string> models;
+    std::string pathFile;
+    std::string outputPath;
+    std::string packPath;
+
+    // ========================================
+    // 第一步：解析命令行参数
+    // ========================================
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--model") && hasValue) {
+            models.emplace_back(argv[++i]);
+        } else if (!strcmp(arg, "--path") && hasValue) {
+            pathFile = argv[++i];
+        } else if (!strcmp(arg, "--time-step") && hasValue) {
+            options.timeStep = std::strtof(argv[++i], nullptr);
+        } else if (!strcmp(arg, "--warmup") && hasValue) {
+            options.warmupFrames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--backend") && hasValue && parseBackend(argv[i + 1], options.backend)) {
+            options.backendName = argv[++i];
+        } else if (!strcmp(arg, "--width") && hasValue) {
+            options.params.width = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--height") && hasValue) {
+            options.params.height = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--assets") && hasValue) {
+            options.params.assetRoot = argv[++i];
+        } else if (!strcmp(arg, "--pack") && hasValue) {
+            packPath = argv[++i];
+        } else if (!strcmp(arg, "--texture-threads") && hasValue) {
+            options.textureThreads = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+
+    if (!(options.timeStep > 0.0f)) {
+        std::cerr << "--time-step must be positive" << std::endl;
+        return 1;
+    }
+    PackFile pack;
+    if (!packPath.empty()) {
+        if (!pack.open(packPath)) {
+            return 1;
+        }
+        options.params.pack = &pack;
+    }
+    if (models.empty()) {
+        models.assign(std::begin(DEFAULT_MODELS), std::end(DEFAULT_MODELS));
+    }
+    if (pathFile.empty()) {
+        options.keys = CameraPath::defaultKeys();
+    } else {
+        std::ifstream in(pathFile);
+        std::string error;
+        if (!in.is_open()) {
+            std::cerr << "Failed to open camera path: " << pathFile << std::endl;
+            return 1;
+        }
+        if (!CameraPath::parse(in, options.keys, error)) {
+            std::cerr << pathFile << ": " << error << std::endl;
+            return 1;
+        }
+    }
+
+    // ========================================
+    // 第二步：逐个模型沿路径渲染
+    // ========================================
+    std::vector<ModelResult> results;
+    for (const auto& model : models) {
+        std::cerr << "Flying through " << model << "..." << std::endl;
+        results.push_back(runModel(model, options));
+        if (!results.back().ok) {
+            std::cerr << "  " << model << ": " << results.back().error << std::endl;
+        }
+    }
+
+    // ========================================
+    // 第三步：输出 JSON
+    // ========================================
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open output file: " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputPath.empty() ? std::cout : file;
+
+    JsonWriter json(out);
+    json.beginObject();
+    json.key("backend").value(options.backendName);
+    json.key("timeStep").value(double(options.timeStep));
+    json.key("width").value(options.params.width);
+    json.key("height").value(options.params.height);
+    json.key("keys").value(static_cast<unsigned long>(options.keys.size()));
+    json.key("models").beginArray();
+    for (const auto& result : results) {
+        writeModelResult(json, result);
+    }
+    json.endArray();
+    json.endObject();
+    out << std::endl;
+
+    bool allOk = true;
+    for (const auto& result : results) {
+        allOk = allOk && result.ok;
+    }
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,403 @@
+// ========================================
+// demo-gltfload：glTF 渐进加载，测量首帧时间和完全加载时间
+// ========================================
+// 每个模型用一个新的 Engine，GltfLoader::loadAsync() 返回（几何体已上传、纹理已交给解码线程）后
+// 立即开始渲染，每帧调用 GltfLoader::update() 绑定解码完成的纹理，直到加载进度到 100%。记录：
+//
+//   geometryMs     开始加载到 loadAsync() 返回
+//   firstFrameMs   开始加载到第一帧提交并 flushAndWait() 完成（time to first frame）
+//   fullyLoadedMs  开始加载到所有纹理绑定后的那一帧完成（time to fully loaded）
+//
+// 以及加载期间的帧耗时（纹理上传造成的卡顿）、加载完成后 --frames 帧的稳定帧耗时和加载进度的时间线。
+// --sync 时改用阻塞的 GltfLoader::load()，首帧时间等于完全加载时间，作为对照。
+// 每一项加载优化都可以用这两个时间衡量。
+//
+// 用法：
+//   demo-gltfload [--model embedded:DamagedHelmet] [--model models/FlightHelmet/FlightHelmet.gltf]...
+//                 [--sync] [--frames 10] [--timeout 60] [--texture-threads 0]
+//                 [--backend noop|opengl|vulkan|metal] [--width 800] [--height 600]
+//                 [--assets macos-demo] [--pack demo.pack] [--output gltfload.json]
+// 不指定 --model 时依次加载内嵌的 DamagedHelmet（gltf_demo.h）和 macos-demo/models 下的
+// FlightHelmet、BusterDrone、shader_ball。
+
+#include "../common/DemoScene.h"
+#include "../common/GltfLoader.h"
+#include "../common/GltfTextureProvider.h"
+#include "../common/JsonWriter.h"
+#include "../common/PackFile.h"
+#include "../common/Stats.h"
+#include "../common/Trace.h"
+
+#include "gltf_demo.h"
+
+#include <filament/Camera.h>
+#include <filament/LightManager.h>
+#include <filament/Renderer.h>
+#include <filament/Scene.h>
+
+#include <gltfio/FilamentAsset.h>
+
+#include <utils/EntityManager.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace demo;
+using namespace filament;
+using namespace filament::math;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 以这个前缀开头的模型名指内嵌资源，不读文件
+const char EMBEDDED_PREFIX[] = "embedded:";
+const char EMBEDDED_HELMET[] = "embedded:DamagedHelmet";
+
+// 默认加载的模型，除内嵌模型外相对于 --assets 目录
+const char* const DEFAULT_MODELS[] = {
+    EMBEDDED_HELMET,
+    "models/FlightHelmet/FlightHelmet.gltf",
+    "models/BusterDrone/scene.gltf",
+    "models/shader_ball/shader_ball.gltf",
+};
+
+struct Options {
+    SceneContext params;
+    Engine::Backend backend = Engine::Backend::NOOP;
+    std::string backendName = "noop";
+    bool sync = false;
+    uint32_t steadyFrames = 10;
+    double timeoutSeconds = 60.0;
+    uint32_t textureThreads = 0;
+};
+
+struct ModelResult {
+    std::string model;
+    bool ok = false;
+    std::string error;
+    size_t renderableCount = 0;
+
+    double geometryMs = 0.0;
+    double firstFrameMs = 0.0;
+    double fullyLoadedMs = 0.0;
+    uint32_t loadingFrames = 0;             // 首帧到完全加载之间渲染的帧数（含这两帧）
+    uint32_t skippedFrames = 0;
+    std::vector<double> loadingFrameMs;     // 加载期间每帧的 CPU 耗时（含 update()）
+    std::vector<double> steadyFrameMs;
+    std::vector<std::pair<double, float>> timeline;    // (毫秒, 进度)，只记录进度变化的帧
+
+    uint32_t textureThreads = 0;
+    GltfTextureStats textures;
+};
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 渲染一帧，beginFrame() 返回 false 时返回 false
+bool renderFrame(SceneContext& ctx) {
+    TRACE_NAME("frame");
+    if (!ctx.renderer->beginFrame(ctx.swapChain)) {
+        return false;
+    }
+    ctx.renderer->render(ctx.view);
+    ctx.renderer->endFrame();
+    return true;
+}
+
+gltfio::FilamentAsset* startLoad(GltfLoader& loader, const SceneContext& ctx, const std::string& model,
+        bool async) {
+    if (model == EMBEDDED_HELMET) {
+        return async ? loader.loadAsync(GLTF_DEMO_DAMAGEDHELMET_DATA, GLTF_DEMO_DAMAGEDHELMET_SIZE, model)
+                : loader.load(GLTF_DEMO_DAMAGEDHELMET_DATA, GLTF_DEMO_DAMAGEDHELMET_SIZE, model);
+    }
+    // 指定资源包时模型路径就是包内路径
+    if (ctx.pack) {
+        return async ? loader.loadAsync(*ctx.pack, model) : loader.load(*ctx.pack, model);
+    }
+    const std::string path = ctx.assetRoot + "/" + model;
+    return async ? loader.loadAsync(path) : loader.load(path);
+}
+
+// 从斜上方看向模型包围盒中心，整个包围球都在视野内
+void frameAsset(SceneContext& ctx, const gltfio::FilamentAsset& asset) {
+    const Aabb bounds = asset.getBoundingBox();
+    const float radius = std::max(length(bounds.extent()), 1e-3f);
+    const double aspect = double(ctx.width) / double(ctx.height);
+    ctx.camera->setProjection(45.0, aspect, 0.01 * radius, 100.0 * radius);
+    const float3 center = bounds.center();
+    ctx.camera->lookAt(center + float3(0.0f, 0.5f, 2.6f) * radius, center, { 0.0f, 1.0f, 0.0f });
+}
+
+ModelResult runModel(const std::string& model, const Options& options) {
+    ModelResult result;
+    result.model = model;
+
+    SceneContext ctx = options.params;
+    if (!createHeadlessContext(ctx, nullptr, options.backend)) {
+        result.error = "failed to create engine";
+        return result;
+    }
+
+    utils::Entity sun = utils::EntityManager::get().create();
+    LightManager::Builder(LightManager::Type::SUN)
+        .color(Color::toLinear<ACCURATE>(sRGBColor(0.98f, 0.92f, 0.89f)))
+        .intensity(110000.0f)
+        .direction({ 0.6f, -1.0f, -0.8f })
+        .build(*ctx.engine, sun);
+    ctx.scene->addEntity(sun);
+
+    {
+        // GltfLoader 必须在 Engine 之前销毁
+        GltfLoader loader(*ctx.engine, options.textureThreads);
+        result.textureThreads = loader.getTextureProvider().getThreadCount();
+
+        // ========================================
+        // 开始加载：返回时几何体已经可以渲染
+        // ========================================
+        const auto start = Clock::now();
+        gltfio::FilamentAsset* asset = startLoad(loader, ctx, model, !options.sync);
+        result.geometryMs = elapsedMs(start);
+        if (!asset) {
+            result.error = "failed to load model";
+        } else {
+            ctx.scene->addEntities(asset->getEntities(), asset->getEntityCount());
+            result.renderableCount = asset->getRenderableEntityCount();
+            frameAsset(ctx, *asset);
+
+            // ========================================
+            // 边渲染边加载，直到进度到 100%
+            // ========================================
+            float lastProgress = -1.0f;
+            bool firstFrame = true;
+            for (;;) {
+                const auto frameStart = Clock::now();
+                const float progress = loader.update();
+                if (!renderFrame(ctx)) {
+                    result.skippedFrames++;
+                } else {
+                    result.loadingFrames++;
+                    result.loadingFrameMs.push_back(elapsedMs(frameStart));
+                    if (firstFrame) {
+                        // 首帧要等 GPU 真正执行完（包括这一帧触发的缓冲区上传和着色器编译）
+                        ctx.engine->flushAndWait();
+                        result.firstFrameMs = elapsedMs(start);
+                        firstFrame = false;
+                    }
+                }
+                if (progress != lastProgress) {
+                    result.timeline.emplace_back(elapsedMs(start), progress);
+                    lastProgress = progress;
+                }
+                if (progress >= 1.0f && !firstFrame) {
+                    ctx.engine->flushAndWait();
+                    result.fullyLoadedMs = elapsedMs(start);
+                    result.ok = true;
+                    break;
+                }
+                if (elapsedMs(start) > options.timeoutSeconds * 1000.0) {
+                    result.error = "timed out while loading";
+                    break;
+                }
+            }
+            result.textures = loader.getTextureProvider().getStats();
+
+            // ========================================
+            // 加载完成后的稳定帧耗时
+            // ========================================
+            for (uint32_t i = 0; result.ok && i < options.steadyFrames; i++) {
+                const auto frameStart = Clock::now();
+                if (renderFrame(ctx)) {
+                    result.steadyFrameMs.push_back(elapsedMs(frameStart));
+                } else {
+                    result.skippedFrames++;
+                }
+            }
+
+            ctx.scene->removeEntities(asset->getEntities(), asset->getEntityCount());
+            // 超时的模型还在异步加载，destroy() 会取消剩余的解码
+            loader.destroy(asset);
+        }
+    }
+
+    ctx.scene->remove(sun);
+    ctx.engine->destroy(sun);
+    utils::EntityManager::get().destroy(sun);
+    destroyHeadlessContext(ctx);
+    return result;
+}
+
+void writeModelResult(JsonWriter& json, const ModelResult& result) {
+    json.beginObject();
+    json.key("model").value(result.model);
+    json.key("ok").value(result.ok);
+    if (!result.error.empty()) {
+        json.key("error").value(result.error);
+    }
+    json.key("renderables").value(static_cast<unsigned long>(result.renderableCount));
+    json.key("geometryMs").value(result.geometryMs);
+    json.key("firstFrameMs").value(result.firstFrameMs);
+    json.key("fullyLoadedMs").value(result.fullyLoadedMs);
+    json.key("loadingFrames").value(result.loadingFrames);
+    json.key("skippedFrames").value(result.skippedFrames);
+    json.key("loadingFrameMs"); writeStats(json, computeStats(result.loadingFrameMs));
+    json.key("steadyFrameMs"); writeStats(json, computeStats(result.steadyFrameMs));
+
+    json.key("textures").beginObject();
+    json.key("threads").value(result.textureThreads);
+    json.key("decoded").value(result.textures.decoded);
+    json.key("failed").value(result.textures.failed);
+    json.key("steals").value(result.textures.steals);
+    json.key("budgetWaits").value(result.textures.budgetWaits);
+    json.key("decodeMs").value(result.textures.decodeMs);
+    json.key("peakPendingBytes").value(static_cast<unsigned long long>(result.textures.peakPendingBytes));
+    json.endObject();
+
+    json.key("timeline").beginArray();
+    for (const auto& point : result.timeline) {
+        json.beginObject();
+        json.key("ms").value(point.first);
+        json.key("progress").value(double(point.second));
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+}
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options]\n"
+              << "  --model <file>       glTF/glb relative to --assets, or " << EMBEDDED_HELMET << " (may be repeated)\n"
+              << "  --sync               block in GltfLoader::load() instead of loading progressively\n"
+              << "  --frames <n>         frames rendered after the model is fully loaded (default 10)\n"
+              << "  --timeout <s>        give up on a model after this many seconds (default 60)\n"
+              << "  --texture-threads <n> PNG/JPEG decode threads, 0 = all hardware threads (default 0)\n"
+              << "  --backend <name>     noop, opengl, vulkan or metal (default noop)\n"
+              << "  --width <n>          swapchain width (default 800)\n"
+              << "  --height <n>         swapchain height (default 600)\n"
+              << "  --assets <dir>       macos-demo directory (default macos-demo)\n"
+              << "  --pack <file>        load models from a demo-pack archive instead of --assets\n"
+              << "  --output <file>      write JSON to file instead of stdout\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    TraceSession traceSession;
+    Options options;
+    std::vector<std::string> models;
+    std::string outputPath;
+    std::string packPath;
+
+    // ========================================
+    // 第一步：解析命令行参数
+    // ========================================
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--model") && hasValue) {
+            models.emplace_back(argv[++i]);
+        } else if (!strcmp(arg, "--sync")) {
+            options.sync = true;
+        } else if (!strcmp(arg, "--frames") && hasValue) {
+            options.steadyFrames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--timeout") && hasValue) {
+            options.timeoutSeconds = std::strtod(argv[++i], nullptr);
+        } else if (!strcmp(arg, "--texture-threads") && hasValue) {
+            options.textureThreads = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--backend") && hasValue && parseBackend(argv[i + 1], options.backend)) {
+            options.backendName = argv[++i];
+        } else if (!strcmp(arg, "--width") && hasValue) {
+            options.params.width = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--height") && hasValue) {
+            options.params.height = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--assets") && hasValue) {
+            options.params.assetRoot = argv[++i];
+        } else if (!strcmp(arg, "--pack") && hasValue) {
+            packPath = argv[++i];
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+
+    PackFile pack;
+    if (!packPath.empty()) {
+        if (!pack.open(packPath)) {
+            return 1;
+        }
+        options.params.pack = &pack;
+    }
+    if (models.empty()) {
+        models.assign(std::begin(DEFAULT_MODELS), std::end(DEFAULT_MODELS));
+    }
+    for (const auto& model : models) {
+        if (!model.compare(0, strlen(EMBEDDED_PREFIX), EMBEDDED_PREFIX) && model != EMBEDDED_HELMET) {
+            std::cerr << "Unknown embedded model: " << model << " (only " << EMBEDDED_HELMET << ")" << std::endl;
+            return 1;
+        }
+    }
+
+    // ========================================
+    // 第二步：逐个模型加载并渲染
+    // ========================================
+    std::vector<ModelResult> results;
+    for (const auto& model : models) {
+        std::cerr << "Loading " << model << "..." << std::endl;
+        results.push_back(runModel(model, options));
+        const ModelResult& result = results.back();
+        if (!result.ok) {
+            std::cerr << "  " << model << ": " << result.error << std::endl;
+            continue;
+        }
+        std::cerr << std::fixed << std::setprecision(1)
+                  << "  geometry " << result.geometryMs << " ms, first frame " << result.firstFrameMs
+                  << " ms, fully loaded " << result.fullyLoadedMs << " ms (" << result.loadingFrames
+                  << " frames, " << result.textures.decoded << " textures on "
+                  << result.textureThreads << " threads)" << std::endl;
+    }
+
+    // ========================================
+    // 第三步：输出 JSON
+    // ========================================
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open output file: " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputPath.empty() ? std::cout : file;
+
+    JsonWriter json(out);
+    json.beginObject();
+    json.key("backend").value(options.backendName);
+    json.key("mode").value(options.sync ? "sync" : "progressive");
+    json.key("width").value(options.params.width);
+    json.key("height").value(options.params.height);
+    json.key("models").beginArray();
+    for (const auto& result : results) {
+        writeModelResult(json, result);
+    }
+    json.endArray();
+    json.endObject();
+    out << std::endl;
+
+    bool allOk = true;
+    for (const auto& result : results) {
+        allOk = allOk && result.ok;
+    }
+    return allOk ? 0 : 1;
+}
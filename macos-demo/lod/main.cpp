@@ -0,0 +1,208 @@
+// ========================================
+// demo-lod：离线生成网格的 LOD 链
+// ========================================
+// 用 common/MeshLod 为 filamesh（或 ObjImporter 导入的 .obj 缓存）的每个 part 生成 LOD 链，
+// 所有级别的索引追加到同一个索引缓冲区，LOD 表写在材质名之后，输出到 <name>.lod.filamesh
+// （或 --write-to 指定的路径）。只支持未压缩的交错 filamesh。
+//
+// 打印每一级的三角形数、误差（模型空间单位）和切换距离：按 --height 像素高、--fov 度的垂直视场，
+// 这一级的误差投影到屏幕上等于 --pixel-error 像素时相机到网格的距离，比它更远时 LodSelector 会选这一级。
+// lod:<path> 场景加载带 LOD 表的文件时不需要再简化。
+//
+// 用法：
+//   demo-lod [--levels 4] [--reduction 0.5] [--max-error 0.05] [--pixel-error 1] [--height 1080]
+//            [--fov 45] [--write-to out.filamesh] [--output lod.json] <file.filamesh|file.obj>...
+
+#include "../common/JsonWriter.h"
+#include "../common/MeshLod.h"
+#include "../common/ObjImporter.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace demo;
+
+namespace {
+
+struct FileResult {
+    std::string path;
+    std::string outputPath;
+    LodBuildStats stats;
+    std::vector<double> switchDistance;
+};
+
+std::string lodPath(const std::string& path) {
+    const std::string extension = ".filamesh";
+    if (path.size() >= extension.size() &&
+            path.compare(path.size() - extension.size(), extension.size(), extension) == 0) {
+        return path.substr(0, path.size() - extension.size()) + ".lod" + extension;
+    }
+    return path + ".lod" + extension;
+}
+
+bool writeFile(const std::string& path, const std::vector<uint8_t>& data) {
+    // 先写临时文件再改名，lod: 场景正在读的旧文件不受影响
+    const std::string temporary = path + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+        if (!out) {
+            std::cerr << "Failed to write filamesh file: " << temporary << std::endl;
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to rename filamesh file: " << path << " (" << std::strerror(errno) << ")"
+                  << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+void printStats(const FileResult& result) {
+    const LodBuildStats& stats = result.stats;
+    std::cout << result.path << " -> " << result.outputPath << ": " << stats.partCount << " parts, "
+              << stats.vertexCount << " vertices, " << std::fixed << std::setprecision(2)
+              << stats.simplifyMs << " ms\n";
+    for (uint32_t level = 0; level < stats.levelCount; level++) {
+        const double ratio = stats.triangleCount[0]
+                ? 100.0 * stats.triangleCount[level] / stats.triangleCount[0] : 0.0;
+        std::cout << "  LOD" << level << "  " << std::setw(9) << stats.triangleCount[level] << " triangles"
+                  << std::setw(8) << std::setprecision(1) << ratio << "%"
+                  << "  error " << std::setprecision(6) << stats.error[level]
+                  << "  from " << std::setprecision(2) << result.switchDistance[level] << '\n';
+    }
+}
+
+bool writeJson(const std::string& path, const std::vector<FileResult>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to open output file: " << path << std::endl;
+        return false;
+    }
+    JsonWriter json(out);
+    json.beginObject();
+    json.key("files").beginArray();
+    for (const auto& result : results) {
+        json.beginObject();
+        json.key("path").value(result.path);
+        json.key("output").value(result.outputPath);
+        json.key("parts").value((unsigned long long) result.stats.partCount);
+        json.key("vertices").value((unsigned long long) result.stats.vertexCount);
+        json.key("simplifyMs").value(result.stats.simplifyMs);
+        json.key("levels").beginArray();
+        for (uint32_t level = 0; level < result.stats.levelCount; level++) {
+            json.beginObject();
+            json.key("triangles").value((unsigned long long) result.stats.triangleCount[level]);
+            json.key("error").value(double(result.stats.error[level]));
+            json.key("switchDistance").value(result.switchDistance[level]);
+            json.endObject();
+        }
+        json.endArray();
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    out << '\n';
+    return true;
+}
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options] <file.filamesh|file.obj>...\n"
+              << "  --levels <n>          LOD levels including the original mesh (default 4, max "
+              << MAX_LOD_LEVELS << ")\n"
+              << "  --reduction <r>       triangle ratio of each level to the previous one (default 0.5)\n"
+              << "  --max-error <e>       stop simplifying at this error relative to the mesh size (default 0.05)\n"
+              << "  --pixel-error <px>    screen-space error used for the switch distances (default 1)\n"
+              << "  --height <px>         viewport height used for the switch distances (default 1080)\n"
+              << "  --fov <degrees>       vertical field of view used for the switch distances (default 45)\n"
+              << "  --write-to <file>     output path, single input only (default <name>.lod.filamesh)\n"
+              << "  --output <file>       write the results as JSON\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    LodOptions options;
+    double pixelError = 1.0;
+    double height = 1080.0;
+    double fov = 45.0;
+    std::string writeTo;
+    std::string outputPath;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--levels") && hasValue) {
+            options.levelCount = uint32_t(std::clamp(std::strtol(argv[++i], nullptr, 10), 1l, long(MAX_LOD_LEVELS)));
+        } else if (!strcmp(arg, "--reduction") && hasValue) {
+            options.reduction = std::clamp(std::strtof(argv[++i], nullptr), 0.01f, 0.99f);
+        } else if (!strcmp(arg, "--max-error") && hasValue) {
+            options.maxError = std::max(0.0f, std::strtof(argv[++i], nullptr));
+        } else if (!strcmp(arg, "--pixel-error") && hasValue) {
+            pixelError = std::max(0.01, std::strtod(argv[++i], nullptr));
+        } else if (!strcmp(arg, "--height") && hasValue) {
+            height = std::max(1.0, std::strtod(argv[++i], nullptr));
+        } else if (!strcmp(arg, "--fov") && hasValue) {
+            fov = std::clamp(std::strtod(argv[++i], nullptr), 1.0, 179.0);
+        } else if (!strcmp(arg, "--write-to") && hasValue) {
+            writeTo = argv[++i];
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg[0] != '-') {
+            files.emplace_back(arg);
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+    if (files.empty() || (!writeTo.empty() && files.size() > 1)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // 与 LodSelector 相同：距离 d 处的误差 e 投影为 e / (d * tan(fov / 2)) * (height / 2) 像素
+    const double pixelsPerUnit = height * 0.5 / std::tan(fov * M_PI / 360.0);
+
+    std::vector<FileResult> results;
+    int failures = 0;
+    for (const auto& file : files) {
+        const std::string meshPath = resolveMeshPath(file);
+        std::vector<uint8_t> data;
+        if (!meshPath.empty()) {
+            std::ifstream in(meshPath, std::ios::binary);
+            data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        FileResult result{ file, writeTo.empty() ? lodPath(meshPath) : writeTo, {}, {} };
+        if (meshPath.empty() || data.empty() || !appendFilameshLods(data, options, &result.stats) ||
+                !writeFile(result.outputPath, data)) {
+            std::cerr << "Failed to build LOD chain: " << file << std::endl;
+            failures++;
+            continue;
+        }
+        for (float error : result.stats.error) {
+            result.switchDistance.push_back(error * pixelsPerUnit / pixelError);
+        }
+        printStats(result);
+        results.push_back(result);
+    }
+    if (!outputPath.empty() && !writeJson(outputPath, results)) {
+        return 1;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,551 @@
+// ========================================
+// demo-mathbench：filament math 头文件微基准测试
+// ========================================
+// 覆盖变换热路径上的 math/mat4.h、quat.h、TMatHelpers.h、TQuatHelpers.h、half.h 和 fast.h：
+//   mat4f 乘法/求逆、mat4f::rotation、四元数 slerp/normalize、half 与 float 互转、
+//   fast::isqrt/fast::cos（以及对应的标准库实现作为参照）。
+//
+// 每个用例有两种形式：
+//   - single：单个值的依赖链，上一次的结果是下一次的输入，测的是延迟
+//   - 数组：对 1K~1M 个元素逐个计算，测的是吞吐，也能看出编译器是否向量化
+// 每个用例先自动确定迭代次数，使一次采样不少于 --min-sample-ms，再采样 --samples 次，
+// 以每个元素的纳秒数（ns/op）的中位数作为结果。
+//
+// 只依赖 math 头文件和 demo-common 的统计工具，不链接 filament 静态库，
+// 可以在 x86-64 上单独构建（见 CMakeLists.txt 中的 demo-mathbench）。
+//
+// 用法：
+//   demo-mathbench [--filter mat4f] [--sizes 1,1024,65536,1048576]
+//                  [--samples 15] [--min-sample-ms 5]
+//                  [--output mathbench.json] [--csv mathbench.csv] [--baseline old.csv]
+// --csv 写出的文件可以作为另一次运行的 --baseline，逐项打印相对旧结果的加速比，
+// 用来在提交之间对比（例如验证对这些头文件的 SIMD 改动）。
+
+#include "../common/JsonWriter.h"
+#include "../common/Stats.h"
+
+#include <math/fast.h>
+#include <math/half.h>
+#include <math/mat4.h>
+#include <math/quat.h>
+#include <math/scalar.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace demo;
+using namespace filament::math;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 执行 iterations 轮，数组用例每轮处理全部元素，single 用例每轮计算一次
+using Runner = std::function<void(size_t iterations)>;
+
+// 阻止编译器把结果当作无用值删除
+template<typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// 让编译器认为内存已被修改，避免把多轮之间不变的计算提到循环外
+inline void clobber() {
+    asm volatile("" : : : "memory");
+}
+
+// ========================================
+// 测试数据
+// ========================================
+// 固定种子，保证每次运行（以及不同提交之间）使用相同的输入
+
+float randomFloat(std::mt19937& rng, float lo, float hi) {
+    return std::uniform_real_distribution<float>(lo, hi)(rng);
+}
+
+float3 randomAxis(std::mt19937& rng) {
+    return normalize(float3{ randomFloat(rng, -1, 1), randomFloat(rng, -1, 1), 1.0f });
+}
+
+quatf randomQuat(std::mt19937& rng) {
+    return quatf::fromAxisAngle(randomAxis(rng), randomFloat(rng, -F_PI, F_PI));
+}
+
+// 旋转 x 缩放 + 平移，和场景中的变换矩阵一样条件良好，求逆不会溢出
+mat4f randomTransform(std::mt19937& rng) {
+    const float3 t{ randomFloat(rng, -10, 10), randomFloat(rng, -10, 10), randomFloat(rng, -10, 10) };
+    return mat4f::translation(t) *
+           mat4f::rotation(randomFloat(rng, -F_PI, F_PI), randomAxis(rng)) *
+           mat4f::scaling(float3{ randomFloat(rng, 0.5f, 2.0f) });
+}
+
+template<typename T, typename Generate>
+std::vector<T> generate(size_t size, Generate generate) {
+    std::vector<T> values(size);
+    for (auto& value : values) {
+        value = generate();
+    }
+    return values;
+}
+
+// 对 in 中的每个元素执行 op，结果写入 out
+template<typename In, typename Out, typename Op>
+Runner arrayRunner(std::vector<In> input, Op op) {
+    auto in = std::make_shared<std::vector<In>>(std::move(input));
+    auto out = std::make_shared<std::vector<Out>>(in->size());
+    return [in, out, op](size_t iterations) {
+        const In* src = in->data();
+        Out* dst = out->data();
+        const size_t size = in->size();
+        for (size_t iteration = 0; iteration < iterations; iteration++) {
+            for (size_t i = 0; i < size; i++) {
+                dst[i] = op(src[i]);
+            }
+            clobber();
+        }
+    };
+}
+
+// 单个值的依赖链：value = op(value)
+template<typename T, typename Op>
+Runner chainRunner(T initial, Op op) {
+    return [initial, op](size_t iterations) {
+        T value = initial;
+        for (size_t iteration = 0; iteration < iterations; iteration++) {
+            value = op(value);
+        }
+        keep(value);
+    };
+}
+
+// ========================================
+// 用例
+// ========================================
+struct BenchmarkDef {
+    const char* name;
+    std::function<Runner(size_t size, std::mt19937& rng)> makeArray;
+    std::function<Runner(std::mt19937& rng)> makeSingle;
+};
+
+struct MatPair { mat4f a; mat4f b; };
+struct SlerpArgs { quatf p; quatf q; float t; };
+
+std::vector<BenchmarkDef> getBenchmarks() {
+    return {
+        { "mat4f.multiply",
+            [](size_t size, std::mt19937& rng) {
+                return arrayRunner<MatPair, mat4f>(generate<MatPair>(size, [&] {
+                    return MatPair{ randomTransform(rng), randomTransform(rng) };
+                }), [](const MatPair& m) { return m.a * m.b; });
+            },
+            [](std::mt19937& rng) {
+                // 纯旋转矩阵连乘，数值保持有界
+                const mat4f r = mat4f::rotation(randomFloat(rng, -F_PI, F_PI), randomAxis(rng));
+                return chainRunner(mat4f{}, [r](const mat4f& m) { return m * r; });
+            } },
+        { "mat4f.inverse",
+            [](size_t size, std::mt19937& rng) {
+                return arrayRunner<mat4f, mat4f>(generate<mat4f>(size, [&] {
+                    return randomTransform(rng);
+                }), [](const mat4f& m) { return inverse(m); });
+            },
+            [](std::mt19937& rng) {
+                return chainRunner(randomTransform(rng), [](const mat4f& m) { return inverse(m); });
+            } },
+        { "mat4f.rotation",
+            [](size_t size, std::mt19937& rng) {
+                const float3 axis = randomAxis(rng);
+                return arrayRunner<float, mat4f>(generate<float>(size, [&] {
+                    return randomFloat(rng, -F_PI, F_PI);
+                }), [axis](float angle) { return mat4f::rotation(angle, axis); });
+            },
+            [](std::mt19937& rng) {
+                const float3 axis = randomAxis(rng);
+                return chainRunner(1.0f, [axis](float angle) {
+                    return mat4f::rotation(angle, axis)[0][0] + 1.0f;
+                });
+            } },
+        { "quatf.slerp",
+            [](size_t size, std::mt19937& rng) {
+                return arrayRunner<SlerpArgs, quatf>(generate<SlerpArgs>(size, [&] {
+                    return SlerpArgs{ randomQuat(rng), randomQuat(rng), randomFloat(rng, 0, 1) };
+                }), [](const SlerpArgs& s) { return slerp(s.p, s.q, s.t); });
+            },
+            [](std::mt19937& rng) {
+                // 在两个目标之间交替逼近，避免收敛到几乎重合的四元数走 lerp 分支
+                const quatf q0 = randomQuat(rng);
+                const quatf q1 = randomQuat(rng);
+                auto state = std::make_pair(randomQuat(rng), false);
+                return chainRunner(state, [q0, q1](const std::pair<quatf, bool>& s) {
+                    return std::make_pair(slerp(s.first, s.second ? q0 : q1, 0.5f), !s.second);
+                });
+            } },
+        { "quatf.normalize",
+            [](size_t size, std::mt19937& rng) {
+                return arrayRunner<quatf, quatf>(generate<quatf>(size, [&] {
+                    return randomQuat(rng) * randomFloat(rng, 0.5f, 2.0f);
+                }), [](const quatf& q) { return normalize(q); });
+            },
+            [](std::mt19937& rng) {
+                return chainRunner(randomQuat(rng), [](const quatf& q) { return normalize(q * 1.5f); });
+            } },
+        { "half.fromFloat",
+            [](size_t size, std::mt19937& rng) {
+                return arrayRunner<float, half>(generate<float>(size, [&] {
+                    return randomFloat(rng, -1000, 1000);
+                }), [](float f) { return half(f); });
+            },
+            [](std::mt19937&) {
+                return chainRunner(half(0.5f), [](half h) { return half(float(h) * 0.5f + 0.75f); });
+            } },
+        { "half.toFloat",
+            [](size_t size, std::mt19937& rng) {
+                return arrayRunner<half, float>(generate<half>(size, [&] {
+                    return half(randomFloat(rng, -1000, 1000));
+                }), [](half h) { return float(h); });
+            },
+            nullptr },
+        { "fast.isqrt",
+            [](size_t size, std::mt19937& rng) {
+                return arrayRunner<float, float>(generate<float>(size, [&] {
+                    return randomFloat(rng, 0.001f, 1000);
+                }), [](float x) { return fast::isqrt(x); });
+            },
+            [](std::mt19937&) {
+                return chainRunner(2.0f, [](float x) { return fast::isqrt(x) + 1.0f; });
+            } },
+        { "std.isqrt",
+            [](size_t size, std::mt19937& rng) {
+                return arrayRunner<float, float>(generate<float>(size, [&] {
+                    return randomFloat(rng, 0.001f, 1000);
+                }), [](float x) { return 1.0f / std::sqrt(x); });
+            },
+            [](std::mt19937&) {
+                return chainRunner(2.0f, [](float x) { return 1.0f / std::sqrt(x) + 1.0f; });
+            } },
+        { "fast.cos",
+            [](size_t size, std::mt19937& rng) {
+                return arrayRunner<float, float>(generate<float>(size, [&] {
+                    return randomFloat(rng, -F_PI, F_PI);
+                }), [](float x) { return fast::cos(x); });
+            },
+            [](std::mt19937&) {
+                // fast::cos 的输入必须在 [-pi, pi] 内
+                return chainRunner(1.0f, [](float x) { return fast::cos(x) * 3.0f; });
+            } },
+        { "std.cos",
+            [](size_t size, std::mt19937& rng) {
+                return arrayRunner<float, float>(generate<float>(size, [&] {
+                    return randomFloat(rng, -F_PI, F_PI);
+                }), [](float x) { return std::cos(x); });
+            },
+            [](std::mt19937&) {
+                return chainRunner(1.0f, [](float x) { return std::cos(x) * 3.0f; });
+            } },
+    };
+}
+
+// ========================================
+// 计时
+// ========================================
+struct Options {
+    std::string filter;
+    std::vector<size_t> sizes = { 1, 1024, 65536, 1048576 };
+    uint32_t samples = 15;
+    double minSampleMs = 5.0;
+};
+
+struct Result {
+    std::string name;
+    size_t size = 0;
+    uint64_t iterations = 0;
+    SampleStats nsPerOp;
+};
+
+double runOnce(const Runner& run, size_t iterations) {
+    const auto start = Clock::now();
+    run(iterations);
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+Result measure(const std::string& name, size_t size, const Runner& run, const Options& options) {
+    Result result;
+    result.name = name;
+    result.size = size;
+
+    // 预热一次，再把迭代次数加倍直到单次采样足够长
+    size_t iterations = 1;
+    runOnce(run, iterations);
+    while (runOnce(run, iterations) < options.minSampleMs && iterations < (size_t(1) << 40)) {
+        iterations *= 2;
+    }
+    result.iterations = iterations;
+
+    std::vector<double> samples;
+    samples.reserve(options.samples);
+    const double ops = double(iterations) * double(size);
+    for (uint32_t i = 0; i < options.samples; i++) {
+        samples.push_back(runOnce(run, iterations) * 1e6 / ops);
+    }
+    result.nsPerOp = computeStats(std::move(samples));
+    return result;
+}
+
+std::string sizeLabel(size_t size) {
+    return size == 1 ? "single" : std::to_string(size);
+}
+
+// ========================================
+// 输出
+// ========================================
+const char* getArchitecture() {
+#if defined(__x86_64__) || defined(_M_X64)
+    return "x86_64";
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    return "arm64";
+#else
+    return "unknown";
+#endif
+}
+
+// 影响这些头文件代码生成的指令集宏，对比不同构建时需要一致
+std::vector<const char*> getSimdFeatures() {
+    std::vector<const char*> features;
+#ifdef __SSE4_1__
+    features.push_back("sse4.1");
+#endif
+#ifdef __AVX__
+    features.push_back("avx");
+#endif
+#ifdef __AVX2__
+    features.push_back("avx2");
+#endif
+#ifdef __FMA__
+    features.push_back("fma");
+#endif
+#ifdef __F16C__
+    features.push_back("f16c");
+#endif
+#ifdef __ARM_NEON
+    features.push_back("neon");
+#endif
+#ifdef __ARM_FP16_FORMAT_IEEE
+    features.push_back("fp16");
+#endif
+    return features;
+}
+
+void writeJson(std::ostream& out, const std::vector<Result>& results, const Options& options) {
+    JsonWriter json(out);
+    json.beginObject();
+    json.key("architecture").value(getArchitecture());
+#ifdef __VERSION__
+    json.key("compiler").value(__VERSION__);
+#endif
+    json.key("simd").beginArray();
+    for (const char* feature : getSimdFeatures()) {
+        json.value(feature);
+    }
+    json.endArray();
+    json.key("samples").value(options.samples);
+    json.key("minSampleMs").value(options.minSampleMs);
+    json.key("benchmarks").beginArray();
+    for (const Result& result : results) {
+        json.beginObject();
+        json.key("name").value(result.name);
+        json.key("size").value(sizeLabel(result.size));
+        json.key("iterations").value(result.iterations);
+        json.key("nsPerOp");
+        writeStats(json, result.nsPerOp);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    out << std::endl;
+}
+
+// CSV 每行：name,size,p50,min（ns/op）
+void writeCsv(std::ostream& out, const std::vector<Result>& results) {
+    out << "name,size,p50,min\n";
+    for (const Result& result : results) {
+        out << result.name << ',' << sizeLabel(result.size) << ','
+            << result.nsPerOp.p50 << ',' << result.nsPerOp.min << '\n';
+    }
+}
+
+// 读取 writeCsv() 的输出，键为 "name/size"，值为 p50
+bool readBaseline(const std::string& path, std::map<std::string, double>& baseline) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open baseline file: " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    std::getline(file, line);   // 表头
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string name, size, p50;
+        if (std::getline(fields, name, ',') && std::getline(fields, size, ',') &&
+                std::getline(fields, p50, ',')) {
+            baseline[name + "/" + size] = std::atof(p50.c_str());
+        }
+    }
+    return true;
+}
+
+void printResult(const Result& result, const std::map<std::string, double>& baseline) {
+    const std::string label = sizeLabel(result.size);
+    std::cerr << "  " << std::left << std::setw(18) << result.name << std::setw(9) << label
+              << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << result.nsPerOp.p50
+              << std::setw(12) << result.nsPerOp.min
+              << std::setw(12) << result.nsPerOp.p90;
+    auto it = baseline.find(result.name + "/" + label);
+    if (it != baseline.end() && result.nsPerOp.p50 > 0.0) {
+        std::cerr << std::setw(10) << std::setprecision(2) << it->second / result.nsPerOp.p50 << 'x';
+    }
+    std::cerr << std::defaultfloat << std::endl;
+}
+
+bool parseSizes(const char* list, std::vector<size_t>& sizes) {
+    sizes.clear();
+    std::istringstream items(list);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        const size_t size = std::strtoul(item.c_str(), nullptr, 10);
+        if (!size) {
+            return false;
+        }
+        sizes.push_back(size);
+    }
+    return !sizes.empty();
+}
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options]\n"
+              << "  --filter <text>         only run benchmarks whose name contains text\n"
+              << "  --sizes <list>          element counts, 1 = single-value latency chain\n"
+              << "                          (default 1,1024,65536,1048576)\n"
+              << "  --samples <n>           samples per benchmark (default 15)\n"
+              << "  --min-sample-ms <ms>    minimum duration of one sample (default 5)\n"
+              << "  --output <file>         write JSON to file instead of stdout\n"
+              << "  --csv <file>            also write name,size,p50,min as CSV\n"
+              << "  --baseline <file>       CSV from an earlier run, prints speedup per benchmark\n"
+              << "  --list                  list benchmark names\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::string outputPath;
+    std::string csvPath;
+    std::string baselinePath;
+
+    // ========================================
+    // 第一步：解析命令行参数
+    // ========================================
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--filter") && hasValue) {
+            options.filter = argv[++i];
+        } else if (!strcmp(arg, "--sizes") && hasValue && parseSizes(argv[i + 1], options.sizes)) {
+            i++;
+        } else if (!strcmp(arg, "--samples") && hasValue) {
+            options.samples = std::max(1u, uint32_t(std::strtoul(argv[++i], nullptr, 10)));
+        } else if (!strcmp(arg, "--min-sample-ms") && hasValue) {
+            options.minSampleMs = std::atof(argv[++i]);
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else if (!strcmp(arg, "--csv") && hasValue) {
+            csvPath = argv[++i];
+        } else if (!strcmp(arg, "--baseline") && hasValue) {
+            baselinePath = argv[++i];
+        } else if (!strcmp(arg, "--list")) {
+            for (const auto& benchmark : getBenchmarks()) {
+                std::cout << benchmark.name << std::endl;
+            }
+            return 0;
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+
+    std::map<std::string, double> baseline;
+    if (!baselinePath.empty() && !readBaseline(baselinePath, baseline)) {
+        return 1;
+    }
+
+    // ========================================
+    // 第二步：逐个用例、逐个规模计时
+    // ========================================
+    std::cerr << "[mathbench] " << getArchitecture() << ", ns/op\n"
+              << "  " << std::left << std::setw(18) << "benchmark" << std::setw(9) << "size"
+              << std::right << std::setw(12) << "p50" << std::setw(12) << "min"
+              << std::setw(12) << "p90";
+    if (!baseline.empty()) {
+        std::cerr << std::setw(11) << "speedup";
+    }
+    std::cerr << std::endl;
+
+    std::vector<Result> results;
+    for (const auto& benchmark : getBenchmarks()) {
+        if (!options.filter.empty() && !strstr(benchmark.name, options.filter.c_str())) {
+            continue;
+        }
+        for (size_t size : options.sizes) {
+            // 每个用例、每个规模使用相同的种子，结果与运行哪些用例无关
+            std::mt19937 rng(12345);
+            Runner run;
+            if (size == 1) {
+                if (!benchmark.makeSingle) {
+                    continue;
+                }
+                run = benchmark.makeSingle(rng);
+            } else {
+                run = benchmark.makeArray(size, rng);
+            }
+            results.push_back(measure(benchmark.name, size, run, options));
+            printResult(results.back(), baseline);
+        }
+    }
+
+    // ========================================
+    // 第三步：输出结果
+    // ========================================
+    if (!csvPath.empty()) {
+        std::ofstream csv(csvPath);
+        if (!csv.is_open()) {
+            std::cerr << "Failed to open CSV file: " << csvPath << std::endl;
+            return 1;
+        }
+        writeCsv(csv, results);
+    }
+
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open output file: " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    writeJson(outputPath.empty() ? std::cout : file, results, options);
+    return 0;
+}
@@ -0,0 +1,247 @@
+// ========================================
+// demo-meshlet：簇划分与 CPU 簇剔除的离线测量
+// ========================================
+// 用 common/Meshlet 把 filamesh（或 ObjImporter 导入的 .obj 缓存）切成簇，打印簇数、平均三角形数、
+// 法线锥可用于背面测试的簇的比例和建簇耗时。然后让相机以 --distance 倍的网格半径绕网格转一圈
+// （--frames 帧，与 meshlet:<path> 场景的相机相同），每帧做一次视锥 + 法线锥剔除，
+// 打印被视锥/背面剔除的簇、留下的三角形比例和每帧剔除耗时（中位数）。
+//
+// 剔除依次用 1、2、4 ... 个线程（到 --threads 为止），打印相对单线程的加速比；
+// MeshletCuller 每个线程至少分到 1024 个簇，lucy 这样只有几百个簇的网格只用调用线程，
+// 线程扩展要用更大的网格观察。
+//
+// 用法：
+//   demo-meshlet [--max-vertices 64] [--max-triangles 124] [--cone-weight 0.5] [--threads 0]
+//                [--frames 360] [--distance 1.1] [--output meshlet.json] <file.filamesh|file.obj>...
+
+#include "../common/JsonWriter.h"
+#include "../common/Meshlet.h"
+#include "../common/ObjImporter.h"
+#include "../common/Parallel.h"
+#include "../common/Stats.h"
+
+#include <math/mat4.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace demo;
+using namespace filament::math;
+
+namespace {
+
+struct CullPoint {
+    uint32_t threadCount = 0;
+    SampleStats cullMs;
+    double visibleTriangles = 0.0;      // 留下的三角形占比（所有帧平均）
+    double frustumCulled = 0.0;         // 每帧被视锥剔除的簇数（平均）
+    double backfaceCulled = 0.0;        // 每帧被背面剔除的簇数（平均）
+};
+
+struct FileResult {
+    std::string path;
+    size_t meshletCount = 0;
+    size_t triangleCount = 0;
+    size_t coneCount = 0;               // coneCutoff < 1，可以做背面测试的簇
+    double buildMs = 0.0;
+    std::vector<CullPoint> points;
+};
+
+// 与 meshlet:<path> 场景相同：网格缩放到单位半径，相机绕 y 轴转一圈并上下摆动
+mat4f cameraViewProjection(size_t frame, size_t frameCount, float distance, float3& eye) {
+    const float angle = float(frame) / float(frameCount) * 2.0f * float(M_PI);
+    eye = float3{ distance * std::sin(angle), 0.3f * std::sin(angle * 2.0f), distance * std::cos(angle) };
+    const mat4f view = inverse(mat4f::lookAt(eye, float3{ 0.0f, 0.2f, 0.0f }, float3{ 0.0f, 1.0f, 0.0f }));
+    return mat4f::perspective(45.0f, 16.0f / 9.0f, 0.05f, 20.0f) * view;
+}
+
+bool measureFile(const std::string& file, const MeshletOptions& options, uint32_t maxThreads,
+        size_t frameCount, float distance, FileResult& result) {
+    result.path = file;
+    const std::string meshPath = resolveMeshPath(file);
+    if (meshPath.empty()) {
+        return false;
+    }
+    std::ifstream in(meshPath, std::ios::binary);
+    const std::vector<uint8_t> data(std::istreambuf_iterator<char>(in), {});
+    MeshletMesh mesh;
+    const auto start = std::chrono::steady_clock::now();
+    if (data.empty() || !buildFilameshMeshlets(data.data(), data.size(), options, mesh) ||
+            mesh.meshlets.empty()) {
+        return false;
+    }
+    result.buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.meshletCount = mesh.meshlets.size();
+    result.triangleCount = mesh.indices.size() / 3;
+
+    // 模型矩阵把所有簇的包围盒缩放到单位半径
+    float3 minimum = mesh.meshlets[0].bounds.getMin();
+    float3 maximum = mesh.meshlets[0].bounds.getMax();
+    for (const Meshlet& meshlet : mesh.meshlets) {
+        minimum = min(minimum, meshlet.bounds.getMin());
+        maximum = max(maximum, meshlet.bounds.getMax());
+        result.coneCount += meshlet.coneCutoff < 1.0f ? 1 : 0;
+    }
+    const float3 center = (minimum + maximum) * 0.5f;
+    const float radius = std::max(length(maximum - minimum) * 0.5f, 1e-6f);
+    const mat4f model = mat4f::scaling(1.0f / radius) * mat4f::translation(-center);
+    const mat4f inverseModel = inverse(model);
+
+    std::cout << file << ": " << result.meshletCount << " meshlets, " << std::fixed << std::setprecision(1)
+              << double(result.triangleCount) / double(result.meshletCount) << " triangles/meshlet, "
+              << 100.0 * double(result.coneCount) / double(result.meshletCount) << "% with a normal cone, "
+              << std::setprecision(2) << result.buildMs << " ms\n";
+
+    std::vector<uint32_t> output(mesh.indices.size());
+    std::vector<MeshletRange> ranges;
+    for (uint32_t threadCount = 1;; threadCount = std::min(threadCount * 2, maxThreads)) {
+        MeshletCuller culler(threadCount);
+        CullPoint point;
+        point.threadCount = threadCount;
+        std::vector<double> samples;
+        uint64_t visible = 0;
+        uint64_t total = 0;
+        for (size_t frame = 0; frame < frameCount; frame++) {
+            float3 eye;
+            const mat4f viewProjection = cameraViewProjection(frame, frameCount, distance, eye);
+            const float4 modelEye = inverseModel * float4(eye, 1.0f);
+            culler.cull(mesh, viewProjection * model, modelEye.xyz, output.data(), ranges);
+            const MeshletCullStats& stats = culler.getStats();
+            samples.push_back(stats.cullMs);
+            visible += stats.visibleTriangles;
+            total += stats.triangles;
+            point.frustumCulled += stats.frustumCulled;
+            point.backfaceCulled += stats.backfaceCulled;
+        }
+        point.cullMs = computeStats(samples);
+        point.visibleTriangles = total ? double(visible) / double(total) : 0.0;
+        point.frustumCulled /= double(frameCount);
+        point.backfaceCulled /= double(frameCount);
+        result.points.push_back(point);
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << "  threads " << std::setw(2) << threadCount << ": " << std::setw(7) << point.cullMs.p50
+                  << " ms  x" << std::setprecision(2) << result.points.front().cullMs.p50 / point.cullMs.p50
+                  << "  frustum " << std::setprecision(1) << point.frustumCulled
+                  << "  backface " << point.backfaceCulled
+                  << "  visible " << 100.0 * point.visibleTriangles << "% triangles\n";
+        if (threadCount == maxThreads) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool writeJson(const std::string& path, const std::vector<FileResult>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to open output file: " << path << std::endl;
+        return false;
+    }
+    JsonWriter json(out);
+    json.beginObject();
+    json.key("files").beginArray();
+    for (const auto& result : results) {
+        json.beginObject();
+        json.key("path").value(result.path);
+        json.key("meshlets").value((unsigned long long) result.meshletCount);
+        json.key("triangles").value((unsigned long long) result.triangleCount);
+        json.key("meshletsWithCone").value((unsigned long long) result.coneCount);
+        json.key("buildMs").value(result.buildMs);
+        json.key("runs").beginArray();
+        for (const auto& point : result.points) {
+            json.beginObject();
+            json.key("threads").value((unsigned long long) point.threadCount);
+            json.key("cullMs");
+            writeStats(json, point.cullMs);
+            json.key("speedup").value(point.cullMs.p50 > 0.0
+                    ? result.points.front().cullMs.p50 / point.cullMs.p50 : 0.0);
+            json.key("visibleTriangles").value(point.visibleTriangles);
+            json.key("frustumCulled").value(point.frustumCulled);
+            json.key("backfaceCulled").value(point.backfaceCulled);
+            json.endObject();
+        }
+        json.endArray();
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    out << '\n';
+    return true;
+}
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options] <file.filamesh|file.obj>...\n"
+              << "  --max-vertices <n>    vertices per meshlet (default 64)\n"
+              << "  --max-triangles <n>   triangles per meshlet, at most 256 (default 124)\n"
+              << "  --cone-weight <w>     0..1, prefer triangles facing the same way (default 0.5)\n"
+              << "  --threads <n>         time culling with 1, 2, 4 ... n threads, 0 = all hardware threads (default 0)\n"
+              << "  --frames <n>          camera positions along the orbit (default 360)\n"
+              << "  --distance <d>        orbit radius relative to the mesh radius (default 1.1)\n"
+              << "  --output <file>       write the results as JSON\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    MeshletOptions options;
+    uint32_t threadCount = 0;
+    size_t frameCount = 360;
+    float distance = 1.1f;
+    std::string outputPath;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--max-vertices") && hasValue) {
+            options.maxVertices = uint32_t(std::clamp(std::strtol(argv[++i], nullptr, 10), 3l, 65536l));
+        } else if (!strcmp(arg, "--max-triangles") && hasValue) {
+            options.maxTriangles = uint32_t(std::clamp(std::strtol(argv[++i], nullptr, 10), 1l, 256l));
+        } else if (!strcmp(arg, "--cone-weight") && hasValue) {
+            options.coneWeight = std::clamp(std::strtof(argv[++i], nullptr), 0.0f, 1.0f);
+        } else if (!strcmp(arg, "--threads") && hasValue) {
+            threadCount = uint32_t(std::max(0l, std::strtol(argv[++i], nullptr, 10)));
+        } else if (!strcmp(arg, "--frames") && hasValue) {
+            frameCount = size_t(std::max(1l, std::strtol(argv[++i], nullptr, 10)));
+        } else if (!strcmp(arg, "--distance") && hasValue) {
+            distance = std::max(0.01f, std::strtof(argv[++i], nullptr));
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg[0] != '-') {
+            files.emplace_back(arg);
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+    if (files.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<FileResult> results;
+    int failures = 0;
+    for (const auto& file : files) {
+        FileResult result;
+        if (!measureFile(file, options, resolveThreadCount(threadCount), frameCount, distance, result)) {
+            std::cerr << "Failed to build meshlets: " << file << std::endl;
+            failures++;
+            continue;
+        }
+        results.push_back(result);
+    }
+    if (!outputPath.empty() && !writeJson(outputPath, results)) {
+        return 1;
+    }
+    return failures ? 1 : 0;
+}
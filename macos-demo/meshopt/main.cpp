@@ -0,0 +1,165 @@
+// ========================================
+// demo-meshopt：统计并优化网格的索引/顶点顺序
+// ========================================
+// 对每个 filamesh 文件用 common/MeshOptimizer 模拟后变换缓存和顶点读取，打印优化前后的
+// ACMR（每个三角形变换的顶点数）、ATVR（每个顶点被变换的次数）和 overfetch（读取的顶点字节倍数）。
+// --write 时把优化结果原地写回（先写临时文件再改名），只支持未压缩的交错 filamesh，
+// 例如 ObjImporter 的缓存和 filamesh 工具不带 --compress 的输出。
+//
+// .obj 文件不读缓存重新导入（ObjImporter 默认在写出缓存前优化），打印导入时的优化前后指标
+// 和写出的缓存文件的 overfetch。--cache-size 改变 filamesh 优化和模拟使用的缓存大小
+// （Tipsify 按这个大小选下一个扇心）。
+//
+// 用法：
+//   demo-meshopt [--cache-size 16] [--write] [--output meshopt.json] <file.filamesh|file.obj>...
+
+#include "../common/JsonWriter.h"
+#include "../common/MeshOptimizer.h"
+#include "../common/ObjImporter.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace demo;
+
+namespace {
+
+struct FileResult {
+    std::string path;
+    MeshOptimizeStats stats;
+};
+
+bool hasExtension(const std::string& path, const std::string& extension) {
+    return path.size() >= extension.size() &&
+            path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+void printStats(const FileResult& result) {
+    const MeshOptimizeStats& stats = result.stats;
+    std::cout << result.path << ": " << stats.triangleCount << " triangles, " << stats.vertexCount
+              << " vertices, " << std::fixed << std::setprecision(2) << stats.optimizeMs << " ms\n"
+              << std::setprecision(3)
+              << "  ACMR      " << stats.before.acmr << " -> " << stats.after.acmr << '\n'
+              << "  ATVR      " << stats.before.atvr << " -> " << stats.after.atvr << '\n';
+    if (stats.after.overfetch > 0.0f) {
+        std::cout << "  overfetch " << stats.before.overfetch << " -> " << stats.after.overfetch << '\n';
+    }
+}
+
+void writeCacheStats(JsonWriter& json, const MeshCacheStats& stats) {
+    json.beginObject();
+    json.key("acmr").value(stats.acmr);
+    json.key("atvr").value(stats.atvr);
+    json.key("overfetch").value(stats.overfetch);
+    json.endObject();
+}
+
+bool writeJson(const std::string& path, const std::vector<FileResult>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to open output file: " << path << std::endl;
+        return false;
+    }
+    JsonWriter json(out);
+    json.beginObject();
+    json.key("files").beginArray();
+    for (const auto& result : results) {
+        json.beginObject();
+        json.key("path").value(result.path);
+        json.key("triangles").value((unsigned long long) result.stats.triangleCount);
+        json.key("vertices").value((unsigned long long) result.stats.vertexCount);
+        json.key("optimizeMs").value(result.stats.optimizeMs);
+        json.key("before");
+        writeCacheStats(json, result.stats.before);
+        json.key("after");
+        writeCacheStats(json, result.stats.after);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    out << '\n';
+    return true;
+}
+
+// 重新导入 OBJ，导入时的指标没有 overfetch，用写出的缓存补上
+bool importFile(const std::string& path, FileResult& result) {
+    ObjImportOptions options;
+    options.readCache = false;
+    const ObjImportResult imported = importObj(path, options);
+    if (!imported.isValid()) {
+        return false;
+    }
+    MeshOptimizeStats cached;
+    if (!optimizeFilamesh(imported.filameshPath, false, cached)) {
+        return false;
+    }
+    result.path = imported.filameshPath;
+    result.stats.before = imported.cacheBefore;
+    result.stats.after = imported.cacheAfter;
+    result.stats.after.overfetch = cached.before.overfetch;
+    result.stats.triangleCount = imported.triangleCount;
+    result.stats.vertexCount = imported.vertexCount;
+    result.stats.optimizeMs = imported.optimizeMs;
+    return true;
+}
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options] <file.filamesh|file.obj>...\n"
+              << "  --cache-size <n>   post-transform cache size to optimize for and simulate, .filamesh only (default 16)\n"
+              << "  --write            rewrite .filamesh files in place with the optimized order\n"
+              << "  --output <file>    write the results as JSON\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    uint32_t cacheSize = DEFAULT_VERTEX_CACHE_SIZE;
+    bool write = false;
+    std::string outputPath;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--cache-size") && hasValue) {
+            cacheSize = uint32_t(std::max(3l, std::strtol(argv[++i], nullptr, 10)));
+        } else if (!strcmp(arg, "--write")) {
+            write = true;
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg[0] != '-') {
+            files.emplace_back(arg);
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+    if (files.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<FileResult> results;
+    int failures = 0;
+    for (const auto& file : files) {
+        FileResult result{ file, {} };
+        const bool ok = hasExtension(file, ".obj") ? importFile(file, result)
+                : optimizeFilamesh(file, write, result.stats, cacheSize);
+        if (!ok) {
+            failures++;
+            continue;
+        }
+        printStats(result);
+        results.push_back(result);
+    }
+    if (!outputPath.empty() && !writeJson(outputPath, results)) {
+        return 1;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,259 @@
+// ========================================
+// demo-objimport：把 OBJ 导入成缓存的 filamesh，并测量导入耗时
+// ========================================
+// 对每个 OBJ 文件调用 common/ObjImporter 的 importObj()，在源文件旁边写出
+// <name>.<内容哈希>.filamesh，之后的 importObj()/resolveMeshPath() 直接使用缓存。
+// 打印每个阶段（哈希、并行解析、合并、去重、切线空间、索引优化、写出）的耗时，
+// 以及索引优化前后的 ACMR/ATVR（--no-optimize 时保持 OBJ 中的三角形顺序）。
+//
+// --sweep 时不读写缓存，对每个文件依次用 1、2、4 ... 个线程（到 --threads 为止）各导入 --repeat 次，
+// 打印中位耗时和相对单线程的加速比，用来观察导入随核数的扩展情况（例如 models/lucy/lucy.obj）。
+//
+// 用法：
+//   demo-objimport [--threads 0] [--no-cache] [--no-optimize] <file.obj>...
+//   demo-objimport --sweep [--threads 8] [--repeat 5] [--output objimport.json] <file.obj>...
+// 不指定文件时导入 --assets 下 assets/models/*/*.obj 和 models/lucy/lucy.obj。
+
+#include "../common/JsonWriter.h"
+#include "../common/ObjImporter.h"
+#include "../common/Parallel.h"
+#include "../common/Stats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace demo;
+
+namespace {
+
+struct SweepPoint {
+    uint32_t threadCount;
+    SampleStats totalMs;
+    ObjImportResult last;       // 最后一次导入的分阶段耗时
+};
+
+struct SweepResult {
+    std::string path;
+    std::vector<SweepPoint> points;
+};
+
+std::vector<std::string> findDefaultFiles(const std::string& assetRoot) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> files;
+    std::error_code error;
+    for (const auto& entry : fs::recursive_directory_iterator(assetRoot + "/assets/models", error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+            files.push_back(entry.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    const std::string lucy = assetRoot + "/models/lucy/lucy.obj";
+    if (fs::exists(lucy, error)) {
+        files.push_back(lucy);
+    }
+    return files;
+}
+
+void printStages(const ObjImportResult& result) {
+    std::cout << std::fixed << std::setprecision(2)
+              << "hash " << result.hashMs << " parse " << result.parseMs << " merge " << result.mergeMs
+              << " dedup " << result.dedupMs << " tangents " << result.tangentMs
+              << " optimize " << result.optimizeMs << " write " << result.writeMs << " ms";
+}
+
+void writeResult(JsonWriter& json, const ObjImportResult& result) {
+    json.beginObject();
+    json.key("cacheHit").value(result.cacheHit);
+    json.key("objBytes").value((unsigned long long) result.objBytes);
+    json.key("positions").value((unsigned long long) result.positionCount);
+    json.key("triangles").value((unsigned long long) result.triangleCount);
+    json.key("vertices").value((unsigned long long) result.vertexCount);
+    json.key("parts").value((unsigned long long) result.partCount);
+    json.key("generatedNormals").value(result.generatedNormals);
+    json.key("hashMs").value(result.hashMs);
+    json.key("parseMs").value(result.parseMs);
+    json.key("mergeMs").value(result.mergeMs);
+    json.key("dedupMs").value(result.dedupMs);
+    json.key("tangentMs").value(result.tangentMs);
+    json.key("optimizeMs").value(result.optimizeMs);
+    json.key("writeMs").value(result.writeMs);
+    json.key("totalMs").value(result.totalMs);
+    json.key("acmrBefore").value(result.cacheBefore.acmr);
+    json.key("acmrAfter").value(result.cacheAfter.acmr);
+    json.key("atvrBefore").value(result.cacheBefore.atvr);
+    json.key("atvrAfter").value(result.cacheAfter.atvr);
+    json.endObject();
+}
+
+bool writeSweepJson(const std::string& path, const std::vector<SweepResult>& sweeps) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to open output file: " << path << std::endl;
+        return false;
+    }
+    JsonWriter json(out);
+    json.beginObject();
+    json.key("files").beginArray();
+    for (const auto& sweep : sweeps) {
+        json.beginObject();
+        json.key("path").value(sweep.path);
+        json.key("runs").beginArray();
+        for (const auto& point : sweep.points) {
+            json.beginObject();
+            json.key("threads").value(point.threadCount);
+            json.key("totalMs");
+            writeStats(json, point.totalMs);
+            json.key("speedup").value(point.totalMs.p50 > 0.0
+                    ? sweep.points.front().totalMs.p50 / point.totalMs.p50 : 0.0);
+            json.key("last");
+            writeResult(json, point.last);
+            json.endObject();
+        }
+        json.endArray();
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    out << '\n';
+    return true;
+}
+
+bool sweepFile(const std::string& path, uint32_t maxThreads, int repeat, bool optimize, SweepResult& sweep) {
+    sweep.path = path;
+    std::cout << path << '\n';
+    for (uint32_t threadCount = 1;; threadCount = std::min(threadCount * 2, maxThreads)) {
+        ObjImportOptions options;
+        options.threadCount = threadCount;
+        options.readCache = false;
+        options.writeCache = false;
+        options.optimize = optimize;
+
+        SweepPoint point{ threadCount, {}, {} };
+        std::vector<double> samples;
+        for (int i = 0; i < repeat; i++) {
+            point.last = importObj(path, options);
+            if (!point.last.isValid()) {
+                return false;
+            }
+            samples.push_back(point.last.totalMs);
+        }
+        // 结果写在临时目录里，只用于计时
+        std::remove(point.last.filameshPath.c_str());
+        point.totalMs = computeStats(samples);
+        sweep.points.push_back(point);
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "  threads " << std::setw(2) << threadCount << ": " << std::setw(8) << point.totalMs.p50
+                  << " ms  x" << sweep.points.front().totalMs.p50 / point.totalMs.p50 << "  (";
+        printStages(point.last);
+        std::cout << ")\n";
+        if (threadCount == maxThreads) {
+            break;
+        }
+    }
+    return true;
+}
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options] [file.obj...]\n"
+              << "  --threads <n>      worker threads, 0 = all hardware threads (default 0)\n"
+              << "  --no-cache         always parse, do not read the cached filamesh\n"
+              << "  --no-optimize      keep the OBJ triangle order (separate cache file)\n"
+              << "  --sweep            time 1, 2, 4 ... --threads threads without the cache\n"
+              << "  --repeat <n>       imports per thread count with --sweep (default 5)\n"
+              << "  --output <file>    write the --sweep results as JSON\n"
+              << "  --assets <dir>     macos-demo directory used when no file is given (default macos-demo)\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    uint32_t threadCount = 0;
+    bool readCache = true;
+    bool optimize = true;
+    bool sweep = false;
+    int repeat = 5;
+    std::string outputPath;
+    std::string assetRoot = "macos-demo";
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--threads") && hasValue) {
+            threadCount = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--no-cache")) {
+            readCache = false;
+        } else if (!strcmp(arg, "--no-optimize")) {
+            optimize = false;
+        } else if (!strcmp(arg, "--sweep")) {
+            sweep = true;
+        } else if (!strcmp(arg, "--repeat") && hasValue) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else if (!strcmp(arg, "--assets") && hasValue) {
+            assetRoot = argv[++i];
+        } else if (arg[0] != '-') {
+            files.emplace_back(arg);
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+    if (files.empty()) {
+        files = findDefaultFiles(assetRoot);
+        if (files.empty()) {
+            std::cerr << "No OBJ files found under " << assetRoot << std::endl;
+            return 1;
+        }
+    }
+
+    if (sweep) {
+        std::vector<SweepResult> sweeps(files.size());
+        for (size_t i = 0; i < files.size(); i++) {
+            if (!sweepFile(files[i], resolveThreadCount(threadCount), repeat, optimize, sweeps[i])) {
+                return 1;
+            }
+        }
+        return outputPath.empty() || writeSweepJson(outputPath, sweeps) ? 0 : 1;
+    }
+
+    ObjImportOptions options;
+    options.threadCount = threadCount;
+    options.readCache = readCache;
+    options.optimize = optimize;
+    int failures = 0;
+    for (const auto& file : files) {
+        const ObjImportResult result = importObj(file, options);
+        if (!result.isValid()) {
+            failures++;
+            continue;
+        }
+        std::cout << result.filameshPath << ": ";
+        if (result.cacheHit) {
+            std::cout << "cached (hash " << std::fixed << std::setprecision(2) << result.hashMs << " ms)\n";
+            continue;
+        }
+        std::cout << result.triangleCount << " triangles, " << result.vertexCount << " vertices, "
+                  << result.partCount << " parts" << (result.generatedNormals ? ", generated normals" : "")
+                  << ", " << std::fixed << std::setprecision(2) << result.totalMs << " ms on "
+                  << result.threadCount << " threads (";
+        printStages(result);
+        std::cout << ")\n";
+        if (optimize) {
+            std::cout << std::setprecision(3) << "  ACMR " << result.cacheBefore.acmr << " -> "
+                      << result.cacheAfter.acmr << ", ATVR " << result.cacheBefore.atvr << " -> "
+                      << result.cacheAfter.atvr << '\n';
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,217 @@
+// ========================================
+// demo-snapshot：把示例场景烘焙成场景快照
+// ========================================
+// 按 04-pbr 或 02-cube-obj 的 setup() 准备同样的场景（网格、材质实例参数、变换、光源、相机、天空盒），
+// 用 common/SceneSnapshot 写成一个对齐、可以直接 mmap 的文件。之后
+//   demo-coldstart --scene snapshot:<file>
+//   demo-bench --scene snapshot:<file>
+// 加载快照时不解析任何格式，每个缓冲区和纹理只上传一次，可以和原场景的冷启动直接对比。
+//
+// GPU 缓冲区无法读回，烘焙从源资源开始：网格由 ObjImporter 从 assets/models 下的 OBJ 导入
+// （未压缩的交错 filamesh），04-pbr 的贴图用 stb_image 从 assets/models/monkey 下的 PNG 解码成 RGBA8。
+// 场景中的动画不在快照里，加载后模型保持 setup() 时的姿态。
+//
+// 用法：
+//   demo-snapshot [--scene 04-pbr] [--assets macos-demo] [--output 04-pbr.snap]
+
+#include "../common/ObjImporter.h"
+#include "../common/SceneSnapshot.h"
+
+#include <filament/Color.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace demo;
+using namespace filament;
+using namespace filament::math;
+
+// stb_image 由 libstb.a 提供
+extern "C" {
+unsigned char* stbi_load(const char* filename, int* x, int* y, int* channels, int desiredChannels);
+const char* stbi_failure_reason();
+void stbi_image_free(void* data);
+}
+
+namespace {
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options]\n"
+              << "  --scene <name>       04-pbr or 02-cube-obj (default 04-pbr)\n"
+              << "  --assets <dir>       macos-demo directory (default macos-demo)\n"
+              << "  --output <file>      snapshot file (default <scene>.snap)\n";
+}
+
+bool readFile(const std::string& path, std::vector<uint8_t>& data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// 导入 OBJ 并把得到的 filamesh 加入快照，instance 填进每个图元
+bool addObjMesh(SceneSnapshotWriter& writer, const std::string& objPath, uint32_t instance,
+        std::vector<SceneSnapshotWriter::Primitive>& primitives, Box& bounds) {
+    const ObjImportResult imported = importObj(objPath);
+    std::vector<uint8_t> filamesh;
+    if (!imported.isValid() || !readFile(imported.filameshPath, filamesh)) {
+        return false;
+    }
+    if (!writer.addFilamesh(filamesh.data(), filamesh.size(), primitives, bounds)) {
+        std::cerr << "Failed to bake mesh: " << imported.filameshPath << std::endl;
+        return false;
+    }
+    for (auto& primitive : primitives) {
+        primitive.instance = instance;
+    }
+    return true;
+}
+
+// 解码 PNG/JPEG 为 RGBA8 并加入快照，失败时返回 ~0u
+uint32_t addImage(SceneSnapshotWriter& writer, const std::string& path, bool srgb) {
+    int width, height, channels;
+    uint8_t* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+    if (!pixels) {
+        std::cerr << "Failed to decode image: " << path << " (" << stbi_failure_reason() << ")"
+                  << std::endl;
+        return ~0u;
+    }
+    const uint32_t texture = writer.addTexture(pixels, uint32_t(width), uint32_t(height), srgb, true);
+    stbi_image_free(pixels);
+    return texture;
+}
+
+// 与 scenes/PbrScene.cpp 的 setup() 一致
+bool bakePbr(SceneSnapshotWriter& writer, const std::string& assetRoot) {
+    const std::string directory = assetRoot + "/assets/models/monkey/";
+    const uint32_t material = writer.addMaterial("texturedlit");
+    const uint32_t instance = writer.addMaterialInstance(material);
+    writer.setParameter(instance, "clearCoat", 0.0f);
+
+    const TextureSampler sampler(TextureSampler::MinFilter::LINEAR_MIPMAP_LINEAR,
+            TextureSampler::MagFilter::LINEAR);
+    const struct {
+        const char* parameter;
+        const char* file;
+        bool srgb;
+    } textures[] = {
+        { "albedo",    "color.png",     true },
+        { "roughness", "roughness.png", false },
+        { "metallic",  "metallic.png",  false },
+        { "ao",        "ao.png",        false },
+        { "normal",    "normal.png",    false },
+    };
+    for (const auto& texture : textures) {
+        const uint32_t index = addImage(writer, directory + texture.file, texture.srgb);
+        if (index == ~0u) {
+            return false;
+        }
+        writer.setParameter(instance, texture.parameter, index, sampler);
+    }
+
+    std::vector<SceneSnapshotWriter::Primitive> primitives;
+    Box bounds;
+    if (!addObjMesh(writer, directory + "monkey.obj", instance, primitives, bounds)) {
+        return false;
+    }
+    writer.addRenderable(mat4f{ mat3f(1), float3(0, 0, -4) }, bounds, primitives, false, true);
+
+    SnapshotLight sun;
+    sun.type = LightManager::Type::SUN;
+    sun.color = Color::toLinear<ACCURATE>(sRGBColor(0.98f, 0.92f, 0.89f));
+    sun.intensity = 110000.0f;
+    sun.direction = { 0.7f, -1.0f, -0.8f };
+    sun.sunAngularRadius = 1.9f;
+    writer.addLight(sun);
+
+    writer.setSkybox({ 0.1f, 0.125f, 0.25f, 1.0f });
+    writer.setCamera(45.0f, 0.1f, 100.0f, mat4f::translation(float3{ 0, 0, 3 }));
+    return true;
+}
+
+// 与 scenes/CubeObjScene.cpp 的 setup() 一致，使用材质的默认实例
+bool bakeCubeObj(SceneSnapshotWriter& writer, const std::string& assetRoot) {
+    const uint32_t material = writer.addMaterial("bakedtexture");
+    const uint32_t instance = writer.addMaterialInstance(material, true);
+
+    std::vector<uint8_t> pixels;
+    if (!readFile(assetRoot + "/rgba8_200x200.rgba", pixels)) {
+        return false;
+    }
+    if (pixels.size() != 200 * 200 * 4) {
+        std::cerr << "Texture file size mismatch: rgba8_200x200.rgba" << std::endl;
+        return false;
+    }
+    TextureSampler sampler(TextureSampler::MinFilter::LINEAR, TextureSampler::MagFilter::LINEAR);
+    sampler.setWrapModeS(TextureSampler::WrapMode::CLAMP_TO_EDGE);
+    sampler.setWrapModeT(TextureSampler::WrapMode::CLAMP_TO_EDGE);
+    writer.setParameter(instance, "albedo", writer.addTexture(pixels.data(), 200, 200, false, false),
+            sampler);
+
+    std::vector<SceneSnapshotWriter::Primitive> primitives;
+    Box bounds;
+    if (!addObjMesh(writer, assetRoot + "/assets/models/cube/cube.obj", instance, primitives, bounds)) {
+        return false;
+    }
+    writer.addRenderable(mat4f(), bounds, primitives, false, true);
+
+    writer.setSkybox({ 0.1f, 0.1f, 0.2f, 1.0f });
+    writer.setCamera(45.0f, 0.1f, 100.0f, mat4f::translation(float3{ 0, 0, 3 }));
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    std::string sceneName = "04-pbr";
+    std::string assetRoot = "macos-demo";
+    std::string outputPath;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--scene") && hasValue) {
+            sceneName = argv[++i];
+        } else if (!strcmp(arg, "--assets") && hasValue) {
+            assetRoot = argv[++i];
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+    if (outputPath.empty()) {
+        outputPath = sceneName + ".snap";
+    }
+
+    SceneSnapshotWriter writer;
+    bool baked;
+    if (sceneName == "04-pbr") {
+        baked = bakePbr(writer, assetRoot);
+    } else if (sceneName == "02-cube-obj") {
+        baked = bakeCubeObj(writer, assetRoot);
+    } else {
+        std::cerr << "Scene cannot be baked: " << sceneName << std::endl;
+        return 1;
+    }
+    if (!baked || !writer.write(outputPath)) {
+        return 1;
+    }
+
+    // 用加载器的校验确认写出的文件完整
+    SceneSnapshot snapshot;
+    if (!snapshot.open(outputPath)) {
+        return 1;
+    }
+    std::cout << sceneName << " -> " << outputPath << " (" << snapshot.getFileSize() << " bytes)"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,331 @@
+// ========================================
+// demo-tangents：分块并行生成切线空间的扩展性测量
+// ========================================
+// 从未压缩的交错 filamesh（或 ObjImporter 导入的 .obj 缓存）读出位置、UV 和法线（从切线空间四元数还原），
+// 所有 part 合成一个三角形列表，用 common/TangentSpace 依次以 1、2、4 ... 个线程（到 --threads 为止）
+// 各生成 --repeat 次，打印中位耗时、相对单线程的加速比、块数、halo 三角形数和各步耗时，
+// 并检查每个线程数的输出是否与单线程（直接调用 TangentSpaceMesh）逐位相同。
+//
+// 默认每个线程数都切成同样多的块（每块至少 1024 个三角形/顶点），--min-chunk 固定每块的下限。
+// bound 是每块独占一个核时估计的加速比：单线程耗时 / (切分 + 最慢一块 + 拼接)，
+// 核数比线程少时（例如单核机器）也能从它看出切块本身的开销和负载均衡。
+//
+// --algorithm 选择 TangentSpaceMesh 的算法，flat 表示不提供法线（平面着色）。
+//
+// 用法：
+//   demo-tangents [--algorithm default|mikktspace|lengyel|hughes-moller|frisvad|flat] [--threads 0]
+//                 [--repeat 5] [--min-chunk 0] [--output tangents.json] <file.filamesh|file.obj>...
+
+#include "../common/Filamesh.h"
+#include "../common/JsonWriter.h"
+#include "../common/ObjImporter.h"
+#include "../common/Parallel.h"
+#include "../common/Stats.h"
+#include "../common/TangentSpace.h"
+
+#include <math/half.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace demo;
+using namespace filament::math;
+using Algorithm = filament::geometry::TangentSpaceMesh::Algorithm;
+
+namespace {
+
+struct AlgorithmName {
+    const char* name;
+    Algorithm algorithm;
+    bool normals;
+};
+
+constexpr AlgorithmName ALGORITHMS[] = {
+    { "default",       Algorithm::DEFAULT,       true },
+    { "mikktspace",    Algorithm::MIKKTSPACE,    true },
+    { "lengyel",       Algorithm::LENGYEL,       true },
+    { "hughes-moller", Algorithm::HUGHES_MOLLER, true },
+    { "frisvad",       Algorithm::FRISVAD,       true },
+    { "flat",          Algorithm::DEFAULT,       false },
+};
+
+struct Mesh {
+    std::vector<float3> positions;
+    std::vector<float3> normals;
+    std::vector<float2> uvs;
+    std::vector<uint3> triangles;
+};
+
+struct SweepPoint {
+    uint32_t threadCount = 0;
+    SampleStats totalMs;
+    TangentSpaceStats last;
+    double boundSpeedup = 0.0;
+    bool identical = false;
+};
+
+struct FileResult {
+    std::string path;
+    size_t vertexCount = 0;
+    size_t triangleCount = 0;
+    std::vector<SweepPoint> points;
+};
+
+float readHalf(const uint8_t* data) {
+    uint16_t bits;
+    std::memcpy(&bits, data, sizeof(bits));
+    return float(makeHalf(bits));
+}
+
+float readSnorm16(const uint8_t* data) {
+    int16_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return std::max(float(value) / 32767.0f, -1.0f);
+}
+
+bool readFilamesh(const std::string& path, Mesh& mesh) {
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<uint8_t> data(std::istreambuf_iterator<char>(in), {});
+    FilameshLayout layout;
+    const char* error = readFilameshLayout(data.data(), data.size(), layout);
+    const FilameshHeader& header = layout.header;
+    if (!error) {
+        error = checkInterleavedFilamesh(header);
+    }
+    if (error) {
+        std::cerr << error << ": " << path << std::endl;
+        return false;
+    }
+    const size_t elementSize = filameshIndexElementSize(header);
+    const uint32_t stride = header.stridePosition;
+
+    const uint8_t* vertices = data.data() + sizeof(header);
+    const bool hasUvs = header.offsetUV0 != FILAMESH_NO_ATTRIBUTE;
+    const bool snormUvs = header.flags & FILAMESH_TEXCOORD_SNORM16;
+    mesh.positions.resize(header.vertexCount);
+    mesh.normals.resize(header.vertexCount);
+    mesh.uvs.resize(hasUvs ? header.vertexCount : 0);
+    for (uint32_t v = 0; v < header.vertexCount; v++) {
+        const uint8_t* vertex = vertices + size_t(v) * stride;
+        const uint8_t* position = vertex + header.offsetPosition;
+        mesh.positions[v] = float3{ readHalf(position), readHalf(position + 2), readHalf(position + 4) };
+        // 法线是切线空间四元数把 +Z 旋转后的方向
+        const uint8_t* tangents = vertex + header.offsetTangents;
+        const quatf q{ readSnorm16(tangents + 6), readSnorm16(tangents), readSnorm16(tangents + 2),
+                readSnorm16(tangents + 4) };
+        mesh.normals[v] = normalize(float3{ 2.0f * (q.x * q.z + q.w * q.y), 2.0f * (q.y * q.z - q.w * q.x),
+                1.0f - 2.0f * (q.x * q.x + q.y * q.y) });
+        if (hasUvs) {
+            const uint8_t* uv = vertex + header.offsetUV0;
+            mesh.uvs[v] = snormUvs ? float2{ readSnorm16(uv), readSnorm16(uv + 2) }
+                                   : float2{ readHalf(uv), readHalf(uv + 2) };
+        }
+    }
+    const uint8_t* indices = vertices + header.vertexSize;
+    mesh.triangles.resize(header.indexCount / 3);
+    for (size_t i = 0; i < mesh.triangles.size() * 3; i++) {
+        uint32_t index;
+        if (elementSize == sizeof(uint16_t)) {
+            uint16_t shortIndex;
+            std::memcpy(&shortIndex, indices + i * sizeof(shortIndex), sizeof(shortIndex));
+            index = shortIndex;
+        } else {
+            std::memcpy(&index, indices + i * sizeof(index), sizeof(index));
+        }
+        mesh.triangles[i / 3][i % 3] = index;
+    }
+    return true;
+}
+
+bool sameOutput(const TangentSpaceOutput& a, const TangentSpaceOutput& b) {
+    const auto sameBytes = [](const auto& x, const auto& y) {
+        return x.size() == y.size() && (x.empty() || std::memcmp(x.data(), y.data(), x.size() * sizeof(x[0])) == 0);
+    };
+    return a.remeshed == b.remeshed && sameBytes(a.tangents, b.tangents) && sameBytes(a.positions, b.positions) &&
+            sameBytes(a.uvs, b.uvs) && sameBytes(a.triangles, b.triangles);
+}
+
+bool sweepFile(const std::string& file, const AlgorithmName& algorithm, uint32_t maxThreads, int repeat,
+        uint32_t minChunkTriangles, FileResult& result) {
+    result.path = file;
+    const std::string meshPath = resolveMeshPath(file);
+    Mesh mesh;
+    if (meshPath.empty() || !readFilamesh(meshPath, mesh)) {
+        return false;
+    }
+    result.vertexCount = mesh.positions.size();
+    result.triangleCount = mesh.triangles.size();
+    std::cout << file << ": " << result.vertexCount << " vertices, " << result.triangleCount << " triangles, "
+              << algorithm.name << '\n';
+
+    TangentSpaceInput input;
+    input.positions = mesh.positions.data();
+    input.normals = algorithm.normals ? mesh.normals.data() : nullptr;
+    input.uvs = mesh.uvs.empty() ? nullptr : mesh.uvs.data();
+    input.vertexCount = mesh.positions.size();
+    input.triangles = mesh.triangles.data();
+    input.triangleCount = mesh.triangles.size();
+
+    TangentSpaceOutput reference;
+    for (uint32_t threadCount = 1;; threadCount = std::min(threadCount * 2, maxThreads)) {
+        TangentSpaceOptions options;
+        options.algorithm = algorithm.algorithm;
+        options.threadCount = threadCount;
+        // 按顶点和按三角形切分的算法都切成 threadCount 块
+        options.minChunkTriangles = minChunkTriangles ? minChunkTriangles
+                : uint32_t(std::max<size_t>(1024, std::min(input.vertexCount, input.triangleCount) / threadCount));
+
+        SweepPoint point;
+        point.threadCount = threadCount;
+        std::vector<double> samples;
+        TangentSpaceOutput output;
+        for (int i = 0; i < repeat; i++) {
+            if (!generateTangentSpace(input, options, output, &point.last)) {
+                return false;
+            }
+            samples.push_back(point.last.totalMs);
+        }
+        if (threadCount == 1) {
+            reference = std::move(output);
+            point.identical = true;
+        } else {
+            point.identical = sameOutput(output, reference);
+        }
+        point.totalMs = computeStats(samples);
+        const TangentSpaceStats& stats = point.last;
+        const double criticalMs = stats.partitionMs + stats.slowestChunkMs + stats.stitchMs;
+        point.boundSpeedup = criticalMs > 0.0
+                ? (result.points.empty() ? point.totalMs.p50 : result.points.front().totalMs.p50) / criticalMs : 0.0;
+        result.points.push_back(point);
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "  threads " << std::setw(2) << threadCount << ": " << std::setw(9) << point.totalMs.p50
+                  << " ms  x" << result.points.front().totalMs.p50 / point.totalMs.p50
+                  << "  bound x" << point.boundSpeedup
+                  << "  (" << stats.chunkCount << " chunks, " << stats.haloTriangles << " halo triangles, partition "
+                  << stats.partitionMs << " chunks " << stats.chunkMs << " (slowest " << stats.slowestChunkMs
+                  << ") stitch " << stats.stitchMs << " ms)"
+                  << (point.identical ? "" : "  DIFFERS from 1 thread") << '\n';
+        if (threadCount == maxThreads) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool writeJson(const std::string& path, const char* algorithm, const std::vector<FileResult>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to open output file: " << path << std::endl;
+        return false;
+    }
+    JsonWriter json(out);
+    json.beginObject();
+    json.key("algorithm").value(algorithm);
+    json.key("files").beginArray();
+    for (const auto& result : results) {
+        json.beginObject();
+        json.key("path").value(result.path);
+        json.key("vertices").value((unsigned long long) result.vertexCount);
+        json.key("triangles").value((unsigned long long) result.triangleCount);
+        json.key("runs").beginArray();
+        for (const auto& point : result.points) {
+            json.beginObject();
+            json.key("threads").value((unsigned long long) point.threadCount);
+            json.key("totalMs");
+            writeStats(json, point.totalMs);
+            json.key("speedup").value(point.totalMs.p50 > 0.0
+                    ? result.points.front().totalMs.p50 / point.totalMs.p50 : 0.0);
+            json.key("chunks").value((unsigned long long) point.last.chunkCount);
+            json.key("haloTriangles").value((unsigned long long) point.last.haloTriangles);
+            json.key("partitionMs").value(point.last.partitionMs);
+            json.key("chunkMs").value(point.last.chunkMs);
+            json.key("slowestChunkMs").value(point.last.slowestChunkMs);
+            json.key("boundSpeedup").value(point.boundSpeedup);
+            json.key("stitchMs").value(point.last.stitchMs);
+            json.key("identical").value(point.identical);
+            json.endObject();
+        }
+        json.endArray();
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+    out << '\n';
+    return true;
+}
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " [options] <file.filamesh|file.obj>...\n"
+              << "  --algorithm <name>    default, mikktspace, lengyel, hughes-moller, frisvad or flat (default default)\n"
+              << "  --threads <n>         time 1, 2, 4 ... n threads, 0 = all hardware threads (default 0)\n"
+              << "  --repeat <n>          runs per thread count (default 5)\n"
+              << "  --min-chunk <n>       minimum triangles per chunk, 0 = one chunk per thread (default 0)\n"
+              << "  --output <file>       write the results as JSON\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    const AlgorithmName* algorithm = &ALGORITHMS[0];
+    uint32_t threadCount = 0;
+    int repeat = 5;
+    uint32_t minChunkTriangles = 0;
+    std::string outputPath;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (!strcmp(arg, "--algorithm") && hasValue) {
+            const char* name = argv[++i];
+            const auto found = std::find_if(std::begin(ALGORITHMS), std::end(ALGORITHMS),
+                    [name](const AlgorithmName& entry) { return !strcmp(entry.name, name); });
+            if (found == std::end(ALGORITHMS)) {
+                std::cerr << "Unknown algorithm: " << name << std::endl;
+                return 1;
+            }
+            algorithm = found;
+        } else if (!strcmp(arg, "--threads") && hasValue) {
+            threadCount = uint32_t(std::max(0l, std::strtol(argv[++i], nullptr, 10)));
+        } else if (!strcmp(arg, "--repeat") && hasValue) {
+            repeat = int(std::max(1l, std::strtol(argv[++i], nullptr, 10)));
+        } else if (!strcmp(arg, "--min-chunk") && hasValue) {
+            minChunkTriangles = uint32_t(std::max(0l, std::strtol(argv[++i], nullptr, 10)));
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg[0] != '-') {
+            files.emplace_back(arg);
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+    }
+    if (files.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<FileResult> results;
+    int failures = 0;
+    for (const auto& file : files) {
+        FileResult result;
+        if (!sweepFile(file, *algorithm, resolveThreadCount(threadCount), repeat, minChunkTriangles, result)) {
+            std::cerr << "Failed to generate tangents: " << file << std::endl;
+            failures++;
+            continue;
+        }
+        results.push_back(result);
+    }
+    if (!outputPath.empty() && !writeJson(outputPath, algorithm->name, results)) {
+        return 1;
+    }
+    return failures ? 1 : 0;
+}
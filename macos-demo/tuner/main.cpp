@@ -0,0 +1,633 @@
+// ========================================
+// demo-tuner：Engine::Config 调优工具
+// ========================================
+// 在无窗口（NOOP 后端）环境下，用不同的 Engine::Config 反复运行同一个场景，
+// 记录帧耗时、RSS 峰值和引擎输出的 arena/命令缓冲区告警，
+// 最后给出满足帧耗时目标、内存占用最小的配置。
+//
+// 每组配置都在 fork() 出的子进程里运行：
+// - RSS 峰值（getrusage）只增不减，独立进程才能按配置比较
+// - arena 不足时引擎可能直接 abort，不会影响后续的测试
+// - 子进程的 stdout/stderr 重定向到管道，由父进程扫描告警
+//
+// 用法：
+//   demo-tuner --scene 04-pbr --target-ms 16.6
+//              [--bisect perRenderPassArenaSizeMB=1:6]...   逐个字段二分查找最小的合格值
+//              [--grid jobSystemThreadCount=1,2,4]...        网格搜索（笛卡尔积）
+//              [--set commandBufferSizeMB=6]...              其余字段的基准值
+//              [--percentile 0.9] [--frames 120] [--warmup 10]
+//              [--width 800] [--height 600]
+//              [--assets macos-demo] [--filamesh /tmp/cube.filamesh]
+//              [--output tuner.json]
+// 不指定 --bisect/--grid 时，对各个内存相关字段依次在 [1, 2 * 默认值] 内二分。
+
+#include "../common/DemoScene.h"
+#include "../common/JsonWriter.h"
+#include "../common/ProcessMemory.h"
+#include "../common/SceneBenchmark.h"
+#include "../common/Stats.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace demo;
+using filament::Engine;
+
+namespace {
+
+// ========================================
+// 可调的 Engine::Config 字段
+// ========================================
+struct ConfigField {
+    const char* name;
+    uint32_t Engine::Config::* member;
+    bool footprint;     // 是否计入内存占用（见 Engine::Config 的注释）
+};
+
+// 二分时按这个顺序处理：perRenderPassArena 必须大于 perFrameCommands，
+// commandBuffer 至少是 minCommandBuffer 的数倍，先缩小被包含的字段
+const ConfigField CONFIG_FIELDS[] = {
+    { "perFrameCommandsSizeMB",       &Engine::Config::perFrameCommandsSizeMB,       false },
+    { "perRenderPassArenaSizeMB",     &Engine::Config::perRenderPassArenaSizeMB,     true  },
+    { "minCommandBufferSizeMB",       &Engine::Config::minCommandBufferSizeMB,       false },
+    { "commandBufferSizeMB",          &Engine::Config::commandBufferSizeMB,          true  },
+    { "driverHandleArenaSizeMB",      &Engine::Config::driverHandleArenaSizeMB,      true  },
+    { "jobSystemThreadCount",         &Engine::Config::jobSystemThreadCount,         false },
+    // filament 1.63 中已经废弃，仍然保留以便和旧版本比较
+    { "resourceAllocatorCacheSizeMB", &Engine::Config::resourceAllocatorCacheSizeMB, false },
+};
+constexpr size_t FIELD_COUNT = sizeof(CONFIG_FIELDS) / sizeof(CONFIG_FIELDS[0]);
+
+// 不指定搜索方式时默认二分的字段
+const char* const DEFAULT_BISECT_FIELDS[] = {
+    "perFrameCommandsSizeMB",
+    "perRenderPassArenaSizeMB",
+    "minCommandBufferSizeMB",
+    "commandBufferSizeMB",
+};
+
+using ConfigValues = std::array<uint32_t, FIELD_COUNT>;
+
+int findField(const std::string& name) {
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        if (name == CONFIG_FIELDS[i].name) {
+            return int(i);
+        }
+    }
+    return -1;
+}
+
+ConfigValues fromConfig(const Engine::Config& config) {
+    ConfigValues values{};
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        values[i] = config.*CONFIG_FIELDS[i].member;
+    }
+    return values;
+}
+
+Engine::Config toConfig(const ConfigValues& values) {
+    Engine::Config config;
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        config.*CONFIG_FIELDS[i].member = values[i];
+    }
+    return config;
+}
+
+uint32_t footprintMB(const ConfigValues& values) {
+    uint32_t total = 0;
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        if (CONFIG_FIELDS[i].footprint) {
+            total += values[i];
+        }
+    }
+    return total;
+}
+
+std::string describe(const ConfigValues& values) {
+    std::ostringstream out;
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        out << (i ? " " : "") << CONFIG_FIELDS[i].name << '=' << values[i];
+    }
+    return out.str();
+}
+
+// ========================================
+// 单次测试
+// ========================================
+
+// 子进程通过管道返回的结果，只包含 POD 字段
+struct TrialReport {
+    uint32_t ok;
+    uint32_t skippedFrames;
+    double frameMs;         // 目标分位数的帧耗时
+    double meanFrameMs;
+    uint64_t peakRssBytes;
+    ConfigValues effective; // Engine::getConfig()，引擎会修正不合法的取值
+};
+
+struct Trial {
+    ConfigValues requested{};
+    TrialReport report{};
+    bool completed = false;         // 子进程正常退出并返回了结果
+    std::string error;
+    uint32_t warningCount = 0;
+    std::vector<std::string> warnings;
+    bool passed = false;
+};
+
+struct TunerOptions {
+    std::string scene;
+    SceneContext params;
+    BenchmarkOptions bench;
+    double targetMs = 1000.0 / 60.0;
+    double percentile = 0.9;
+};
+
+// 引擎日志中表示 arena/命令缓冲区容量不足的关键字（小写）
+const char* const WARNING_KEYWORDS[] = {
+    "arena", "overflow", "out of memory", "heap", "commandstream", "command buffer", "stall",
+};
+constexpr size_t MAX_WARNING_LINES = 8;
+
+void scanWarnings(const std::string& log, Trial& trial) {
+    std::istringstream lines(log);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::string lower = line;
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+                [](unsigned char c) { return char(std::tolower(c)); });
+        for (const char* keyword : WARNING_KEYWORDS) {
+            if (lower.find(keyword) != std::string::npos) {
+                trial.warningCount++;
+                if (trial.warnings.size() < MAX_WARNING_LINES) {
+                    trial.warnings.push_back(line);
+                }
+                break;
+            }
+        }
+    }
+}
+
+std::string readAll(int fd) {
+    std::string data;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        data.append(buffer, size_t(n));
+    }
+    return data;
+}
+
+// 在子进程中运行：测量一组配置并把结果写入 reportFd
+[[noreturn]] void runChild(const TunerOptions& options, const ConfigValues& values, int reportFd) {
+    const Engine::Config config = toConfig(values);
+    BenchmarkResult result = runSceneBenchmark(options.scene, options.params, &config, options.bench);
+
+    TrialReport report{};
+    report.ok = result.ok;
+    report.skippedFrames = result.skippedFrames;
+    report.frameMs = computePercentile(result.frameMs, options.percentile);
+    report.meanFrameMs = computeStats(result.frameMs).mean;
+    report.peakRssBytes = getPeakRssBytes();
+    report.effective = fromConfig(result.engineConfig);
+
+    const ssize_t written = write(reportFd, &report, sizeof(report));
+    _exit(written == ssize_t(sizeof(report)) ? 0 : 1);
+}
+
+Trial runTrial(const TunerOptions& options, const ConfigValues& values) {
+    Trial trial;
+    trial.requested = values;
+
+    int reportPipe[2];
+    int logPipe[2];
+    if (pipe(reportPipe) != 0) {
+        trial.error = "pipe() failed";
+        return trial;
+    }
+    if (pipe(logPipe) != 0) {
+        close(reportPipe[0]);
+        close(reportPipe[1]);
+        trial.error = "pipe() failed";
+        return trial;
+    }
+
+    // 避免缓冲区里未输出的内容在子进程中再输出一次
+    std::cout.flush();
+    std::cerr.flush();
+
+    const pid_t pid = fork();
+    if (pid < 0) {
+        close(reportPipe[0]);
+        close(reportPipe[1]);
+        close(logPipe[0]);
+        close(logPipe[1]);
+        trial.error = "fork() failed";
+        return trial;
+    }
+    if (pid == 0) {
+        close(reportPipe[0]);
+        close(logPipe[0]);
+        dup2(logPipe[1], STDOUT_FILENO);
+        dup2(logPipe[1], STDERR_FILENO);
+        close(logPipe[1]);
+        runChild(options, values, reportPipe[1]);
+    }
+
+    close(reportPipe[1]);
+    close(logPipe[1]);
+    // 先读完日志再读结果：子进程退出时两个管道都会关闭
+    const std::string log = readAll(logPipe[0]);
+    close(logPipe[0]);
+    const std::string report = readAll(reportPipe[0]);
+    close(reportPipe[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (WIFSIGNALED(status)) {
+        trial.error = "crashed with signal " + std::to_string(WTERMSIG(status));
+    } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || report.size() != sizeof(TrialReport)) {
+        trial.error = "no result from child process";
+    } else {
+        std::memcpy(&trial.report, report.data(), sizeof(TrialReport));
+        trial.completed = true;
+        if (!trial.report.ok) {
+            trial.error = "benchmark failed";
+        }
+    }
+
+    scanWarnings(log, trial);
+    trial.passed = trial.completed && trial.report.ok && trial.warningCount == 0 &&
+            trial.report.frameMs <= options.targetMs;
+    return trial;
+}
+
+// ========================================
+// 搜索
+// ========================================
+class Tuner {
+public:
+    explicit Tuner(const TunerOptions& options) : mOptions(options) {
+    }
+
+    // 相同的配置只运行一次
+    const Trial& evaluate(const ConfigValues& values) {
+        auto it = mCache.find(values);
+        if (it != mCache.end()) {
+            return mTrials[it->second];
+        }
+        mTrials.push_back(runTrial(mOptions, values));
+        mCache[values] = mTrials.size() - 1;
+
+        const Trial& trial = mTrials.back();
+        std::cerr << "[" << mTrials.size() << "] " << describe(values) << "\n    -> ";
+        if (trial.completed) {
+            std::cerr << std::fixed << std::setprecision(2)
+                      << trial.report.frameMs << " ms, peak RSS "
+                      << double(trial.report.peakRssBytes) / (1024.0 * 1024.0) << " MB"
+                      << std::defaultfloat;
+        } else {
+            std::cerr << trial.error;
+        }
+        if (trial.warningCount) {
+            std::cerr << ", " << trial.warningCount << " warning(s)";
+        }
+        std::cerr << (trial.passed ? "  PASS" : "  FAIL") << std::endl;
+        return trial;
+    }
+
+    // 网格搜索：values[i] 为空的字段保持 base 中的值
+    void grid(const ConfigValues& base, const std::vector<std::vector<uint32_t>>& values) {
+        std::vector<size_t> dims;
+        for (size_t i = 0; i < FIELD_COUNT; i++) {
+            if (!values[i].empty()) {
+                dims.push_back(i);
+            }
+        }
+        std::vector<size_t> index(dims.size(), 0);
+        while (true) {
+            ConfigValues config = base;
+            for (size_t d = 0; d < dims.size(); d++) {
+                config[dims[d]] = values[dims[d]][index[d]];
+            }
+            evaluate(config);
+
+            size_t d = 0;
+            while (d < dims.size() && ++index[d] == values[dims[d]].size()) {
+                index[d++] = 0;
+            }
+            if (d == dims.size()) {
+                break;
+            }
+        }
+    }
+
+    // 二分查找 [lo, hi] 中满足目标的最小值（假设值越大越容易满足），返回更新后的配置
+    ConfigValues bisect(ConfigValues config, size_t field, uint32_t lo, uint32_t hi) {
+        config[field] = hi;
+        if (!evaluate(config).passed) {
+            std::cerr << CONFIG_FIELDS[field].name << ": target not met at " << hi
+                      << ", keeping " << hi << std::endl;
+            return config;
+        }
+        while (lo < hi) {
+            const uint32_t mid = lo + (hi - lo) / 2;
+            config[field] = mid;
+            if (evaluate(config).passed) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        config[field] = hi;
+        std::cerr << CONFIG_FIELDS[field].name << ": smallest passing value " << hi << std::endl;
+        return config;
+    }
+
+    // 满足目标的测试中，实际配置的内存占用最小者；相同时取 RSS 峰值较小者
+    const Trial* best() const {
+        const Trial* best = nullptr;
+        for (const auto& trial : mTrials) {
+            if (!trial.passed) {
+                continue;
+            }
+            if (!best) {
+                best = &trial;
+                continue;
+            }
+            const uint32_t a = footprintMB(trial.report.effective);
+            const uint32_t b = footprintMB(best->report.effective);
+            if (a < b || (a == b && trial.report.peakRssBytes < best->report.peakRssBytes)) {
+                best = &trial;
+            }
+        }
+        return best;
+    }
+
+    const std::vector<Trial>& getTrials() const noexcept { return mTrials; }
+
+private:
+    TunerOptions mOptions;
+    std::vector<Trial> mTrials;
+    std::map<ConfigValues, size_t> mCache;
+};
+
+// ========================================
+// 输出
+// ========================================
+void writeConfig(JsonWriter& json, const ConfigValues& values) {
+    json.beginObject();
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        json.key(CONFIG_FIELDS[i].name).value(values[i]);
+    }
+    json.endObject();
+}
+
+void writeTrial(JsonWriter& json, const Trial& trial) {
+    json.beginObject();
+    json.key("requested"); writeConfig(json, trial.requested);
+    json.key("completed").value(trial.completed);
+    json.key("passed").value(trial.passed);
+    if (!trial.error.empty()) {
+        json.key("error").value(trial.error);
+    }
+    if (trial.completed) {
+        json.key("effective"); writeConfig(json, trial.report.effective);
+        json.key("footprintMB").value(footprintMB(trial.report.effective));
+        json.key("frameMs").value(trial.report.frameMs);
+        json.key("meanFrameMs").value(trial.report.meanFrameMs);
+        json.key("skippedFrames").value(trial.report.skippedFrames);
+        json.key("peakRssMB").value(double(trial.report.peakRssBytes) / (1024.0 * 1024.0));
+    }
+    json.key("warningCount").value(trial.warningCount);
+    json.key("warnings").beginArray();
+    for (const auto& line : trial.warnings) {
+        json.value(line);
+    }
+    json.endArray();
+    json.endObject();
+}
+
+// 把推荐配置打印成可以直接粘贴的代码
+void printConfigSnippet(std::ostream& out, const ConfigValues& values) {
+    const ConfigValues defaults = fromConfig(Engine::Config{});
+    out << "Engine::Config config;\n";
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        if (values[i] != defaults[i]) {
+            out << "config." << CONFIG_FIELDS[i].name << " = " << values[i] << ";\n";
+        }
+    }
+    out << "Engine* engine = Engine::create(backend, nullptr, nullptr, &config);\n";
+}
+
+// ========================================
+// 命令行解析
+// ========================================
+
+// 解析 "name=value"，返回字段下标，失败返回 -1
+int splitAssignment(const char* arg, std::string& value) {
+    const char* eq = std::strchr(arg, '=');
+    if (!eq) {
+        return -1;
+    }
+    value = eq + 1;
+    return findField(std::string(arg, eq));
+}
+
+bool parseUint(const std::string& text, uint32_t& out) {
+    if (text.empty() || !std::isdigit((unsigned char)text[0])) {
+        return false;
+    }
+    char* end = nullptr;
+    out = uint32_t(std::strtoul(text.c_str(), &end, 10));
+    return *end == '\0';
+}
+
+struct BisectRange {
+    size_t field;
+    uint32_t lo;
+    uint32_t hi;
+};
+
+void printUsage(const char* name) {
+    std::cout << "Usage: " << name << " --scene <name> [options]\n"
+              << "  --target-ms <ms>        frame-time target (default 16.67)\n"
+              << "  --percentile <p>        frame-time percentile compared to the target (default 0.9)\n"
+              << "  --bisect <field>=lo:hi  find the smallest passing value (may be repeated)\n"
+              << "  --grid <field>=a,b,c    try every combination (may be repeated)\n"
+              << "  --set <field>=value     base value for a field (may be repeated)\n"
+              << "  --frames <n>            measured frames per trial (default 120)\n"
+              << "  --warmup <n>            warmup frames per trial (default 10)\n"
+              << "  --width <n> --height <n>\n"
+              << "  --assets <dir>          macos-demo directory (default macos-demo)\n"
+              << "  --filamesh <file>       mesh used by 02-cube-obj\n"
+              << "  --output <file>         write JSON to file instead of stdout\n"
+              << "Fields:";
+    for (const auto& field : CONFIG_FIELDS) {
+        std::cout << ' ' << field.name;
+    }
+    std::cout << '\n';
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    TunerOptions options;
+    options.bench.frames = 120;
+    ConfigValues base = fromConfig(Engine::Config{});
+    std::vector<std::vector<uint32_t>> gridValues(FIELD_COUNT);
+    std::vector<BisectRange> bisectRanges;
+    std::string outputPath;
+
+    // ========================================
+    // 第一步：解析命令行参数
+    // ========================================
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        std::string value;
+        int field = -1;
+        bool valid = true;
+
+        if (!strcmp(arg, "--scene") && hasValue) {
+            options.scene = argv[++i];
+        } else if (!strcmp(arg, "--target-ms") && hasValue) {
+            options.targetMs = std::strtod(argv[++i], nullptr);
+        } else if (!strcmp(arg, "--percentile") && hasValue) {
+            options.percentile = std::clamp(std::strtod(argv[++i], nullptr), 0.0, 1.0);
+        } else if (!strcmp(arg, "--frames") && hasValue) {
+            options.bench.frames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--warmup") && hasValue) {
+            options.bench.warmupFrames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--width") && hasValue) {
+            options.params.width = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--height") && hasValue) {
+            options.params.height = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!strcmp(arg, "--assets") && hasValue) {
+            options.params.assetRoot = argv[++i];
+        } else if (!strcmp(arg, "--filamesh") && hasValue) {
+            options.params.filameshPath = argv[++i];
+        } else if (!strcmp(arg, "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else if (!strcmp(arg, "--set") && hasValue) {
+            field = splitAssignment(argv[++i], value);
+            valid = field >= 0 && parseUint(value, base[field]);
+        } else if (!strcmp(arg, "--grid") && hasValue) {
+            field = splitAssignment(argv[++i], value);
+            valid = field >= 0;
+            std::istringstream items(value);
+            std::string item;
+            while (valid && std::getline(items, item, ',')) {
+                uint32_t v = 0;
+                valid = parseUint(item, v);
+                gridValues[field].push_back(v);
+            }
+            valid = valid && !gridValues[field].empty();
+        } else if (!strcmp(arg, "--bisect") && hasValue) {
+            field = splitAssignment(argv[++i], value);
+            const size_t colon = value.find(':');
+            BisectRange range{ size_t(field), 0, 0 };
+            valid = field >= 0 && colon != std::string::npos &&
+                    parseUint(value.substr(0, colon), range.lo) &&
+                    parseUint(value.substr(colon + 1), range.hi) && range.lo <= range.hi;
+            if (valid) {
+                bisectRanges.push_back(range);
+            }
+        } else {
+            printUsage(argv[0]);
+            return !strcmp(arg, "--help") ? 0 : 1;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid argument: " << arg << ' ' << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (options.scene.empty() || !createDemoScene(options.scene)) {
+        std::cerr << "A valid --scene is required, available scenes:" << std::endl;
+        for (const auto& name : getDemoSceneNames()) {
+            std::cerr << "  " << name << std::endl;
+        }
+        return 1;
+    }
+
+    const bool hasGrid = std::any_of(gridValues.begin(), gridValues.end(),
+            [](const std::vector<uint32_t>& v) { return !v.empty(); });
+    if (!hasGrid && bisectRanges.empty()) {
+        for (const char* name : DEFAULT_BISECT_FIELDS) {
+            const size_t field = size_t(findField(name));
+            bisectRanges.push_back({ field, 1, std::max(1u, base[field] * 2) });
+        }
+    }
+
+    // ========================================
+    // 第二步：搜索
+    // ========================================
+    // 先做网格搜索，再从当前基准配置出发逐个字段二分
+    Tuner tuner(options);
+    if (hasGrid) {
+        tuner.grid(base, gridValues);
+    }
+    ConfigValues current = base;
+    for (const auto& range : bisectRanges) {
+        current = tuner.bisect(current, range.field, range.lo, range.hi);
+    }
+
+    // ========================================
+    // 第三步：输出结果
+    // ========================================
+    const Trial* best = tuner.best();
+    if (best) {
+        std::cerr << "\nSmallest passing config (footprint " << footprintMB(best->report.effective)
+                  << " MB):\n";
+        printConfigSnippet(std::cerr, best->report.effective);
+    } else {
+        std::cerr << "\nNo config met the " << options.targetMs << " ms target" << std::endl;
+    }
+
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open output file: " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputPath.empty() ? std::cout : file;
+
+    JsonWriter json(out);
+    json.beginObject();
+    json.key("scene").value(options.scene);
+    json.key("backend").value("noop");
+    json.key("frames").value(options.bench.frames);
+    json.key("warmupFrames").value(options.bench.warmupFrames);
+    json.key("targetMs").value(options.targetMs);
+    json.key("percentile").value(options.percentile);
+    json.key("trials").beginArray();
+    for (const auto& trial : tuner.getTrials()) {
+        writeTrial(json, trial);
+    }
+    json.endArray();
+    json.key("found").value(best != nullptr);
+    if (best) {
+        json.key("best"); writeTrial(json, *best);
+    }
+    json.endObject();
+    out << std::endl;
+
+    return best ? 0 : 2;
+}